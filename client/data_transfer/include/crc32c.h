@@ -0,0 +1,15 @@
+#pragma once
+
+// CRC32C（Castagnoli）校验，运行时按CPU选择实现：
+// x86 SSE4.2 crc32指令 / ARMv8 CRC扩展 / 查表（slicing-by-8）
+#include <cstddef>
+#include <cstdint>
+
+// crc为上一段的结果，可分段累计计算；首段传0
+uint32_t Crc32c(const void* data, size_t size, uint32_t crc = 0);
+
+// 查表实现，供对比与校验
+uint32_t Crc32cScalar(const void* data, size_t size, uint32_t crc = 0);
+
+// 当前使用的实现名称："sse4.2" / "armv8" / "scalar"
+const char* Crc32cImplementation();
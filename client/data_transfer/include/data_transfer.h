@@ -1,24 +1,40 @@
-#pragma once
-
-// 数据转移模块接口定义
-#ifdef DATATRANSFER_EXPORTS
-#define DATATRANSFER_API __declspec(dllexport)
-#else
-#define DATATRANSFER_API __declspec(dllimport)
-#endif
-
-#include <cstddef>
-
-extern "C" {
-    // 零拷贝数据发送接口
-    DATATRANSFER_API bool SendData(const char* ip, 
-                                  unsigned short port,
-                                  const void* buffer, 
-                                  size_t size);
-    
-    // 零拷贝数据接收接口
-    DATATRANSFER_API bool ReceiveData(const char* ip, 
-                                     unsigned short port,
-                                     void* buffer, 
-                                     size_t size);
-}
+#pragma once
+
+// 数据转移模块接口定义
+#ifdef DATATRANSFER_EXPORTS
+#define DATATRANSFER_API __declspec(dllexport)
+#else
+#define DATATRANSFER_API __declspec(dllimport)
+#endif
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+    // 零拷贝数据发送接口
+    DATATRANSFER_API bool SendData(const char* ip, 
+                                  unsigned short port,
+                                  const void* buffer, 
+                                  size_t size);
+    
+    // 零拷贝数据接收接口
+    DATATRANSFER_API bool ReceiveData(const char* ip, 
+                                     unsigned short port,
+                                     void* buffer, 
+                                     size_t size);
+
+    // 大消息分片发送：按报文大小切分，每片带32字节数据头与分片头
+    DATATRANSFER_API bool SendDataFragmented(const char* ip,
+                                            unsigned short port,
+                                            uint8_t operation,
+                                            uint64_t dstDevice,
+                                            const void* buffer,
+                                            size_t size);
+
+    // 接收一次分片传输并重组到buffer，分片可乱序到达
+    DATATRANSFER_API bool ReceiveDataFragmented(const char* ip,
+                                               unsigned short port,
+                                               void* buffer,
+                                               size_t size,
+                                               int timeoutMs);
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+// 双向报文通道抽象：可靠传输层只依赖该接口，便于在环回上注入丢包/乱序
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zmq_socket_pool.h"
+
+class DatagramChannel {
+public:
+    virtual ~DatagramChannel() = default;
+
+    virtual bool send(const void* data, size_t size) = 0;
+    // 返回报文字节数；超时返回0，错误返回-1。timeoutMs为0时不阻塞
+    virtual int receive(void* buffer, size_t capacity, int timeoutMs) = 0;
+};
+
+// 基于ZMQ_DGRAM的通道：每条消息为[对端地址, 报文]两帧。
+// peer为空时采用第一个收到报文的来源作为对端。
+class ZmqDatagramChannel : public DatagramChannel {
+public:
+    ZmqDatagramChannel(ZmqSocketLease&& socket, const std::string& peer = std::string());
+
+    bool send(const void* data, size_t size) override;
+    int receive(void* buffer, size_t capacity, int timeoutMs) override;
+
+    const std::string& peer() const { return m_peer; }
+
+private:
+    ZmqSocketLease m_socket;
+    std::string m_peer;
+    int m_timeoutMs = -2;                // 当前RCVTIMEO，避免重复设置
+};
+
+// 进程内环回通道对，用于测试与压测
+class LoopbackChannel : public DatagramChannel {
+public:
+    static std::pair<std::unique_ptr<LoopbackChannel>, std::unique_ptr<LoopbackChannel>> createPair();
+
+    bool send(const void* data, size_t size) override;
+    int receive(void* buffer, size_t capacity, int timeoutMs) override;
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<std::vector<uint8_t>> packets;
+    };
+
+    LoopbackChannel(std::shared_ptr<Queue> inbound, std::shared_ptr<Queue> outbound);
+
+    std::shared_ptr<Queue> m_inbound;
+    std::shared_ptr<Queue> m_outbound;
+};
+
+struct LossConfig {
+    double dropRate = 0.0;               // 发送时丢弃的概率
+    double reorderRate = 0.0;            // 发送时暂扣（稍后乱序送出）的概率
+    size_t reorderDepth = 8;             // 最多暂扣的报文数
+    uint32_t seed = 1;
+};
+
+// 丢包/乱序注入装饰器：只作用于发送方向
+class LossyChannel : public DatagramChannel {
+public:
+    LossyChannel(DatagramChannel& inner, const LossConfig& config);
+
+    bool send(const void* data, size_t size) override;
+    // 接收前先放出暂扣的报文，使其晚于后续报文到达
+    int receive(void* buffer, size_t capacity, int timeoutMs) override;
+
+    uint64_t dropped() const { return m_dropped; }
+    uint64_t reordered() const { return m_reordered; }
+
+private:
+    void releaseHeld();
+
+    DatagramChannel& m_inner;
+    LossConfig m_config;
+    std::mt19937 m_rng;
+    std::uniform_real_distribution<double> m_uniform{0.0, 1.0};
+    std::deque<std::vector<uint8_t>> m_held;
+    uint64_t m_dropped = 0;
+    uint64_t m_reordered = 0;
+};
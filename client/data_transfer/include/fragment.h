@@ -0,0 +1,106 @@
+#pragma once
+
+// UDP数据通路的大消息分片与重组
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#pragma pack(push, 1)
+// 与capnpserver processMessage解析的32字节头一致（小端）
+struct DataHeader {
+    uint8_t operation;
+    uint64_t dstDevice;
+    uint32_t dataSize;                  // 本报文负载字节数
+    uint8_t reserved[19];
+};
+
+// 分片头，紧跟DataHeader之后（operation带kOpFragmented标志时存在）
+struct FragmentHeader {
+    uint64_t transferId;
+    uint64_t offset;                    // 负载在整个传输中的偏移
+    uint64_t totalLength;               // 整个传输的字节数
+    uint32_t crc;                       // 本分片负载的CRC32C
+    uint32_t fragmentSize;              // 标称分片负载大小（最后一片可更小）
+};
+#pragma pack(pop)
+
+static_assert(sizeof(DataHeader) == 32, "DataHeader must be 32 bytes");
+static_assert(sizeof(FragmentHeader) == 32, "FragmentHeader must be 32 bytes");
+
+constexpr uint8_t kOpFragmented = 0x80;
+constexpr size_t kFragmentOverhead = sizeof(DataHeader) + sizeof(FragmentHeader);
+// 接收端单个报文缓冲区为4096字节
+constexpr size_t kDefaultDatagramSize = 4096;
+
+// 分片发送：按datagramSize切分，每片带完整头部；sink返回false时中止
+using DatagramSink = std::function<bool(const void* data, size_t size)>;
+
+class FragmentSender {
+public:
+    explicit FragmentSender(size_t datagramSize = kDefaultDatagramSize);
+
+    bool send(const DatagramSink& sink, uint64_t transferId, uint8_t operation,
+              uint64_t dstDevice, const void* data, size_t size);
+
+    // 只发送第index个分片（用于选择性重传）
+    bool sendFragment(const DatagramSink& sink, uint64_t transferId, uint8_t operation,
+                      uint64_t dstDevice, const void* data, size_t size, uint64_t index);
+
+    size_t fragmentPayload() const { return m_fragmentPayload; }
+    uint64_t fragmentCount(size_t size) const {
+        return size == 0 ? 1 : (size + m_fragmentPayload - 1) / m_fragmentPayload;
+    }
+
+private:
+    size_t m_fragmentPayload;
+    std::vector<uint8_t> m_datagram;     // 复用的报文缓冲区
+};
+
+// 分片重组：乱序到达的分片直接写入目标缓冲区的对应偏移，
+// 按位图去重，收齐后回调。单线程使用（由接收线程独占）。
+class FragmentReassembler {
+public:
+    // 首个分片到达时解析目标缓冲区，返回nullptr表示丢弃该传输
+    using Resolver = std::function<uint8_t*(uint64_t transferId, uint64_t dstDevice, uint64_t totalLength)>;
+    using Completion = std::function<void(uint64_t transferId, uint8_t operation, uint64_t dstDevice, uint64_t totalLength)>;
+
+    FragmentReassembler(Resolver resolver, Completion completion);
+
+    enum class Result {
+        Accepted,
+        Completed,
+        Duplicate,
+        Invalid,          // 头部或长度错误
+        BadChecksum,
+        Dropped           // 解析器拒绝
+    };
+
+    Result onDatagram(const void* data, size_t size);
+
+    // 未完成传输的分片位图（第i位表示第i个分片已收到），不存在时返回nullptr
+    const std::vector<uint64_t>* progress(uint64_t transferId, uint64_t* fragmentCount = nullptr) const;
+
+    // 丢弃超过maxAge未收齐的传输，返回丢弃数量
+    size_t expire(std::chrono::steady_clock::duration maxAge);
+    size_t pendingTransfers() const { return m_transfers.size(); }
+
+private:
+    struct Transfer {
+        uint8_t* destination = nullptr;
+        uint64_t totalLength = 0;
+        uint32_t fragmentSize = 0;
+        uint64_t fragmentCount = 0;
+        uint64_t receivedBytes = 0;
+        std::vector<uint64_t> received;  // 分片位图
+        std::chrono::steady_clock::time_point lastSeen;
+    };
+
+    Resolver m_resolver;
+    Completion m_completion;
+    std::unordered_map<uint64_t, Transfer> m_transfers;
+};
+
+uint32_t FragmentChecksum(const void* data, size_t size);
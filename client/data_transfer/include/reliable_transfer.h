@@ -0,0 +1,106 @@
+#pragma once
+
+// 基于分片的选择重传可靠层：分片序号 = offset / fragmentSize，
+// 接收端以累计确认+位图（SACK）反馈，发送端只重传缺失的分片。
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "datagram_channel.h"
+#include "fragment.h"
+
+#pragma pack(push, 1)
+// 接收端反馈报文头，后跟bitmapWords个uint64位图，
+// 位图第0位对应分片 (cumulative / 64) * 64
+struct ControlHeader {
+    uint8_t operation;                  // kOpControl
+    uint8_t flags;                      // kControlComplete
+    uint16_t bitmapWords;
+    uint32_t reserved;
+    uint64_t transferId;
+    uint64_t cumulative;                // 该序号之前的分片全部收到
+    uint64_t highest;                   // 已收到的最大序号 + 1
+};
+#pragma pack(pop)
+
+static_assert(sizeof(ControlHeader) == 32, "ControlHeader must be 32 bytes");
+
+constexpr uint8_t kOpControl = 0x40;
+constexpr uint8_t kControlComplete = 0x01;
+
+struct ReliableConfig {
+    size_t datagramSize = kDefaultDatagramSize;
+    uint32_t window = 1024;                              // 最多未确认分片数
+    uint64_t pacingBytesPerSec = 0;                      // 发送速率上限，0表示不限速
+    std::chrono::milliseconds rto{20};                   // 无反馈时重传最早未确认分片
+    std::chrono::microseconds reorderHoldoff{500};       // 分片发出后该时间内不因NACK重传
+    uint32_t maxTimeouts = 50;                           // 连续超时次数上限
+    uint32_t ackEvery = 32;                              // 接收端每N个顺序分片确认一次
+};
+
+struct ReliableStats {
+    uint64_t fragmentsSent = 0;
+    uint64_t retransmissions = 0;
+    uint64_t feedbackReceived = 0;
+    uint64_t timeouts = 0;
+};
+
+class ReliableSender {
+public:
+    ReliableSender(DatagramChannel& channel, const ReliableConfig& config = ReliableConfig());
+
+    // 发送一次传输，所有分片被确认后返回true
+    bool send(uint64_t transferId, uint8_t operation, uint64_t dstDevice, const void* data, size_t size);
+
+    const ReliableStats& stats() const { return m_stats; }
+
+private:
+    struct Pacer {
+        double tokens = 0;
+        std::chrono::steady_clock::time_point last;
+    };
+
+    bool paceAllows(size_t bytes);
+    bool transmit(uint64_t index);
+
+    DatagramChannel& m_channel;
+    ReliableConfig m_config;
+    FragmentSender m_fragments;
+    ReliableStats m_stats;
+    Pacer m_pacer;
+
+    // 当前传输
+    uint64_t m_transferId = 0;
+    uint8_t m_operation = 0;
+    uint64_t m_dstDevice = 0;
+    const void* m_data = nullptr;
+    size_t m_size = 0;
+    std::vector<uint8_t> m_acked;
+    std::vector<std::chrono::steady_clock::time_point> m_sentAt;
+};
+
+class ReliableReceiver {
+public:
+    ReliableReceiver(DatagramChannel& channel, const ReliableConfig& config = ReliableConfig());
+
+    // 接收一次长度为size的传输到buffer
+    bool receive(void* buffer, size_t size, int timeoutMs, uint64_t* transferId = nullptr);
+
+private:
+    void sendFeedback(uint64_t transferId, bool complete, uint64_t fragments);
+    void rememberCompleted(uint64_t transferId, uint64_t fragments);
+
+    DatagramChannel& m_channel;
+    ReliableConfig m_config;
+    std::vector<uint8_t> m_datagram;
+
+    // 最近完成的传输，用于响应最终确认丢失后的重传
+    std::deque<std::pair<uint64_t, uint64_t>> m_completed;
+
+    // 当前传输的反馈状态
+    FragmentReassembler* m_reassembler = nullptr;
+    uint64_t m_cumulative = 0;
+    uint64_t m_highest = 0;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+// ZMQ上下文与套接字池（data_transfer与launcher共用）
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+class ZmqSocketPool;
+
+// 借出的套接字，析构时归还池中；出错时调用discard()丢弃
+class ZmqSocketLease {
+public:
+    ZmqSocketLease() = default;
+    ZmqSocketLease(ZmqSocketPool* pool, void* socket, const std::string& endpoint, int type, bool bound);
+    ZmqSocketLease(ZmqSocketLease&& other) noexcept;
+    ZmqSocketLease& operator=(ZmqSocketLease&& other) noexcept;
+    ZmqSocketLease(const ZmqSocketLease&) = delete;
+    ZmqSocketLease& operator=(const ZmqSocketLease&) = delete;
+    ~ZmqSocketLease();
+
+    void* socket() const { return m_socket; }
+    explicit operator bool() const { return m_socket != nullptr; }
+
+    // 套接字状态不可信（发送/接收失败），归还时直接关闭
+    void discard() { m_healthy = false; }
+
+private:
+    void release();
+
+    ZmqSocketPool* m_pool = nullptr;
+    void* m_socket = nullptr;
+    std::string m_endpoint;
+    int m_type = 0;
+    bool m_bound = false;
+    bool m_healthy = true;
+};
+
+struct ZmqSocketPoolConfig {
+    std::chrono::milliseconds idleTimeout{30000};   // 空闲超过该时间的套接字被关闭
+    size_t maxIdlePerEndpoint = 4;                  // 每个端点最多缓存的空闲套接字
+    int lingerMs = 100;                             // 关闭时等待未发送消息的时间
+};
+
+// 进程内长期存在的ZMQ上下文，按(类型, connect/bind, 端点)缓存套接字。
+// ZMQ套接字不是线程安全的，借出期间由借用者独占。
+class ZmqSocketPool {
+public:
+    explicit ZmqSocketPool(const ZmqSocketPoolConfig& config = ZmqSocketPoolConfig());
+    ~ZmqSocketPool();
+
+    // 进程级共享实例
+    static ZmqSocketPool& Instance();
+
+    void* context() const { return m_context; }
+
+    // 借出已connect（bind=false）或已bind（bind=true）到endpoint的套接字
+    ZmqSocketLease acquire(const std::string& endpoint, int type, bool bind = false);
+
+    // 关闭空闲超时的套接字（acquire/归还时也会按需触发）
+    void reapIdle();
+    void clear();
+
+    size_t idleCount() const;
+
+private:
+    friend class ZmqSocketLease;
+
+    using Key = std::tuple<int, bool, std::string>;
+    struct IdleSocket {
+        void* socket;
+        std::chrono::steady_clock::time_point since;
+    };
+
+    void giveBack(void* socket, const std::string& endpoint, int type, bool bound, bool healthy);
+    void* open(const std::string& endpoint, int type, bool bind);
+    void reapLocked(std::chrono::steady_clock::time_point now, std::vector<void*>& expired);
+
+    ZmqSocketPoolConfig m_config;
+    void* m_context = nullptr;
+
+    mutable std::mutex m_mutex;
+    std::map<Key, std::vector<IdleSocket>> m_idle;  // 尾部为最近归还
+    std::chrono::steady_clock::time_point m_lastReap;
+};
@@ -0,0 +1,304 @@
+#include "crc32c.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CRC32C_X86 1
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define CRC32C_ARM 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <arm_acle.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#define CRC32C_TARGET(x)
+#else
+#define CRC32C_TARGET(x) __attribute__((target(x)))
+#endif
+
+namespace {
+
+constexpr uint32_t kPolynomial = 0x82F63B78;   // 反射多项式
+
+// slicing-by-8查表
+struct Crc32cTables {
+    uint32_t table[8][256];
+
+    Crc32cTables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (kPolynomial & (0u - (crc & 1)));
+            }
+            table[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int slice = 1; slice < 8; ++slice) {
+                table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+const Crc32cTables& Tables() {
+    static const Crc32cTables tables;
+    return tables;
+}
+
+uint32_t ScalarUpdate(uint32_t crc, const uint8_t* p, size_t size) {
+    const auto& t = Tables().table;
+    while (size >= 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        word ^= crc;
+        crc = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF] ^
+              t[5][(word >> 16) & 0xFF] ^ t[4][(word >> 24) & 0xFF] ^
+              t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF] ^
+              t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+        p += 8;
+        size -= 8;
+    }
+    while (size--) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+// 硬件实现三路交错计算以掩盖crc32指令延迟，
+// 各路结果通过"追加N个零字节"算子（GF(2)矩阵，预先展开为查表）合并
+constexpr size_t kLongBlock = 8192;
+constexpr size_t kShortBlock = 256;
+
+uint32_t Gf2MatrixTimes(const uint32_t* mat, uint32_t vec) {
+    uint32_t sum = 0;
+    while (vec) {
+        if (vec & 1) sum ^= *mat;
+        vec >>= 1;
+        ++mat;
+    }
+    return sum;
+}
+
+void Gf2MatrixSquare(uint32_t* square, const uint32_t* mat) {
+    for (int n = 0; n < 32; ++n) {
+        square[n] = Gf2MatrixTimes(mat, mat[n]);
+    }
+}
+
+// 构造对CRC寄存器追加len个零字节的算子
+void ZerosOperator(uint32_t* even, size_t len) {
+    uint32_t odd[32];
+    odd[0] = kPolynomial;               // 单个零比特
+    uint32_t row = 1;
+    for (int n = 1; n < 32; ++n) {
+        odd[n] = row;
+        row <<= 1;
+    }
+    Gf2MatrixSquare(even, odd);         // 2个零比特
+    Gf2MatrixSquare(odd, even);         // 4个零比特
+    // 每次平方使零比特数翻倍，从一个字节开始
+    do {
+        Gf2MatrixSquare(even, odd);
+        len >>= 1;
+        if (len == 0) return;
+        Gf2MatrixSquare(odd, even);
+        len >>= 1;
+    } while (len);
+    memcpy(even, odd, sizeof(odd));
+}
+
+struct ShiftTable {
+    uint32_t table[4][256];
+
+    explicit ShiftTable(size_t len) {
+        uint32_t op[32];
+        ZerosOperator(op, len);
+        for (uint32_t n = 0; n < 256; ++n) {
+            table[0][n] = Gf2MatrixTimes(op, n);
+            table[1][n] = Gf2MatrixTimes(op, n << 8);
+            table[2][n] = Gf2MatrixTimes(op, n << 16);
+            table[3][n] = Gf2MatrixTimes(op, n << 24);
+        }
+    }
+
+    uint32_t shift(uint32_t crc) const {
+        return table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF] ^
+               table[2][(crc >> 16) & 0xFF] ^ table[3][crc >> 24];
+    }
+};
+
+const ShiftTable& LongShift() {
+    static const ShiftTable table(kLongBlock);
+    return table;
+}
+
+const ShiftTable& ShortShift() {
+    static const ShiftTable table(kShortBlock);
+    return table;
+}
+
+#if defined(CRC32C_X86)
+#define CRC32C_HW_TARGET CRC32C_TARGET("sse4.2")
+#if defined(_M_X64) || defined(__x86_64__)
+CRC32C_HW_TARGET
+inline uint64_t Crc64Step(uint64_t crc, uint64_t word) { return _mm_crc32_u64(crc, word); }
+#define CRC32C_HAS_U64 1
+#endif
+#elif defined(CRC32C_ARM)
+#define CRC32C_HW_TARGET CRC32C_TARGET("+crc")
+CRC32C_HW_TARGET
+inline uint64_t Crc64Step(uint64_t crc, uint64_t word) { return __crc32cd(static_cast<uint32_t>(crc), word); }
+#define CRC32C_HAS_U64 1
+#endif
+
+#if defined(CRC32C_HAS_U64)
+// 以block为单位三路并行，返回处理后的寄存器值
+template <size_t Block>
+CRC32C_HW_TARGET
+uint64_t Interleaved(uint64_t crc0, const uint8_t*& p, size_t& size, const ShiftTable& shift) {
+    while (size >= Block * 3) {
+        uint64_t crc1 = 0;
+        uint64_t crc2 = 0;
+        const uint8_t* end = p + Block;
+        do {
+            uint64_t w0, w1, w2;
+            memcpy(&w0, p, 8);
+            memcpy(&w1, p + Block, 8);
+            memcpy(&w2, p + 2 * Block, 8);
+            crc0 = Crc64Step(crc0, w0);
+            crc1 = Crc64Step(crc1, w1);
+            crc2 = Crc64Step(crc2, w2);
+            p += 8;
+        } while (p < end);
+        crc0 = shift.shift(static_cast<uint32_t>(crc0)) ^ crc1;
+        crc0 = shift.shift(static_cast<uint32_t>(crc0)) ^ crc2;
+        p += Block * 2;
+        size -= Block * 3;
+    }
+    return crc0;
+}
+#endif
+
+#if defined(CRC32C_X86)
+CRC32C_HW_TARGET
+uint32_t HardwareUpdate(uint32_t crc, const uint8_t* p, size_t size) {
+#if defined(CRC32C_HAS_U64)
+    uint64_t crc64 = crc;
+    crc64 = Interleaved<kLongBlock>(crc64, p, size, LongShift());
+    crc64 = Interleaved<kShortBlock>(crc64, p, size, ShortShift());
+    while (size >= 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        p += 8;
+        size -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    while (size >= 4) {
+        uint32_t word;
+        memcpy(&word, p, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+        p += 4;
+        size -= 4;
+    }
+    while (size--) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+
+bool HardwareAvailable() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSE4_2);
+#endif
+}
+
+const char* kHardwareName = "sse4.2";
+#elif defined(CRC32C_ARM)
+CRC32C_HW_TARGET
+uint32_t HardwareUpdate(uint32_t crc, const uint8_t* p, size_t size) {
+    crc = static_cast<uint32_t>(Interleaved<kLongBlock>(crc, p, size, LongShift()));
+    crc = static_cast<uint32_t>(Interleaved<kShortBlock>(crc, p, size, ShortShift()));
+    while (size >= 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        crc = __crc32cd(crc, word);
+        p += 8;
+        size -= 8;
+    }
+    while (size--) {
+        crc = __crc32cb(crc, *p++);
+    }
+    return crc;
+}
+
+bool HardwareAvailable() {
+#if defined(_MSC_VER)
+    return true;                        // Windows on ARM64要求CRC扩展
+#elif defined(__linux__) && defined(HWCAP_CRC32)
+    return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#elif defined(__ARM_FEATURE_CRC32)
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* kHardwareName = "armv8";
+#endif
+
+using UpdateFn = uint32_t (*)(uint32_t, const uint8_t*, size_t);
+
+struct Dispatch {
+    UpdateFn update = ScalarUpdate;
+    const char* name = "scalar";
+
+    Dispatch() {
+#if defined(CRC32C_X86) || defined(CRC32C_ARM)
+        if (HardwareAvailable()) {
+            // 合并用的查表在选择硬件实现时一并构造
+            LongShift();
+            ShortShift();
+            update = HardwareUpdate;
+            name = kHardwareName;
+        }
+#endif
+    }
+};
+
+const Dispatch& Selected() {
+    static const Dispatch dispatch;
+    return dispatch;
+}
+
+} // namespace
+
+uint32_t Crc32c(const void* data, size_t size, uint32_t crc) {
+    return ~Selected().update(~crc, static_cast<const uint8_t*>(data), size);
+}
+
+uint32_t Crc32cScalar(const void* data, size_t size, uint32_t crc) {
+    return ~ScalarUpdate(~crc, static_cast<const uint8_t*>(data), size);
+}
+
+const char* Crc32cImplementation() {
+    return Selected().name;
+}
@@ -0,0 +1,115 @@
+#include "datagram_channel.h"
+#include <zmq.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+// ---------------- ZmqDatagramChannel ----------------
+
+ZmqDatagramChannel::ZmqDatagramChannel(ZmqSocketLease&& socket, const std::string& peer)
+    : m_socket(std::move(socket)), m_peer(peer) {}
+
+bool ZmqDatagramChannel::send(const void* data, size_t size) {
+    if (!m_socket || m_peer.empty()) return false;
+    if (zmq_send(m_socket.socket(), m_peer.data(), m_peer.size(), ZMQ_SNDMORE) == -1 ||
+        zmq_send(m_socket.socket(), data, size, 0) == -1) {
+        return false;
+    }
+    return true;
+}
+
+int ZmqDatagramChannel::receive(void* buffer, size_t capacity, int timeoutMs) {
+    if (!m_socket) return -1;
+    if (timeoutMs != m_timeoutMs) {
+        zmq_setsockopt(m_socket.socket(), ZMQ_RCVTIMEO, &timeoutMs, sizeof(timeoutMs));
+        m_timeoutMs = timeoutMs;
+    }
+
+    char address[256];
+    int addressSize = zmq_recv(m_socket.socket(), address, sizeof(address), 0);
+    if (addressSize == -1) {
+        return zmq_errno() == EAGAIN ? 0 : -1;
+    }
+    int received = zmq_recv(m_socket.socket(), buffer, capacity, 0);
+    if (received == -1) {
+        return -1;
+    }
+
+    std::string from(address, std::min<size_t>(addressSize, sizeof(address)));
+    if (m_peer.empty()) {
+        m_peer = from;
+    } else if (from != m_peer) {
+        return 0;                        // 非对端报文忽略
+    }
+    // 截断的报文视为无效
+    return static_cast<size_t>(received) > capacity ? 0 : received;
+}
+
+// ---------------- LoopbackChannel ----------------
+
+std::pair<std::unique_ptr<LoopbackChannel>, std::unique_ptr<LoopbackChannel>> LoopbackChannel::createPair() {
+    auto a = std::make_shared<Queue>();
+    auto b = std::make_shared<Queue>();
+    return {std::unique_ptr<LoopbackChannel>(new LoopbackChannel(a, b)),
+            std::unique_ptr<LoopbackChannel>(new LoopbackChannel(b, a))};
+}
+
+LoopbackChannel::LoopbackChannel(std::shared_ptr<Queue> inbound, std::shared_ptr<Queue> outbound)
+    : m_inbound(std::move(inbound)), m_outbound(std::move(outbound)) {}
+
+bool LoopbackChannel::send(const void* data, size_t size) {
+    auto* bytes = static_cast<const uint8_t*>(data);
+    {
+        std::lock_guard<std::mutex> lock(m_outbound->mutex);
+        m_outbound->packets.emplace_back(bytes, bytes + size);
+    }
+    m_outbound->cv.notify_one();
+    return true;
+}
+
+int LoopbackChannel::receive(void* buffer, size_t capacity, int timeoutMs) {
+    std::unique_lock<std::mutex> lock(m_inbound->mutex);
+    auto ready = [this] { return !m_inbound->packets.empty(); };
+    if (timeoutMs < 0) {
+        m_inbound->cv.wait(lock, ready);
+    } else if (!m_inbound->cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), ready)) {
+        return 0;
+    }
+
+    std::vector<uint8_t> packet = std::move(m_inbound->packets.front());
+    m_inbound->packets.pop_front();
+    if (packet.size() > capacity) return 0;
+    memcpy(buffer, packet.data(), packet.size());
+    return static_cast<int>(packet.size());
+}
+
+// ---------------- LossyChannel ----------------
+
+LossyChannel::LossyChannel(DatagramChannel& inner, const LossConfig& config)
+    : m_inner(inner), m_config(config), m_rng(config.seed) {}
+
+bool LossyChannel::send(const void* data, size_t size) {
+    if (m_uniform(m_rng) < m_config.dropRate) {
+        ++m_dropped;
+        return true;                     // 对发送方而言丢包不可见
+    }
+    if (m_held.size() < m_config.reorderDepth && m_uniform(m_rng) < m_config.reorderRate) {
+        auto* bytes = static_cast<const uint8_t*>(data);
+        m_held.emplace_back(bytes, bytes + size);
+        ++m_reordered;
+        return true;
+    }
+    return m_inner.send(data, size);
+}
+
+void LossyChannel::releaseHeld() {
+    while (!m_held.empty()) {
+        m_inner.send(m_held.front().data(), m_held.front().size());
+        m_held.pop_front();
+    }
+}
+
+int LossyChannel::receive(void* buffer, size_t capacity, int timeoutMs) {
+    releaseHeld();
+    return m_inner.receive(buffer, capacity, timeoutMs);
+}
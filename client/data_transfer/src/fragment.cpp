@@ -0,0 +1,156 @@
+#include "fragment.h"
+#include "crc32c.h"
+#include <algorithm>
+#include <cstring>
+
+uint32_t FragmentChecksum(const void* data, size_t size) {
+    return Crc32c(data, size);
+}
+
+// ---------------- FragmentSender ----------------
+
+FragmentSender::FragmentSender(size_t datagramSize)
+    : m_fragmentPayload(std::max(datagramSize, kFragmentOverhead + 1) - kFragmentOverhead),
+      m_datagram(m_fragmentPayload + kFragmentOverhead) {}
+
+bool FragmentSender::send(const DatagramSink& sink, uint64_t transferId, uint8_t operation,
+                          uint64_t dstDevice, const void* data, size_t size) {
+    uint64_t count = fragmentCount(size);
+    for (uint64_t index = 0; index < count; ++index) {
+        if (!sendFragment(sink, transferId, operation, dstDevice, data, size, index)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FragmentSender::sendFragment(const DatagramSink& sink, uint64_t transferId, uint8_t operation,
+                                  uint64_t dstDevice, const void* data, size_t size, uint64_t index) {
+    auto* source = static_cast<const uint8_t*>(data);
+    uint64_t offset = index * m_fragmentPayload;
+    if (offset > size || (offset == size && size != 0)) {
+        return false;
+    }
+    size_t length = static_cast<size_t>(std::min<uint64_t>(m_fragmentPayload, size - offset));
+
+    DataHeader header = {};
+    header.operation = operation | kOpFragmented;
+    header.dstDevice = dstDevice;
+    header.dataSize = static_cast<uint32_t>(length);
+
+    FragmentHeader fragment = {};
+    fragment.transferId = transferId;
+    fragment.offset = offset;
+    fragment.totalLength = size;
+    fragment.crc = FragmentChecksum(source + offset, length);
+    fragment.fragmentSize = static_cast<uint32_t>(m_fragmentPayload);
+
+    memcpy(m_datagram.data(), &header, sizeof(header));
+    memcpy(m_datagram.data() + sizeof(header), &fragment, sizeof(fragment));
+    if (length > 0) {
+        memcpy(m_datagram.data() + kFragmentOverhead, source + offset, length);
+    }
+    return sink(m_datagram.data(), kFragmentOverhead + length);
+}
+
+// ---------------- FragmentReassembler ----------------
+
+FragmentReassembler::FragmentReassembler(Resolver resolver, Completion completion)
+    : m_resolver(std::move(resolver)), m_completion(std::move(completion)) {}
+
+FragmentReassembler::Result FragmentReassembler::onDatagram(const void* data, size_t size) {
+    if (size < kFragmentOverhead) {
+        return Result::Invalid;
+    }
+
+    DataHeader header;
+    FragmentHeader fragment;
+    auto* bytes = static_cast<const uint8_t*>(data);
+    memcpy(&header, bytes, sizeof(header));
+    memcpy(&fragment, bytes + sizeof(header), sizeof(fragment));
+    const uint8_t* payload = bytes + kFragmentOverhead;
+
+    if (!(header.operation & kOpFragmented) ||
+        size < kFragmentOverhead + header.dataSize ||
+        fragment.fragmentSize == 0 ||
+        fragment.offset % fragment.fragmentSize != 0 ||
+        fragment.offset + header.dataSize > fragment.totalLength) {
+        return Result::Invalid;
+    }
+    // 非末尾分片必须恰好为fragmentSize字节，末尾分片为剩余字节；否则分片号与位图对不上，
+    // 短分片会被记为已收到而留下空洞，offset == totalLength的空分片会越过位图末尾
+    uint64_t index = fragment.offset / fragment.fragmentSize;
+    uint64_t fragments = std::max<uint64_t>((fragment.totalLength + fragment.fragmentSize - 1) / fragment.fragmentSize, 1);
+    if (index >= fragments ||
+        header.dataSize != std::min<uint64_t>(fragment.fragmentSize, fragment.totalLength - fragment.offset)) {
+        return Result::Invalid;
+    }
+    if (FragmentChecksum(payload, header.dataSize) != fragment.crc) {
+        return Result::BadChecksum;
+    }
+
+    auto it = m_transfers.find(fragment.transferId);
+    if (it == m_transfers.end()) {
+        uint8_t* destination = m_resolver(fragment.transferId, header.dstDevice, fragment.totalLength);
+        if (!destination && fragment.totalLength > 0) {
+            return Result::Dropped;
+        }
+        Transfer transfer;
+        transfer.destination = destination;
+        transfer.totalLength = fragment.totalLength;
+        transfer.fragmentSize = fragment.fragmentSize;
+        transfer.fragmentCount = fragments;
+        transfer.received.assign((fragments + 63) / 64, 0);
+        it = m_transfers.emplace(fragment.transferId, std::move(transfer)).first;
+    }
+
+    Transfer& transfer = it->second;
+    if (fragment.totalLength != transfer.totalLength || fragment.fragmentSize != transfer.fragmentSize) {
+        return Result::Invalid;
+    }
+    transfer.lastSeen = std::chrono::steady_clock::now();
+
+    uint64_t mask = uint64_t(1) << (index % 64);
+    if (transfer.received[index / 64] & mask) {
+        return Result::Duplicate;
+    }
+    transfer.received[index / 64] |= mask;
+
+    // 乱序分片直接放置到目标偏移
+    if (header.dataSize > 0) {
+        memcpy(transfer.destination + fragment.offset, payload, header.dataSize);
+    }
+    transfer.receivedBytes += header.dataSize;
+
+    if (transfer.receivedBytes < transfer.totalLength) {
+        return Result::Accepted;
+    }
+
+    uint64_t totalLength = transfer.totalLength;
+    m_transfers.erase(it);
+    if (m_completion) {
+        m_completion(fragment.transferId, header.operation & ~kOpFragmented, header.dstDevice, totalLength);
+    }
+    return Result::Completed;
+}
+
+const std::vector<uint64_t>* FragmentReassembler::progress(uint64_t transferId, uint64_t* fragmentCount) const {
+    auto it = m_transfers.find(transferId);
+    if (it == m_transfers.end()) return nullptr;
+    if (fragmentCount) *fragmentCount = it->second.fragmentCount;
+    return &it->second.received;
+}
+
+size_t FragmentReassembler::expire(std::chrono::steady_clock::duration maxAge) {
+    auto now = std::chrono::steady_clock::now();
+    size_t dropped = 0;
+    for (auto it = m_transfers.begin(); it != m_transfers.end();) {
+        if (now - it->second.lastSeen > maxAge) {
+            it = m_transfers.erase(it);
+            ++dropped;
+        } else {
+            ++it;
+        }
+    }
+    return dropped;
+}
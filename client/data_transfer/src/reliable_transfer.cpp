@@ -0,0 +1,269 @@
+#include "reliable_transfer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr size_t kCompletedHistory = 16;
+constexpr double kPacerBurstDatagrams = 64;
+}
+
+// ---------------- ReliableSender ----------------
+
+ReliableSender::ReliableSender(DatagramChannel& channel, const ReliableConfig& config)
+    : m_channel(channel), m_config(config), m_fragments(config.datagramSize) {
+    m_pacer.last = std::chrono::steady_clock::now();
+}
+
+// 令牌桶限速，突发上限为若干个报文
+bool ReliableSender::paceAllows(size_t bytes) {
+    if (m_config.pacingBytesPerSec == 0) return true;
+
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - m_pacer.last).count();
+    m_pacer.last = now;
+    double burst = kPacerBurstDatagrams * m_config.datagramSize;
+    m_pacer.tokens = std::min(burst, m_pacer.tokens + elapsed * m_config.pacingBytesPerSec);
+    if (m_pacer.tokens < bytes) return false;
+    m_pacer.tokens -= bytes;
+    return true;
+}
+
+bool ReliableSender::transmit(uint64_t index) {
+    bool ok = m_fragments.sendFragment([this](const void* data, size_t size) {
+        return m_channel.send(data, size);
+    }, m_transferId, m_operation, m_dstDevice, m_data, m_size, index);
+    m_sentAt[index] = std::chrono::steady_clock::now();
+    m_stats.fragmentsSent++;
+    return ok;
+}
+
+bool ReliableSender::send(uint64_t transferId, uint8_t operation, uint64_t dstDevice,
+                          const void* data, size_t size) {
+    m_transferId = transferId;
+    m_operation = operation;
+    m_dstDevice = dstDevice;
+    m_data = data;
+    m_size = size;
+
+    const uint64_t count = m_fragments.fragmentCount(size);
+    const size_t fragmentBytes = kFragmentOverhead + m_fragments.fragmentPayload();
+    m_acked.assign(count, 0);
+    m_sentAt.assign(count, std::chrono::steady_clock::time_point());
+
+    uint64_t base = 0;                   // 最早未确认分片
+    uint64_t next = 0;                   // 下一个首次发送的分片
+    uint32_t timeouts = 0;
+    auto lastProgress = std::chrono::steady_clock::now();
+    std::vector<uint8_t> feedback(m_config.datagramSize);
+
+    while (base < count) {
+        // 窗口内发送新分片
+        while (next < count && next < base + m_config.window && paceAllows(fragmentBytes)) {
+            if (!transmit(next)) return false;
+            ++next;
+        }
+
+        // 窗口已满或被限速时短暂等待反馈，否则只取已到达的反馈
+        bool blocked = next >= count || next >= base + m_config.window;
+        int received = m_channel.receive(feedback.data(), feedback.size(), blocked ? 1 : 0);
+        if (received < 0) return false;
+        auto now = std::chrono::steady_clock::now();
+
+        ControlHeader control;
+        if (received >= static_cast<int>(sizeof(ControlHeader))) {
+            memcpy(&control, feedback.data(), sizeof(control));
+        }
+        if (received < static_cast<int>(sizeof(ControlHeader)) ||
+            control.operation != kOpControl || control.transferId != m_transferId ||
+            received < static_cast<int>(sizeof(ControlHeader) + control.bitmapWords * sizeof(uint64_t))) {
+            // 长时间无进展：重传最早未确认分片，促使接收端反馈
+            if (now - lastProgress > m_config.rto) {
+                m_stats.timeouts++;
+                if (++timeouts > m_config.maxTimeouts) return false;
+                if (base < next) {
+                    if (!transmit(base)) return false;
+                    m_stats.retransmissions++;
+                }
+                lastProgress = now;
+            }
+            continue;
+        }
+
+        m_stats.feedbackReceived++;
+        if (control.flags & kControlComplete) {
+            break;
+        }
+
+        // 累计确认与位图
+        uint64_t cumulative = std::min(control.cumulative, count);
+        for (uint64_t i = base; i < cumulative; ++i) {
+            m_acked[i] = 1;
+        }
+        uint64_t wordBase = (control.cumulative / 64) * 64;
+        const uint8_t* bitmap = feedback.data() + sizeof(ControlHeader);
+        for (uint16_t w = 0; w < control.bitmapWords; ++w) {
+            uint64_t word;
+            memcpy(&word, bitmap + w * sizeof(uint64_t), sizeof(word));
+            for (uint32_t bit = 0; word != 0; ++bit, word >>= 1) {
+                uint64_t index = wordBase + w * 64 + bit;
+                if ((word & 1) && index < count) m_acked[index] = 1;
+            }
+        }
+
+        uint64_t previousBase = base;
+        while (base < count && m_acked[base]) ++base;
+        if (base != previousBase) {
+            timeouts = 0;
+            lastProgress = now;
+        }
+
+        // NACK：highest之前未确认的分片视为丢失，已过乱序容忍时间的选择性重传
+        uint64_t limit = std::min(control.highest, next);
+        for (uint64_t i = base; i < limit; ++i) {
+            if (m_acked[i] || now - m_sentAt[i] < m_config.reorderHoldoff) continue;
+            if (!paceAllows(fragmentBytes)) break;
+            if (!transmit(i)) return false;
+            m_stats.retransmissions++;
+        }
+    }
+    return true;
+}
+
+// ---------------- ReliableReceiver ----------------
+
+ReliableReceiver::ReliableReceiver(DatagramChannel& channel, const ReliableConfig& config)
+    : m_channel(channel), m_config(config), m_datagram(config.datagramSize) {}
+
+void ReliableReceiver::rememberCompleted(uint64_t transferId, uint64_t fragments) {
+    m_completed.emplace_back(transferId, fragments);
+    if (m_completed.size() > kCompletedHistory) {
+        m_completed.pop_front();
+    }
+}
+
+void ReliableReceiver::sendFeedback(uint64_t transferId, bool complete, uint64_t fragments) {
+    ControlHeader control = {};
+    control.operation = kOpControl;
+    control.transferId = transferId;
+
+    if (complete) {
+        control.flags = kControlComplete;
+        control.cumulative = fragments;
+        control.highest = fragments;
+        m_channel.send(&control, sizeof(control));
+        return;
+    }
+
+    control.cumulative = m_cumulative;
+    control.highest = m_highest;
+    const std::vector<uint64_t>* bitmap = m_reassembler ? m_reassembler->progress(transferId) : nullptr;
+    size_t words = 0;
+    if (bitmap) {
+        size_t firstWord = m_cumulative / 64;
+        size_t lastWord = std::min<size_t>((m_highest + 63) / 64, bitmap->size());
+        size_t maxWords = (m_datagram.size() - sizeof(ControlHeader)) / sizeof(uint64_t);
+        words = lastWord > firstWord ? std::min(lastWord - firstWord, maxWords) : 0;
+        control.bitmapWords = static_cast<uint16_t>(words);
+        memcpy(m_datagram.data() + sizeof(ControlHeader), bitmap->data() + firstWord, words * sizeof(uint64_t));
+    }
+    memcpy(m_datagram.data(), &control, sizeof(control));
+    m_channel.send(m_datagram.data(), sizeof(control) + words * sizeof(uint64_t));
+}
+
+bool ReliableReceiver::receive(void* buffer, size_t size, int timeoutMs, uint64_t* transferId) {
+    bool claimed = false;
+    bool completed = false;
+    uint64_t current = 0;
+    uint64_t currentFragments = 0;
+
+    FragmentReassembler reassembler(
+        [&](uint64_t id, uint64_t, uint64_t totalLength) -> uint8_t* {
+            if (claimed || totalLength != size) return nullptr;
+            claimed = true;
+            current = id;
+            return static_cast<uint8_t*>(buffer);
+        },
+        [&](uint64_t, uint8_t, uint64_t, uint64_t) { completed = true; });
+    m_reassembler = &reassembler;
+    m_cumulative = 0;
+    m_highest = 0;
+
+    const int idleMs = std::max<int>(1, static_cast<int>(m_config.rto.count() / 2));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    auto lastFeedback = std::chrono::steady_clock::time_point();
+    uint32_t sinceAck = 0;
+    std::vector<uint8_t> packet(m_config.datagramSize);
+
+    while (!completed) {
+        auto now = std::chrono::steady_clock::now();
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+        if (remaining <= 0) break;
+
+        int received = m_channel.receive(packet.data(), packet.size(),
+                                         static_cast<int>(std::min<long long>(remaining, idleMs)));
+        if (received < 0) break;
+        if (received == 0) {
+            // 空闲：重发当前状态，尾部分片丢失时由发送端据此重传
+            if (claimed) {
+                sendFeedback(current, false, 0);
+                lastFeedback = std::chrono::steady_clock::now();
+            }
+            continue;
+        }
+        if (static_cast<size_t>(received) < kFragmentOverhead) continue;
+
+        DataHeader header;
+        FragmentHeader fragment;
+        memcpy(&header, packet.data(), sizeof(header));
+        memcpy(&fragment, packet.data() + sizeof(header), sizeof(fragment));
+        if (!(header.operation & kOpFragmented) || fragment.fragmentSize == 0) continue;
+
+        // 已完成传输的重传说明最终确认丢失，重新确认
+        auto done = std::find_if(m_completed.begin(), m_completed.end(),
+                                 [&](const std::pair<uint64_t, uint64_t>& entry) {
+                                     return entry.first == fragment.transferId;
+                                 });
+        if (done != m_completed.end()) {
+            sendFeedback(done->first, true, done->second);
+            continue;
+        }
+
+        auto result = reassembler.onDatagram(packet.data(), received);
+        if (result != FragmentReassembler::Result::Accepted &&
+            result != FragmentReassembler::Result::Completed) {
+            continue;
+        }
+        currentFragments = std::max<uint64_t>(
+            (fragment.totalLength + fragment.fragmentSize - 1) / fragment.fragmentSize, 1);
+        if (completed) break;
+
+        uint64_t fragments = 0;
+        const std::vector<uint64_t>* bitmap = reassembler.progress(current, &fragments);
+        uint64_t index = fragment.offset / fragment.fragmentSize;
+        m_highest = std::max(m_highest, index + 1);
+        while (bitmap && m_cumulative < fragments &&
+               ((*bitmap)[m_cumulative / 64] >> (m_cumulative % 64) & 1)) {
+            ++m_cumulative;
+        }
+
+        // 出现空洞时尽快反馈（按乱序容忍时间限频），顺序到达时每ackEvery个确认一次
+        now = std::chrono::steady_clock::now();
+        bool gap = m_cumulative < m_highest;
+        if (++sinceAck >= m_config.ackEvery || (gap && now - lastFeedback > m_config.reorderHoldoff)) {
+            sendFeedback(current, false, 0);
+            lastFeedback = now;
+            sinceAck = 0;
+        }
+    }
+
+    m_reassembler = nullptr;
+    if (!completed) return false;
+
+    // 最终确认多发几次，降低其丢失导致发送端超时的概率
+    for (int i = 0; i < 3; ++i) {
+        sendFeedback(current, true, currentFragments);
+    }
+    rememberCompleted(current, currentFragments);
+    if (transferId) *transferId = current;
+    return true;
+}
@@ -1,103 +1,134 @@
-#include "data_transfer.h"
-#include <zmq.h>
-#include <string>
-#include <stdexcept>
-
-// ZMQ 零拷贝回调函数
-static void zmq_free_fn(void* /*data*/, void* /*hint*/) {}
-
-DATATRANSFER_API bool SendData(const char* ip, unsigned short port, const void* buffer, size_t size) {
-    // 创建 ZMQ 上下文
-    void* context = zmq_ctx_new();
-    if (!context) return false;
-    
-    // 创建 ZMQ 套接字
-    void* socket = zmq_socket(context, ZMQ_DGRAM);
-    if (!socket) {
-        zmq_ctx_destroy(context);
-        return false;
-    }
-    
-    // 构建目标端点
-    std::string endpoint = "udp://" + std::string(ip) + ":" + std::to_string(port);
-    
-    // 连接到目标端点
-    if (zmq_connect(socket, endpoint.c_str()) != 0) {
-        zmq_close(socket);
-        zmq_ctx_destroy(context);
-        return false;
-    }
-    
-    // 初始化消息（零拷贝）
-    zmq_msg_t msg;
-    if (zmq_msg_init_data(&msg, const_cast<void*>(buffer), size, zmq_free_fn, nullptr) != 0) {
-        zmq_close(socket);
-        zmq_ctx_destroy(context);
-        return false;
-    }
-    
-    // 发送消息
-    int sent = zmq_msg_send(&msg, socket, 0);
-    zmq_msg_close(&msg);
-    zmq_close(socket);
-    zmq_ctx_destroy(context);
-    
-    return sent != -1;
-}
-
-DATATRANSFER_API bool ReceiveData(const char* ip, unsigned short port, void* buffer, size_t size) {
-    // 创建 ZMQ 上下文
-    void* context = zmq_ctx_new();
-    if (!context) return false;
-    
-    // 创建 ZMQ 套接字
-    void* socket = zmq_socket(context, ZMQ_DGRAM);
-    if (!socket) {
-        zmq_ctx_destroy(context);
-        return false;
-    }
-    
-    // 构建监听端点
-    std::string endpoint = "udp://" + std::string(ip) + ":" + std::to_string(port);
-    
-    // 绑定到监听端点
-    if (zmq_bind(socket, endpoint.c_str()) != 0) {
-        zmq_close(socket);
-        zmq_ctx_destroy(context);
-        return false;
-    }
-    
-    // 初始化消息
-    zmq_msg_t msg;
-    if (zmq_msg_init(&msg) != 0) {
-        zmq_close(socket);
-        zmq_ctx_destroy(context);
-        return false;
-    }
-    
-    // 接收消息
-    int received = zmq_msg_recv(&msg, socket, 0);
-    if (received == -1) {
-        zmq_msg_close(&msg);
-        zmq_close(socket);
-        zmq_ctx_destroy(context);
-        return false;
-    }
-    
-    // 检查消息大小
-    size_t msg_size = zmq_msg_size(&msg);
-    if (msg_size != size) {
-        zmq_msg_close(&msg);
-        zmq_close(socket);
-        zmq_ctx_destroy(context);
-        return false;
-    }
-    
-    // 复制数据到缓冲区
-    memcpy(buffer, zmq_msg_data(&msg), size);
-    zmq_msg_close(&msg);
-    zmq_close(socket);
-    zmq_ctx_destroy(context);
-    
-    return true;
-}
+#include "data_transfer.h"
+#include "zmq_socket_pool.h"
+#include "fragment.h"
+#include <zmq.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+// 构建UDP端点
+static std::string make_endpoint(const char* ip, unsigned short port) {
+    return "udp://" + std::string(ip) + ":" + std::to_string(port);
+}
+
+DATATRANSFER_API bool SendData(const char* ip, unsigned short port, const void* buffer, size_t size) {
+    // 从进程级池中借用已连接的套接字，避免每次创建上下文与连接
+    ZmqSocketLease socket = ZmqSocketPool::Instance().acquire(make_endpoint(ip, port), ZMQ_DGRAM);
+    if (!socket) return false;
+    
+    // 初始化消息：套接字长期存在，发送可能在返回后才完成，因此由ZMQ持有一份拷贝
+    zmq_msg_t msg;
+    if (zmq_msg_init_size(&msg, size) != 0) {
+        return false;
+    }
+    memcpy(zmq_msg_data(&msg), buffer, size);
+    
+    // 发送消息
+    int sent = zmq_msg_send(&msg, socket.socket(), 0);
+    if (sent == -1) {
+        zmq_msg_close(&msg);
+        socket.discard();
+    }
+    
+    return sent != -1;
+}
+
+DATATRANSFER_API bool ReceiveData(const char* ip, unsigned short port, void* buffer, size_t size) {
+    // 绑定的套接字在调用之间保持，调用间隙到达的报文不会丢失
+    ZmqSocketLease socket = ZmqSocketPool::Instance().acquire(make_endpoint(ip, port), ZMQ_DGRAM, true);
+    if (!socket) return false;
+    
+    // 初始化消息
+    zmq_msg_t msg;
+    if (zmq_msg_init(&msg) != 0) {
+        return false;
+    }
+    
+    // 接收消息
+    int received = zmq_msg_recv(&msg, socket.socket(), 0);
+    if (received == -1) {
+        zmq_msg_close(&msg);
+        socket.discard();
+        return false;
+    }
+    
+    // 检查消息大小
+    size_t msg_size = zmq_msg_size(&msg);
+    if (msg_size != size) {
+        zmq_msg_close(&msg);
+        return false;
+    }
+    
+    // 复制数据到缓冲区
+    memcpy(buffer, zmq_msg_data(&msg), size);
+    zmq_msg_close(&msg);
+    
+    return true;
+}
+
+// 传输ID：高32位为进程随机种子，避免不同发送端冲突
+static uint64_t next_transfer_id() {
+    static const uint64_t seed = static_cast<uint64_t>(std::random_device{}()) << 32;
+    static std::atomic<uint32_t> counter{0};
+    return seed | counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+DATATRANSFER_API bool SendDataFragmented(const char* ip, unsigned short port, uint8_t operation,
+                                         uint64_t dstDevice, const void* buffer, size_t size) {
+    ZmqSocketLease socket = ZmqSocketPool::Instance().acquire(make_endpoint(ip, port), ZMQ_DGRAM);
+    if (!socket) return false;
+
+    FragmentSender sender;
+    bool ok = sender.send([&](const void* data, size_t length) {
+        return zmq_send(socket.socket(), data, length, 0) != -1;
+    }, next_transfer_id(), operation, dstDevice, buffer, size);
+
+    if (!ok) socket.discard();
+    return ok;
+}
+
+DATATRANSFER_API bool ReceiveDataFragmented(const char* ip, unsigned short port, void* buffer,
+                                            size_t size, int timeoutMs) {
+    ZmqSocketLease socket = ZmqSocketPool::Instance().acquire(make_endpoint(ip, port), ZMQ_DGRAM, true);
+    if (!socket) return false;
+
+    // 只接收第一个长度匹配的传输
+    bool claimed = false;
+    bool completed = false;
+    FragmentReassembler reassembler(
+        [&](uint64_t, uint64_t, uint64_t totalLength) -> uint8_t* {
+            if (claimed || totalLength != size) return nullptr;
+            claimed = true;
+            return static_cast<uint8_t*>(buffer);
+        },
+        [&](uint64_t, uint8_t, uint64_t, uint64_t) { completed = true; });
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::vector<uint8_t> datagram(kDefaultDatagramSize);
+    while (!completed) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) break;
+
+        int timeout = static_cast<int>(remaining);
+        zmq_setsockopt(socket.socket(), ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+        int received = zmq_recv(socket.socket(), datagram.data(), datagram.size(), 0);
+        if (received == -1) {
+            if (zmq_errno() == EAGAIN) continue;
+            socket.discard();
+            return false;
+        }
+        // 超出缓冲区的报文被截断，按无效丢弃
+        if (static_cast<size_t>(received) > datagram.size()) continue;
+        reassembler.onDatagram(datagram.data(), received);
+    }
+
+    // 套接字归还池中，恢复阻塞接收
+    int infinite = -1;
+    zmq_setsockopt(socket.socket(), ZMQ_RCVTIMEO, &infinite, sizeof(infinite));
+    return completed;
+}
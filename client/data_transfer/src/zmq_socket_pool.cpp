@@ -0,0 +1,182 @@
+#include "zmq_socket_pool.h"
+#include <zmq.h>
+#include <iostream>
+
+// ---------------- ZmqSocketLease ----------------
+
+ZmqSocketLease::ZmqSocketLease(ZmqSocketPool* pool, void* socket, const std::string& endpoint, int type, bool bound)
+    : m_pool(pool), m_socket(socket), m_endpoint(endpoint), m_type(type), m_bound(bound) {}
+
+ZmqSocketLease::ZmqSocketLease(ZmqSocketLease&& other) noexcept
+    : m_pool(other.m_pool), m_socket(other.m_socket), m_endpoint(std::move(other.m_endpoint)),
+      m_type(other.m_type), m_bound(other.m_bound), m_healthy(other.m_healthy) {
+    other.m_socket = nullptr;
+}
+
+ZmqSocketLease& ZmqSocketLease::operator=(ZmqSocketLease&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_pool = other.m_pool;
+        m_socket = other.m_socket;
+        m_endpoint = std::move(other.m_endpoint);
+        m_type = other.m_type;
+        m_bound = other.m_bound;
+        m_healthy = other.m_healthy;
+        other.m_socket = nullptr;
+    }
+    return *this;
+}
+
+ZmqSocketLease::~ZmqSocketLease() {
+    release();
+}
+
+void ZmqSocketLease::release() {
+    if (m_socket && m_pool) {
+        m_pool->giveBack(m_socket, m_endpoint, m_type, m_bound, m_healthy);
+    }
+    m_socket = nullptr;
+}
+
+// ---------------- ZmqSocketPool ----------------
+
+ZmqSocketPool::ZmqSocketPool(const ZmqSocketPoolConfig& config)
+    : m_config(config), m_context(zmq_ctx_new()), m_lastReap(std::chrono::steady_clock::now()) {
+    if (!m_context) {
+        std::cerr << "zmq_ctx_new failed: " << zmq_strerror(zmq_errno()) << std::endl;
+    }
+}
+
+ZmqSocketPool::~ZmqSocketPool() {
+    clear();
+    if (m_context) {
+        zmq_ctx_term(m_context);
+    }
+}
+
+ZmqSocketPool& ZmqSocketPool::Instance() {
+    // 有意不析构：DLL卸载时在加载器锁内终止ZMQ上下文会死锁
+    static ZmqSocketPool* instance = new ZmqSocketPool();
+    return *instance;
+}
+
+void* ZmqSocketPool::open(const std::string& endpoint, int type, bool bind) {
+    void* socket = zmq_socket(m_context, type);
+    if (!socket) {
+        std::cerr << "zmq_socket failed: " << zmq_strerror(zmq_errno()) << std::endl;
+        return nullptr;
+    }
+    zmq_setsockopt(socket, ZMQ_LINGER, &m_config.lingerMs, sizeof(m_config.lingerMs));
+
+    int rc = bind ? zmq_bind(socket, endpoint.c_str()) : zmq_connect(socket, endpoint.c_str());
+    if (rc != 0) {
+        std::cerr << (bind ? "zmq_bind" : "zmq_connect") << " failed for " << endpoint
+                  << ": " << zmq_strerror(zmq_errno()) << std::endl;
+        zmq_close(socket);
+        return nullptr;
+    }
+    return socket;
+}
+
+ZmqSocketLease ZmqSocketPool::acquire(const std::string& endpoint, int type, bool bind) {
+    if (!m_context) return ZmqSocketLease();
+
+    std::vector<void*> expired;
+    void* socket = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = std::chrono::steady_clock::now();
+        reapLocked(now, expired);
+
+        auto it = m_idle.find(Key(type, bind, endpoint));
+        if (it != m_idle.end() && !it->second.empty()) {
+            socket = it->second.back().socket;
+            it->second.pop_back();
+        }
+    }
+    for (void* s : expired) {
+        zmq_close(s);
+    }
+
+    if (!socket) {
+        socket = open(endpoint, type, bind);
+        if (!socket) return ZmqSocketLease();
+    }
+    return ZmqSocketLease(this, socket, endpoint, type, bind);
+}
+
+void ZmqSocketPool::giveBack(void* socket, const std::string& endpoint, int type, bool bound, bool healthy) {
+    std::vector<void*> expired;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (healthy) {
+            auto& idle = m_idle[Key(type, bound, endpoint)];
+            if (idle.size() < m_config.maxIdlePerEndpoint) {
+                idle.push_back(IdleSocket{socket, std::chrono::steady_clock::now()});
+                socket = nullptr;
+            }
+        }
+        reapLocked(std::chrono::steady_clock::now(), expired);
+    }
+    if (socket) {
+        zmq_close(socket);
+    }
+    for (void* s : expired) {
+        zmq_close(s);
+    }
+}
+
+// 惰性清理：距上次清理超过半个超时周期才遍历
+void ZmqSocketPool::reapLocked(std::chrono::steady_clock::time_point now, std::vector<void*>& expired) {
+    if (now - m_lastReap < m_config.idleTimeout / 2) return;
+    m_lastReap = now;
+
+    for (auto it = m_idle.begin(); it != m_idle.end();) {
+        auto& idle = it->second;
+        // 尾部最近归还，过期的集中在头部
+        size_t keep = 0;
+        while (keep < idle.size() && now - idle[keep].since >= m_config.idleTimeout) {
+            expired.push_back(idle[keep].socket);
+            ++keep;
+        }
+        idle.erase(idle.begin(), idle.begin() + keep);
+        it = idle.empty() ? m_idle.erase(it) : std::next(it);
+    }
+}
+
+void ZmqSocketPool::reapIdle() {
+    std::vector<void*> expired;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lastReap = std::chrono::steady_clock::time_point();
+        reapLocked(std::chrono::steady_clock::now(), expired);
+    }
+    for (void* s : expired) {
+        zmq_close(s);
+    }
+}
+
+void ZmqSocketPool::clear() {
+    std::vector<void*> sockets;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& pair : m_idle) {
+            for (auto& idle : pair.second) {
+                sockets.push_back(idle.socket);
+            }
+        }
+        m_idle.clear();
+    }
+    for (void* s : sockets) {
+        zmq_close(s);
+    }
+}
+
+size_t ZmqSocketPool::idleCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (const auto& pair : m_idle) {
+        count += pair.second.size();
+    }
+    return count;
+}
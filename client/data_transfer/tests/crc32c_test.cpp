@@ -0,0 +1,95 @@
+// CRC32C测试：RFC 3720标准向量、硬件实现与查表实现在各种长度与对齐下一致、分段累计与整段一致，
+// 并输出与原zlib crc32的吞吐对比
+// 构建（在client/data_transfer下）：
+//   g++ -std=c++17 -O2 -Iinclude tests/crc32c_test.cpp src/crc32c.cpp -lz -o crc32c_test
+#include "crc32c.h"
+#include <zlib.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+void testVectors() {
+    unsigned char buffer[32];
+    CHECK(Crc32c("123456789", 9) == 0xE3069283u);
+    CHECK(Crc32cScalar("123456789", 9) == 0xE3069283u);
+    CHECK(Crc32c(nullptr, 0) == 0);
+
+    std::memset(buffer, 0, sizeof(buffer));
+    CHECK(Crc32c(buffer, sizeof(buffer)) == 0x8A9136AAu);
+    std::memset(buffer, 0xFF, sizeof(buffer));
+    CHECK(Crc32c(buffer, sizeof(buffer)) == 0x62A8AB43u);
+    for (int i = 0; i < 32; ++i) buffer[i] = static_cast<unsigned char>(i);
+    CHECK(Crc32c(buffer, sizeof(buffer)) == 0x46DD794Eu);
+    for (int i = 0; i < 32; ++i) buffer[i] = static_cast<unsigned char>(31 - i);
+    CHECK(Crc32c(buffer, sizeof(buffer)) == 0x113FDB5Cu);
+}
+
+// 覆盖三路交错的分界、尾部与非对齐起点
+void testAgainstScalar() {
+    std::mt19937_64 rng(11);
+    std::vector<unsigned char> data(1 << 20);
+    for (auto& byte : data) byte = static_cast<unsigned char>(rng());
+
+    int mismatches = 0;
+    for (size_t size = 0; size < 4096; ++size) {
+        size_t start = size % 16;
+        if (Crc32c(data.data() + start, size) != Crc32cScalar(data.data() + start, size)) ++mismatches;
+    }
+    for (int i = 0; i < 200; ++i) {
+        size_t start = rng() % 64;
+        size_t size = rng() % (data.size() - start);
+        if (Crc32c(data.data() + start, size) != Crc32cScalar(data.data() + start, size)) ++mismatches;
+    }
+    CHECK(mismatches == 0);
+
+    uint32_t whole = Crc32c(data.data(), data.size());
+    for (size_t split : {size_t(1), size_t(7), size_t(4096), size_t(300000)}) {
+        CHECK(Crc32c(data.data() + split, data.size() - split, Crc32c(data.data(), split)) == whole);
+        CHECK(Crc32cScalar(data.data() + split, data.size() - split, Crc32cScalar(data.data(), split)) == whole);
+    }
+}
+
+template <typename Fn>
+void bench(const char* name, const std::vector<unsigned char>& data, Fn&& fn) {
+    constexpr int kRounds = 8;
+    volatile uint32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRounds; ++i) sink = sink ^ fn();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-20s %6.2f GB/s\n", name, kRounds * data.size() / seconds / 1e9);
+}
+
+void benchThroughput() {
+    std::vector<unsigned char> data(64 << 20);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<unsigned char>(i * 7);
+    std::printf("implementation: %s\n", Crc32cImplementation());
+    bench("zlib crc32", data, [&] { return static_cast<uint32_t>(crc32(0, data.data(), static_cast<uInt>(data.size()))); });
+    bench("crc32c scalar", data, [&] { return Crc32cScalar(data.data(), data.size()); });
+    bench("crc32c", data, [&] { return Crc32c(data.data(), data.size()); });
+}
+}
+
+int main() {
+    testVectors();
+    testAgainstScalar();
+    benchThroughput();
+    if (g_failures) {
+        std::fprintf(stderr, "crc32c_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("crc32c_test: OK\n");
+    return 0;
+}
@@ -0,0 +1,180 @@
+// 分片发送/重组的环回测试，并输出4 KB到1 GB传输经FragmentSender/FragmentReassembler环回的吞吐
+// 构建（在client/data_transfer下）：
+//   g++ -std=c++17 -O2 -Iinclude tests/fragment_test.cpp src/fragment.cpp src/crc32c.cpp -o fragment_test
+#include "fragment.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+constexpr size_t kDatagram = 256;
+
+std::vector<uint8_t> makePayload(size_t size) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i) data[i] = static_cast<uint8_t>(i * 31 + 7);
+    return data;
+}
+
+std::vector<std::vector<uint8_t>> fragmentAll(const std::vector<uint8_t>& data, uint64_t transferId) {
+    std::vector<std::vector<uint8_t>> datagrams;
+    FragmentSender sender(kDatagram);
+    sender.send([&](const void* d, size_t n) {
+        auto* p = static_cast<const uint8_t*>(d);
+        datagrams.emplace_back(p, p + n);
+        return true;
+    }, transferId, 1, 0x1000, data.data(), data.size());
+    return datagrams;
+}
+
+struct Sink {
+    std::vector<uint8_t> buffer;
+    int completions = 0;
+    FragmentReassembler reassembler{
+        [this](uint64_t, uint64_t, uint64_t total) { buffer.assign(total, 0); return buffer.data(); },
+        [this](uint64_t, uint8_t, uint64_t, uint64_t) { ++completions; }};
+};
+
+// 按序、乱序送达均能完整重组
+void testInOrderAndShuffled() {
+    for (size_t size : {size_t(0), size_t(1), kDatagram - kFragmentOverhead, size_t(10000)}) {
+        auto data = makePayload(size);
+        auto datagrams = fragmentAll(data, 1);
+        CHECK(datagrams.size() == FragmentSender(kDatagram).fragmentCount(size));
+
+        Sink ordered;
+        for (size_t i = 0; i < datagrams.size(); ++i) {
+            auto r = ordered.reassembler.onDatagram(datagrams[i].data(), datagrams[i].size());
+            CHECK(r == (i + 1 == datagrams.size() ? FragmentReassembler::Result::Completed
+                                                 : FragmentReassembler::Result::Accepted));
+        }
+        CHECK(ordered.completions == 1);
+        CHECK(ordered.buffer == data);
+
+        Sink shuffled;
+        std::mt19937 rng(static_cast<uint32_t>(size));
+        std::shuffle(datagrams.begin(), datagrams.end(), rng);
+        for (auto& d : datagrams) shuffled.reassembler.onDatagram(d.data(), d.size());
+        CHECK(shuffled.completions == 1);
+        CHECK(shuffled.buffer == data);
+        CHECK(shuffled.reassembler.pendingTransfers() == 0);
+    }
+}
+
+// 重复分片不计入已收字节，不会提前完成
+void testDuplicates() {
+    auto data = makePayload(1000);
+    auto datagrams = fragmentAll(data, 2);
+    CHECK(datagrams.size() > 2);
+
+    Sink sink;
+    CHECK(sink.reassembler.onDatagram(datagrams[0].data(), datagrams[0].size()) == FragmentReassembler::Result::Accepted);
+    for (size_t i = 0; i < datagrams.size(); ++i) {
+        CHECK(sink.reassembler.onDatagram(datagrams[0].data(), datagrams[0].size()) == FragmentReassembler::Result::Duplicate);
+    }
+    CHECK(sink.completions == 0);
+    for (size_t i = 1; i < datagrams.size(); ++i) {
+        sink.reassembler.onDatagram(datagrams[i].data(), datagrams[i].size());
+    }
+    CHECK(sink.completions == 1);
+    CHECK(sink.buffer == data);
+}
+
+// 非末尾分片短于fragmentSize、越过末尾的空分片均被拒绝
+void testMalformed() {
+    auto data = makePayload(1000);
+    auto datagrams = fragmentAll(data, 3);
+
+    // 截短首片并重算校验，使其看起来合法
+    auto shortened = datagrams[0];
+    DataHeader header;
+    FragmentHeader fragment;
+    std::memcpy(&header, shortened.data(), sizeof(header));
+    std::memcpy(&fragment, shortened.data() + sizeof(header), sizeof(fragment));
+    header.dataSize -= 1;
+    fragment.crc = FragmentChecksum(shortened.data() + kFragmentOverhead, header.dataSize);
+    std::memcpy(shortened.data(), &header, sizeof(header));
+    std::memcpy(shortened.data() + sizeof(header), &fragment, sizeof(fragment));
+    shortened.pop_back();
+
+    Sink sink;
+    CHECK(sink.reassembler.onDatagram(shortened.data(), shortened.size()) == FragmentReassembler::Result::Invalid);
+    CHECK(sink.reassembler.pendingTransfers() == 0);
+
+    // offset == totalLength 的空分片
+    std::vector<uint8_t> tail(kFragmentOverhead);
+    header = {};
+    header.operation = 1 | kOpFragmented;
+    fragment = {};
+    fragment.transferId = 3;
+    fragment.totalLength = 2 * 100;
+    fragment.fragmentSize = 100;
+    fragment.offset = fragment.totalLength;
+    fragment.crc = FragmentChecksum(nullptr, 0);
+    std::memcpy(tail.data(), &header, sizeof(header));
+    std::memcpy(tail.data() + sizeof(header), &fragment, sizeof(fragment));
+    CHECK(sink.reassembler.onDatagram(tail.data(), tail.size()) == FragmentReassembler::Result::Invalid);
+
+    // 负载损坏
+    auto corrupted = datagrams[1];
+    corrupted.back() ^= 0xFF;
+    CHECK(sink.reassembler.onDatagram(corrupted.data(), corrupted.size()) == FragmentReassembler::Result::BadChecksum);
+}
+
+// 发送端的每个报文直接交给重组器（默认4096字节报文），不经过套接字：
+// 反映分片、CRC32C与按偏移写入目标缓冲区的开销。小传输重复多次，每个大小至少处理256 MB
+void benchLoopback() {
+    constexpr size_t kMinBytes = size_t(256) << 20;
+    std::printf("%10s %10s %12s %10s\n", "size", "MB/s", "datagrams", "repeats");
+    for (size_t size : {size_t(4) << 10, size_t(64) << 10, size_t(1) << 20, size_t(16) << 20,
+                        size_t(256) << 20, size_t(1) << 30}) {
+        std::vector<uint8_t> source(size);
+        for (size_t i = 0; i < size; i += 4096) source[i] = static_cast<uint8_t>(i >> 12);
+        std::vector<uint8_t> target(size);
+        int completions = 0;
+        FragmentReassembler reassembler(
+            [&](uint64_t, uint64_t, uint64_t) { return target.data(); },
+            [&](uint64_t, uint8_t, uint64_t, uint64_t) { ++completions; });
+        FragmentSender sender;
+        auto sink = [&](const void* d, size_t n) {
+            return reassembler.onDatagram(d, n) != FragmentReassembler::Result::Invalid;
+        };
+
+        size_t repeats = std::max<size_t>(1, kMinBytes / size);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < repeats; ++r) {
+            sender.send(sink, r + 1, 1, 0x1000, source.data(), size);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        CHECK(completions == static_cast<int>(repeats));
+        CHECK(std::memcmp(source.data(), target.data(), size) == 0);
+        std::printf("%9zuK %10.1f %12llu %10zu\n", size >> 10, repeats * size / seconds / 1e6,
+                    static_cast<unsigned long long>(sender.fragmentCount(size)), repeats);
+    }
+}
+}
+
+int main() {
+    testInOrderAndShuffled();
+    testDuplicates();
+    testMalformed();
+    benchLoopback();
+    if (g_failures) {
+        std::fprintf(stderr, "fragment_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("fragment_test: OK\n");
+    return 0;
+}
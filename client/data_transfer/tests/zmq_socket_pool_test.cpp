@@ -0,0 +1,150 @@
+// ZMQ套接字池测试：归还后按(类型, connect/bind, 端点)复用、出错丢弃、每端点空闲上限、空闲超时回收、
+// 复用的套接字仍可收发，并对比原先每条消息新建上下文与套接字和从池借用的发送耗时
+// 构建（在client/data_transfer下）：
+//   g++ -std=c++17 -O2 -Iinclude tests/zmq_socket_pool_test.cpp src/zmq_socket_pool.cpp -lzmq -pthread -o zmq_socket_pool_test
+#include "zmq_socket_pool.h"
+#include <zmq.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+const char* kEndpoint = "tcp://127.0.0.1:5591";
+
+void testReuse() {
+    ZmqSocketPool pool;
+    void* first = nullptr;
+    {
+        ZmqSocketLease lease = pool.acquire(kEndpoint, ZMQ_PUSH);
+        CHECK(lease);
+        first = lease.socket();
+        CHECK(pool.idleCount() == 0);
+    }
+    CHECK(pool.idleCount() == 1);
+    {
+        ZmqSocketLease again = pool.acquire(kEndpoint, ZMQ_PUSH);
+        CHECK(again.socket() == first && pool.idleCount() == 0);
+        // 借出期间独占：同一端点再借得到另一个套接字
+        ZmqSocketLease second = pool.acquire(kEndpoint, ZMQ_PUSH);
+        CHECK(second && second.socket() != first);
+        ZmqSocketLease moved = std::move(second);
+        CHECK(!second && moved);
+    }
+    CHECK(pool.idleCount() == 2);
+
+    // 类型不同不复用
+    ZmqSocketLease other = pool.acquire(kEndpoint, ZMQ_DEALER);
+    CHECK(other && other.socket() != first && pool.idleCount() == 2);
+}
+
+void testDiscardAndLimits() {
+    ZmqSocketPoolConfig config;
+    config.maxIdlePerEndpoint = 2;
+    config.idleTimeout = std::chrono::milliseconds(20);
+    ZmqSocketPool pool(config);
+    {
+        ZmqSocketLease lease = pool.acquire(kEndpoint, ZMQ_PUSH);
+        lease.discard();
+    }
+    CHECK(pool.idleCount() == 0);
+
+    {
+        std::vector<ZmqSocketLease> leases;
+        for (int i = 0; i < 5; ++i) leases.push_back(pool.acquire(kEndpoint, ZMQ_PUSH));
+    }
+    CHECK(pool.idleCount() == 2);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    pool.reapIdle();
+    CHECK(pool.idleCount() == 0);
+
+    // 无效端点借出失败，不留下套接字
+    CHECK(!pool.acquire("bogus://endpoint", ZMQ_PUSH));
+    CHECK(pool.idleCount() == 0);
+}
+
+bool Receive(void* socket, std::string& out) {
+    char buffer[64];
+    int size = zmq_recv(socket, buffer, sizeof(buffer), 0);
+    if (size < 0) return false;
+    out.assign(buffer, static_cast<size_t>(size));
+    return true;
+}
+
+void testDelivery() {
+    ZmqSocketPool pool;
+    ZmqSocketLease pull = pool.acquire(kEndpoint, ZMQ_PULL, true);
+    CHECK(pull);
+    if (!pull) return;
+    int timeout = 2000;
+    zmq_setsockopt(pull.socket(), ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string received;
+    for (const char* text : {"first", "second"}) {
+        ZmqSocketLease push = pool.acquire(kEndpoint, ZMQ_PUSH);
+        CHECK(zmq_send(push.socket(), text, std::strlen(text), 0) == static_cast<int>(std::strlen(text)));
+        CHECK(Receive(pull.socket(), received) && received == text);
+    }
+}
+
+// 原ZmqTransport::Transfer：每条消息新建上下文与套接字，发送后全部销毁
+void benchSend() {
+    ZmqSocketPool receiver;
+    ZmqSocketLease pull = receiver.acquire(kEndpoint, ZMQ_PULL, true);
+    if (!pull) return;
+    int timeout = 2000;
+    zmq_setsockopt(pull.socket(), ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+    const char payload[256] = {};
+    std::string received;
+
+    constexpr int kFresh = 200;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kFresh; ++i) {
+        void* context = zmq_ctx_new();
+        void* socket = zmq_socket(context, ZMQ_PUSH);
+        zmq_connect(socket, kEndpoint);
+        zmq_send(socket, payload, sizeof(payload), 0);
+        Receive(pull.socket(), received);
+        zmq_close(socket);
+        zmq_ctx_term(context);
+    }
+    double fresh = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / kFresh;
+
+    ZmqSocketPool pool;
+    constexpr int kPooled = 20000;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kPooled; ++i) {
+        ZmqSocketLease push = pool.acquire(kEndpoint, ZMQ_PUSH);
+        zmq_send(push.socket(), payload, sizeof(payload), 0);
+        Receive(pull.socket(), received);
+    }
+    double pooled = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / kPooled;
+    std::printf("256 B message: fresh context+socket %.1f us, pooled socket %.1f us\n", fresh, pooled);
+}
+}
+
+int main() {
+    testReuse();
+    testDiscardAndLimits();
+    testDelivery();
+    benchSend();
+    if (g_failures) {
+        std::fprintf(stderr, "zmq_socket_pool_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("zmq_socket_pool_test: OK\n");
+    return 0;
+}
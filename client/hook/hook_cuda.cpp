@@ -1,183 +1,300 @@
-// CUDA API Hook实现模块 - 重构版本
-// 将文件保存为 UTF-8 编码以修复编码问题
-#include "pch.h" // 预编译头必须放在最前面
-#include "hook_cuda.h" // 当前模块专用头文件
-
-// 全局资源声明
-static std::mutex g_api_mutex; // 添加API互斥锁
-static std::map<CUfunction, std::string> g_function_name_map;
-static std::thread g_status_thread;
-static LauncherClient g_launcher_client("127.0.0.1:12345"); // 使用LauncherClient替代本地服务
-
-// 原始函数指针声明
-#define LOAD_ORIG(func) pOriginal_##func = reinterpret_cast<func##_t>(GetProcAddress(cudaModule, #func))
-typedef CUresult (CUDAAPI *cuMemAlloc_t)(CUdeviceptr*, size_t);
-typedef CUresult (CUDAAPI *cuMemFree_t)(CUdeviceptr);
-typedef CUresult (CUDAAPI *cuMemcpyHtoD_t)(CUdeviceptr, const void*, size_t);
-typedef CUresult (CUDAAPI *cuMemcpyDtoH_t)(void*, CUdeviceptr, size_t);
-typedef CUresult (CUDAAPI *cuLaunchKernel_t)(CUfunction, unsigned, unsigned, unsigned,
-                                           unsigned, unsigned, unsigned,
-                                           unsigned, CUstream, void**, void**);
-typedef CUresult (CUDAAPI *cuModuleGetFunction_t)(CUfunction*, CUmodule, const char*);
-static HMODULE cudaModule = nullptr;
-static cuMemAlloc_t pOriginal_cuMemAlloc = nullptr;
-static cuMemFree_t pOriginal_cuMemFree = nullptr;
-static cuMemcpyHtoD_t pOriginal_cuMemcpyHtoD = nullptr;
-static cuMemcpyDtoH_t pOriginal_cuMemcpyDtoH = nullptr;
-static cuLaunchKernel_t pOriginal_cuLaunchKernel = nullptr;
-static cuModuleGetFunction_t pOriginal_cuModuleGetFunction = nullptr;
-
-// 初始化原始函数
-void InitOriginalFunctions() {
-    cudaModule = LoadLibraryA("nvcuda.dll");
-    if (!cudaModule) {
-        std::cerr << "Failed to load nvcuda.dll" << std::endl;
-        return;
-    }
-    LOAD_ORIG(cuMemAlloc);
-    LOAD_ORIG(cuMemFree);
-    LOAD_ORIG(cuMemcpyHtoD);
-    LOAD_ORIG(cuMemcpyDtoH);
-    LOAD_ORIG(cuLaunchKernel);
-    LOAD_ORIG(cuModuleGetFunction);
-}
-
-// Hooked_cuModuleGetFunction
-CUresult CUDAAPI Hooked_cuModuleGetFunction(CUfunction* hfunc, CUmodule hmod, const char* name) {
-    std::lock_guard<std::mutex> lock(g_api_mutex);
-    CUresult res = pOriginal_cuModuleGetFunction(hfunc, hmod, name);
-    if (res == CUDA_SUCCESS) {
-        g_function_name_map[*hfunc] = name;
-        std::cout << "[Hook] Mapped CUfunction " << *hfunc << " to name '" << name << "'" << std::endl;
-    }
-    return res;
-}
-
-// 简化的Hooked_cuMemAlloc
-CUresult CUDAAPI Hooked_cuMemAlloc(CUdeviceptr* dev_ptr, size_t byte_size) {
-    std::lock_guard<std::mutex> lock(g_api_mutex);
-    
-    // 通过RPC调用远程分配内存
-    auto result = g_launcher_client.requestAllocationPlan(byte_size);
-    // 注意: AllocationPlan不包含设备指针，需要后续实现
-    // 临时解决方案 - 返回原始实现
-    return pOriginal_cuMemAlloc(dev_ptr, byte_size);
-    
-    return CUDA_SUCCESS;
-}
-
-// 简化的Hooked_cuMemFree
-CUresult CUDAAPI Hooked_cuMemFree(CUdeviceptr dptr) {
-    std::lock_guard<std::mutex> lock(g_api_mutex);
-    
-    // 通过RPC调用远程释放内存
-    auto result = g_launcher_client.requestFreePlan(dptr);
-    if (static_cast<int>(result) != CUDA_SUCCESS) {
-        std::cerr << "[Hook] Remote free failed: " << static_cast<int>(result) << std::endl;
-    }
-    
-    // 同时调用原始释放
-    return pOriginal_cuMemFree(dptr);
-    
-    return CUDA_SUCCESS;
-}
-
-// 简化的Hooked_cuMemcpyHtoD
-CUresult CUDAAPI Hooked_cuMemcpyHtoD(CUdeviceptr dstDevice, const void* srcHost, size_t ByteCount) {
-    std::lock_guard<std::mutex> lock(g_api_mutex);
-    
-    // 直接调用数据传输模块
-    bool success = SendData("127.0.0.1", 5555, srcHost, ByteCount);
-    
-    if (!success) {
-        std::cerr << "[Hook] HtoD transfer failed" << std::endl;
-        return CUDA_ERROR_UNKNOWN;
-    }
-    
-    return CUDA_SUCCESS;
-}
-
-// 简化的Hooked_cuMemcpyDtoH
-CUresult CUDAAPI Hooked_cuMemcpyDtoH(void* dstHost, CUdeviceptr srcDevice, size_t ByteCount) {
-    std::lock_guard<std::mutex> lock(g_api_mutex);
-    
-    // 直接调用数据传输模块
-    bool success = ReceiveData("127.0.0.1", 5555, dstHost, ByteCount);
-    
-    if (!success) {
-        std::cerr << "[Hook] DtoH transfer failed" << std::endl;
-        return CUDA_ERROR_UNKNOWN;
-    }
-    
-    return CUDA_SUCCESS;
-}
-
-// 简化的Hooked_cuLaunchKernel实现
-CUresult CUDAAPI Hooked_cuLaunchKernel(
-    CUfunction f,
-    unsigned gridDimX, unsigned gridDimY, unsigned gridDimZ,
-    unsigned blockDimX, unsigned blockDimY, unsigned blockDimZ,
-    unsigned sharedMemBytes, CUstream hStream,
-    void** kernelParams, void** extra) {
-
-    std::lock_guard<std::mutex> lock(g_api_mutex);
-
-    // 查找内核名称
-    auto it = g_function_name_map.find(f);
-    if (it == g_function_name_map.end()) {
-        std::cerr << "[Hook] Unknown kernel function" << std::endl;
-        return CUDA_ERROR_INVALID_HANDLE;
-    }
-    const std::string& kernelName = it->second;
-    
-    try {
-        // 通过RPC调用远程启动内核
-        auto result = g_launcher_client.launchKernel(
-            kernelName,
-            gridDimX, gridDimY, gridDimZ,
-            blockDimX, blockDimY, blockDimZ,
-            sharedMemBytes,
-            kernelParams
-        );
-        
-        return static_cast<CUresult>(result);
-    } catch (const kj::Exception& e) {
-        std::cerr << "[Hook] Exception in LaunchKernel: " << e.getDescription().cStr() << std::endl;
-        return CUDA_ERROR_LAUNCH_FAILED;
-    }
-}
-
-// 简化的InitializeHook
-void InitializeHook() {
-    InitOriginalFunctions();
-    
-    // 连接LauncherClient
-    g_launcher_client.connect();
-    
-    std::cout << "[Hook] Initialized with LauncherClient" << std::endl;
-}
-
-// CleanupHook实现
-void CleanupHook() {
-    // 无需显式断开连接
-    
-    if (cudaModule) {
-        FreeLibrary(cudaModule);
-        cudaModule = nullptr;
-    }
-    
-    std::cout << "[Hook] Cleaned up" << std::endl;
-}
-
-// DllMain实现
-BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserved) {
-    switch (ul_reason_for_call) {
-    case DLL_PROCESS_ATTACH: 
-        InitializeHook(); 
-        break;
-    case DLL_PROCESS_DETACH: 
-        CleanupHook(); 
-        break;
-    }
-    return TRUE;
-}
+// CUDA API Hook实现模块 - 重构版本
+// 将文件保存为 UTF-8 编码以修复编码问题
+#include "pch.h" // 预编译头必须放在最前面
+#include "hook_cuda.h" // 当前模块专用头文件
+#include "hook_state.h" // Hook全局状态（无全局锁）
+#include "launch_batcher.h" // 内核启动合并
+#include "kernel_signature.h" // 内核参数签名缓存
+#include "sub_allocator.h" // 小块分配缓存
+
+// 全局资源声明
+static std::thread g_status_thread;
+static HookState& g_state = HookState::Instance(); // 函数名映射、RPC通道与在途操作
+static const char* kLauncherAddress = "127.0.0.1:12345";
+static const size_t kLauncherChannels = 4; // 每个通道独立的RPC线程与连接
+static LaunchBatcher g_launch_batcher(g_state); // 按流缓冲cuLaunchKernel
+static KernelSignatureCache g_signatures; // CUfunction -> 参数布局
+static const char* kSignatureDescriptor = "kernel_signatures.json"; // 可选的内核签名描述文件
+static SubAllocator g_suballocator; // 小块cuMemAlloc从本地slab切分
+
+// 原始函数指针声明
+#define LOAD_ORIG(func) pOriginal_##func = reinterpret_cast<func##_t>(GetProcAddress(cudaModule, #func))
+typedef CUresult (CUDAAPI *cuMemAlloc_t)(CUdeviceptr*, size_t);
+typedef CUresult (CUDAAPI *cuMemFree_t)(CUdeviceptr);
+typedef CUresult (CUDAAPI *cuMemcpyHtoD_t)(CUdeviceptr, const void*, size_t);
+typedef CUresult (CUDAAPI *cuMemcpyDtoH_t)(void*, CUdeviceptr, size_t);
+typedef CUresult (CUDAAPI *cuLaunchKernel_t)(CUfunction, unsigned, unsigned, unsigned,
+                                           unsigned, unsigned, unsigned,
+                                           unsigned, CUstream, void**, void**);
+typedef CUresult (CUDAAPI *cuModuleGetFunction_t)(CUfunction*, CUmodule, const char*);
+typedef CUresult (CUDAAPI *cuCtxSynchronize_t)(void);
+typedef CUresult (CUDAAPI *cuStreamSynchronize_t)(CUstream);
+static HMODULE cudaModule = nullptr;
+static cuMemAlloc_t pOriginal_cuMemAlloc = nullptr;
+static cuMemFree_t pOriginal_cuMemFree = nullptr;
+static cuMemcpyHtoD_t pOriginal_cuMemcpyHtoD = nullptr;
+static cuMemcpyDtoH_t pOriginal_cuMemcpyDtoH = nullptr;
+static cuLaunchKernel_t pOriginal_cuLaunchKernel = nullptr;
+static cuModuleGetFunction_t pOriginal_cuModuleGetFunction = nullptr;
+static cuCtxSynchronize_t pOriginal_cuCtxSynchronize = nullptr;
+static cuStreamSynchronize_t pOriginal_cuStreamSynchronize = nullptr;
+static cuFuncGetParamInfo_t pOriginal_cuFuncGetParamInfo = nullptr; // CUDA 12.4+，旧驱动为空
+
+// 初始化原始函数
+void InitOriginalFunctions() {
+    cudaModule = LoadLibraryA("nvcuda.dll");
+    if (!cudaModule) {
+        std::cerr << "Failed to load nvcuda.dll" << std::endl;
+        return;
+    }
+    LOAD_ORIG(cuMemAlloc);
+    LOAD_ORIG(cuMemFree);
+    LOAD_ORIG(cuMemcpyHtoD);
+    LOAD_ORIG(cuMemcpyDtoH);
+    LOAD_ORIG(cuLaunchKernel);
+    LOAD_ORIG(cuModuleGetFunction);
+    LOAD_ORIG(cuCtxSynchronize);
+    LOAD_ORIG(cuStreamSynchronize);
+    LOAD_ORIG(cuFuncGetParamInfo);
+}
+
+// Hooked_cuModuleGetFunction
+CUresult CUDAAPI Hooked_cuModuleGetFunction(CUfunction* hfunc, CUmodule hmod, const char* name) {
+    CUresult res = pOriginal_cuModuleGetFunction(hfunc, hmod, name);
+    if (res == CUDA_SUCCESS) {
+        g_state.registerFunction(*hfunc, name);
+        g_signatures.build(*hfunc, name); // 每个函数只解析一次参数布局
+        std::cout << "[Hook] Mapped CUfunction " << *hfunc << " to name '" << name << "'" << std::endl;
+    }
+    return res;
+}
+
+// 小块分配的目标池：slab都由本地cuMemAlloc分配，池键在本地确定，分配时不发RPC
+static const SlabKey kLocalSlabKey{}; // 本节点显存
+
+// 申请slab：先向Launcher预留（每个slab一次分配决策RPC，由其上的全部小块分摊），再本地分配
+static CUresult AcquireSlab(size_t size, const SlabKey&, CUdeviceptr* base) {
+    g_state.channel().requestAllocationPlan(size);
+    CUresult res = pOriginal_cuMemAlloc(base, size);
+    if (res == CUDA_SUCCESS) {
+        g_state.registerAllocation(*base, size);
+    }
+    return res;
+}
+
+// 归还空闲slab：与普通分配的释放相同，通知Launcher释放预留（不等待确认，失败在下一个同步点报告）
+static void ReleaseSlab(CUdeviceptr base, size_t) {
+    g_state.trackPendingOp(nullptr, g_state.channel().requestFreePlanAsync(base));
+    g_state.unregisterAllocation(base);
+    pOriginal_cuMemFree(base);
+}
+
+// 简化的Hooked_cuMemAlloc
+CUresult CUDAAPI Hooked_cuMemAlloc(CUdeviceptr* dev_ptr, size_t byte_size) {
+    // 小块分配由本地slab满足，不发RPC
+    if (g_suballocator.accepts(byte_size)) {
+        return g_suballocator.allocate(byte_size, kLocalSlabKey, dev_ptr);
+    }
+
+    // 通过RPC调用远程分配内存
+    auto result = g_state.channel().requestAllocationPlan(byte_size);
+    // 注意: AllocationPlan不包含设备指针，需要后续实现
+    // 临时解决方案 - 返回原始实现
+    CUresult res = pOriginal_cuMemAlloc(dev_ptr, byte_size);
+    if (res == CUDA_SUCCESS) {
+        g_state.registerAllocation(*dev_ptr, byte_size);
+    }
+    return res;
+    
+    return CUDA_SUCCESS;
+}
+
+// 简化的Hooked_cuMemFree
+CUresult CUDAAPI Hooked_cuMemFree(CUdeviceptr dptr) {
+    // cuMemFree隐式同步：批次按流散列到各自的通道，与本线程通道上的释放请求之间没有顺序，
+    // 提交缓冲的内核后还要等到全部确认，才能释放它们可能仍在使用的内存
+    g_launch_batcher.flushAll();
+    CUresult pending = g_state.drainAll();
+
+    // slab内的块放回本地空闲表，不发RPC
+    CUresult res = g_suballocator.free(dptr);
+    if (res == CUDA_ERROR_NOT_FOUND) {
+        // 通过RPC调用远程释放内存，不等待确认，失败在下一个同步点报告
+        g_state.trackPendingOp(nullptr, g_state.channel().requestFreePlanAsync(dptr));
+
+        // 同时调用原始释放
+        g_state.unregisterAllocation(dptr);
+        res = pOriginal_cuMemFree(dptr);
+    }
+    // 内存照常释放，之前内核的异步错误在这里返回
+    return pending != CUDA_SUCCESS ? pending : res;
+    
+    return CUDA_SUCCESS;
+}
+
+// 简化的Hooked_cuMemcpyHtoD
+CUresult CUDAAPI Hooked_cuMemcpyHtoD(CUdeviceptr dstDevice, const void* srcHost, size_t ByteCount) {
+    // 同步拷贝是CUDA同步点：先提交并等待之前发出的内核启动完成
+    g_launch_batcher.flushAll();
+    CUresult pending = g_state.drainAll();
+    if (pending != CUDA_SUCCESS) {
+        return pending;
+    }
+    
+    // 直接调用数据传输模块
+    bool success = SendData("127.0.0.1", 5555, srcHost, ByteCount);
+    
+    if (!success) {
+        std::cerr << "[Hook] HtoD transfer failed" << std::endl;
+        return CUDA_ERROR_UNKNOWN;
+    }
+    
+    return CUDA_SUCCESS;
+}
+
+// 简化的Hooked_cuMemcpyDtoH
+CUresult CUDAAPI Hooked_cuMemcpyDtoH(void* dstHost, CUdeviceptr srcDevice, size_t ByteCount) {
+    // 同步拷贝是CUDA同步点：先提交并等待之前发出的内核启动完成
+    g_launch_batcher.flushAll();
+    CUresult pending = g_state.drainAll();
+    if (pending != CUDA_SUCCESS) {
+        return pending;
+    }
+    
+    // 直接调用数据传输模块
+    bool success = ReceiveData("127.0.0.1", 5555, dstHost, ByteCount);
+    
+    if (!success) {
+        std::cerr << "[Hook] DtoH transfer failed" << std::endl;
+        return CUDA_ERROR_UNKNOWN;
+    }
+    
+    return CUDA_SUCCESS;
+}
+
+// 简化的Hooked_cuLaunchKernel实现
+CUresult CUDAAPI Hooked_cuLaunchKernel(
+    CUfunction f,
+    unsigned gridDimX, unsigned gridDimY, unsigned gridDimZ,
+    unsigned blockDimX, unsigned blockDimY, unsigned blockDimZ,
+    unsigned sharedMemBytes, CUstream hStream,
+    void** kernelParams, void** extra) {
+
+    // 查找内核名称（线程缓存的无锁快照）
+    const std::string* name = g_state.functionName(f);
+    if (name == nullptr) {
+        std::cerr << "[Hook] Unknown kernel function" << std::endl;
+        return CUDA_ERROR_INVALID_HANDLE;
+    }
+    const std::string& kernelName = *name;
+    
+    KernelLaunchDesc launch;
+    launch.func = kernelName;
+    launch.funcHandle = reinterpret_cast<uint64_t>(f);
+    launch.gridDimX = gridDimX;
+    launch.gridDimY = gridDimY;
+    launch.gridDimZ = gridDimZ;
+    launch.blockDimX = blockDimX;
+    launch.blockDimY = blockDimY;
+    launch.blockDimZ = blockDimZ;
+    launch.sharedMemBytes = sharedMemBytes;
+
+    // 按缓存的签名只序列化实际参数字节，指针/标量在本地判定
+    auto signature = g_signatures.lookup(f);
+    if (!signature) {
+        signature = g_signatures.build(f, kernelName.c_str());
+    }
+    bool packed = false;
+    {
+        auto allocations = g_state.readAllocations();
+        packed = KernelSignatureCache::pack(*signature, kernelParams, extra,
+            [&allocations](CUdeviceptr value) { return allocations.isDevicePointer(value); },
+            launch.params, launch.paramLayout);
+    }
+    if (!packed) {
+        std::cerr << "[Hook] Failed to marshal parameters for kernel '" << kernelName << "'" << std::endl;
+        return CUDA_ERROR_INVALID_VALUE;
+    }
+
+    // 缓冲到流的批次中，与cuLaunchKernel一样立即返回，错误在同步点报告
+    g_launch_batcher.enqueue(hStream, std::move(launch));
+    return CUDA_SUCCESS;
+}
+
+// 同步点：等待所有在途的远程操作，返回期间发生的异步错误
+CUresult CUDAAPI Hooked_cuCtxSynchronize() {
+    g_launch_batcher.flushAll();
+    CUresult res = g_state.drainAll();
+    CUresult local = pOriginal_cuCtxSynchronize();
+    return res != CUDA_SUCCESS ? res : local;
+}
+
+CUresult CUDAAPI Hooked_cuStreamSynchronize(CUstream hStream) {
+    g_launch_batcher.flush(hStream);
+    CUresult res = g_state.drainStream(hStream);
+    CUresult local = pOriginal_cuStreamSynchronize(hStream);
+    return res != CUDA_SUCCESS ? res : local;
+}
+
+// 简化的InitializeHook
+void InitializeHook() {
+    InitOriginalFunctions();
+    g_signatures.setParamInfoQuery(pOriginal_cuFuncGetParamInfo);
+    g_signatures.loadDescriptor(kSignatureDescriptor);
+    
+    // 建立LauncherClient通道（各通道在自己的RPC线程上异步连接）
+    g_state.initialize(kLauncherAddress, kLauncherChannels);
+    g_launch_batcher.start();
+    g_suballocator.setSource({AcquireSlab, ReleaseSlab});
+    
+    std::cout << "[Hook] Initialized with LauncherClient" << std::endl;
+}
+
+// CleanupHook实现（会发出RPC并join各线程，不可在DllMain中调用）
+void CleanupHook() {
+    g_launch_batcher.stop();
+
+    auto stats = g_suballocator.stats();
+    std::cout << "[Hook] Suballocator: " << stats.allocations << " allocs, hit rate " << stats.hitRate()
+              << ", RPCs saved " << stats.rpcsSaved()
+              << ", fragmentation internal " << stats.internalFragmentation()
+              << " / external " << stats.externalFragmentation() << std::endl;
+    g_suballocator.releaseAll();
+    g_state.drainAll(); // 等待slab的释放请求送达后再断开
+    g_state.shutdown();
+    
+    if (cudaModule) {
+        FreeLibrary(cudaModule);
+        cudaModule = nullptr;
+    }
+    
+    std::cout << "[Hook] Cleaned up" << std::endl;
+}
+
+static std::atomic<bool> g_shutdown{false};
+
+// 显式关闭入口（经hook_cuda.def导出）：卸载DLL（FreeLibrary）前由注入方在普通线程上调用
+extern "C" void HookShutdown() {
+    if (g_shutdown.exchange(true)) return;
+    CleanupHook();
+}
+
+// DllMain实现
+// DLL_PROCESS_DETACH持有加载器锁，不能发RPC或join线程；lpReserved非空表示进程正在退出，
+// 其余线程已被终止。未经HookShutdown清理时只放弃后台线程与连接，跳过静态析构中的拆除
+BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserved) {
+    switch (ul_reason_for_call) {
+    case DLL_PROCESS_ATTACH: 
+        InitializeHook(); 
+        break;
+    case DLL_PROCESS_DETACH: 
+        if (g_shutdown.exchange(true)) break;
+        if (lpReserved == nullptr) {
+            std::cerr << "[Hook] Unloaded without HookShutdown, abandoning launcher channels" << std::endl;
+        }
+        g_launch_batcher.abandon();
+        g_state.abandon();
+        break;
+    }
+    return TRUE;
+}
@@ -1,33 +1,39 @@
-#pragma once
-#include <cuda.h> // CUDA核心功能
-#include <optional> // C++17可选类型
-
-// 定义函数指针类型
-typedef CUresult (CUDAAPI *cuMemAlloc_t)(CUdeviceptr* dptr, size_t bytesize);
-typedef CUresult (CUDAAPI *cuMemFree_t)(CUdeviceptr dptr);
-typedef CUresult (CUDAAPI *cuMemcpyHtoD_t)(CUdeviceptr dstDevice, const void* srcHost, size_t ByteCount);
-typedef CUresult (CUDAAPI *cuMemcpyDtoH_t)(void* dstHost, CUdeviceptr srcDevice, size_t ByteCount);
-typedef CUresult (CUDAAPI *cuLaunchKernel_t)(
-    CUfunction f,
-    unsigned int gridDimX, unsigned int gridDimY, unsigned int gridDimZ,
-    unsigned int blockDimX, unsigned int blockDimY, unsigned int blockDimZ,
-    unsigned int sharedMemBytes, CUstream hStream,
-    void** kernelParams, void** extra);
-
-// 声明全局函数指针为extern
-// 声明全局函数指针（extern）
-extern cuMemAlloc_t pOriginal_cuMemAlloc;
-extern cuMemFree_t pOriginal_cuMemFree;
-extern cuMemcpyHtoD_t pOriginal_cuMemcpyHtoD;
-extern cuMemcpyDtoH_t pOriginal_cuMemcpyDtoH;
-extern cuLaunchKernel_t pOriginal_cuLaunchKernel;
-
-// Hook函数声明
-CUresult __stdcall Hooked_cuMemAlloc(CUdeviceptr* dev_ptr, size_t byte_size);
-CUresult __stdcall Hooked_cuMemFree(CUdeviceptr dptr);
-CUresult __stdcall Hooked_cuMemcpyHtoD(CUdeviceptr dstDevice, const void* srcHost, size_t ByteCount);
-CUresult __stdcall Hooked_cuMemcpyDtoH(void* dstHost, CUdeviceptr srcDevice, size_t ByteCount);
-CUresult __stdcall Hooked_cuLaunchKernel(CUfunction f,
-    unsigned int gridDimX, unsigned int gridDimY, unsigned int gridDimZ,
-    unsigned int blockDimX, unsigned int blockDimY, unsigned int blockDimZ,
-    unsigned int sharedMemBytes, CUstream hStream, void** kernelParams, void** extra);
+#pragma once
+#include <cuda.h> // CUDA核心功能
+#include <optional> // C++17可选类型
+
+// 定义函数指针类型
+typedef CUresult (CUDAAPI *cuMemAlloc_t)(CUdeviceptr* dptr, size_t bytesize);
+typedef CUresult (CUDAAPI *cuMemFree_t)(CUdeviceptr dptr);
+typedef CUresult (CUDAAPI *cuMemcpyHtoD_t)(CUdeviceptr dstDevice, const void* srcHost, size_t ByteCount);
+typedef CUresult (CUDAAPI *cuMemcpyDtoH_t)(void* dstHost, CUdeviceptr srcDevice, size_t ByteCount);
+typedef CUresult (CUDAAPI *cuLaunchKernel_t)(
+    CUfunction f,
+    unsigned int gridDimX, unsigned int gridDimY, unsigned int gridDimZ,
+    unsigned int blockDimX, unsigned int blockDimY, unsigned int blockDimZ,
+    unsigned int sharedMemBytes, CUstream hStream,
+    void** kernelParams, void** extra);
+typedef CUresult (CUDAAPI *cuCtxSynchronize_t)(void);
+typedef CUresult (CUDAAPI *cuStreamSynchronize_t)(CUstream hStream);
+
+// 声明全局函数指针为extern
+// 声明全局函数指针（extern）
+extern cuMemAlloc_t pOriginal_cuMemAlloc;
+extern cuMemFree_t pOriginal_cuMemFree;
+extern cuMemcpyHtoD_t pOriginal_cuMemcpyHtoD;
+extern cuMemcpyDtoH_t pOriginal_cuMemcpyDtoH;
+extern cuLaunchKernel_t pOriginal_cuLaunchKernel;
+extern cuCtxSynchronize_t pOriginal_cuCtxSynchronize;
+extern cuStreamSynchronize_t pOriginal_cuStreamSynchronize;
+
+// Hook函数声明
+CUresult __stdcall Hooked_cuMemAlloc(CUdeviceptr* dev_ptr, size_t byte_size);
+CUresult __stdcall Hooked_cuMemFree(CUdeviceptr dptr);
+CUresult __stdcall Hooked_cuMemcpyHtoD(CUdeviceptr dstDevice, const void* srcHost, size_t ByteCount);
+CUresult __stdcall Hooked_cuMemcpyDtoH(void* dstHost, CUdeviceptr srcDevice, size_t ByteCount);
+CUresult __stdcall Hooked_cuLaunchKernel(CUfunction f,
+    unsigned int gridDimX, unsigned int gridDimY, unsigned int gridDimZ,
+    unsigned int blockDimX, unsigned int blockDimY, unsigned int blockDimZ,
+    unsigned int sharedMemBytes, CUstream hStream, void** kernelParams, void** extra);
+CUresult __stdcall Hooked_cuCtxSynchronize(void);
+CUresult __stdcall Hooked_cuStreamSynchronize(CUstream hStream);
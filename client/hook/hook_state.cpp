@@ -0,0 +1,217 @@
+// 将文件保存为 UTF-8 编码以修复编码问题
+#include "pch.h" // 预编译头必须放在最前面
+#include "hook_state.h" // 当前模块专用头文件
+
+// 远程错误码转换为CUDA错误码
+static CUresult ToCuResult(ErrorCode code) {
+    switch (code) {
+    case ErrorCode::OK:                 return CUDA_SUCCESS;
+    case ErrorCode::OUT_OF_MEMORY:      return CUDA_ERROR_OUT_OF_MEMORY;
+    case ErrorCode::GPU_NOT_FOUND:      return CUDA_ERROR_NO_DEVICE;
+    case ErrorCode::KERNEL_LAUNCH_FAIL: return CUDA_ERROR_LAUNCH_FAILED;
+    default:                            return CUDA_ERROR_UNKNOWN;
+    }
+}
+
+HookState& HookState::Instance() {
+    static HookState instance;
+    return instance;
+}
+
+void HookState::initialize(const std::string& launcherAddress, size_t channelCount) {
+    if (channelCount == 0) {
+        channelCount = 1;
+    }
+    m_channels.reserve(channelCount);
+    for (size_t i = 0; i < channelCount; ++i) {
+        auto client = std::make_unique<LauncherClient>(launcherAddress);
+        client->connect();
+        m_channels.push_back(std::move(client));
+    }
+}
+
+void HookState::shutdown() {
+    for (auto& client : m_channels) {
+        client->disconnect();
+    }
+}
+
+void HookState::abandon() {
+    for (auto& client : m_channels) {
+        (void)client.release();
+    }
+    m_channels.clear();
+}
+
+// ===== 函数名映射 =====
+
+void HookState::registerFunction(CUfunction func, const char* name) {
+    std::lock_guard<std::mutex> lock(m_functionWriteMutex);
+    auto current = std::atomic_load_explicit(&m_functionNames, std::memory_order_acquire);
+    auto updated = std::make_shared<FunctionNameMap>(*current);
+    (*updated)[func] = name;
+    std::atomic_store_explicit(&m_functionNames,
+                               std::shared_ptr<const FunctionNameMap>(std::move(updated)),
+                               std::memory_order_release);
+    // 先发布快照再递增版本：读者看到新版本时必然能取到新快照
+    m_functionVersion.fetch_add(1, std::memory_order_release);
+}
+
+std::shared_ptr<const FunctionNameMap> HookState::functionNames() const {
+    return std::atomic_load_explicit(&m_functionNames, std::memory_order_acquire);
+}
+
+const std::string* HookState::functionName(CUfunction func) const {
+    // atomic_load共享指针要经过库内部的锁并修改共享的引用计数，每次启动都做会在线程间争用；
+    // 线程只在版本变化后重新取快照
+    struct Cached {
+        uint64_t version = ~uint64_t(0);
+        std::shared_ptr<const FunctionNameMap> names;
+    };
+    thread_local Cached cached;
+    uint64_t version = m_functionVersion.load(std::memory_order_acquire);
+    if (cached.version != version) {
+        cached.names = functionNames();
+        cached.version = version;
+    }
+    auto it = cached.names->find(func);
+    return it == cached.names->end() ? nullptr : &it->second;
+}
+
+// ===== 本地设备分配 =====
+
+void HookState::registerAllocation(CUdeviceptr base, size_t size) {
+    std::unique_lock<std::shared_mutex> lock(m_allocationMutex);
+    m_allocations[base] = size;
+}
+
+void HookState::unregisterAllocation(CUdeviceptr base) {
+    std::unique_lock<std::shared_mutex> lock(m_allocationMutex);
+    m_allocations.erase(base);
+}
+
+bool HookState::isDevicePointer(CUdeviceptr value) const {
+    return readAllocations().isDevicePointer(value);
+}
+
+bool HookState::AllocationReader::isDevicePointer(CUdeviceptr value) const {
+    auto it = m_allocations.upper_bound(value);
+    if (it == m_allocations.begin()) {
+        return false;
+    }
+    --it;
+    return value < it->first + it->second;
+}
+
+// ===== RPC通道 =====
+
+LauncherClient& HookState::channel() {
+    // 线程首次调用时轮询分配通道，此后固定使用
+    thread_local size_t index = m_nextChannel.fetch_add(1, std::memory_order_relaxed);
+    return *m_channels[index % m_channels.size()];
+}
+
+LauncherClient& HookState::channelFor(CUstream stream) {
+    auto key = reinterpret_cast<uintptr_t>(stream);
+    return *m_channels[(key >> 4) % m_channels.size()];
+}
+
+// ===== 异步操作与延迟错误 =====
+
+HookState::PendingShard& HookState::shardFor(CUstream stream) {
+    auto key = reinterpret_cast<uintptr_t>(stream);
+    return m_pending[(key >> 4) % kPendingShards];
+}
+
+CUresult HookState::collect(std::future<ErrorCode>& op) {
+    try {
+        return ToCuResult(op.get());
+    } catch (const std::exception& e) {
+        std::cerr << "[Hook] Async RPC failed: " << e.what() << std::endl;
+        return CUDA_ERROR_UNKNOWN;
+    }
+}
+
+void HookState::waitAll(std::vector<PendingOp>& ops) {
+    for (auto& op : ops) {
+        CUresult res = collect(op.result);
+        if (res != CUDA_SUCCESS) {
+            auto& shard = shardFor(op.stream);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.errors.emplace(op.stream, res); // 已有错误时保留先发生的
+        }
+    }
+    ops.clear();
+}
+
+CUresult HookState::takeError(CUstream stream) {
+    auto& shard = shardFor(stream);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.errors.find(stream);
+    if (it == shard.errors.end()) {
+        return CUDA_SUCCESS;
+    }
+    CUresult res = it->second;
+    shard.errors.erase(it);
+    return res;
+}
+
+void HookState::trackPendingOp(CUstream stream, std::future<ErrorCode>&& op) {
+    auto& shard = shardFor(stream);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.ops.size() >= kMaxPendingPerShard) {
+        auto done = std::remove_if(shard.ops.begin(), shard.ops.end(),
+            [&shard](PendingOp& pending) {
+                if (pending.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                    return false;
+                }
+                CUresult res = collect(pending.result);
+                if (res != CUDA_SUCCESS) {
+                    shard.errors.emplace(pending.stream, res);
+                }
+                return true;
+            });
+        shard.ops.erase(done, shard.ops.end());
+    }
+    shard.ops.push_back(PendingOp{stream, std::move(op)});
+}
+
+CUresult HookState::drainStream(CUstream stream) {
+    if (stream == nullptr) {
+        return drainAll();
+    }
+
+    // 只在分片锁内摘取该流的操作，等待时不持锁
+    std::vector<PendingOp> ops;
+    auto& shard = shardFor(stream);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto split = std::stable_partition(shard.ops.begin(), shard.ops.end(),
+            [stream](const PendingOp& op) { return op.stream != stream; });
+        std::move(split, shard.ops.end(), std::back_inserter(ops));
+        shard.ops.erase(split, shard.ops.end());
+    }
+    waitAll(ops);
+    return takeError(stream);
+}
+
+CUresult HookState::drainAll() {
+    for (auto& shard : m_pending) {
+        std::vector<PendingOp> ops;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            ops.swap(shard.ops);
+        }
+        waitAll(ops);
+    }
+    // 全局同步点返回任一流的错误，并清空各流已登记的错误
+    CUresult first = CUDA_SUCCESS;
+    for (auto& shard : m_pending) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& entry : shard.errors) {
+            if (first == CUDA_SUCCESS) first = entry.second;
+        }
+        shard.errors.clear();
+    }
+    return first;
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include "pch.h" // 预编译头必须放在最前面
+
+// 标准库
+#include <array>
+#include <atomic>
+#include <future>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 内核函数句柄 -> 内核名称
+using FunctionNameMap = std::unordered_map<CUfunction, std::string>;
+
+// Hook全局状态
+// 拦截入口不再共用一把进程级互斥锁：
+// - 函数名映射读多写少，写者复制后原子替换（RCU）；启动路径的读者在线程内缓存快照，版本不变时不触碰共享状态
+// - 每个线程固定使用一条独立的LauncherClient通道（各自的RPC线程与连接）
+// - 在途异步操作按流分片登记，同步点只锁相关分片
+class HookState {
+public:
+    static HookState& Instance();
+
+    void initialize(const std::string& launcherAddress, size_t channelCount);
+    void shutdown();
+    // 进程退出时调用：其他线程已被终止，有意泄漏各通道而不析构（析构会join RPC线程）
+    void abandon();
+
+    // ===== 函数名映射 =====
+    void registerFunction(CUfunction func, const char* name);
+    std::shared_ptr<const FunctionNameMap> functionNames() const;
+    // 启动热路径的查找：线程缓存快照，版本未变时不加锁也不增减引用计数。
+    // 返回的指针在本线程下次调用前有效，未注册时返回nullptr
+    const std::string* functionName(CUfunction func) const;
+
+    // ===== 本地设备分配（用于在本地判定内核参数是否为设备指针） =====
+    void registerAllocation(CUdeviceptr base, size_t size);
+    void unregisterAllocation(CUdeviceptr base);
+    bool isDevicePointer(CUdeviceptr value) const;
+
+    // 持有分配表读锁期间多次判定：内核参数打包时每次启动只加一次锁，而不是每个参数一次
+    class AllocationReader {
+    public:
+        bool isDevicePointer(CUdeviceptr value) const;
+
+    private:
+        friend class HookState;
+        explicit AllocationReader(const HookState& state)
+            : m_allocations(state.m_allocations), m_lock(state.m_allocationMutex) {}
+
+        const std::map<CUdeviceptr, size_t>& m_allocations;
+        std::shared_lock<std::shared_mutex> m_lock;
+    };
+    AllocationReader readAllocations() const { return AllocationReader(*this); }
+
+    // ===== RPC通道 =====
+    // 返回当前线程绑定的通道
+    LauncherClient& channel();
+    // 返回流绑定的通道，保证同一流上的请求在同一连接上按序到达
+    LauncherClient& channelFor(CUstream stream);
+
+    // ===== 异步操作与延迟错误 =====
+    void trackPendingOp(CUstream stream, std::future<ErrorCode>&& op);
+    // 等待指定流上的在途操作并返回该流的异步错误；空流（legacy默认流）与所有流同步
+    CUresult drainStream(CUstream stream);
+    // 等待全部在途操作并返回任一流上的异步错误
+    CUresult drainAll();
+
+private:
+    HookState() = default;
+
+    struct PendingOp {
+        CUstream stream;
+        std::future<ErrorCode> result;
+    };
+
+    struct alignas(64) PendingShard {
+        std::mutex mutex;
+        std::vector<PendingOp> ops;
+        std::unordered_map<CUstream, CUresult> errors; // 每流第一个尚未返回的异步错误
+    };
+
+    static constexpr size_t kPendingShards = 16;
+    static constexpr size_t kMaxPendingPerShard = 1024; // 超过时顺带回收已完成的操作
+
+    PendingShard& shardFor(CUstream stream);
+    static CUresult collect(std::future<ErrorCode>& op);
+    void waitAll(std::vector<PendingOp>& ops);
+    CUresult takeError(CUstream stream);
+
+    std::shared_ptr<const FunctionNameMap> m_functionNames = std::make_shared<FunctionNameMap>();
+    std::mutex m_functionWriteMutex; // 仅串行化写者
+    std::atomic<uint64_t> m_functionVersion{0}; // 每次发布新快照后递增
+
+    std::map<CUdeviceptr, size_t> m_allocations; // 基址 -> 大小
+    mutable std::shared_mutex m_allocationMutex;
+
+    std::vector<std::unique_ptr<LauncherClient>> m_channels;
+    std::atomic<size_t> m_nextChannel{0};
+
+    std::array<PendingShard, kPendingShards> m_pending;
+};
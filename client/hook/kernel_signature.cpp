@@ -0,0 +1,148 @@
+// 将文件保存为 UTF-8 编码以修复编码问题
+#include "pch.h" // 预编译头必须放在最前面
+#include "kernel_signature.h" // 当前模块专用头文件
+
+using json = nlohmann::json;
+
+// 按自然对齐（最大8字节）依次排布参数
+void KernelSignatureCache::assignOffsets(KernelSignature& signature) {
+    uint32_t offset = 0;
+    for (auto& param : signature.params) {
+        uint32_t align = std::min<uint32_t>(std::max<uint32_t>(param.size, 1), 8);
+        offset = (offset + align - 1) / align * align;
+        param.offset = offset;
+        offset += param.size;
+    }
+    signature.paramBytes = offset;
+}
+
+// 参数缓冲区大小取各参数末尾的最大值（描述文件与驱动给出的参数不一定按偏移排序），
+// 参数区间互相重叠时布局无效
+bool KernelSignatureCache::finishLayout(KernelSignature& signature) {
+    std::vector<const KernelParamInfo*> sorted;
+    sorted.reserve(signature.params.size());
+    signature.paramBytes = 0;
+    for (const auto& param : signature.params) {
+        sorted.push_back(&param);
+        signature.paramBytes = std::max(signature.paramBytes, param.offset + param.size);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const KernelParamInfo* a, const KernelParamInfo* b) {
+        return a->offset < b->offset;
+    });
+    for (size_t i = 1; i < sorted.size(); ++i) {
+        if (sorted[i - 1]->offset + sorted[i - 1]->size > sorted[i]->offset) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool KernelSignatureCache::loadDescriptor(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    bool valid = true;
+    try {
+        json j = json::parse(file);
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        for (auto it = j.begin(); it != j.end(); ++it) {
+            KernelSignature signature;
+            size_t withOffsets = 0;
+            for (const auto& param : it.value()) {
+                KernelParamInfo info;
+                info.size = param.at("size").get<uint32_t>();
+                std::string type = param.value("type", "");
+                if (type == "pointer") {
+                    info.cls = KernelParamClass::Pointer;
+                } else if (type == "scalar") {
+                    info.cls = KernelParamClass::Scalar;
+                }
+                if (param.contains("offset")) {
+                    info.offset = param["offset"].get<uint32_t>();
+                    ++withOffsets;
+                }
+                signature.params.push_back(info);
+            }
+            // 偏移要么全部给出，要么全部省略按自然对齐排布
+            bool ok = true;
+            if (withOffsets == 0) {
+                assignOffsets(signature);
+            } else {
+                ok = withOffsets == signature.params.size() && finishLayout(signature);
+            }
+            if (!ok) {
+                std::cerr << "[Hook] Invalid parameter offsets for kernel '" << it.key() << "' in " << path
+                          << " (missing or overlapping), ignored" << std::endl;
+                valid = false;
+                continue;
+            }
+            m_descriptors[it.key()] = std::move(signature);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[Hook] Failed to parse kernel signature descriptor " << path
+                  << ": " << e.what() << std::endl;
+        return false;
+    }
+    return valid;
+}
+
+// 通过cuFuncGetParamInfo逐个查询参数偏移与大小，越界时驱动返回CUDA_ERROR_INVALID_VALUE
+std::shared_ptr<KernelSignature> KernelSignatureCache::fromDriver(CUfunction func) const {
+    if (!m_paramInfoQuery) {
+        return nullptr;
+    }
+
+    auto signature = std::make_shared<KernelSignature>();
+    for (size_t index = 0;; ++index) {
+        size_t offset = 0;
+        size_t size = 0;
+        if (m_paramInfoQuery(func, index, &offset, &size) != CUDA_SUCCESS) {
+            break;
+        }
+        KernelParamInfo info;
+        info.offset = static_cast<uint32_t>(offset);
+        info.size = static_cast<uint32_t>(size);
+        signature->params.push_back(info);
+    }
+    if (!finishLayout(*signature)) {
+        return nullptr;
+    }
+    return signature;
+}
+
+std::shared_ptr<const KernelSignature> KernelSignatureCache::build(CUfunction func, const char* name) {
+    std::shared_ptr<KernelSignature> signature;
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        auto it = m_descriptors.find(name);
+        if (it != m_descriptors.end()) {
+            signature = std::make_shared<KernelSignature>(it->second);
+        }
+    }
+    if (!signature) {
+        signature = fromDriver(func);
+    }
+    if (!signature) {
+        std::cerr << "[Hook] No parameter info for kernel '" << name
+                  << "', only extra-form launches are supported; add it to kernel_signatures.json" << std::endl;
+        signature = std::make_shared<KernelSignature>();
+        signature->exact = false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto current = std::atomic_load_explicit(&m_signatures, std::memory_order_acquire);
+    auto updated = std::make_shared<SignatureMap>(*current);
+    (*updated)[func] = signature;
+    std::atomic_store_explicit(&m_signatures,
+                               std::shared_ptr<const SignatureMap>(std::move(updated)),
+                               std::memory_order_release);
+    return signature;
+}
+
+std::shared_ptr<const KernelSignature> KernelSignatureCache::lookup(CUfunction func) const {
+    auto signatures = std::atomic_load_explicit(&m_signatures, std::memory_order_acquire);
+    auto it = signatures->find(func);
+    return it != signatures->end() ? it->second : nullptr;
+}
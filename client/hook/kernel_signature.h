@@ -0,0 +1,125 @@
+#pragma once
+#include "pch.h" // 预编译头必须放在最前面
+
+// 标准库
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 参数类别：pointer/scalar可由描述文件给出；驱动只提供大小，8字节参数按值在本地判定
+enum class KernelParamClass : uint8_t {
+    Scalar,
+    Pointer,
+    Unknown
+};
+
+struct KernelParamInfo {
+    uint32_t offset = 0;                           // 在参数缓冲区中的偏移
+    uint32_t size = 0;                             // 参数字节数
+    KernelParamClass cls = KernelParamClass::Unknown;
+};
+
+// 内核签名：参数布局在每个CUfunction上只解析一次
+struct KernelSignature {
+    std::vector<KernelParamInfo> params;
+    uint32_t paramBytes = 0;                       // 参数缓冲区总大小
+    bool exact = true;                             // false表示布局未知，仅支持extra形式
+};
+
+typedef CUresult (CUDAAPI *cuFuncGetParamInfo_t)(CUfunction, size_t, size_t*, size_t*);
+
+// 内核签名缓存（以CUfunction为键）
+// 签名来源优先级：描述文件（按内核名）> cuFuncGetParamInfo；都没有时只接受extra形式的启动。
+// 读路径无锁：读者获取不可变快照，写者复制后原子替换。
+class KernelSignatureCache {
+public:
+    // 加载描述文件，格式：{"kernel": [{"size": 8, "type": "pointer"}, {"size": 4, "type": "scalar"}]}
+    // 可为每个参数给出"offset"（须全部给出且互不重叠），否则按自然对齐排布。
+    // 布局无效的内核被忽略并返回false，其余内核照常加载
+    bool loadDescriptor(const std::string& path);
+    void setParamInfoQuery(cuFuncGetParamInfo_t query) { m_paramInfoQuery = query; }
+
+    // 在cuModuleGetFunction成功后调用，解析并缓存签名
+    std::shared_ptr<const KernelSignature> build(CUfunction func, const char* name);
+    std::shared_ptr<const KernelSignature> lookup(CUfunction func) const;
+
+    // 按签名将kernelParams/extra序列化为紧凑参数缓冲区，并生成逐参数描述。
+    // 未知类别的8字节参数按是否落在已知设备分配内判定为指针。
+    template <typename IsDevicePtr>
+    static bool pack(const KernelSignature& signature, void** kernelParams, void** extra,
+                     IsDevicePtr&& isDevicePtr,
+                     std::vector<uint8_t>& buffer, std::vector<KernelParamDesc>& layout);
+
+private:
+    using SignatureMap = std::unordered_map<CUfunction, std::shared_ptr<const KernelSignature>>;
+
+    std::shared_ptr<KernelSignature> fromDriver(CUfunction func) const;
+    static void assignOffsets(KernelSignature& signature);
+    static bool finishLayout(KernelSignature& signature);
+
+    std::shared_ptr<const SignatureMap> m_signatures = std::make_shared<SignatureMap>();
+    std::unordered_map<std::string, KernelSignature> m_descriptors; // 按内核名
+    std::mutex m_writeMutex;
+    cuFuncGetParamInfo_t m_paramInfoQuery = nullptr;
+};
+
+template <typename IsDevicePtr>
+bool KernelSignatureCache::pack(const KernelSignature& signature, void** kernelParams, void** extra,
+                                IsDevicePtr&& isDevicePtr,
+                                std::vector<uint8_t>& buffer, std::vector<KernelParamDesc>& layout) {
+    // extra形式：参数已由应用打包为连续缓冲区
+    const uint8_t* packed = nullptr;
+    size_t packedSize = 0;
+    if (!kernelParams && extra) {
+        for (size_t i = 0; extra[i] != CU_LAUNCH_PARAM_END; i += 2) {
+            if (extra[i] == CU_LAUNCH_PARAM_BUFFER_POINTER) {
+                packed = static_cast<const uint8_t*>(extra[i + 1]);
+            } else if (extra[i] == CU_LAUNCH_PARAM_BUFFER_SIZE) {
+                packedSize = *static_cast<size_t*>(extra[i + 1]);
+            }
+        }
+        if (!packed) {
+            return false;
+        }
+    }
+
+    if (!signature.exact) {
+        // 布局未知：extra缓冲区自带长度，整体作为buffer发送（layout为空），由launcher按值判定指针；
+        // kernelParams数组既无长度也不保证以nullptr结尾，没有签名时无法安全读取
+        if (!packed) {
+            return false;
+        }
+        buffer.assign(packed, packed + packedSize);
+        layout.clear();
+        return true;
+    }
+
+    if (packed && packedSize < signature.paramBytes) {
+        return false;
+    }
+    if (!packed && !kernelParams && !signature.params.empty()) {
+        return false;
+    }
+
+    buffer.assign(signature.paramBytes, 0);
+    layout.clear();
+    layout.reserve(signature.params.size());
+
+    for (size_t i = 0; i < signature.params.size(); ++i) {
+        const auto& param = signature.params[i];
+        const void* src = packed ? packed + param.offset : kernelParams[i];
+        memcpy(buffer.data() + param.offset, src, param.size);
+
+        bool pointer = param.cls == KernelParamClass::Pointer;
+        if (param.cls == KernelParamClass::Unknown && param.size == sizeof(CUdeviceptr)) {
+            CUdeviceptr value;
+            memcpy(&value, src, sizeof(value));
+            pointer = isDevicePtr(value);
+        }
+        layout.push_back(KernelParamDesc{param.offset, param.size, pointer});
+    }
+    return true;
+}
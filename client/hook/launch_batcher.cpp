@@ -0,0 +1,144 @@
+// 将文件保存为 UTF-8 编码以修复编码问题
+#include "pch.h" // 预编译头必须放在最前面
+#include "launch_batcher.h" // 当前模块专用头文件
+
+LaunchBatcher::LaunchBatcher(HookState& state, const LaunchBatchConfig& config, BatchSender sender)
+    : m_state(state), m_config(config), m_sender(std::move(sender)) {
+    if (!m_sender) {
+        m_sender = [this](CUstream stream, std::vector<KernelLaunchDesc>&& launches) {
+            return m_state.channelFor(stream).launchKernelBatchAsync(reinterpret_cast<uint64_t>(stream),
+                                                                     std::move(launches));
+        };
+    }
+}
+
+LaunchBatcher::~LaunchBatcher() {
+    stop();
+}
+
+void LaunchBatcher::start() {
+    std::lock_guard<std::mutex> lock(m_timerMutex);
+    if (m_running) return;
+    m_running = true;
+    m_timer = std::thread(&LaunchBatcher::timerLoop, this);
+}
+
+void LaunchBatcher::stop() {
+    if (m_abandoned) return;
+    {
+        std::lock_guard<std::mutex> lock(m_timerMutex);
+        if (!m_running) return;
+        m_running = false;
+    }
+    m_timerCv.notify_all();
+    if (m_timer.joinable()) {
+        m_timer.join();
+    }
+    flushAll();
+}
+
+void LaunchBatcher::abandon() {
+    // 计时线程可能在持有锁时被终止，这里不再加锁
+    m_abandoned = true;
+    if (m_timer.joinable()) {
+        m_timer.detach();
+    }
+}
+
+LaunchBatcher::BatchShard& LaunchBatcher::shardFor(CUstream stream) {
+    auto key = reinterpret_cast<uintptr_t>(stream);
+    return m_shards[(key >> 4) % kBatchShards];
+}
+
+void LaunchBatcher::enqueue(CUstream stream, KernelLaunchDesc&& launch) {
+    auto& shard = shardFor(stream);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto& batch = shard.streams[stream];
+    bool opened = batch.launches.empty();
+    if (opened) {
+        batch.firstEnqueued = std::chrono::steady_clock::now();
+    }
+    batch.bytes += launch.params.size();
+    batch.launches.push_back(std::move(launch));
+
+    // 数量或字节阈值触发立即提交
+    if (batch.launches.size() >= m_config.maxLaunches || batch.bytes >= m_config.maxBytes) {
+        submit(stream, std::move(batch));
+        shard.streams.erase(stream);
+        if (!opened) m_openBatches.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+    if (opened && m_openBatches.fetch_add(1, std::memory_order_relaxed) == 0) {
+        notifyTimer();
+    }
+}
+
+void LaunchBatcher::notifyTimer() {
+    // 加锁后再通知，避免计时线程在检查计数与进入等待之间错过唤醒
+    std::lock_guard<std::mutex> lock(m_timerMutex);
+    m_timerCv.notify_one();
+}
+
+void LaunchBatcher::flush(CUstream stream) {
+    if (stream == nullptr) {
+        flushAll();
+        return;
+    }
+
+    auto& shard = shardFor(stream);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.streams.find(stream);
+    if (it == shard.streams.end()) return;
+    submit(stream, std::move(it->second));
+    shard.streams.erase(it);
+    m_openBatches.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void LaunchBatcher::flushAll() {
+    for (auto& shard : m_shards) {
+        flushShard(shard, false);
+    }
+}
+
+void LaunchBatcher::flushShard(BatchShard& shard, bool onlyExpired) {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (auto it = shard.streams.begin(); it != shard.streams.end();) {
+        if (onlyExpired && now - it->second.firstEnqueued < m_config.maxDelay) {
+            ++it;
+            continue;
+        }
+        submit(it->first, std::move(it->second));
+        it = shard.streams.erase(it);
+        m_openBatches.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void LaunchBatcher::submit(CUstream stream, StreamBatch&& batch) {
+    if (batch.launches.empty()) return;
+
+    m_state.trackPendingOp(stream, m_sender(stream, std::move(batch.launches)));
+}
+
+// 时间阈值：有缓冲批次时周期性提交等待过久的批次，没有时休眠到下一次入队
+void LaunchBatcher::timerLoop() {
+    auto period = std::max(m_config.maxDelay / 2, std::chrono::microseconds(50));
+    std::unique_lock<std::mutex> lock(m_timerMutex);
+    while (m_running) {
+        if (m_openBatches.load(std::memory_order_relaxed) == 0) {
+            m_timerCv.wait(lock, [this] {
+                return !m_running || m_openBatches.load(std::memory_order_relaxed) > 0;
+            });
+        } else {
+            m_timerCv.wait_for(lock, period);
+        }
+        if (!m_running) break;
+
+        lock.unlock();
+        for (auto& shard : m_shards) {
+            flushShard(shard, true);
+        }
+        lock.lock();
+    }
+}
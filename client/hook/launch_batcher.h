@@ -0,0 +1,80 @@
+#pragma once
+#include "pch.h" // 预编译头必须放在最前面
+#include "hook_state.h"
+
+// 标准库
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 内核启动批处理参数
+struct LaunchBatchConfig {
+    size_t maxLaunches = 64;                             // 单批最多内核数
+    size_t maxBytes = 256 * 1024;                        // 单批最大参数字节数
+    std::chrono::microseconds maxDelay{200};             // 首个内核入队后的最长等待时间
+};
+
+// 内核启动合并器
+// 同一流上连续的cuLaunchKernel先在本地缓冲，在以下时机合并为一次launchKernelBatch：
+// 同步点、内存拷贝/释放、数量或字节阈值、时间阈值（后台线程检查，无缓冲批次时休眠）。
+// 批次结果登记到HookState，错误在下一次同步调用时返回。
+class LaunchBatcher {
+public:
+    // 发送一个批次并返回其确认；默认经流绑定的通道发送launchKernelBatch
+    using BatchSender = std::function<std::future<ErrorCode>(CUstream, std::vector<KernelLaunchDesc>&&)>;
+
+    LaunchBatcher(HookState& state, const LaunchBatchConfig& config = LaunchBatchConfig(),
+                  BatchSender sender = nullptr);
+    ~LaunchBatcher();
+
+    void start();
+    void stop();
+    // 进程退出时调用：不join计时线程、不提交缓冲的内核，析构随之跳过
+    void abandon();
+
+    // 入队一次内核启动，必要时立即提交
+    void enqueue(CUstream stream, KernelLaunchDesc&& launch);
+
+    // 提交指定流上缓冲的内核；空流提交全部
+    void flush(CUstream stream);
+    void flushAll();
+
+private:
+    struct StreamBatch {
+        std::vector<KernelLaunchDesc> launches;
+        size_t bytes = 0;
+        std::chrono::steady_clock::time_point firstEnqueued;
+    };
+
+    struct alignas(64) BatchShard {
+        std::mutex mutex;
+        std::unordered_map<CUstream, StreamBatch> streams;
+    };
+
+    static constexpr size_t kBatchShards = 16;
+
+    BatchShard& shardFor(CUstream stream);
+    // 发送批次（调用方持有分片锁，保证同一流的批次按序交给RPC线程）
+    void submit(CUstream stream, StreamBatch&& batch);
+    void flushShard(BatchShard& shard, bool onlyExpired);
+    // 流上出现第一个缓冲的内核时唤醒计时线程
+    void notifyTimer();
+    void timerLoop();
+
+    HookState& m_state;
+    LaunchBatchConfig m_config;
+    BatchSender m_sender;
+    std::array<BatchShard, kBatchShards> m_shards;
+
+    std::thread m_timer;
+    std::mutex m_timerMutex;
+    std::condition_variable m_timerCv;
+    bool m_running = false;
+    std::atomic<size_t> m_openBatches{0}; // 缓冲中的（非空）流批次数，为0时计时线程休眠
+    bool m_abandoned = false; // 仅在DllMain及静态析构（同一线程）中访问
+};
@@ -1,91 +1,320 @@
-// 将文件保存为 UTF-8 编码以修复编码问题
-#include "pch.h" // 预编译头必须放在最前面
-#include "launcher_client.h" // 当前模块专用头文件
-
-LauncherClient::LauncherClient(const std::string& address) 
-    : m_address(address), m_client(nullptr) {}
-
-bool LauncherClient::connect() {
-    try {
-        m_rpcClient = std::make_unique<capnp::EzRpcClient>(m_address);
-        auto& waitScope = m_rpcClient->getWaitScope();
-        m_client = m_rpcClient->getMain<HookLauncher>();
-        return true;
-    } catch (const std::exception& e) {
-        KJ_LOG(ERROR, "Failed to connect to launcher", e.what());
-        return false;
-    }
-}
-
-AllocationPlan::Reader LauncherClient::requestAllocationPlan(uint64_t size) {
-    auto request = m_client.requestAllocationPlanRequest();
-    request.setSize(size);
-    auto response = request.send().wait(m_rpcClient->getWaitScope());
-    return response.getPlan();
-}
-
-ErrorCode LauncherClient::requestFreePlan(uint64_t fakePtr) {
-    auto request = m_client.requestFreePlanRequest();
-    request.setFakePtr(fakePtr);
-    auto response = request.send().wait(m_rpcClient->getWaitScope());
-    return static_cast<ErrorCode>(response.getAck().getCode());
-}
-
-MemcpyPlan::Reader LauncherClient::planMemcpyHtoD(uint64_t dstFakePtr, uint64_t size) {
-    auto request = m_client.planMemcpyHtoDRequest();
-    auto handle = request.initDstHandle();
-    handle.getId().setHandle(dstFakePtr);
-    request.setSize(size);
-    auto response = request.send().wait(m_rpcClient->getWaitScope());
-    return response.getPlan();
-}
-
-MemcpyPlan::Reader LauncherClient::planMemcpyDtoH(uint64_t srcFakePtr, uint64_t size) {
-    auto request = m_client.planMemcpyDtoHRequest();
-    auto handle = request.initSrcHandle();
-    handle.getId().setHandle(srcFakePtr);
-    request.setSize(size);
-    auto response = request.send().wait(m_rpcClient->getWaitScope());
-    return response.getPlan();
-}
-
-ErrorCode LauncherClient::launchKernel(const std::string& func, 
-                                      uint32_t gridDimX, 
-                                      uint32_t gridDimY,
-                                      uint32_t gridDimZ,
-                                      uint32_t blockDimX,
-                                      uint32_t blockDimY,
-                                      uint32_t blockDimZ,
-                                      uint32_t sharedMemBytes,
-                                      const void* params) {
-    auto request = m_client.launchKernelRequest();
-    request.setFunc(func);
-    request.setGridDimX(gridDimX);
-    request.setGridDimY(gridDimY);
-    request.setGridDimZ(gridDimZ);
-    request.setBlockDimX(blockDimX);
-    request.setBlockDimY(blockDimY);
-    request.setBlockDimZ(blockDimZ);
-    request.setSharedMemBytes(sharedMemBytes);
-    
-    // 正确设置参数数据
-    auto paramsBuilder = request.initParams(512); // 分配足够空间
-    memcpy(paramsBuilder.begin(), params, 512); // 实际使用时需要知道参数大小
-    auto response = request.send().wait(m_rpcClient->getWaitScope());
-    return static_cast<ErrorCode>(response.getAck().getCode());
-}
-
-// ===== 实现新增高级功能方法 =====
-NodeInfo::Reader LauncherClient::getMemoryLocation(uint64_t fakePtr) {
-    auto request = m_client.getMemoryLocationRequest();
-    request.setFakePtr(fakePtr);
-    auto response = request.send().wait(m_rpcClient->getWaitScope());
-    return response.getLocation();
-}
-
-ErrorCode LauncherClient::advisePrefetch(uint64_t fakePtr) {
-    auto request = m_client.advisePrefetchRequest();
-    request.setFakePtr(fakePtr);
-    auto response = request.send().wait(m_rpcClient->getWaitScope());
-    return static_cast<ErrorCode>(response.getAck().getCode());
-}
+// 将文件保存为 UTF-8 编码以修复编码问题
+#include "pch.h" // 预编译头必须放在最前面
+#include "launcher_client.h" // 当前模块专用头文件
+
+LauncherClient::LauncherClient(const std::string& address)
+    : m_address(address), m_client(nullptr) {}
+
+LauncherClient::~LauncherClient() {
+    disconnect();
+}
+
+bool LauncherClient::Connect(const std::string& address) {
+    m_address = address; // 更新地址
+    return connect(); // 调用现有的连接逻辑
+}
+
+// 启动RPC线程；不在此处等待连接完成，避免在DllMain持有加载器锁时阻塞
+bool LauncherClient::connect() {
+    if (m_rpcThread.joinable()) {
+        return true;
+    }
+    std::promise<bool> connected;
+    m_connected = connected.get_future().share();
+    m_rpcThread = std::thread(&LauncherClient::rpcThreadMain, this, std::move(connected));
+    return true;
+}
+
+// 不可在DllMain中调用：等待RPC线程退出需要加载器锁
+void LauncherClient::disconnect() {
+    if (!m_rpcThread.joinable()) {
+        return;
+    }
+    if (m_connected.get()) {
+        auto executor = currentExecutor();
+        if (executor != nullptr) {
+            try {
+                executor->executeSync([this]() { m_shutdown->fulfill(); });
+            } catch (const kj::Exception&) {
+                // 事件循环已自行退出
+            }
+        }
+    }
+    m_rpcThread.join();
+}
+
+kj::Own<const kj::Executor> LauncherClient::currentExecutor() {
+    std::lock_guard<std::mutex> lock(m_executorMutex);
+    return m_executor != nullptr ? m_executor->addRef() : kj::Own<const kj::Executor>();
+}
+
+void LauncherClient::rpcThreadMain(std::promise<bool> connected) {
+    bool signaled = false;
+    try {
+        m_rpcClient = std::make_unique<capnp::EzRpcClient>(m_address);
+        auto& waitScope = m_rpcClient->getWaitScope();
+        m_client = m_rpcClient->getMain<HookLauncher>();
+        {
+            std::lock_guard<std::mutex> lock(m_executorMutex);
+            m_executor = kj::getCurrentThreadExecutor().addRef();
+        }
+
+        auto paf = kj::newPromiseAndCrossThreadFulfiller<void>();
+        m_shutdown = kj::mv(paf.fulfiller);
+        connected.set_value(true);
+        signaled = true;
+
+        // 事件循环在此运行，直到disconnect()
+        paf.promise.wait(waitScope);
+    } catch (const kj::Exception& e) {
+        KJ_LOG(ERROR, "Launcher RPC thread failed", e.getDescription());
+    } catch (const std::exception& e) {
+        KJ_LOG(ERROR, "Launcher RPC thread failed", e.what());
+    }
+    if (!signaled) {
+        connected.set_value(false);
+    }
+
+    // 事件循环随EzRpcClient销毁，此后的submit直接失败
+    {
+        std::lock_guard<std::mutex> lock(m_executorMutex);
+        m_executor = nullptr;
+    }
+    m_shutdown = nullptr;
+    m_client = nullptr;
+    m_rpcClient.reset();
+}
+
+template <typename T, typename Func>
+std::future<T> LauncherClient::submit(Func&& func) {
+    auto result = std::make_shared<std::promise<T>>();
+    auto future = result->get_future();
+
+    if (!m_connected.valid() || !m_connected.get()) {
+        result->set_exception(std::make_exception_ptr(
+            std::runtime_error("launcher is not connected")));
+        return future;
+    }
+    auto executor = currentExecutor();
+    if (executor == nullptr) {
+        result->set_exception(std::make_exception_ptr(
+            std::runtime_error("launcher RPC thread has exited")));
+        return future;
+    }
+
+    m_inFlight.fetch_add(1, std::memory_order_relaxed);
+
+    // executeSync只等待请求被发出，不等待RPC往返。
+    // evalNow把func()抛出的异常转为失败的promise，计数与结果都经同一路径收尾
+    bool dispatched = false;
+    try {
+        executor->executeSync([this, result, &func, &dispatched]() {
+            dispatched = true;
+            kj::evalNow(kj::fwd<Func>(func)).then(
+                [result](T&& value) {
+                    result->set_value(std::move(value));
+                },
+                [result](kj::Exception&& e) {
+                    result->set_exception(std::make_exception_ptr(
+                        std::runtime_error(e.getDescription().cStr())));
+                })
+                .attach(kj::defer([this]() {
+                    m_inFlight.fetch_sub(1, std::memory_order_relaxed);
+                }))
+                .detach([](kj::Exception&&) {});
+        });
+    } catch (const kj::Exception& e) {
+        // 事件循环在投递前退出，请求未发出
+        if (!dispatched) {
+            m_inFlight.fetch_sub(1, std::memory_order_relaxed);
+            result->set_exception(std::make_exception_ptr(
+                std::runtime_error(e.getDescription().cStr())));
+        }
+    }
+    return future;
+}
+
+std::future<OwnedResult<AllocationPlan>> LauncherClient::requestAllocationPlanAsync(uint64_t size) {
+    return submit<OwnedResult<AllocationPlan>>([this, size]() {
+        auto request = m_client.requestAllocationPlanRequest();
+        request.setSize(size);
+        return request.send().then([](auto&& response) {
+            return OwnedResult<AllocationPlan>(response.getPlan());
+        });
+    });
+}
+
+std::future<ErrorCode> LauncherClient::requestFreePlanAsync(uint64_t fakePtr) {
+    return submit<ErrorCode>([this, fakePtr]() {
+        auto request = m_client.requestFreePlanRequest();
+        request.setFakePtr(fakePtr);
+        return request.send().then([](auto&& response) {
+            return static_cast<ErrorCode>(response.getAck().getCode());
+        });
+    });
+}
+
+std::future<OwnedResult<MemcpyPlan>> LauncherClient::planMemcpyHtoDAsync(uint64_t dstFakePtr, uint64_t size) {
+    return submit<OwnedResult<MemcpyPlan>>([this, dstFakePtr, size]() {
+        auto request = m_client.planMemcpyHtoDRequest();
+        auto handle = request.initDstHandle();
+        handle.getId().setHandle(dstFakePtr);
+        request.setSize(size);
+        return request.send().then([](auto&& response) {
+            return OwnedResult<MemcpyPlan>(response.getPlan());
+        });
+    });
+}
+
+std::future<OwnedResult<MemcpyPlan>> LauncherClient::planMemcpyDtoHAsync(uint64_t srcFakePtr, uint64_t size) {
+    return submit<OwnedResult<MemcpyPlan>>([this, srcFakePtr, size]() {
+        auto request = m_client.planMemcpyDtoHRequest();
+        auto handle = request.initSrcHandle();
+        handle.getId().setHandle(srcFakePtr);
+        request.setSize(size);
+        return request.send().then([](auto&& response) {
+            return OwnedResult<MemcpyPlan>(response.getPlan());
+        });
+    });
+}
+
+std::future<ErrorCode> LauncherClient::launchKernelAsync(const std::string& func,
+                                                         uint32_t gridDimX,
+                                                         uint32_t gridDimY,
+                                                         uint32_t gridDimZ,
+                                                         uint32_t blockDimX,
+                                                         uint32_t blockDimY,
+                                                         uint32_t blockDimZ,
+                                                         uint32_t sharedMemBytes,
+                                                         const void* params, size_t paramBytes) {
+    // 参数在调用线程上拷贝，调用返回后参数缓冲区即可被应用复用
+    auto paramCopy = std::make_shared<std::vector<uint8_t>>(
+        static_cast<const uint8_t*>(params), static_cast<const uint8_t*>(params) + paramBytes);
+
+    return submit<ErrorCode>([=]() {
+        auto request = m_client.launchKernelRequest();
+        request.setFunc(func);
+        request.setGridDimX(gridDimX);
+        request.setGridDimY(gridDimY);
+        request.setGridDimZ(gridDimZ);
+        request.setBlockDimX(blockDimX);
+        request.setBlockDimY(blockDimY);
+        request.setBlockDimZ(blockDimZ);
+        request.setSharedMemBytes(sharedMemBytes);
+        request.setParams(kj::arrayPtr(paramCopy->data(), paramCopy->size()));
+        return request.send().then([](auto&& response) {
+            return static_cast<ErrorCode>(response.getAck().getCode());
+        });
+    });
+}
+
+std::future<ErrorCode> LauncherClient::launchKernelBatchAsync(uint64_t stream,
+                                                              std::vector<KernelLaunchDesc>&& launches) {
+    auto batch = std::make_shared<std::vector<KernelLaunchDesc>>(std::move(launches));
+
+    return submit<ErrorCode>([this, stream, batch]() {
+        auto request = m_client.launchKernelBatchRequest();
+        auto batchBuilder = request.initRequest();
+        batchBuilder.setStream(stream);
+
+        auto requests = batchBuilder.initRequests(static_cast<unsigned int>(batch->size()));
+        for (size_t i = 0; i < batch->size(); ++i) {
+            const auto& desc = (*batch)[i];
+            auto launch = requests[i];
+            launch.setName(desc.func);
+            launch.setFuncHandle(desc.funcHandle);
+            launch.setGridX(desc.gridDimX);
+            launch.setGridY(desc.gridDimY);
+            launch.setGridZ(desc.gridDimZ);
+            launch.setBlockX(desc.blockDimX);
+            launch.setBlockY(desc.blockDimY);
+            launch.setBlockZ(desc.blockDimZ);
+            launch.setSharedMem(desc.sharedMemBytes);
+            launch.setStreamHandle(stream);
+            launch.setParamBytes(static_cast<uint32_t>(desc.params.size()));
+
+            if (desc.paramLayout.empty()) {
+                // 布局未知：参数以单个连续缓冲区传输
+                auto param = launch.initParams(1)[0];
+                param.setType(ParamType::BUFFER);
+                param.setValue(kj::arrayPtr(desc.params.data(), desc.params.size()));
+                continue;
+            }
+
+            // 按签名逐个参数传输，只发送实际字节
+            auto params = launch.initParams(static_cast<unsigned int>(desc.paramLayout.size()));
+            for (size_t p = 0; p < desc.paramLayout.size(); ++p) {
+                const auto& layout = desc.paramLayout[p];
+                auto param = params[p];
+                param.setType(layout.pointer ? ParamType::POINTER : ParamType::SCALAR);
+                param.setValue(kj::arrayPtr(desc.params.data() + layout.offset, layout.size));
+                param.setOffset(layout.offset);
+                param.setAlignment(static_cast<uint8_t>(std::min<uint32_t>(layout.size, 8)));
+            }
+        }
+
+        return request.send().then([](auto&& response) {
+            return static_cast<ErrorCode>(response.getAck().getCode());
+        });
+    });
+}
+
+std::future<OwnedResult<NodeInfo>> LauncherClient::getMemoryLocationAsync(uint64_t fakePtr) {
+    return submit<OwnedResult<NodeInfo>>([this, fakePtr]() {
+        auto request = m_client.getMemoryLocationRequest();
+        request.setFakePtr(fakePtr);
+        return request.send().then([](auto&& response) {
+            return OwnedResult<NodeInfo>(response.getLocation());
+        });
+    });
+}
+
+std::future<ErrorCode> LauncherClient::advisePrefetchAsync(uint64_t fakePtr) {
+    return submit<ErrorCode>([this, fakePtr]() {
+        auto request = m_client.advisePrefetchRequest();
+        request.setFakePtr(fakePtr);
+        return request.send().then([](auto&& response) {
+            return static_cast<ErrorCode>(response.getAck().getCode());
+        });
+    });
+}
+
+OwnedResult<AllocationPlan> LauncherClient::requestAllocationPlan(uint64_t size) {
+    return requestAllocationPlanAsync(size).get();
+}
+
+ErrorCode LauncherClient::requestFreePlan(uint64_t fakePtr) {
+    return requestFreePlanAsync(fakePtr).get();
+}
+
+OwnedResult<MemcpyPlan> LauncherClient::planMemcpyHtoD(uint64_t dstFakePtr, uint64_t size) {
+    return planMemcpyHtoDAsync(dstFakePtr, size).get();
+}
+
+OwnedResult<MemcpyPlan> LauncherClient::planMemcpyDtoH(uint64_t srcFakePtr, uint64_t size) {
+    return planMemcpyDtoHAsync(srcFakePtr, size).get();
+}
+
+ErrorCode LauncherClient::launchKernel(const std::string& func,
+                                      uint32_t gridDimX,
+                                      uint32_t gridDimY,
+                                      uint32_t gridDimZ,
+                                      uint32_t blockDimX,
+                                      uint32_t blockDimY,
+                                      uint32_t blockDimZ,
+                                      uint32_t sharedMemBytes,
+                                      const void* params, size_t paramBytes) {
+    return launchKernelAsync(func,
+                             gridDimX, gridDimY, gridDimZ,
+                             blockDimX, blockDimY, blockDimZ,
+                             sharedMemBytes, params, paramBytes).get();
+}
+
+// ===== 实现新增高级功能方法 =====
+OwnedResult<NodeInfo> LauncherClient::getMemoryLocation(uint64_t fakePtr) {
+    return getMemoryLocationAsync(fakePtr).get();
+}
+
+ErrorCode LauncherClient::advisePrefetch(uint64_t fakePtr) {
+    return advisePrefetchAsync(fakePtr).get();
+}
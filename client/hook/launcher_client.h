@@ -1,41 +1,125 @@
-#pragma once
-#include "pch.h" // 预编译头必须放在最前面
-
-// 项目特定头文件
-#include "hook-launcher.capnp.h"
-#include "common.capnp.h"
-
-// 第三方库
-#include <capnp/ez-rpc.h>
-
-// 标准库
-#include <memory>
-#include <string>
-#include <cstdint>
-
-class LauncherClient {
-public:
-    explicit LauncherClient(const std::string& address);
-    bool Connect(const std::string& address); // 修正为单参数Connect方法
-    bool connect();
-    
-    // HookLauncher接口实现
-    AllocationPlan::Reader requestAllocationPlan(uint64_t size);
-    ErrorCode requestFreePlan(uint64_t fakePtr);
-    MemcpyPlan::Reader planMemcpyHtoD(uint64_t dstFakePtr, uint64_t size);
-    MemcpyPlan::Reader planMemcpyDtoH(uint64_t srcFakePtr, uint64_t size);
-    ErrorCode launchKernel(const std::string& func, 
-                          uint32_t gridDimX, uint32_t gridDimY, uint32_t gridDimZ,
-                          uint32_t blockDimX, uint32_t blockDimY, uint32_t blockDimZ,
-                          uint32_t sharedMemBytes,
-                          const void* params);
-    
-    // ===== 新增高级功能方法 =====
-    NodeInfo::Reader getMemoryLocation(uint64_t fakePtr);
-    ErrorCode advisePrefetch(uint64_t fakePtr);
-    
-private:
-    std::string m_address;
-    std::unique_ptr<capnp::EzRpcClient> m_rpcClient;
-    HookLauncher::Client m_client{nullptr}; // 初始化客户端为nullptr
-};
+#pragma once
+#include "pch.h" // 预编译头必须放在最前面
+
+// 项目特定头文件
+#include "hook-launcher.capnp.h"
+#include "common.capnp.h"
+#include "cuda.capnp.h"
+
+// 第三方库
+#include <capnp/ez-rpc.h>
+#include <capnp/message.h>
+#include <kj/async.h>
+
+// 标准库
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// RPC结果的自有副本
+// capnp::Response只能在RPC线程上析构，跨线程返回前先拷贝到独立消息中
+template <typename T>
+class OwnedResult {
+public:
+    OwnedResult() = default;
+    explicit OwnedResult(typename T::Reader reader)
+        : m_message(std::make_shared<capnp::MallocMessageBuilder>()) {
+        m_message->setRoot(reader);
+    }
+
+    typename T::Reader get() const {
+        return m_message->getRoot<T>().asReader();
+    }
+
+private:
+    std::shared_ptr<capnp::MallocMessageBuilder> m_message;
+};
+
+// 单个内核参数在参数缓冲区中的位置与类别
+struct KernelParamDesc {
+    uint32_t offset = 0;
+    uint32_t size = 0;
+    bool pointer = false;
+};
+
+// 一次内核启动的本地描述（参数已在调用线程上拷贝）
+struct KernelLaunchDesc {
+    std::string func;
+    uint64_t funcHandle = 0;
+    uint32_t gridDimX = 1, gridDimY = 1, gridDimZ = 1;
+    uint32_t blockDimX = 1, blockDimY = 1, blockDimZ = 1;
+    uint32_t sharedMemBytes = 0;
+    std::vector<uint8_t> params;              // 按签名打包的参数缓冲区
+    std::vector<KernelParamDesc> paramLayout; // 逐参数描述，为空时整体作为buffer发送
+};
+
+class LauncherClient {
+public:
+    explicit LauncherClient(const std::string& address);
+    ~LauncherClient();
+
+    bool Connect(const std::string& address); // 修正为单参数Connect方法
+    bool connect();
+    void disconnect();
+
+    // ===== 异步接口 =====
+    // 请求在专用RPC线程上发出，同一连接上可同时挂起多个请求，
+    // 调用方只在真正需要结果（CUDA同步点）时才对future调用get()
+    std::future<OwnedResult<AllocationPlan>> requestAllocationPlanAsync(uint64_t size);
+    std::future<ErrorCode> requestFreePlanAsync(uint64_t fakePtr);
+    std::future<OwnedResult<MemcpyPlan>> planMemcpyHtoDAsync(uint64_t dstFakePtr, uint64_t size);
+    std::future<OwnedResult<MemcpyPlan>> planMemcpyDtoHAsync(uint64_t srcFakePtr, uint64_t size);
+    std::future<ErrorCode> launchKernelAsync(const std::string& func,
+                                             uint32_t gridDimX, uint32_t gridDimY, uint32_t gridDimZ,
+                                             uint32_t blockDimX, uint32_t blockDimY, uint32_t blockDimZ,
+                                             uint32_t sharedMemBytes,
+                                             const void* params, size_t paramBytes);
+    // 同一流上的多个内核启动合并为一次launchKernelBatch请求
+    std::future<ErrorCode> launchKernelBatchAsync(uint64_t stream, std::vector<KernelLaunchDesc>&& launches);
+    std::future<OwnedResult<NodeInfo>> getMemoryLocationAsync(uint64_t fakePtr);
+    std::future<ErrorCode> advisePrefetchAsync(uint64_t fakePtr);
+
+    // HookLauncher接口实现（同步版本，等价于异步版本后立即get()）
+    OwnedResult<AllocationPlan> requestAllocationPlan(uint64_t size);
+    ErrorCode requestFreePlan(uint64_t fakePtr);
+    OwnedResult<MemcpyPlan> planMemcpyHtoD(uint64_t dstFakePtr, uint64_t size);
+    OwnedResult<MemcpyPlan> planMemcpyDtoH(uint64_t srcFakePtr, uint64_t size);
+    ErrorCode launchKernel(const std::string& func,
+                          uint32_t gridDimX, uint32_t gridDimY, uint32_t gridDimZ,
+                          uint32_t blockDimX, uint32_t blockDimY, uint32_t blockDimZ,
+                          uint32_t sharedMemBytes,
+                          const void* params, size_t paramBytes);
+
+    // ===== 新增高级功能方法 =====
+    OwnedResult<NodeInfo> getMemoryLocation(uint64_t fakePtr);
+    ErrorCode advisePrefetch(uint64_t fakePtr);
+
+    // 当前在途（已发出未完成）的请求数
+    size_t inFlight() const { return m_inFlight.load(std::memory_order_relaxed); }
+
+private:
+    // 将请求投递到RPC线程，func在RPC线程上执行并返回kj::Promise<T>
+    template <typename T, typename Func>
+    std::future<T> submit(Func&& func);
+
+    void rpcThreadMain(std::promise<bool> connected);
+    // 取得RPC线程执行器的引用；事件循环已退出时为空
+    kj::Own<const kj::Executor> currentExecutor();
+
+    std::string m_address;
+    std::unique_ptr<capnp::EzRpcClient> m_rpcClient;
+    HookLauncher::Client m_client{nullptr}; // 初始化客户端为nullptr
+
+    // RPC线程：EzRpcClient及其事件循环都只在该线程上使用
+    std::thread m_rpcThread;
+    std::shared_future<bool> m_connected;
+    std::mutex m_executorMutex;
+    kj::Own<const kj::Executor> m_executor; // 事件循环退出前由RPC线程置空
+    kj::Own<kj::CrossThreadPromiseFulfiller<void>> m_shutdown;
+    std::atomic<size_t> m_inFlight{0};
+};
@@ -0,0 +1,204 @@
+// 将文件保存为 UTF-8 编码以修复编码问题
+#include "pch.h" // 预编译头必须放在最前面
+#include "sub_allocator.h" // 当前模块专用头文件
+
+SubAllocator::SubAllocator(const SubAllocatorConfig& config) : m_config(config) {
+    // 每个slab至少容纳一个最大块，且大小类数量有限
+    m_config.maxBlockSize = std::min(m_config.maxBlockSize, size_t(1) << (kMinBlockShift + kMaxClasses - 1));
+    m_config.slabSize = std::max(m_config.slabSize, m_config.maxBlockSize);
+    m_config.trimInterval = std::max<size_t>(m_config.trimInterval, 1);
+}
+
+SubAllocator::~SubAllocator() = default;
+
+void SubAllocator::setSource(SlabSource source) {
+    m_source = std::move(source);
+}
+
+size_t SubAllocator::classFor(size_t size) {
+    size_t index = 0;
+    while ((size_t(1) << (kMinBlockShift + index)) < size) ++index;
+    return index;
+}
+
+void SubAllocator::carve(Slab& slab, size_t size, CUdeviceptr* ptr) {
+    uint32_t index;
+    if (!slab.freeBlocks.empty()) {
+        index = slab.freeBlocks.back();
+        slab.freeBlocks.pop_back();
+    } else {
+        index = slab.bump++;
+    }
+    ++slab.used;
+    slab.requested[index] = size;
+    *ptr = slab.base + CUdeviceptr(index) * slab.blockSize;
+
+    m_blockBytes.fetch_add(slab.blockSize, std::memory_order_relaxed);
+    m_requestedBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+CUresult SubAllocator::allocate(size_t size, const SlabKey& key, CUdeviceptr* ptr) {
+    size_t classIndex = classFor(size);
+    SizeClass& sizeClass = m_classes[classIndex];
+    m_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        auto it = sizeClass.partial.find(key.packed());
+        if (it != sizeClass.partial.end() && !it->second.empty()) {
+            Slab* slab = it->second.back();
+            carve(*slab, size, ptr);
+            if (slab->freeBlocks.empty() && slab->bump == slab->blockCount) {
+                it->second.pop_back();
+                slab->inPartial = false;
+            }
+            m_cacheHits.fetch_add(1, std::memory_order_relaxed);
+            return CUDA_SUCCESS;
+        }
+    }
+
+    // 缓存未命中：不持锁申请新slab（一次RPC）
+    if (!m_source.acquire) {
+        m_allocations.fetch_sub(1, std::memory_order_relaxed);
+        return CUDA_ERROR_NOT_INITIALIZED;
+    }
+    CUdeviceptr base = 0;
+    CUresult res = m_source.acquire(m_config.slabSize, key, &base);
+    if (res != CUDA_SUCCESS) {
+        m_allocations.fetch_sub(1, std::memory_order_relaxed);
+        return res;
+    }
+
+    auto slab = std::make_unique<Slab>();
+    slab->base = base;
+    slab->key = key;
+    slab->classIndex = classIndex;
+    slab->blockSize = size_t(1) << (kMinBlockShift + classIndex);
+    slab->blockCount = static_cast<uint32_t>(m_config.slabSize / slab->blockSize);
+    slab->requested.assign(slab->blockCount, 0);
+    Slab* raw = slab.get();
+
+    m_slabsAcquired.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::unique_lock<std::shared_mutex> lock(m_slabMutex);
+        m_slabs.emplace(base, std::move(slab));
+    }
+
+    std::lock_guard<std::mutex> lock(sizeClass.mutex);
+    carve(*raw, size, ptr);
+    if (raw->bump < raw->blockCount) {
+        sizeClass.partial[key.packed()].push_back(raw);
+        raw->inPartial = true;
+    }
+    return CUDA_SUCCESS;
+}
+
+SubAllocator::Slab* SubAllocator::findSlab(CUdeviceptr ptr) const {
+    std::shared_lock<std::shared_mutex> lock(m_slabMutex);
+    auto it = m_slabs.upper_bound(ptr);
+    if (it == m_slabs.begin()) return nullptr;
+    --it;
+    if (ptr - it->first >= m_config.slabSize) return nullptr;
+    return it->second.get();
+}
+
+CUresult SubAllocator::free(CUdeviceptr ptr) {
+    Slab* slab = findSlab(ptr);
+    if (!slab) return CUDA_ERROR_NOT_FOUND;
+
+    {
+        std::lock_guard<std::mutex> lock(m_classes[slab->classIndex].mutex);
+        CUdeviceptr offset = ptr - slab->base;
+        uint32_t index = static_cast<uint32_t>(offset / slab->blockSize);
+        // 只接受块起始地址，且不可重复释放
+        if (offset % slab->blockSize != 0 || index >= slab->bump || slab->requested[index] == 0) {
+            return CUDA_ERROR_INVALID_VALUE;
+        }
+
+        m_blockBytes.fetch_sub(slab->blockSize, std::memory_order_relaxed);
+        m_requestedBytes.fetch_sub(slab->requested[index], std::memory_order_relaxed);
+        slab->requested[index] = 0;
+        slab->freeBlocks.push_back(index);
+        if (--slab->used == 0) {
+            slab->idleSince = std::chrono::steady_clock::now();
+        }
+        if (!slab->inPartial) {
+            m_classes[slab->classIndex].partial[slab->key.packed()].push_back(slab);
+            slab->inPartial = true;
+        }
+    }
+    m_frees.fetch_add(1, std::memory_order_relaxed);
+
+    if (m_freeCount.fetch_add(1, std::memory_order_relaxed) % m_config.trimInterval == 0) {
+        trim();
+    }
+    return CUDA_SUCCESS;
+}
+
+void SubAllocator::trim(bool force) {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<CUdeviceptr> idle;
+
+    for (SizeClass& sizeClass : m_classes) {
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        for (auto& [key, slabs] : sizeClass.partial) {
+            auto keep = std::partition(slabs.begin(), slabs.end(), [&](Slab* slab) {
+                return slab->used != 0 || (!force && now - slab->idleSince < m_config.idleTimeout);
+            });
+            for (auto it = keep; it != slabs.end(); ++it) {
+                (*it)->inPartial = false;
+                idle.push_back((*it)->base);
+            }
+            slabs.erase(keep, slabs.end());
+        }
+    }
+    if (idle.empty()) return;
+
+    {
+        std::unique_lock<std::shared_mutex> lock(m_slabMutex);
+        for (CUdeviceptr base : idle) {
+            m_slabs.erase(base);
+        }
+    }
+    // 归还涉及RPC，在锁外进行
+    for (CUdeviceptr base : idle) {
+        if (m_source.release) m_source.release(base, m_config.slabSize);
+        m_slabsReleased.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SubAllocator::releaseAll() {
+    std::vector<CUdeviceptr> bases;
+    for (SizeClass& sizeClass : m_classes) {
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        sizeClass.partial.clear();
+    }
+    {
+        std::unique_lock<std::shared_mutex> lock(m_slabMutex);
+        for (const auto& [base, slab] : m_slabs) {
+            bases.push_back(base);
+            m_blockBytes.fetch_sub(slab->used * slab->blockSize, std::memory_order_relaxed);
+            for (size_t requested : slab->requested) {
+                m_requestedBytes.fetch_sub(requested, std::memory_order_relaxed);
+            }
+        }
+        m_slabs.clear();
+    }
+    for (CUdeviceptr base : bases) {
+        if (m_source.release) m_source.release(base, m_config.slabSize);
+        m_slabsReleased.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SubAllocatorStats SubAllocator::stats() const {
+    SubAllocatorStats stats;
+    stats.allocations = m_allocations.load(std::memory_order_relaxed);
+    stats.frees = m_frees.load(std::memory_order_relaxed);
+    stats.cacheHits = m_cacheHits.load(std::memory_order_relaxed);
+    stats.slabsAcquired = m_slabsAcquired.load(std::memory_order_relaxed);
+    stats.slabsReleased = m_slabsReleased.load(std::memory_order_relaxed);
+    stats.slabBytes = (stats.slabsAcquired - stats.slabsReleased) * m_config.slabSize;
+    stats.blockBytes = m_blockBytes.load(std::memory_order_relaxed);
+    stats.requestedBytes = m_requestedBytes.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include "pch.h" // 预编译头必须放在最前面
+
+// 标准库
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+// 小块分配缓存参数
+struct SubAllocatorConfig {
+    size_t slabSize = 2 * 1024 * 1024;                   // 每次向Launcher申请的slab大小
+    size_t maxBlockSize = 256 * 1024;                    // 超过此大小的分配直接走远程分配
+    std::chrono::milliseconds idleTimeout{5000};         // 空闲slab保留时间，超时后归还
+    size_t trimInterval = 1024;                          // 每隔多少次释放检查一次空闲slab
+};
+
+// slab所属的池：目标节点与内存类型（取自AllocationPlan）
+struct SlabKey {
+    uint32_t nodeId = 0;
+    uint16_t memoryType = 0;
+
+    bool operator==(const SlabKey& other) const {
+        return nodeId == other.nodeId && memoryType == other.memoryType;
+    }
+    uint64_t packed() const { return (uint64_t(nodeId) << 16) | memoryType; }
+};
+
+// slab来源：acquire为指定的池申请整块设备内存，release将其归还
+struct SlabSource {
+    std::function<CUresult(size_t size, const SlabKey& key, CUdeviceptr* base)> acquire;
+    std::function<void(CUdeviceptr base, size_t size)> release;
+};
+
+struct SubAllocatorStats {
+    uint64_t allocations = 0;      // 由本地slab满足的分配
+    uint64_t frees = 0;            // 本地回收的释放
+    uint64_t cacheHits = 0;        // 无需申请新slab即满足的分配
+    uint64_t slabsAcquired = 0;
+    uint64_t slabsReleased = 0;
+    uint64_t slabBytes = 0;        // 当前持有的slab总字节
+    uint64_t blockBytes = 0;       // 当前已分出的块（按大小类取整）
+    uint64_t requestedBytes = 0;   // 当前已分出块的申请字节
+
+    double hitRate() const { return allocations ? double(cacheHits) / allocations : 0.0; }
+    // 大小类取整造成的浪费
+    double internalFragmentation() const {
+        return blockBytes ? 1.0 - double(requestedBytes) / blockBytes : 0.0;
+    }
+    // slab中未分出的部分
+    double externalFragmentation() const {
+        return slabBytes ? 1.0 - double(blockBytes) / slabBytes : 0.0;
+    }
+    // 每次本地分配/释放原本各需一次RPC，申请/归还slab各需一次
+    int64_t rpcsSaved() const {
+        return int64_t(allocations + frees) - int64_t(slabsAcquired + slabsReleased);
+    }
+};
+
+// Hook侧的小块分配缓存
+// 小于maxBlockSize的cuMemAlloc按2的幂大小类从本地slab切分，释放的块放回大小类空闲表复用，
+// 均不发RPC。每个slab只服务一个大小类，slab按(节点, 内存类型)分池；全部块释放后
+// 空闲超过idleTimeout的slab才归还。各大小类独立加锁，申请slab时不持有锁。
+// 析构不归还slab：静态析构可能发生在DllMain中，归还只在releaseAll中显式进行。
+class SubAllocator {
+public:
+    explicit SubAllocator(const SubAllocatorConfig& config = SubAllocatorConfig());
+    ~SubAllocator();
+
+    void setSource(SlabSource source);
+
+    // 是否由本缓存处理该大小的分配
+    bool accepts(size_t size) const { return size > 0 && size <= m_config.maxBlockSize; }
+    size_t slabSize() const { return m_config.slabSize; }
+
+    // 只从key对应的池中分配，池中无空闲块时为该池申请新slab
+    CUresult allocate(size_t size, const SlabKey& key, CUdeviceptr* ptr);
+    // ptr不属于任何slab时返回CUDA_ERROR_NOT_FOUND，由调用方按普通分配释放
+    CUresult free(CUdeviceptr ptr);
+
+    // 归还空闲超时的slab；force时归还全部空闲slab
+    void trim(bool force = false);
+    // 归还所有slab（由CleanupHook调用，仍在使用的块一并失效）
+    void releaseAll();
+
+    SubAllocatorStats stats() const;
+
+private:
+    static constexpr size_t kMinBlockShift = 8;          // 最小块256字节
+    static constexpr size_t kMaxClasses = 24;
+
+    struct Slab {
+        CUdeviceptr base = 0;
+        SlabKey key;
+        size_t classIndex = 0;
+        size_t blockSize = 0;
+        uint32_t blockCount = 0;
+        uint32_t bump = 0;                                // 尚未切分过的首个块
+        uint32_t used = 0;
+        std::vector<uint32_t> freeBlocks;                 // 释放后可复用的块
+        std::vector<size_t> requested;                    // 各块的申请大小，0表示空闲
+        std::chrono::steady_clock::time_point idleSince;
+        bool inPartial = false;
+    };
+
+    // 一个大小类的slab，按池分组
+    struct alignas(64) SizeClass {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, std::vector<Slab*>> partial;  // 池键 -> 尚有空闲块的slab
+    };
+
+    static size_t classFor(size_t size);
+    void carve(Slab& slab, size_t size, CUdeviceptr* ptr);
+    Slab* findSlab(CUdeviceptr ptr) const;
+
+    SubAllocatorConfig m_config;
+    SlabSource m_source;
+    std::array<SizeClass, kMaxClasses> m_classes;
+
+    // slab基址 -> slab，释放时按地址定位
+    std::map<CUdeviceptr, std::unique_ptr<Slab>> m_slabs;
+    mutable std::shared_mutex m_slabMutex;
+
+    std::atomic<uint64_t> m_freeCount{0};
+
+    // 统计
+    std::atomic<uint64_t> m_allocations{0};
+    std::atomic<uint64_t> m_frees{0};
+    std::atomic<uint64_t> m_cacheHits{0};
+    std::atomic<uint64_t> m_slabsAcquired{0};
+    std::atomic<uint64_t> m_slabsReleased{0};
+    std::atomic<uint64_t> m_blockBytes{0};
+    std::atomic<uint64_t> m_requestedBytes{0};
+};
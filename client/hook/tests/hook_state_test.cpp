@@ -0,0 +1,359 @@
+// Hook全局状态测试：函数名RCU快照（读者持有旧快照不受写者影响、并发读写）、本地分配区间判定
+// （内部指针、末尾边界、注销后）、按流登记的异步操作（只等待本流、保留首个错误、空流与全部流同步、
+// 超过分片上限时回收已完成操作），对比函数名查找在单锁映射与RCU快照下的多线程吞吐，
+// 以及N线程对假驱动混合执行分配/拷贝/内核启动时原全局锁实现与HookState的吞吐
+// 构建（在client/hook下，包含目录与链接库与Hook工程相同，不需要GPU与Launcher）：
+//   cl /std:c++17 /EHsc /O2 tests\hook_state_test.cpp hook_state.cpp launcher_client.cpp
+#include "pch.h" // 预编译头必须放在最前面
+#include "hook_state.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+CUfunction Func(uintptr_t id) { return reinterpret_cast<CUfunction>(id * 64); }
+CUstream Stream(uintptr_t id) { return reinterpret_cast<CUstream>(id * 16); }
+
+std::future<ErrorCode> Ready(ErrorCode code) {
+    std::promise<ErrorCode> promise;
+    promise.set_value(code);
+    return promise.get_future();
+}
+
+void testFunctionNames() {
+    HookState& state = HookState::Instance();
+    state.registerFunction(Func(1), "vectorAdd");
+    auto before = state.functionNames();
+    state.registerFunction(Func(2), "reduce");
+    state.registerFunction(Func(1), "vectorAdd_v2");
+
+    // 旧快照不变，新快照包含全部更新
+    CHECK(before->size() == 1 && before->at(Func(1)) == "vectorAdd");
+    auto after = state.functionNames();
+    CHECK(after->size() == 2 && after->at(Func(1)) == "vectorAdd_v2" && after->at(Func(2)) == "reduce");
+
+    // 线程缓存的快照在注册新函数后更新
+    CHECK(state.functionName(Func(3)) == nullptr);
+    state.registerFunction(Func(3), "scan");
+    const std::string* scan = state.functionName(Func(3));
+    CHECK(scan != nullptr && *scan == "scan" && *state.functionName(Func(1)) == "vectorAdd_v2");
+
+    constexpr int kWriters = 2;
+    constexpr int kPerWriter = 500;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::thread reader([&] {
+        while (!done.load()) {
+            auto names = state.functionNames();
+            auto it = names->find(Func(2));
+            if (it == names->end() || it->second != "reduce") ++torn;
+            const std::string* name = state.functionName(Func(2));
+            if (name == nullptr || *name != "reduce") ++torn;
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int w = 0; w < kWriters; ++w) {
+        writers.emplace_back([&, w] {
+            for (int i = 0; i < kPerWriter; ++i) {
+                state.registerFunction(Func(1000 + w * kPerWriter + i), "generated");
+            }
+        });
+    }
+    for (auto& writer : writers) writer.join();
+    done = true;
+    reader.join();
+    CHECK(torn == 0);
+    CHECK(state.functionNames()->size() == 3 + kWriters * kPerWriter);
+    CHECK(state.functionName(Func(1000 + kWriters * kPerWriter - 1)) != nullptr);
+}
+
+void testAllocations() {
+    HookState& state = HookState::Instance();
+    state.registerAllocation(0x10000, 0x1000);
+    state.registerAllocation(0x20000, 0x100);
+    CHECK(state.isDevicePointer(0x10000) && state.isDevicePointer(0x10FFF));
+    CHECK(!state.isDevicePointer(0x11000) && !state.isDevicePointer(0xFFFF));
+    CHECK(state.isDevicePointer(0x200FF) && !state.isDevicePointer(0x20100));
+    CHECK(!state.isDevicePointer(0));
+    {
+        auto allocations = state.readAllocations();
+        CHECK(allocations.isDevicePointer(0x10800) && allocations.isDevicePointer(0x20000));
+        CHECK(!allocations.isDevicePointer(0x11000));
+    }
+    state.unregisterAllocation(0x10000);
+    CHECK(!state.isDevicePointer(0x10800) && state.isDevicePointer(0x20000));
+    state.unregisterAllocation(0x20000);
+}
+
+void testPendingOps() {
+    HookState& state = HookState::Instance();
+    CUstream a = Stream(1);
+    CUstream b = Stream(2);
+    CUstream sameShard = Stream(1 + 16);   // 与a落在同一分片
+
+    // a上的同步不等待b上尚未完成的操作
+    std::promise<ErrorCode> slow;
+    state.trackPendingOp(b, slow.get_future());
+    state.trackPendingOp(a, Ready(ErrorCode::OK));
+    state.trackPendingOp(sameShard, Ready(ErrorCode::KERNEL_LAUNCH_FAIL));
+    auto drained = std::async(std::launch::async, [&] { return state.drainStream(a); });
+    CHECK(drained.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    CHECK(drained.get() == CUDA_SUCCESS);
+    CHECK(state.drainStream(sameShard) == CUDA_ERROR_LAUNCH_FAILED);
+    CHECK(state.drainStream(sameShard) == CUDA_SUCCESS);   // 错误只返回一次
+
+    // 同一流保留先发生的错误
+    state.trackPendingOp(a, Ready(ErrorCode::OUT_OF_MEMORY));
+    state.trackPendingOp(a, Ready(ErrorCode::GPU_NOT_FOUND));
+    CHECK(state.drainStream(a) == CUDA_ERROR_OUT_OF_MEMORY);
+
+    // 空流与所有流同步
+    slow.set_value(ErrorCode::KERNEL_LAUNCH_FAIL);
+    CHECK(state.drainStream(nullptr) == CUDA_ERROR_LAUNCH_FAILED);
+    CHECK(state.drainStream(b) == CUDA_SUCCESS);
+    CHECK(state.drainAll() == CUDA_SUCCESS);
+
+    // 分片积压时顺带回收已完成的操作，其错误仍在同步点返回
+    state.trackPendingOp(a, Ready(ErrorCode::GPU_NOT_FOUND));
+    for (int i = 0; i < 3000; ++i) state.trackPendingOp(a, Ready(ErrorCode::OK));
+    CHECK(state.drainStream(a) == CUDA_ERROR_NO_DEVICE);
+}
+
+// 原实现：所有拦截入口共用一把互斥锁查找函数名
+template <typename Lookup>
+double LookupsPerSecond(int threads, Lookup&& lookup) {
+    constexpr int kPerThread = 500000;
+    std::atomic<size_t> found{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            size_t hits = 0;
+            for (int i = 0; i < kPerThread; ++i) hits += lookup(Func(1000 + (i * 7 + t) % 1000));
+            found += hits;
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return found == size_t(threads) * kPerThread ? threads * kPerThread / seconds : 0.0;
+}
+
+void benchFunctionLookup() {
+    HookState& state = HookState::Instance();
+    std::mutex mutex;
+    FunctionNameMap locked(*state.functionNames());
+    for (int threads : {1, 4}) {
+        double before = LookupsPerSecond(threads, [&](CUfunction func) {
+            std::lock_guard<std::mutex> lock(mutex);
+            return locked.count(func);
+        });
+        double snapshot = LookupsPerSecond(threads, [&](CUfunction func) {
+            return state.functionNames()->count(func);
+        });
+        double cached = LookupsPerSecond(threads, [&](CUfunction func) {
+            return size_t(state.functionName(func) != nullptr);
+        });
+        std::printf("threads=%d  global lock %.2f M/s  atomic snapshot %.2f M/s  thread-cached snapshot %.2f M/s\n",
+                    threads, before / 1e6, snapshot / 1e6, cached / 1e6);
+    }
+}
+
+// 假驱动：同步调用（分配计划RPC、拷贝传输）阻塞固定时延，异步确认（释放、内核启动）立即就绪
+struct FakeDriver {
+    std::chrono::microseconds latency{0};
+
+    void call() const {
+        if (latency.count() != 0) std::this_thread::sleep_for(latency);
+    }
+    std::future<ErrorCode> ack() const { return Ready(ErrorCode::OK); }
+};
+
+constexpr int kResidentAllocations = 1000;
+CUdeviceptr Resident(int i) { return CUdeviceptr(1) << 36 | CUdeviceptr(i) << 20; }
+
+// 原实现：每个拦截入口在整个调用期间（含同步RPC与传输）持有g_api_mutex，同步点等待全部在途操作
+class GlobalLockHook {
+public:
+    explicit GlobalLockHook(const FakeDriver& driver) : m_driver(driver) {
+        m_names = *HookState::Instance().functionNames();
+        for (int i = 0; i < kResidentAllocations; ++i) m_allocations[Resident(i)] = 1 << 20;
+    }
+
+    void alloc(CUdeviceptr base, size_t size) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_driver.call();
+        m_allocations[base] = size;
+    }
+    void free(CUdeviceptr base) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_allocations.erase(base);
+        track(m_driver.ack());
+    }
+    bool copy(CUstream, CUdeviceptr dst) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        bool device = isDevicePointer(dst);
+        for (auto& op : m_pending) op.get();
+        m_pending.clear();
+        m_driver.call();
+        return device;
+    }
+    bool launch(CUstream, CUfunction func, const CUdeviceptr* params, int count) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        bool ok = m_names.count(func) != 0;
+        for (int i = 0; i < count; ++i) ok = isDevicePointer(params[i]) && ok;
+        track(m_driver.ack());
+        return ok;
+    }
+    void finish(CUstream) {}
+
+private:
+    bool isDevicePointer(CUdeviceptr value) const {
+        auto it = m_allocations.upper_bound(value);
+        if (it == m_allocations.begin()) return false;
+        --it;
+        return value < it->first + it->second;
+    }
+    void track(std::future<ErrorCode>&& op) {
+        if (m_pending.size() >= 1024) {
+            auto done = std::remove_if(m_pending.begin(), m_pending.end(), [](std::future<ErrorCode>& pending) {
+                return pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            });
+            m_pending.erase(done, m_pending.end());
+        }
+        m_pending.push_back(std::move(op));
+    }
+
+    const FakeDriver& m_driver;
+    std::mutex m_mutex;
+    FunctionNameMap m_names;
+    std::map<CUdeviceptr, size_t> m_allocations;
+    std::vector<std::future<ErrorCode>> m_pending;
+};
+
+// 现实现：函数名读RCU快照，分配表读写锁，在途操作按流分片，同步RPC与传输不持锁
+class ShardedHook {
+public:
+    explicit ShardedHook(const FakeDriver& driver) : m_driver(driver), m_state(HookState::Instance()) {
+        for (int i = 0; i < kResidentAllocations; ++i) m_state.registerAllocation(Resident(i), 1 << 20);
+    }
+    ~ShardedHook() {
+        for (int i = 0; i < kResidentAllocations; ++i) m_state.unregisterAllocation(Resident(i));
+    }
+
+    void alloc(CUdeviceptr base, size_t size) {
+        m_driver.call();
+        m_state.registerAllocation(base, size);
+    }
+    void free(CUdeviceptr base) {
+        m_state.unregisterAllocation(base);
+        m_state.trackPendingOp(nullptr, m_driver.ack());
+    }
+    bool copy(CUstream stream, CUdeviceptr dst) {
+        bool device = m_state.isDevicePointer(dst);
+        m_state.drainStream(stream);
+        m_driver.call();
+        return device;
+    }
+    bool launch(CUstream stream, CUfunction func, const CUdeviceptr* params, int count) {
+        bool ok = m_state.functionName(func) != nullptr;
+        {
+            auto allocations = m_state.readAllocations();
+            for (int i = 0; i < count; ++i) ok = allocations.isDevicePointer(params[i]) && ok;
+        }
+        m_state.trackPendingOp(stream, m_driver.ack());
+        return ok;
+    }
+    void finish(CUstream stream) { m_state.drainStream(stream); }
+
+private:
+    const FakeDriver& m_driver;
+    HookState& m_state;
+};
+
+// 每20次操作：1次分配（并释放上一次的分配）、3次拷贝（同步本流）、16次内核启动（4个指针参数）
+template <typename Hook>
+double MixedOpsPerSecond(Hook& hook, int threads, int perThread) {
+    std::atomic<int> wrong{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            CUstream stream = Stream(100 + t);
+            CUdeviceptr live = 0;
+            CUdeviceptr params[4];
+            for (int i = 0; i < perThread; ++i) {
+                int r = i % 20;
+                if (r == 0) {
+                    if (live != 0) hook.free(live);
+                    live = (CUdeviceptr(t + 1) << 40) | (CUdeviceptr(i) << 12);
+                    hook.alloc(live, 4096);
+                } else if (r < 4) {
+                    if (!hook.copy(stream, Resident((i * 13 + t) % kResidentAllocations) + 64)) ++wrong;
+                } else {
+                    for (int p = 0; p < 4; ++p) params[p] = Resident((i * 7 + p * 31 + t) % kResidentAllocations);
+                    if (!hook.launch(stream, Func(1000 + (i * 7 + t) % 1000), params, 4)) ++wrong;
+                }
+            }
+            if (live != 0) hook.free(live);
+            hook.finish(stream);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return wrong == 0 ? threads * perThread / seconds : 0.0;
+}
+
+void benchMixedContention() {
+    HookState& state = HookState::Instance();
+    for (int latencyUs : {0, 20}) {
+        FakeDriver driver;
+        driver.latency = std::chrono::microseconds(latencyUs);
+        int perThread = latencyUs == 0 ? 200000 : 4000;
+        for (int threads : {1, 2, 4, 8}) {
+            double before, after;
+            {
+                GlobalLockHook hook(driver);
+                before = MixedOpsPerSecond(hook, threads, perThread);
+            }
+            {
+                ShardedHook hook(driver);
+                after = MixedOpsPerSecond(hook, threads, perThread);
+            }
+            CHECK(before > 0 && after > 0);
+            std::printf("mixed driver=%2dus threads=%d  global lock %8.1f k/s  HookState %8.1f k/s\n", latencyUs,
+                        threads, before / 1e3, after / 1e3);
+        }
+    }
+    CHECK(state.drainAll() == CUDA_SUCCESS);
+    CHECK(!state.isDevicePointer(Resident(0)) && !state.isDevicePointer(CUdeviceptr(1) << 40));
+}
+}
+
+int main() {
+    testFunctionNames();
+    testAllocations();
+    testPendingOps();
+    benchFunctionLookup();
+    benchMixedContention();
+    if (g_failures) {
+        std::fprintf(stderr, "hook_state_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("hook_state_test: OK\n");
+    return 0;
+}
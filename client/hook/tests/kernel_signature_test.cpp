@@ -0,0 +1,202 @@
+// 内核签名缓存测试：描述文件（自然对齐排布、乱序的显式偏移按最大末尾计算参数区大小、重叠或部分缺失的偏移
+// 被拒绝且不影响其余内核）、cuFuncGetParamInfo（驱动给出的偏移、8字节参数按值判定指针、重叠布局退回）、
+// 两者都没有时只接受extra形式，以及各来源下kernelParams与extra两种形式的打包结果
+// 构建（在client/hook下，包含目录与链接库与Hook工程相同，不需要GPU与Launcher）：
+//   cl /std:c++17 /EHsc /O2 tests\kernel_signature_test.cpp kernel_signature.cpp launcher_client.cpp
+#include "pch.h" // 预编译头必须放在最前面
+#include "kernel_signature.h"
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+CUfunction Func(uintptr_t id) { return reinterpret_cast<CUfunction>(id * 64); }
+
+const char* kDescriptorPath = "kernel_signature_test.json";
+
+void WriteDescriptor(const char* text) {
+    std::ofstream file(kDescriptorPath, std::ios::trunc);
+    file << text;
+}
+
+// 驱动查询桩：按CUfunction返回(偏移, 大小)列表，越界时返回CUDA_ERROR_INVALID_VALUE
+std::map<CUfunction, std::vector<std::pair<size_t, size_t>>> g_driverParams;
+
+CUresult CUDAAPI FakeParamInfo(CUfunction func, size_t index, size_t* offset, size_t* size) {
+    auto it = g_driverParams.find(func);
+    if (it == g_driverParams.end() || index >= it->second.size()) {
+        return CUDA_ERROR_INVALID_VALUE;
+    }
+    *offset = it->second[index].first;
+    *size = it->second[index].second;
+    return CUDA_SUCCESS;
+}
+
+bool IsDevice(CUdeviceptr value) { return value >= 0x700000000000 && value < 0x700000100000; }
+
+struct Packed {
+    bool ok = false;
+    std::vector<uint8_t> buffer;
+    std::vector<KernelParamDesc> layout;
+};
+
+Packed Pack(const KernelSignature& signature, void** kernelParams, void** extra) {
+    Packed result;
+    result.ok = KernelSignatureCache::pack(signature, kernelParams, extra, IsDevice, result.buffer, result.layout);
+    return result;
+}
+
+template <typename T>
+T ReadAt(const std::vector<uint8_t>& buffer, size_t offset) {
+    T value;
+    std::memcpy(&value, buffer.data() + offset, sizeof(value));
+    return value;
+}
+
+bool SameDesc(const KernelParamDesc& desc, uint32_t offset, uint32_t size, bool pointer) {
+    return desc.offset == offset && desc.size == size && desc.pointer == pointer;
+}
+
+void testDescriptor() {
+    WriteDescriptor(R"({
+        "natural":  [{"size": 8, "type": "pointer"}, {"size": 4, "type": "scalar"}, {"size": 8}],
+        "reversed": [{"size": 4, "offset": 8, "type": "scalar"}, {"size": 8, "offset": 0, "type": "pointer"}],
+        "overlap":  [{"size": 8, "offset": 0}, {"size": 4, "offset": 4}],
+        "partial":  [{"size": 8, "offset": 0}, {"size": 4}]
+    })");
+    KernelSignatureCache cache;
+    // 两个无效内核被忽略，返回false，其余照常加载
+    CHECK(!cache.loadDescriptor(kDescriptorPath));
+
+    // 自然对齐：8字节指针、4字节标量补齐到8、未标注的8字节参数
+    auto natural = cache.build(Func(1), "natural");
+    CHECK(natural->exact && natural->params.size() == 3 && natural->paramBytes == 24);
+    CHECK(natural->params[1].offset == 8 && natural->params[2].offset == 16);
+
+    CUdeviceptr devicePtr = 0x700000000100;
+    int32_t scalar = -7;
+    CUdeviceptr unknown = 0x700000000200;
+    void* params[] = {&devicePtr, &scalar, &unknown};
+    Packed packed = Pack(*natural, params, nullptr);
+    CHECK(packed.ok && packed.buffer.size() == 24 && packed.layout.size() == 3);
+    CHECK(ReadAt<CUdeviceptr>(packed.buffer, 0) == devicePtr && ReadAt<int32_t>(packed.buffer, 8) == scalar);
+    CHECK(SameDesc(packed.layout[0], 0, 8, true) && SameDesc(packed.layout[1], 8, 4, false));
+    CHECK(SameDesc(packed.layout[2], 16, 8, true));   // 未知类别按值落在设备分配内
+    unknown = 42;
+    CHECK(!Pack(*natural, params, nullptr).layout[2].pointer);
+
+    // 显式偏移不按顺序时，参数区大小取最大末尾（12），而不是最后一项的末尾（8）
+    auto reversed = cache.build(Func(2), "reversed");
+    CHECK(reversed->exact && reversed->paramBytes == 12);
+    void* reversedParams[] = {&scalar, &devicePtr};
+    packed = Pack(*reversed, reversedParams, nullptr);
+    CHECK(packed.ok && packed.buffer.size() == 12);
+    CHECK(ReadAt<CUdeviceptr>(packed.buffer, 0) == devicePtr && ReadAt<int32_t>(packed.buffer, 8) == scalar);
+    CHECK(SameDesc(packed.layout[0], 8, 4, false) && SameDesc(packed.layout[1], 0, 8, true));
+
+    // extra形式按描述的偏移读取，缓冲区短于参数区时拒绝
+    uint8_t raw[12];
+    std::memcpy(raw, &devicePtr, 8);
+    std::memcpy(raw + 8, &scalar, 4);
+    size_t rawSize = sizeof(raw);
+    void* extra[] = {CU_LAUNCH_PARAM_BUFFER_POINTER, raw, CU_LAUNCH_PARAM_BUFFER_SIZE, &rawSize, CU_LAUNCH_PARAM_END};
+    packed = Pack(*reversed, nullptr, extra);
+    CHECK(packed.ok && std::memcmp(packed.buffer.data(), raw, sizeof(raw)) == 0 && packed.layout.size() == 2);
+    rawSize = 8;
+    CHECK(!Pack(*reversed, nullptr, extra).ok);
+
+    // 被拒绝的描述不生效：没有驱动查询时退回extra形式
+    for (const char* name : {"overlap", "partial"}) {
+        auto rejected = cache.build(Func(3), name);
+        CHECK(!rejected->exact && rejected->params.empty());
+    }
+    std::remove(kDescriptorPath);
+}
+
+void testDriverParamInfo() {
+    KernelSignatureCache cache;
+    cache.setParamInfoQuery(FakeParamInfo);
+    // 驱动按参数序号给出偏移，未必递增；参数区大小取最大末尾
+    g_driverParams[Func(10)] = {{0, 8}, {16, 4}, {8, 8}};
+    g_driverParams[Func(11)] = {{0, 8}, {4, 8}};       // 重叠
+    g_driverParams[Func(12)] = {};                     // 无参数
+
+    auto signature = cache.build(Func(10), "fromDriver");
+    CHECK(signature->exact && signature->params.size() == 3 && signature->paramBytes == 20);
+    CHECK(cache.lookup(Func(10)) == signature);
+
+    CUdeviceptr a = 0x700000000000;
+    int32_t n = 1024;
+    CUdeviceptr b = 5;
+    void* params[] = {&a, &n, &b};
+    Packed packed = Pack(*signature, params, nullptr);
+    CHECK(packed.ok && packed.buffer.size() == 20);
+    CHECK(ReadAt<CUdeviceptr>(packed.buffer, 0) == a && ReadAt<int32_t>(packed.buffer, 16) == n);
+    CHECK(ReadAt<CUdeviceptr>(packed.buffer, 8) == b);
+    // 驱动不给类别：8字节参数按值判定，4字节参数总是标量
+    CHECK(SameDesc(packed.layout[0], 0, 8, true) && SameDesc(packed.layout[1], 16, 4, false));
+    CHECK(SameDesc(packed.layout[2], 8, 8, false));
+
+    // 驱动给出的布局重叠时不采用，只接受extra形式
+    CHECK(!cache.build(Func(11), "overlapping")->exact);
+
+    auto empty = cache.build(Func(12), "noParams");
+    CHECK(empty->exact && empty->paramBytes == 0);
+    packed = Pack(*empty, nullptr, nullptr);
+    CHECK(packed.ok && packed.buffer.empty() && packed.layout.empty());
+
+    // 描述文件优先于驱动
+    WriteDescriptor(R"({"fromDriver": [{"size": 8, "type": "scalar"}]})");
+    CHECK(cache.loadDescriptor(kDescriptorPath));
+    auto described = cache.build(Func(13), "fromDriver");
+    CHECK(described->params.size() == 1 && described->params[0].cls == KernelParamClass::Scalar);
+    std::remove(kDescriptorPath);
+}
+
+void testExtraOnlyFallback() {
+    KernelSignatureCache cache;
+    CHECK(!cache.loadDescriptor("missing_kernel_signatures.json"));
+    auto signature = cache.build(Func(20), "unknownKernel");
+    CHECK(!signature->exact);
+
+    // kernelParams既无长度也无结尾标记，没有签名时拒绝
+    CUdeviceptr value = 0x700000000000;
+    void* params[] = {&value};
+    CHECK(!Pack(*signature, params, nullptr).ok);
+
+    // extra缓冲区按自带长度整体发送，不生成逐参数描述
+    uint8_t raw[20] = {1, 2, 3};
+    size_t rawSize = sizeof(raw);
+    void* extra[] = {CU_LAUNCH_PARAM_BUFFER_SIZE, &rawSize, CU_LAUNCH_PARAM_BUFFER_POINTER, raw, CU_LAUNCH_PARAM_END};
+    Packed packed = Pack(*signature, nullptr, extra);
+    CHECK(packed.ok && packed.buffer.size() == sizeof(raw) && packed.buffer[2] == 3 && packed.layout.empty());
+
+    // extra中没有缓冲区指针
+    void* noBuffer[] = {CU_LAUNCH_PARAM_BUFFER_SIZE, &rawSize, CU_LAUNCH_PARAM_END};
+    CHECK(!Pack(*signature, nullptr, noBuffer).ok);
+}
+}
+
+int main() {
+    testDescriptor();
+    testDriverParamInfo();
+    testExtraOnlyFallback();
+    if (g_failures) {
+        std::fprintf(stderr, "kernel_signature_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("kernel_signature_test: OK\n");
+    return 0;
+}
@@ -0,0 +1,220 @@
+// 内核启动合并器测试（记录批次的发送桩代替Launcher）：数量阈值与字节阈值立即提交、未达阈值的批次由
+// 计时线程在200us时间阈值后提交、各流分别成批、批次的异步错误在该流（及空流/全部流）的同步点返回一次，
+// 以及cuMemFree依赖的顺序：flushAll后drainAll要等到已提交批次确认才返回
+// 构建（在client/hook下，包含目录与链接库与Hook工程相同，不需要GPU与Launcher）：
+//   cl /std:c++17 /EHsc /O2 tests\launch_batcher_test.cpp launch_batcher.cpp hook_state.cpp launcher_client.cpp
+#include "pch.h" // 预编译头必须放在最前面
+#include "launch_batcher.h"
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+CUstream Stream(uintptr_t id) { return reinterpret_cast<CUstream>(id * 16); }
+
+KernelLaunchDesc Launch(size_t paramBytes) {
+    KernelLaunchDesc launch;
+    launch.func = "vectorAdd";
+    launch.params.resize(paramBytes);
+    return launch;
+}
+
+// 记录每个批次；确认由测试决定：立即以result完成，或hold时挂起直到release
+class RecordingSender {
+public:
+    struct Batch {
+        CUstream stream;
+        size_t launches;
+        size_t bytes;
+        std::chrono::steady_clock::time_point sent;
+    };
+
+    LaunchBatcher::BatchSender sender() {
+        return [this](CUstream stream, std::vector<KernelLaunchDesc>&& launches) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            size_t bytes = 0;
+            for (auto& launch : launches) bytes += launch.params.size();
+            m_batches.push_back({stream, launches.size(), bytes, std::chrono::steady_clock::now()});
+            std::promise<ErrorCode> ack;
+            auto future = ack.get_future();
+            if (hold) {
+                m_held.push_back(std::move(ack));
+            } else {
+                ack.set_value(result);
+            }
+            return future;
+        };
+    }
+
+    std::vector<Batch> batches() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_batches;
+    }
+
+    void release(ErrorCode code) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& ack : m_held) ack.set_value(code);
+        m_held.clear();
+    }
+
+    ErrorCode result = ErrorCode::OK;
+    bool hold = false;
+
+private:
+    std::mutex m_mutex;
+    std::vector<Batch> m_batches;
+    std::vector<std::promise<ErrorCode>> m_held;
+};
+
+// 不启动计时线程，只看阈值触发
+void testCountThreshold() {
+    RecordingSender recorder;
+    LaunchBatcher batcher(HookState::Instance(), LaunchBatchConfig(), recorder.sender());
+    CUstream a = Stream(1);
+    for (int i = 0; i < 63; ++i) batcher.enqueue(a, Launch(16));
+    CHECK(recorder.batches().empty());
+    batcher.enqueue(a, Launch(16));
+    auto batches = recorder.batches();
+    CHECK(batches.size() == 1 && batches[0].launches == 64 && batches[0].stream == a);
+
+    // 达到阈值后重新开始计数
+    for (int i = 0; i < 64 + 10; ++i) batcher.enqueue(a, Launch(16));
+    CHECK(recorder.batches().size() == 2);
+    batcher.flush(a);
+    batches = recorder.batches();
+    CHECK(batches.size() == 3 && batches[2].launches == 10);
+    batcher.flush(a);                     // 空流批次不发送
+    CHECK(recorder.batches().size() == 3);
+    CHECK(HookState::Instance().drainAll() == CUDA_SUCCESS);
+}
+
+void testByteThreshold() {
+    RecordingSender recorder;
+    LaunchBatchConfig config;
+    config.maxBytes = 4096;
+    LaunchBatcher batcher(HookState::Instance(), config, recorder.sender());
+    CUstream a = Stream(1);
+    CUstream b = Stream(2);
+    for (int i = 0; i < 3; ++i) batcher.enqueue(a, Launch(1000));
+    batcher.enqueue(b, Launch(1000));
+    CHECK(recorder.batches().empty());
+    batcher.enqueue(a, Launch(1096));     // 恰好达到4096字节
+    auto batches = recorder.batches();
+    CHECK(batches.size() == 1 && batches[0].stream == a && batches[0].launches == 4 && batches[0].bytes == 4096);
+
+    // 单个超过阈值的内核独自成批
+    batcher.enqueue(Stream(3), Launch(8192));
+    batches = recorder.batches();
+    CHECK(batches.size() == 2 && batches[1].launches == 1);
+
+    // 其他流的批次不受影响，flushAll时提交
+    batcher.flushAll();
+    batches = recorder.batches();
+    CHECK(batches.size() == 3 && batches[2].stream == b && batches[2].launches == 1);
+    CHECK(HookState::Instance().drainAll() == CUDA_SUCCESS);
+}
+
+// 未达阈值的批次在首个内核入队200us后由计时线程提交，不需要同步点
+void testTimerFlush() {
+    RecordingSender recorder;
+    LaunchBatcher batcher(HookState::Instance(), LaunchBatchConfig(), recorder.sender());
+    batcher.start();
+    CUstream a = Stream(1);
+    for (int round = 0; round < 3; ++round) {
+        auto enqueued = std::chrono::steady_clock::now();
+        batcher.enqueue(a, Launch(16));
+        batcher.enqueue(a, Launch(16));
+        auto deadline = enqueued + std::chrono::seconds(2);
+        while (recorder.batches().size() == size_t(round) && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+        auto batches = recorder.batches();
+        CHECK(batches.size() == size_t(round + 1));
+        if (batches.size() != size_t(round + 1)) break;
+        CHECK(batches[round].launches == 2);
+        CHECK(batches[round].sent - enqueued >= std::chrono::microseconds(200));
+        // 计时线程在没有缓冲批次时休眠，下一轮入队再唤醒
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        CHECK(recorder.batches().size() == size_t(round + 1));
+    }
+    batcher.stop();
+    CHECK(HookState::Instance().drainAll() == CUDA_SUCCESS);
+}
+
+// 批次失败不在enqueue时报告，而在之后的同步点返回一次
+void testDeferredErrors() {
+    HookState& state = HookState::Instance();
+    RecordingSender recorder;
+    LaunchBatcher batcher(state, LaunchBatchConfig(), recorder.sender());
+    CUstream a = Stream(1);
+    CUstream b = Stream(2);
+
+    recorder.result = ErrorCode::KERNEL_LAUNCH_FAIL;
+    batcher.enqueue(a, Launch(16));
+    batcher.flush(a);
+    recorder.result = ErrorCode::OK;
+    batcher.enqueue(b, Launch(16));
+    batcher.flush(b);
+    CHECK(state.drainStream(b) == CUDA_SUCCESS);
+    CHECK(state.drainStream(a) == CUDA_ERROR_LAUNCH_FAILED);
+    CHECK(state.drainStream(a) == CUDA_SUCCESS);
+
+    // 空流与全部流的同步点也返回其他流上的错误
+    recorder.result = ErrorCode::OUT_OF_MEMORY;
+    batcher.enqueue(b, Launch(16));
+    batcher.flushAll();
+    CHECK(state.drainStream(nullptr) == CUDA_ERROR_OUT_OF_MEMORY);
+    recorder.result = ErrorCode::GPU_NOT_FOUND;
+    batcher.enqueue(a, Launch(16));
+    batcher.flushAll();
+    CHECK(state.drainAll() == CUDA_ERROR_NO_DEVICE);
+    CHECK(state.drainAll() == CUDA_SUCCESS);
+}
+
+// cuMemFree的顺序保证：批次与释放请求走不同通道，flushAll后drainAll必须等到批次确认
+void testFlushThenDrainWaitsForAcks() {
+    HookState& state = HookState::Instance();
+    RecordingSender recorder;
+    recorder.hold = true;
+    LaunchBatcher batcher(state, LaunchBatchConfig(), recorder.sender());
+    batcher.enqueue(Stream(1), Launch(16));
+    batcher.enqueue(Stream(7), Launch(16));
+
+    auto freed = std::async(std::launch::async, [&] {
+        batcher.flushAll();
+        return state.drainAll();
+    });
+    CHECK(freed.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout);
+    CHECK(recorder.batches().size() == 2);
+    recorder.release(ErrorCode::KERNEL_LAUNCH_FAIL);
+    CHECK(freed.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    CHECK(freed.get() == CUDA_ERROR_LAUNCH_FAILED);
+}
+}
+
+int main() {
+    testCountThreshold();
+    testByteThreshold();
+    testTimerFlush();
+    testDeferredErrors();
+    testFlushThenDrainWaitsForAcks();
+    if (g_failures) {
+        std::fprintf(stderr, "launch_batcher_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("launch_batcher_test: OK\n");
+    return 0;
+}
@@ -0,0 +1,178 @@
+// 小块分配缓存测试：随机分配/释放的块互不重叠且落在所属slab内、块只取自请求的池、
+// 非法与重复释放被拒绝、全部释放后trim归还所有slab、析构不归还slab，并输出热路径耗时与RPC节省
+// 构建（在client/hook下，包含目录与Hook工程相同，不需要GPU）：
+//   cl /std:c++17 /EHsc /O2 tests\sub_allocator_test.cpp sub_allocator.cpp
+#include "pch.h" // 预编译头必须放在最前面
+#include "sub_allocator.h"
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+// 模拟的slab来源：顺序分配地址，记录每个slab所属的池
+struct FakeSource {
+    CUdeviceptr next = 0x10000000;
+    std::map<CUdeviceptr, std::pair<size_t, uint64_t>> slabs;     // 基址 -> (大小, 池键)
+    int acquired = 0;
+    int released = 0;
+
+    SlabSource source() {
+        return {[this](size_t size, const SlabKey& key, CUdeviceptr* base) {
+                    *base = next;
+                    next += size;
+                    slabs[*base] = {size, key.packed()};
+                    ++acquired;
+                    return CUresult(CUDA_SUCCESS);
+                },
+                [this](CUdeviceptr base, size_t) {
+                    slabs.erase(base);
+                    ++released;
+                }};
+    }
+
+    // ptr所在slab的池键，不在任何slab内时为UINT64_MAX
+    uint64_t poolOf(CUdeviceptr ptr, size_t size) const {
+        auto it = slabs.upper_bound(ptr);
+        if (it == slabs.begin()) return UINT64_MAX;
+        --it;
+        return ptr + size <= it->first + it->second.first ? it->second.second : UINT64_MAX;
+    }
+};
+
+const SlabKey kPools[] = {{1, 0}, {2, 0}, {2, 1}};
+
+void testRandom() {
+    SubAllocatorConfig config;
+    config.idleTimeout = std::chrono::milliseconds(0);
+    SubAllocator allocator(config);
+    FakeSource fake;
+    allocator.setSource(fake.source());
+
+    std::mt19937_64 rng(5);
+    std::vector<std::pair<CUdeviceptr, size_t>> live;
+    std::map<CUdeviceptr, CUdeviceptr> ranges;      // 起点 -> 终点
+    int overlaps = 0;
+    int wrongPool = 0;
+    for (int i = 0; i < 300000; ++i) {
+        bool alloc = live.size() < 2000 ? rng() % 3 != 0 : rng() % 3 == 0;
+        if (alloc || live.empty()) {
+            int bucket = static_cast<int>(rng() % 10);
+            size_t size = bucket < 6 ? 16 + rng() % 4096
+                        : bucket < 9 ? 4096 + rng() % 65536
+                                     : 65536 + rng() % (config.maxBlockSize - 65536);
+            const SlabKey& key = kPools[rng() % 3];
+            CUdeviceptr ptr = 0;
+            CHECK(allocator.allocate(size, key, &ptr) == CUDA_SUCCESS);
+            if (fake.poolOf(ptr, size) != key.packed()) ++wrongPool;
+            auto next = ranges.upper_bound(ptr);
+            if (next != ranges.end() && next->first < ptr + size) ++overlaps;
+            if (next != ranges.begin() && std::prev(next)->second > ptr) ++overlaps;
+            ranges[ptr] = ptr + size;
+            live.emplace_back(ptr, size);
+        } else {
+            size_t k = rng() % live.size();
+            ranges.erase(live[k].first);
+            CHECK(allocator.free(live[k].first) == CUDA_SUCCESS);
+            live[k] = live.back();
+            live.pop_back();
+        }
+    }
+    CHECK(overlaps == 0);
+    CHECK(wrongPool == 0);
+
+    // 不属于任何slab、非块起始地址、重复释放
+    CHECK(allocator.free(0x1) == CUDA_ERROR_NOT_FOUND);
+    CUdeviceptr ptr = live.back().first;
+    live.pop_back();
+    CHECK(allocator.free(ptr + 1) == CUDA_ERROR_INVALID_VALUE);
+    CHECK(allocator.free(ptr) == CUDA_SUCCESS);
+    CHECK(allocator.free(ptr) == CUDA_ERROR_INVALID_VALUE);
+
+    SubAllocatorStats stats = allocator.stats();
+    std::printf("allocs %llu  hit rate %.4f  internal %.3f  external %.3f  RPCs saved %lld\n",
+                static_cast<unsigned long long>(stats.allocations), stats.hitRate(),
+                stats.internalFragmentation(), stats.externalFragmentation(),
+                static_cast<long long>(stats.rpcsSaved()));
+    CHECK(stats.rpcsSaved() > 0);
+
+    for (auto [p, size] : live) CHECK(allocator.free(p) == CUDA_SUCCESS);
+    allocator.trim(true);
+    stats = allocator.stats();
+    CHECK(fake.slabs.empty());
+    CHECK(stats.slabsAcquired == stats.slabsReleased && stats.blockBytes == 0 && stats.requestedBytes == 0);
+}
+
+// 池中的空闲块不会分给其他池的请求
+void testPoolIsolation() {
+    SubAllocator allocator;
+    FakeSource fake;
+    allocator.setSource(fake.source());
+    CUdeviceptr a = 0;
+    CUdeviceptr b = 0;
+    CHECK(allocator.allocate(1024, kPools[0], &a) == CUDA_SUCCESS);
+    CHECK(allocator.free(a) == CUDA_SUCCESS);
+    CHECK(allocator.allocate(1024, kPools[1], &b) == CUDA_SUCCESS);
+    CHECK(fake.acquired == 2 && fake.poolOf(b, 1024) == kPools[1].packed());
+    CHECK(allocator.allocate(1024, kPools[0], &b) == CUDA_SUCCESS && b == a);
+    CHECK(fake.acquired == 2);
+}
+
+// 析构时不归还slab，只有releaseAll归还
+void testNoReleaseInDestructor() {
+    FakeSource fake;
+    {
+        SubAllocator allocator;
+        allocator.setSource(fake.source());
+        CUdeviceptr ptr = 0;
+        CHECK(allocator.allocate(4096, kPools[2], &ptr) == CUDA_SUCCESS);
+    }
+    CHECK(fake.acquired == 1 && fake.released == 0);
+
+    SubAllocator allocator;
+    allocator.setSource(fake.source());
+    CUdeviceptr ptr = 0;
+    CHECK(allocator.allocate(4096, kPools[2], &ptr) == CUDA_SUCCESS);
+    allocator.releaseAll();
+    CHECK(fake.released == 1);
+}
+
+void benchHotPath() {
+    SubAllocator allocator;
+    FakeSource fake;
+    allocator.setSource(fake.source());
+    constexpr int kOps = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kOps; ++i) {
+        CUdeviceptr ptr = 0;
+        allocator.allocate(1024, kPools[0], &ptr);
+        allocator.free(ptr);
+    }
+    std::printf("1 KiB alloc + free %.1f ns/op\n",
+                std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kOps);
+}
+}
+
+int main() {
+    testRandom();
+    testPoolIsolation();
+    testNoReleaseInDestructor();
+    benchHotPath();
+    if (g_failures) {
+        std::fprintf(stderr, "sub_allocator_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("sub_allocator_test: OK\n");
+    return 0;
+}
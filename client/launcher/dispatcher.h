@@ -1,79 +1,115 @@
-#pragma once
-
-#include <string>
-#include <vector>
-#include <mutex>
-#include <memory>
-#include <unordered_map>
-#include "launcher_client.h"  // 替换为新的客户端实现
-
-// 远程节点信息
-struct RemoteNode {
-    RemoteNode() = default;
-    
-    RemoteNode(std::string id, std::string name, std::string address, 
-               std::string roce_interface, int priority,
-               size_t total_memory, size_t available_memory,
-               double network_latency, double cpu_usage, 
-    double gpu_utilization, int numaId)
-        : id(std::move(id)), name(std::move(name)), address(std::move(address)),
-          roce_interface(std::move(roce_interface)), priority(priority),
-          total_memory(total_memory), available_memory(available_memory),
-          network_latency(network_latency), cpu_usage(cpu_usage),
-          gpu_utilization(gpu_utilization), numaId(numaId) {}
-    
-    std::string id;
-    std::string name;
-    std::string address;
-    std::string roce_interface;
-    int priority;
-    size_t total_memory;
-    size_t available_memory;
-    double network_latency;
-    double cpu_usage;
-    double gpu_utilization;
-    int numaId;  // NUMA节点标识符
-    uint16_t zmq_port;  // ZMQ数据传输端口
-    std::unique_ptr<LauncherClient> launcher_client;  // 更新为新的客户端类型
-};
-
-// 内存映射信息
-struct RemoteAllocInfo {
-    std::string node_id;
-    size_t size;
-    uint64_t remote_handle;
-};
-
-// 负载均衡调度器
-class Dispatcher {
-    std::vector<RemoteNode> nodes;
-    std::mutex mutex;
-    
-    // 内存映射表 (fake_ptr → allocation info)
-    std::unordered_map<uint64_t, RemoteAllocInfo> memory_map_;
-    
-    // 健康检查线程
-    std::thread health_check_thread_;
-    bool running_ = false;
-
-public:
-    Dispatcher();
-    ~Dispatcher();
-    
-    // 节点管理
-    void AddNode(RemoteNode&& node);
-    std::vector<RemoteNode>& GetNodes();
-    bool LoadConfig(const std::string& config_path);
-    RemoteNode* PickNode(size_t required_memory);  // 保持接口不变
-    RemoteNode* GetNodeById(const std::string& id);
-    RemoteNode* GetDefaultNode();
-    
-    // 内存映射管理
-    void AddMapping(uint64_t fake_ptr, const RemoteAllocInfo& info);
-    RemoteAllocInfo* GetMapping(uint64_t fake_ptr);
-    void RemoveMapping(uint64_t fake_ptr);
-    
-    // 健康检查
-    void StartHealthCheck();
-    void StopHealthCheck();
-};
+#pragma once
+
+#include <string>
+#include <deque>
+#include <functional>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include "launcher_client.h"  // 替换为新的客户端实现
+#include "memory/allocation_index.h"
+#include "node_selector.h"
+#include "topology/path_planner.h"
+
+// 远程节点信息。加入调度器后标识字段（下标、ID、地址、NUMA、客户端）不再改变，
+// 可经GetNode返回的指针直接读取；内存与负载等动态字段只在持有调度器mutex时读写
+struct RemoteNode {
+    RemoteNode() = default;
+    
+    RemoteNode(std::string id, std::string name, std::string address, 
+               std::string roce_interface, int priority,
+               size_t total_memory, size_t available_memory,
+               double network_latency, double cpu_usage, 
+    double gpu_utilization, int numaId)
+        : id(std::move(id)), name(std::move(name)), address(std::move(address)),
+          roce_interface(std::move(roce_interface)), priority(priority),
+          total_memory(total_memory), available_memory(available_memory),
+          network_latency(network_latency), cpu_usage(cpu_usage),
+          gpu_utilization(gpu_utilization), numaId(numaId) {}
+    
+    NodeIndex index = kInvalidNodeIndex;
+    std::string id;
+    std::string name;
+    std::string address;
+    std::string roce_interface;
+    int priority;
+    size_t total_memory;
+    size_t available_memory;
+    double network_latency;
+    double cpu_usage;
+    double gpu_utilization;
+    int numaId;  // NUMA节点标识符
+    uint16_t zmq_port;  // ZMQ数据传输端口
+    uint8_t capabilities = 0;  // NodeCapability位：rdma/nvlink/gdr
+    std::unique_ptr<LauncherClient> launcher_client;  // 更新为新的客户端类型
+};
+
+// 伪指针映射信息（全局内存服务另有按节点ID记录的RemoteAllocInfo）
+struct NodeAllocInfo {
+    NodeIndex node_index;
+    size_t size;
+    uint64_t remote_handle;
+};
+
+// 负载均衡调度器
+class Dispatcher {
+    std::deque<RemoteNode> nodes;        // 下标即NodeIndex；deque追加不移动已有元素，返回的指针长期有效
+    NodeSelector selector_;              // 节点指标随变更逐个更新，分配决策从中读取，不持有mutex
+    std::unordered_map<std::string, NodeIndex> node_ids;   // 配置ID → 下标，仅在非热路径使用
+    PathPlanner planner_;                // 传输路径规划，拓扑由LoadConfig发布
+    std::mutex mutex;
+    
+    // 内存映射表 (fake_ptr区间 → allocation info)
+    AllocationIndex<NodeAllocInfo> memory_map_;
+    
+    // 健康检查线程
+    std::thread health_check_thread_;
+    bool running_ = false;
+
+public:
+    Dispatcher();
+    ~Dispatcher();
+    
+    // 节点管理
+    void AddNode(RemoteNode&& node);
+    // 持有mutex依次访问各节点，fn不应再调用调度器
+    void ForEachNode(const std::function<void(const RemoteNode&)>& fn);
+    bool LoadConfig(const std::string& config_path);
+    RemoteNode* PickNode(uintptr_t ptr, size_t required_memory);
+    RemoteNode* GetNode(NodeIndex index);            // 下标访问
+    RemoteNode* GetNodeById(const std::string& id);  // 按配置ID查找
+    NodeIndex GetNodeIndex(const std::string& id);
+    // 更新节点的动态指标（同时刷新节点表）
+    void UpdateNodeMetrics(NodeIndex index, size_t available_memory, double network_latency,
+                           double cpu_usage, double gpu_utilization);
+    
+    // 内存映射管理
+    // 以[fake_ptr, fake_ptr+info.size)登记，与已有区间重叠时返回false
+    bool AddMapping(uint64_t fake_ptr, const NodeAllocInfo& info);
+    // fake_ptr可为分配内部地址，offset返回相对分配起点的偏移；返回副本，不受并发删除影响
+    std::optional<NodeAllocInfo> GetMapping(uint64_t fake_ptr, size_t* offset = nullptr) const;
+    // 原子地删除并返回以fake_ptr为起点的映射，并发释放同一地址时只有一方成功
+    std::optional<NodeAllocInfo> TakeMapping(uint64_t fake_ptr);
+    void RemoveMapping(uint64_t fake_ptr);
+    
+    // 分配决策
+    AllocationPlan makeAllocationDecision(uintptr_t ptr, size_t size, int current_numa);
+
+    // 传输路径规划，设备ID见TopologyGraph::HostId/GpuId
+    TransferPlan PlanTransfer(const std::string& src_device, const std::string& dst_device, uint64_t size) {
+        return planner_.Plan(src_device, dst_device, size);
+    }
+    PathPlanner& GetPathPlanner() { return planner_; }
+
+    // 健康检查
+    void StartHealthCheck();
+    void StopHealthCheck();
+
+    void SetSelectionPolicy(NodeSelectionPolicy policy) { selector_.SetPolicy(policy); }
+
+private:
+    // 调用方持有mutex。重复ID只更新已有节点的配置值
+    void InsertNode(RemoteNode&& node);
+};
@@ -1,74 +1,115 @@
-#include "launcher_client.h"
-#include <kj/debug.h>
-#include <capnp/message.h>
-#include <capnp/serialize.h>
-#include <stdexcept>
-
-LauncherClient::LauncherClient(const std::string& address) 
-    : m_address(address) {}
-
-bool LauncherClient::Connect(const std::string& address) {
-    m_address = address; // 更新地址
-    return connect(); // 调用现有的连接逻辑
-}
-
-bool LauncherClient::connect() {
-    try {
-        m_rpcClient = std::make_unique<capnp::EzRpcClient>(m_address);
-        auto& waitScope = m_rpcClient->getWaitScope();
-        m_client = m_rpcClient->getMain<hook_launcher::HookLauncher>();
-        return true;
-    } catch (const std::exception& e) {
-        KJ_LOG(ERROR, "Failed to connect to launcher", e.what());
-        return false;
-    }
-}
-
-hook_launcher::AllocationResult::Reader LauncherClient::requestAllocation(uint64_t size) {
-    auto request = m_client.requestAllocationRequest();
-    request.setSize(size);
-    auto response = request.send().wait(m_rpcClient->getWaitScope());
-    return response.getResult();
-}
-
-common::ErrorCode LauncherClient::requestFree(uint64_t fakePtr) {
-    auto request = m_client.requestFreeRequest();
-    request.setFakePtr(fakePtr);
-    auto response = request.send().wait(m_rpcClient->getWaitScope());
-    return response.getResult();
-}
-
-hook_launcher::MemcpyPlan::Reader LauncherClient::planMemcpyHtoD(uint64_t dstFakePtr, uint64_t size) {
-    auto request = m_client.planMemcpyHtoDRequest();
-    request.setDstFakePtr(dstFakePtr);
-    request.setSize(size);
-    auto response = request.send().wait(m_rpcClient->getWaitScope());
-    return response.getPlan();
-}
-
-hook_launcher::MemcpyPlan::Reader LauncherClient::planMemcpyDtoH(uint64_t srcFakePtr, uint64_t size) {
-    auto request = m_client.planMemcpyDtoHRequest();
-    request.setSrcFakePtr(srcFakePtr);
-    request.setSize(size);
-    auto response = request.send().wait(m_rpcClient->getWaitScope());
-    return response.getPlan();
-}
-
-common::ErrorCode LauncherClient::launchKernel(const std::string& func, 
-                                              uint32_t gridDim, 
-                                              uint32_t blockDim,
-                                              uint32_t sharedMem,
-                                              const void* params) {
-    auto request = m_client.launchKernelRequest();
-    request.setFunc(func);
-    request.setGridDim(gridDim);
-    request.setBlockDim(blockDim);
-    request.setSharedMem(sharedMem);
-    
-    // 正确设置参数数据
-    auto paramsBuilder = request.initParams(512); // 分配足够空间
-    memcpy(paramsBuilder.begin(), params, 512); // 实际使用时需要知道参数大小
-    
-    auto response = request.send().wait(m_rpcClient->getWaitScope());
-    return response.getResult();
-}
+#include "launcher_client.h"
+#include <kj/debug.h>
+#include <capnp/message.h>
+#include <capnp/serialize.h>
+#include <stdexcept>
+
+LauncherClient::LauncherClient(const std::string& address) 
+    : m_address(address) {}
+
+bool LauncherClient::Connect(const std::string& address) {
+    m_address = address; // 更新地址
+    return connect(); // 调用现有的连接逻辑
+}
+
+bool LauncherClient::connect() {
+    try {
+        m_rpcClient = std::make_unique<capnp::EzRpcClient>(m_address);
+        auto& waitScope = m_rpcClient->getWaitScope();
+        m_client = m_rpcClient->getMain<hook_launcher::HookLauncher>();
+        return true;
+    } catch (const std::exception& e) {
+        KJ_LOG(ERROR, "Failed to connect to launcher", e.what());
+        return false;
+    }
+}
+
+kj::Promise<capnp::Response<hook_launcher::HookLauncher::RequestAllocationResults>>
+LauncherClient::requestAllocationAsync(uint64_t size) {
+    auto request = m_client.requestAllocationRequest();
+    request.setSize(size);
+    return request.send();
+}
+
+kj::Promise<common::ErrorCode> LauncherClient::requestFreeAsync(uint64_t fakePtr) {
+    auto request = m_client.requestFreeRequest();
+    request.setFakePtr(fakePtr);
+    return request.send().then([](auto&& response) {
+        return response.getResult();
+    });
+}
+
+kj::Promise<capnp::Response<hook_launcher::HookLauncher::PlanMemcpyHtoDResults>>
+LauncherClient::planMemcpyHtoDAsync(uint64_t dstFakePtr, uint64_t size) {
+    auto request = m_client.planMemcpyHtoDRequest();
+    request.setDstFakePtr(dstFakePtr);
+    request.setSize(size);
+    return request.send();
+}
+
+kj::Promise<capnp::Response<hook_launcher::HookLauncher::PlanMemcpyDtoHResults>>
+LauncherClient::planMemcpyDtoHAsync(uint64_t srcFakePtr, uint64_t size) {
+    auto request = m_client.planMemcpyDtoHRequest();
+    request.setSrcFakePtr(srcFakePtr);
+    request.setSize(size);
+    return request.send();
+}
+
+kj::Promise<common::ErrorCode> LauncherClient::launchKernelAsync(const std::string& func,
+                                                                 uint32_t gridDim,
+                                                                 uint32_t blockDim,
+                                                                 uint32_t sharedMem,
+                                                                 const void* params) {
+    auto request = m_client.launchKernelRequest();
+    request.setFunc(func);
+    request.setGridDim(gridDim);
+    request.setBlockDim(blockDim);
+    request.setSharedMem(sharedMem);
+    
+    // 正确设置参数数据
+    auto paramsBuilder = request.initParams(512); // 分配足够空间
+    memcpy(paramsBuilder.begin(), params, 512); // 实际使用时需要知道参数大小
+    
+    return request.send().then([](auto&& response) {
+        return response.getResult();
+    });
+}
+
+kj::Promise<common::ErrorCode> LauncherClient::launchKernelBatchAsync(BatchKernelLaunch::Reader batch) {
+    auto request = m_client.launchKernelBatchRequest();
+    request.setRequest(batch);
+    return request.send().then([](auto&& response) {
+        return response.getAck().getCode();
+    });
+}
+
+// ===== 同步版本 =====
+// 注意：返回的Reader指向的响应在函数返回时即被释放，新代码应使用异步接口
+
+hook_launcher::AllocationResult::Reader LauncherClient::requestAllocation(uint64_t size) {
+    auto response = requestAllocationAsync(size).wait(m_rpcClient->getWaitScope());
+    return response.getResult();
+}
+
+common::ErrorCode LauncherClient::requestFree(uint64_t fakePtr) {
+    return requestFreeAsync(fakePtr).wait(m_rpcClient->getWaitScope());
+}
+
+hook_launcher::MemcpyPlan::Reader LauncherClient::planMemcpyHtoD(uint64_t dstFakePtr, uint64_t size) {
+    auto response = planMemcpyHtoDAsync(dstFakePtr, size).wait(m_rpcClient->getWaitScope());
+    return response.getPlan();
+}
+
+hook_launcher::MemcpyPlan::Reader LauncherClient::planMemcpyDtoH(uint64_t srcFakePtr, uint64_t size) {
+    auto response = planMemcpyDtoHAsync(srcFakePtr, size).wait(m_rpcClient->getWaitScope());
+    return response.getPlan();
+}
+
+common::ErrorCode LauncherClient::launchKernel(const std::string& func, 
+                                              uint32_t gridDim, 
+                                              uint32_t blockDim,
+                                              uint32_t sharedMem,
+                                              const void* params) {
+    return launchKernelAsync(func, gridDim, blockDim, sharedMem, params)
+        .wait(m_rpcClient->getWaitScope());
+}
@@ -1,31 +1,49 @@
-#pragma once
-
-#include "hook-launcher.capnp.h"
-#include "common.capnp.h"
-#include <capnp/ez-rpc.h>
-#include <memory>
-#include <string>  
-#include <cstdint>  
-
-class LauncherClient {
-public:
-    LauncherClient(const std::string& address);
-    bool Connect(const std::string& address); // 修正为单参数Connect方法
-    bool connect();
-    
-    // HookLauncher接口实现
-    hook_launcher::AllocationResult::Reader requestAllocation(uint64_t size);
-    common::ErrorCode requestFree(uint64_t fakePtr);
-    hook_launcher::MemcpyPlan::Reader planMemcpyHtoD(uint64_t dstFakePtr, uint64_t size);
-    hook_launcher::MemcpyPlan::Reader planMemcpyDtoH(uint64_t srcFakePtr, uint64_t size);
-    common::ErrorCode launchKernel(const std::string& func, 
-                                   uint32_t gridDim, 
-                                   uint32_t blockDim,
-                                   uint32_t sharedMem,
-                                   const void* params);
-    
-private:
-    std::string m_address;
-    std::unique_ptr<capnp::EzRpcClient> m_rpcClient;
-    hook_launcher::HookLauncher::Client m_client;
-};
+#pragma once
+
+#include "hook-launcher.capnp.h"
+#include "common.capnp.h"
+#include "cuda.capnp.h"
+#include <capnp/ez-rpc.h>
+#include <kj/async.h>
+#include <memory>
+#include <string>  
+#include <cstdint>  
+
+class LauncherClient {
+public:
+    LauncherClient(const std::string& address);
+    bool Connect(const std::string& address); // 修正为单参数Connect方法
+    bool connect();
+    
+    // 异步接口：直接返回promise，在调用线程（launcher RPC事件循环）上继续链式处理，
+    // 同一连接上可同时挂起多个请求
+    kj::Promise<capnp::Response<hook_launcher::HookLauncher::RequestAllocationResults>>
+        requestAllocationAsync(uint64_t size);
+    kj::Promise<common::ErrorCode> requestFreeAsync(uint64_t fakePtr);
+    kj::Promise<capnp::Response<hook_launcher::HookLauncher::PlanMemcpyHtoDResults>>
+        planMemcpyHtoDAsync(uint64_t dstFakePtr, uint64_t size);
+    kj::Promise<capnp::Response<hook_launcher::HookLauncher::PlanMemcpyDtoHResults>>
+        planMemcpyDtoHAsync(uint64_t srcFakePtr, uint64_t size);
+    kj::Promise<common::ErrorCode> launchKernelAsync(const std::string& func,
+                                                     uint32_t gridDim,
+                                                     uint32_t blockDim,
+                                                     uint32_t sharedMem,
+                                                     const void* params);
+    kj::Promise<common::ErrorCode> launchKernelBatchAsync(BatchKernelLaunch::Reader batch);
+
+    // HookLauncher接口实现（同步版本，阻塞等待往返）
+    hook_launcher::AllocationResult::Reader requestAllocation(uint64_t size);
+    common::ErrorCode requestFree(uint64_t fakePtr);
+    hook_launcher::MemcpyPlan::Reader planMemcpyHtoD(uint64_t dstFakePtr, uint64_t size);
+    hook_launcher::MemcpyPlan::Reader planMemcpyDtoH(uint64_t srcFakePtr, uint64_t size);
+    common::ErrorCode launchKernel(const std::string& func, 
+                                   uint32_t gridDim, 
+                                   uint32_t blockDim,
+                                   uint32_t sharedMem,
+                                   const void* params);
+    
+private:
+    std::string m_address;
+    std::unique_ptr<capnp::EzRpcClient> m_rpcClient;
+    hook_launcher::HookLauncher::Client m_client;
+};
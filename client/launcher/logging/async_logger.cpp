@@ -0,0 +1,219 @@
+#include "async_logger.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <ctime>
+
+std::atomic<LogLevel> AsyncLogger::level_{LogLevel::Info};
+
+namespace {
+const char* LevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info:  return "INFO";
+        case LogLevel::Warn:  return "WARN";
+        case LogLevel::Error: return "ERROR";
+        default:              return "-";
+    }
+}
+
+void AppendArg(const LogRecord& record, const LogArg& arg, bool hex, std::string& out) {
+    char buf[32];
+    int n = 0;
+    switch (arg.type) {
+        case LogArg::Type::Int:
+            n = hex ? snprintf(buf, sizeof(buf), "0x%" PRIx64, static_cast<uint64_t>(arg.i))
+                    : snprintf(buf, sizeof(buf), "%" PRId64, arg.i);
+            break;
+        case LogArg::Type::Uint:
+            n = snprintf(buf, sizeof(buf), hex ? "0x%" PRIx64 : "%" PRIu64, arg.u);
+            break;
+        case LogArg::Type::Double:
+            n = snprintf(buf, sizeof(buf), "%g", arg.d);
+            break;
+        case LogArg::Type::Bool:
+            out += arg.u ? "true" : "false";
+            return;
+        case LogArg::Type::Text:
+            out.append(record.text + arg.offset, arg.length);
+            return;
+    }
+    out.append(buf, std::max(0, std::min<int>(n, sizeof(buf) - 1)));
+}
+
+// 线程退出时标记其缓冲，由后台线程取空后回收
+struct LocalRingHolder {
+    std::shared_ptr<LogRing> ring;
+    ~LocalRingHolder() {
+        if (ring) ring->Retire();
+    }
+};
+}
+
+// ---------------- LogRecord ----------------
+
+LogArg& LogRecord::Push(LogArg::Type type) {
+    LogArg& arg = args[argCount++];
+    arg.type = type;
+    return arg;
+}
+
+void LogRecord::AddText(const char* data, size_t length) {
+    LogArg& arg = Push(LogArg::Type::Text);
+    length = std::min(length, kTextBytes - textUsed);
+    arg.offset = textUsed;
+    arg.length = static_cast<uint8_t>(length);
+    if (length) memcpy(text + textUsed, data, length);
+    textUsed = static_cast<uint8_t>(textUsed + length);
+}
+
+// ---------------- LogRing ----------------
+
+LogRecord* LogRing::Reserve() {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >= kCapacity) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &records_[head % kCapacity];
+}
+
+void LogRing::Commit() {
+    head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// ---------------- AsyncLogger ----------------
+
+AsyncLogger& AsyncLogger::Instance() {
+    static AsyncLogger instance;
+    return instance;
+}
+
+AsyncLogger::AsyncLogger() {
+    writer_ = std::thread(&AsyncLogger::Run, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+    Shutdown();
+}
+
+LogRing& AsyncLogger::LocalRing() {
+    thread_local LocalRingHolder holder;
+    if (!holder.ring) {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        holder.ring = std::make_shared<LogRing>(next_thread_id_++);
+        rings_.push_back(holder.ring);
+    }
+    return *holder.ring;
+}
+
+void AsyncLogger::Fill(LogRecord& record, LogLevel level, const char* format, uint32_t threadId) {
+    record.timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.format = format;
+    record.threadId = threadId;
+    record.level = level;
+    record.argCount = 0;
+    record.textUsed = 0;
+}
+
+void AsyncLogger::Format(const LogRecord& record, std::string& out) {
+    time_t seconds = static_cast<time_t>(record.timeNs / 1000000000);
+    struct tm local;
+#ifdef _WIN32
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    char prefix[64];
+    size_t n = strftime(prefix, sizeof(prefix), "[%Y-%m-%d %H:%M:%S", &local);
+    n += snprintf(prefix + n, sizeof(prefix) - n, ".%03d] %-5s [%u] ",
+                  static_cast<int>(record.timeNs / 1000000 % 1000), LevelName(record.level), record.threadId);
+    out.append(prefix, std::min(n, sizeof(prefix) - 1));
+
+    size_t next = 0;
+    for (const char* p = record.format; *p; ++p) {
+        if (p[0] == '{' && p[1] == '}') {
+            if (next < record.argCount) AppendArg(record, record.args[next++], false, out);
+            ++p;
+        } else if (strncmp(p, "{:x}", 4) == 0) {
+            if (next < record.argCount) AppendArg(record, record.args[next++], true, out);
+            p += 3;
+        } else {
+            out += *p;
+        }
+    }
+}
+
+void AsyncLogger::Run() {
+    while (running_.load(std::memory_order_acquire)) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_.wait_for(lock, flush_interval_);
+        }
+        DrainOnce();
+    }
+}
+
+void AsyncLogger::DrainOnce() {
+    std::lock_guard<std::mutex> drain(drain_mutex_);
+    std::vector<std::shared_ptr<LogRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        // 已退出且取空的线程缓冲不再需要，其丢弃计数并入累计值
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                    [this](const std::shared_ptr<LogRing>& ring) {
+                                        if (!ring->Retired() || !ring->Empty()) return false;
+                                        retired_dropped_ += ring->Dropped();
+                                        return true;
+                                    }),
+                     rings_.end());
+        rings = rings_;
+    }
+
+    // 复制出记录后立即归还缓冲空间，再在各线程间按时间排序
+    std::vector<LogRecord> records;
+    uint64_t dropped = retired_dropped_;
+    for (auto& ring : rings) {
+        ring->Drain([&](const LogRecord& record) { records.push_back(record); });
+        dropped += ring->Dropped();
+    }
+    std::stable_sort(records.begin(), records.end(),
+                     [](const LogRecord& a, const LogRecord& b) { return a.timeNs < b.timeNs; });
+
+    std::string out;
+    std::string err;
+    for (const LogRecord& record : records) {
+        std::string& sink = record.level >= LogLevel::Warn ? err : out;
+        Format(record, sink);
+        sink += '\n';
+    }
+    if (dropped > reported_dropped_) {
+        err += "[logger] " + std::to_string(dropped - reported_dropped_) + " records dropped\n";
+        reported_dropped_ = dropped;
+    }
+    if (!out.empty()) {
+        fwrite(out.data(), 1, out.size(), stdout);
+        fflush(stdout);
+    }
+    if (!err.empty()) {
+        fwrite(err.data(), 1, err.size(), stderr);
+    }
+}
+
+void AsyncLogger::Flush() {
+    DrainOnce();
+}
+
+uint64_t AsyncLogger::DroppedCount() {
+    std::lock_guard<std::mutex> drain(drain_mutex_);
+    return reported_dropped_;
+}
+
+void AsyncLogger::Shutdown() {
+    if (!running_.exchange(false)) return;
+    wake_.notify_one();
+    if (writer_.joinable()) writer_.join();
+    DrainOnce();
+    SetLevel(LogLevel::Off);
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+// Launcher异步日志。
+// 调用线程只把定长二进制记录（格式串指针+参数）写入本线程的SPSC环形缓冲，
+// 不格式化、不加锁、不做IO；后台线程批量取出、按时间排序后格式化输出。
+// 格式串必须是字符串字面量，占位符为{}，{:x}按十六进制输出整数。
+// 字符串参数复制进记录，超出kTextBytes的部分被截断。
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+enum class LogLevel : uint8_t {
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Off,
+};
+
+struct LogArg {
+    enum class Type : uint8_t { Int, Uint, Double, Bool, Text };
+    Type type;
+    uint8_t length;                     // Text：在记录文本区中的长度
+    uint16_t offset;                    // Text：在记录文本区中的偏移
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+    };
+};
+
+struct alignas(64) LogRecord {
+    static constexpr size_t kMaxArgs = 8;
+    static constexpr size_t kTextBytes = 96;
+
+    int64_t timeNs;                     // system_clock纳秒
+    const char* format;
+    uint32_t threadId;
+    LogLevel level;
+    uint8_t argCount;
+    uint8_t textUsed;
+    LogArg args[kMaxArgs];
+    char text[kTextBytes];
+
+    void Add(int64_t value) { Push(LogArg::Type::Int).i = value; }
+    void Add(uint64_t value) { Push(LogArg::Type::Uint).u = value; }
+    void Add(double value) { Push(LogArg::Type::Double).d = value; }
+    void Add(bool value) { Push(LogArg::Type::Bool).u = value; }
+    void Add(const char* value) { AddText(value, value ? strlen(value) : 0); }
+    void Add(const std::string& value) { AddText(value.data(), value.size()); }
+    void Add(const void* value) { Add(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value))); }
+
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>> Add(T value) {
+        if constexpr (std::is_enum_v<T>) {
+            Add(static_cast<int64_t>(value));
+        } else if constexpr (std::is_signed_v<T>) {
+            Add(static_cast<int64_t>(value));
+        } else {
+            Add(static_cast<uint64_t>(value));
+        }
+    }
+    void Add(float value) { Add(static_cast<double>(value)); }
+
+private:
+    LogArg& Push(LogArg::Type type);
+    void AddText(const char* data, size_t length);
+};
+
+// 单生产者（所属线程）单消费者（后台线程）的环形缓冲
+class LogRing {
+public:
+    static constexpr size_t kCapacity = 1024;
+
+    explicit LogRing(uint32_t threadId) : thread_id_(threadId) {}
+
+    // 满时返回nullptr，记录被丢弃
+    LogRecord* Reserve();
+    void Commit();
+
+    // 消费端：取出全部已提交记录
+    template <typename Fn>
+    size_t Drain(Fn&& fn);
+
+    uint32_t ThreadId() const { return thread_id_; }
+    uint64_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    void Retire() { retired_.store(true, std::memory_order_release); }
+    bool Retired() const { return retired_.load(std::memory_order_acquire); }
+    bool Empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_relaxed);
+    }
+
+private:
+    alignas(64) std::atomic<uint64_t> head_{0};     // 生产者写入位置
+    alignas(64) std::atomic<uint64_t> tail_{0};     // 消费者读取位置
+    alignas(64) std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> retired_{false};              // 所属线程已退出
+    uint32_t thread_id_;
+    LogRecord records_[kCapacity];
+};
+
+template <typename Fn>
+size_t LogRing::Drain(Fn&& fn) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    for (uint64_t i = tail; i < head; ++i) {
+        fn(records_[i % kCapacity]);
+    }
+    tail_.store(head, std::memory_order_release);
+    return head - tail;
+}
+
+class AsyncLogger {
+public:
+    static AsyncLogger& Instance();
+
+    // 全局级别，低于该级别的调用在宏中直接跳过
+    static void SetLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    static bool Enabled(LogLevel level) { return level >= level_.load(std::memory_order_relaxed); }
+
+    // 后台线程的取出间隔
+    void SetFlushInterval(std::chrono::milliseconds interval) { flush_interval_ = interval; }
+
+    template <typename... Args>
+    void Log(LogLevel level, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= LogRecord::kMaxArgs, "too many log arguments");
+        LogRing& ring = LocalRing();
+        LogRecord* record = ring.Reserve();
+        if (!record) return;
+        Fill(*record, level, format, ring.ThreadId());
+        (record->Add(args), ...);
+        ring.Commit();
+        // Error立即唤醒后台线程，其余等待下个周期
+        if (level >= LogLevel::Error) wake_.notify_one();
+    }
+
+    // 同步写出所有已提交的记录
+    void Flush();
+    // 截至上次取出累计丢弃的记录数（含已退出线程）
+    uint64_t DroppedCount();
+    // 写出剩余记录并停止后台线程，之后的日志不再输出
+    void Shutdown();
+
+    // 将记录格式化为一行文本（不含换行）
+    static void Format(const LogRecord& record, std::string& out);
+
+private:
+    AsyncLogger();
+    ~AsyncLogger();
+
+    LogRing& LocalRing();
+    static void Fill(LogRecord& record, LogLevel level, const char* format, uint32_t threadId);
+    void Run();
+    void DrainOnce();
+
+    static std::atomic<LogLevel> level_;
+
+    std::mutex rings_mutex_;                        // 仅在线程首次记录及取出时使用
+    std::vector<std::shared_ptr<LogRing>> rings_;
+    uint32_t next_thread_id_ = 1;
+
+    std::mutex drain_mutex_;                        // 串行化后台线程与Flush
+    uint64_t retired_dropped_ = 0;                  // 已回收缓冲的丢弃数，保证总数单调
+    uint64_t reported_dropped_ = 0;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::chrono::milliseconds flush_interval_{10};
+    std::atomic<bool> running_{true};
+    std::thread writer_;
+};
+
+#define LAUNCHER_LOG(level, ...)                                                \
+    do {                                                                        \
+        if (AsyncLogger::Enabled(level)) {                                      \
+            AsyncLogger::Instance().Log(level, __VA_ARGS__);                    \
+        }                                                                       \
+    } while (0)
+
+// 每n次调用记录一次，用于高频路径
+#define LAUNCHER_LOG_SAMPLED(level, n, ...)                                     \
+    do {                                                                        \
+        static std::atomic<uint32_t> log_sample_counter_{0};                    \
+        if (AsyncLogger::Enabled(level) &&                                      \
+            log_sample_counter_.fetch_add(1, std::memory_order_relaxed) % (n) == 0) { \
+            AsyncLogger::Instance().Log(level, __VA_ARGS__);                    \
+        }                                                                       \
+    } while (0)
+
+#define LOG_DEBUG(...) LAUNCHER_LOG(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...)  LAUNCHER_LOG(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARN(...)  LAUNCHER_LOG(LogLevel::Warn, __VA_ARGS__)
+#define LOG_ERROR(...) LAUNCHER_LOG(LogLevel::Error, __VA_ARGS__)
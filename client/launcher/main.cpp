@@ -1,216 +1,373 @@
-#include <iostream>
-#include <thread>
-#include <memory>
-#include <filesystem>
-#include <fstream>
-#include <chrono>
-#include <capnp/ez-rpc.h>
-#include "dispatcher.h"
-#include "hook-launcher.capnp.h"
-#include "services/memory_service.h"
-#include "services/transport_service.h"
-#include "services/advise_service.h"
-#include "services/cooling_service.h" // 用于AdviseService
-#include "transport_manager.h" // 用于TransportService
-
-namespace fs = std::filesystem;
-
-// 根服务聚合所有接口
-class RootService final : 
-    public HookLauncher::Server,
-    public GenericServices::Server {
-public:
-    RootService(
-        Dispatcher& dispatcher,
-        GlobalMemoryManager& memoryManager,
-        TransportManager& transportManager,
-        CoolingService& coolingService
-    ) : dispatcher_(dispatcher),
-        memoryService_(memoryManager),
-        transportService_(transportManager),
-        adviseService_(coolingService) {}
-
-    // HookLauncher接口实现
-    kj::Promise<void> requestAllocation(RequestAllocationContext context) override {
-        auto size = context.getParams().getSize();
-        
-        auto* node = dispatcher_.PickNode(0, size); // 使用0作为ptr占位符
-        if (!node) {
-            context.getResults().setResult(AllocationResult{
-                .fakePtr = 0,
-                .error = CUDA_ERROR_OUT_OF_MEMORY
-            });
-            return kj::READY_NOW;
-        }
-        
-        auto allocPromise = node->launcher_client->requestAllocation(size);
-        return allocPromise.then([this, context, node](auto response) mutable {
-            if (response.error != CUDA_SUCCESS) {
-                context.getResults().setResult(AllocationResult{
-                    .fakePtr = 0,
-                    .error = response.error
-                });
-                return;
-            }
-            
-            uint64_t fakePtr = reinterpret_cast<uint64_t>(::operator new(1));
-            RemoteAllocInfo allocInfo{
-                .node_id = node->id,
-                .size = response.size,
-                .remote_handle = response.handle
-            };
-            dispatcher_.AddMapping(fakePtr, allocInfo);
-            
-            context.getResults().setResult(AllocationResult{
-                .fakePtr = fakePtr,
-                .error = CUDA_SUCCESS
-            });
-        });
-    }
-
-    kj::Promise<void> requestFree(RequestFreeContext context) override {
-        auto fakePtr = context.getParams().getFakePtr();
-        
-        auto* allocInfo = dispatcher_.GetMapping(fakePtr);
-        if (!allocInfo) {
-            context.getResults().setResult(CUDA_ERROR_INVALID_VALUE);
-            return kj::READY_NOW;
-        }
-        
-        auto* node = dispatcher_.GetNodeById(allocInfo->node_id);
-        if (!node) {
-            context.getResults().setResult(CUDA_ERROR_INVALID_VALUE);
-            return kj::READY_NOW;
-        }
-        
-        auto freePromise = node->launcher_client->requestFree(allocInfo->remote_handle);
-        return freePromise.then([this, context, fakePtr](auto error) mutable {
-            dispatcher_.RemoveMapping(fakePtr);
-            ::operator delete(reinterpret_cast<void*>(fakePtr), 1);
-            context.getResults().setResult(error);
-        });
-    }
-
-    kj::Promise<void> planMemcpyHtoD(PlanMemcpyHtoDContext context) override {
-        // 保持原有实现不变
-        auto dstFakePtr = context.getParams().getDstFakePtr();
-        auto size = context.getParams().getSize();
-        
-        auto* allocInfo = dispatcher_.GetMapping(dstFakePtr);
-        if (!allocInfo) {
-            context.getResults().initPlan().setError(CUDA_ERROR_INVALID_VALUE);
-            return kj::READY_NOW;
-        }
-        
-        auto* node = dispatcher_.GetNodeById(allocInfo->node_id);
-        if (!node) {
-            context.getResults().initPlan().setError(CUDA_ERROR_INVALID_VALUE);
-            return kj::READY_NOW;
-        }
-        
-        auto plan = context.getResults().initPlan();
-        plan.setTargetServerIp(node->address);
-        plan.setTargetServerZmqPort(node->zmq_port);
-        plan.setRemotePtr(allocInfo->remote_handle);
-        plan.setError(CUDA_SUCCESS);
-        
-        return kj::READY_NOW;
-    }
-
-    // GenericServices接口实现
-    kj::Promise<void> allocateMemory(AllocateMemoryContext context) override {
-        return memoryService_.allocateMemory(context);
-    }
-    
-    kj::Promise<void> freeMemory(FreeMemoryContext context) override {
-        return memoryService_.freeMemory(context);
-    }
-    
-    kj::Promise<void> executeTransfer(ExecuteTransferContext context) override {
-        return transportService_.executeTransfer(context);
-    }
-    
-    kj::Promise<void> handleMemAdvise(HandleMemAdviseContext context) override {
-        return adviseService_.handleMemAdvise(context);
-    }
-
-private:
-    Dispatcher& dispatcher_;
-    MemoryService memoryService_;
-    TransportService transportService_;
-    AdviseService adviseService_;
-};
-
-// 配置文件监视器
-void ConfigWatcher(Dispatcher& dispatcher, const std::string& configPath) {
-    auto lastWriteTime = fs::last_write_time(configPath);
-    while (true) {
-        std::this_thread::sleep_for(std::chrono::seconds(10));
-        try {
-            auto currentWriteTime = fs::last_write_time(configPath);
-            if (currentWriteTime != lastWriteTime) {
-                std::cout << "检测到配置文件变化，重新加载配置..." << std::endl;
-                dispatcher.LoadConfig(configPath);
-                lastWriteTime = currentWriteTime;
-            }
-        } catch (...) {
-            std::cerr << "配置文件监视错误" << std::endl;
-        }
-    }
-}
-
-int main() {
-    const std::string configPath = "config/scheduler_policy.yaml";
-    
-    // 初始化全局调度器
-    Dispatcher dispatcher;
-    dispatcher.LoadConfig(configPath);
-
-    // 创建服务依赖
-    GlobalMemoryManager memoryManager;
-    TransportManager transportManager;
-    CoolingService coolingService;
-    
-    // 创建聚合服务
-    capnp::EzRpcServer server(
-        kj::heap<RootService>(dispatcher, memoryManager, transportManager, coolingService), 
-        "127.0.0.1:12345"
-    );
-    
-    // 启动服务
-    auto& waitScope = server.getWaitScope();
-    uint16_t port = server.getPort().wait(waitScope);
-    std::cout << "Launcher RPC服务已启动，端口: " << port << std::endl;
-
-    // 运行健康检查线程
-    std::thread healthCheckThread([&]{
-        while (true) {
-            std::this_thread::sleep_for(std::chrono::seconds(5));
-            
-            // 增强健康检查：包括内存和GPU利用率监控
-            dispatcher.PerformHealthCheck();
-            
-            // 记录节点状态
-            auto nodes = dispatcher.GetNodes();
-            for (const auto& node : nodes) {
-                std::cout << "节点 " << node.id << " - "
-                          << "可用内存: " << node.available_memory << " MB, "
-                          << "GPU利用率: " << node.gpu_utilization << "%" 
-                          << std::endl;
-            }
-        }
-    });
-
-    // 运行配置监视线程
-    std::thread configWatcherThread([&]{
-        ConfigWatcher(dispatcher, configPath);
-    });
-
-    // 设置线程分离
-    healthCheckThread.detach();
-    configWatcherThread.detach();
-
-    // 等待服务终止
-    kj::NEVER_DONE.wait(waitScope);
-    return 0;
-}
+#include <iostream>
+#include <thread>
+#include <memory>
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <unordered_map>
+#include <capnp/ez-rpc.h>
+#include "dispatcher.h"
+#include "memory/fake_address_space.h"
+#include "memory/global_memory.h"
+#include "logging/async_logger.h"
+#include "hook-launcher.capnp.h"
+#include "services/memory_service.h"
+#include "services/transport_service.h"
+#include "services/advise_service.h"
+#include "services/cooling_service.h" // 用于AdviseService
+#include "transport_manager.h" // 用于TransportService
+
+namespace fs = std::filesystem;
+
+// 根服务聚合所有接口
+class RootService final : 
+    public HookLauncher::Server,
+    public GenericServices::Server {
+public:
+    RootService(
+        Dispatcher& dispatcher,
+        GlobalMemoryManager& memoryManager,
+        TransportManager& transportManager,
+        CoolingService& coolingService,
+        GlobalMemoryService& mappingStore
+    ) : dispatcher_(dispatcher),
+        cooling_(coolingService),
+        mappingStore_(mappingStore),
+        memoryService_(memoryManager),
+        transportService_(transportManager),
+        adviseService_(coolingService) {}
+
+    // HookLauncher接口实现
+    kj::Promise<void> requestAllocation(RequestAllocationContext context) override {
+        auto size = context.getParams().getSize();
+        
+        auto* node = dispatcher_.PickNode(0, size); // 使用0作为ptr占位符
+        if (!node) {
+            context.getResults().setResult(AllocationResult{
+                .fakePtr = 0,
+                .error = CUDA_ERROR_OUT_OF_MEMORY
+            });
+            return kj::READY_NOW;
+        }
+        
+        auto allocPromise = node->launcher_client->requestAllocationAsync(size);
+        return allocPromise.then([this, context, node](auto response) mutable {
+            if (response.error != CUDA_SUCCESS) {
+                context.getResults().setResult(AllocationResult{
+                    .fakePtr = 0,
+                    .error = response.error
+                });
+                return;
+            }
+            
+            // 伪指针高位编码节点与NUMA，按分配大小占据独立区间，内部指针可解析到所属分配
+            uint64_t fakePtr = fakeAddresses_.Allocate(node->index, node->numaId, response.size);
+            if (!fakePtr) {
+                // 伪地址空间耗尽，归还远端分配
+                node->launcher_client->requestFreeAsync(response.handle).detach([](kj::Exception&&) {});
+                context.getResults().setResult(AllocationResult{
+                    .fakePtr = 0,
+                    .error = CUDA_ERROR_OUT_OF_MEMORY
+                });
+                return;
+            }
+            NodeAllocInfo allocInfo{
+                .node_index = node->index,
+                .size = response.size,
+                .remote_handle = response.handle
+            };
+            if (!dispatcher_.AddMapping(fakePtr, allocInfo)) {
+                fakeAddresses_.Free(fakePtr, response.size);
+                node->launcher_client->requestFreeAsync(response.handle).detach([](kj::Exception&&) {});
+                context.getResults().setResult(AllocationResult{
+                    .fakePtr = 0,
+                    .error = CUDA_ERROR_OUT_OF_MEMORY
+                });
+                return;
+            }
+            // 持久化映射，launcher重启后据此恢复
+            mappingStore_.AddMapping(fakePtr, RemoteAllocInfo{node->id, response.size, response.handle});
+            
+            context.getResults().setResult(AllocationResult{
+                .fakePtr = fakePtr,
+                .error = CUDA_SUCCESS
+            });
+        });
+    }
+
+    kj::Promise<void> requestFree(RequestFreeContext context) override {
+        auto fakePtr = context.getParams().getFakePtr();
+        
+        // 所属节点直接取自伪指针高位
+        auto* node = dispatcher_.GetNode(FakeAddressSpace::NodeOf(fakePtr));
+        if (!node) {
+            context.getResults().setResult(CUDA_ERROR_INVALID_VALUE);
+            return kj::READY_NOW;
+        }
+        
+        // 先摘除映射再释放远端：并发或重复释放同一地址时只有一方取得映射，
+        // 远端释放期间新的查找也不会再解析到该分配。只能以分配起始地址释放
+        auto allocInfo = dispatcher_.TakeMapping(fakePtr);
+        if (!allocInfo) {
+            context.getResults().setResult(CUDA_ERROR_INVALID_VALUE);
+            return kj::READY_NOW;
+        }
+        
+        auto freePromise = node->launcher_client->requestFreeAsync(allocInfo->remote_handle);
+        return freePromise.then([this, context, fakePtr, info = *allocInfo](auto error) mutable {
+            if (error != CUDA_SUCCESS) {
+                // 远端分配仍然存在，恢复映射以便重试
+                dispatcher_.AddMapping(fakePtr, info);
+            } else {
+                fakeAddresses_.Free(fakePtr, info.size);
+                mappingStore_.RemoveMapping(fakePtr);
+            }
+            context.getResults().setResult(error);
+        }, [this, fakePtr, info = *allocInfo](kj::Exception&& e) {
+            dispatcher_.AddMapping(fakePtr, info);
+            kj::throwFatalException(kj::mv(e));
+        });
+    }
+
+    kj::Promise<void> planMemcpyHtoD(PlanMemcpyHtoDContext context) override {
+        // 保持原有实现不变
+        auto dstFakePtr = context.getParams().getDstFakePtr();
+        auto size = context.getParams().getSize();
+        
+        size_t offset = 0;
+        auto allocInfo = dispatcher_.GetMapping(dstFakePtr, &offset);
+        if (!allocInfo || size > allocInfo->size - offset) {
+            context.getResults().initPlan().setError(CUDA_ERROR_INVALID_VALUE);
+            return kj::READY_NOW;
+        }
+        // 以分配起点为键记录访问，偏移供访问模式识别
+        cooling_.RecordAccess(dstFakePtr - offset, offset);
+        
+        auto* node = dispatcher_.GetNode(FakeAddressSpace::NodeOf(dstFakePtr));
+        if (!node) {
+            context.getResults().initPlan().setError(CUDA_ERROR_INVALID_VALUE);
+            return kj::READY_NOW;
+        }
+        
+        // 数据直接发往所属节点：remotePtr是所属节点上的句柄，中继节点尚不能逐跳转发，
+        // 路径规划（Dispatcher::PlanTransfer）的结果在此无处可用，不逐次计算
+        auto plan = context.getResults().initPlan();
+        plan.setTargetServerIp(node->address);
+        plan.setTargetServerZmqPort(node->zmq_port);
+        plan.setRemotePtr(allocInfo->remote_handle + offset);
+        plan.setError(CUDA_SUCCESS);
+        
+        return kj::READY_NOW;
+    }
+
+    kj::Promise<void> launchKernelBatch(LaunchKernelBatchContext context) override {
+        auto* node = pickBatchNode(context.getParams().getRequest());
+        if (!node) {
+            auto ack = context.getResults().initAck();
+            ack.setOk(false);
+            ack.setCode(common::ErrorCode::GPU_NOT_FOUND);
+            return kj::READY_NOW;
+        }
+        
+        // 整批转发到目标节点，批内顺序保持不变
+        auto batchPromise = node->launcher_client->launchKernelBatchAsync(context.getParams().getRequest());
+        return batchPromise.then([context](common::ErrorCode code) mutable {
+            auto ack = context.getResults().initAck();
+            ack.setOk(code == common::ErrorCode::OK);
+            ack.setCode(code);
+        });
+    }
+
+    // GenericServices接口实现
+    kj::Promise<void> allocateMemory(AllocateMemoryContext context) override {
+        return memoryService_.allocateMemory(context);
+    }
+    
+    kj::Promise<void> freeMemory(FreeMemoryContext context) override {
+        return memoryService_.freeMemory(context);
+    }
+    
+    kj::Promise<void> executeTransfer(ExecuteTransferContext context) override {
+        return transportService_.executeTransfer(context);
+    }
+    
+    kj::Promise<void> handleMemAdvise(HandleMemAdviseContext context) override {
+        return adviseService_.handleMemAdvise(context);
+    }
+
+    // 启动时按已加载的快照恢复伪地址占用与调度器映射，返回恢复的条目数。
+    // 节点已不在配置中或伪地址与节点不符的条目无法恢复，从映射存储中移除
+    size_t restoreMappings() {
+        size_t restored = 0;
+        std::vector<uint64_t> stale;
+        mappingStore_.ForEachMapping([&](uint64_t base, const RemoteAllocInfo& info) {
+            NodeIndex index = dispatcher_.GetNodeIndex(info.node_id);
+            if (index == kInvalidNodeIndex || FakeAddressSpace::NodeOf(base) != index) {
+                LOG_WARN("Dropping snapshot mapping {:#x}: node {} unavailable", base, info.node_id);
+                stale.push_back(base);
+                return;
+            }
+            if (!fakeAddresses_.Reserve(base, info.size)) {
+                LOG_WARN("Dropping snapshot mapping {:#x}: fake address range unavailable", base);
+                stale.push_back(base);
+                return;
+            }
+            if (!dispatcher_.AddMapping(base, NodeAllocInfo{index, info.size, info.remote_handle})) {
+                fakeAddresses_.Free(base, info.size);
+                stale.push_back(base);
+                return;
+            }
+            ++restored;
+        });
+        // 遍历持有索引的读锁，移除放在遍历之后
+        for (uint64_t base : stale) {
+            mappingStore_.RemoveMapping(base);
+        }
+        return restored;
+    }
+
+private:
+    // 批次发往其缓冲区所属的节点：统计各内核指针参数（布局未知时扫描参数缓冲区中对齐的8字节值）
+    // 命中的伪指针映射，取命中最多的节点；批次不引用任何映射时按分配策略选择节点
+    RemoteNode* pickBatchNode(BatchKernelLaunch::Reader batch) {
+        std::unordered_map<NodeIndex, size_t> hits;
+        auto count = [&](const kj::byte* data, size_t size) {
+            for (size_t pos = 0; pos + sizeof(uint64_t) <= size; pos += sizeof(uint64_t)) {
+                uint64_t value;
+                std::memcpy(&value, data + pos, sizeof(value));
+                if (value != 0 && dispatcher_.GetMapping(value)) {
+                    ++hits[FakeAddressSpace::NodeOf(value)];
+                }
+            }
+        };
+        for (auto launch : batch.getRequests()) {
+            for (auto param : launch.getParams()) {
+                auto value = param.getValue();
+                bool pointer = param.getType() == ParamType::POINTER && value.size() == sizeof(uint64_t);
+                if (pointer || param.getType() == ParamType::BUFFER) {
+                    count(value.begin(), value.size());
+                }
+            }
+        }
+
+        NodeIndex owner = kInvalidNodeIndex;
+        size_t best = 0;
+        for (const auto& [index, n] : hits) {
+            if (n > best) {
+                owner = index;
+                best = n;
+            }
+        }
+        if (hits.size() > 1) {
+            LOG_WARN("Kernel batch references buffers on {} nodes, routing to node {}", hits.size(), owner);
+        }
+        if (owner != kInvalidNodeIndex) {
+            return dispatcher_.GetNode(owner);
+        }
+        return dispatcher_.PickNode(0, 0);
+    }
+
+    Dispatcher& dispatcher_;
+    CoolingService& cooling_;
+    GlobalMemoryService& mappingStore_;
+    FakeAddressSpace fakeAddresses_;
+    MemoryService memoryService_;
+    TransportService transportService_;
+    AdviseService adviseService_;
+};
+
+// 配置文件监视器
+void ConfigWatcher(Dispatcher& dispatcher, const std::string& configPath) {
+    auto lastWriteTime = fs::last_write_time(configPath);
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::seconds(10));
+        try {
+            auto currentWriteTime = fs::last_write_time(configPath);
+            if (currentWriteTime != lastWriteTime) {
+                std::cout << "检测到配置文件变化，重新加载配置..." << std::endl;
+                dispatcher.LoadConfig(configPath);
+                lastWriteTime = currentWriteTime;
+            }
+        } catch (...) {
+            std::cerr << "配置文件监视错误" << std::endl;
+        }
+    }
+}
+
+int main() {
+    const std::string configPath = "config/scheduler_policy.yaml";
+    const std::string snapshotPath = "state/memory_mapping.snap";
+    
+    // 初始化全局调度器
+    Dispatcher dispatcher;
+    dispatcher.LoadConfig(configPath);
+
+    // 创建服务依赖
+    GlobalMemoryManager memoryManager;
+    TransportManager transportManager;
+    // 与Dispatcher的分配决策共用同一实例，记录的访问才会影响决策
+    CoolingService& coolingService = CoolingService::Instance();
+
+    // 伪指针映射存储：加载上次的快照并重放增量日志
+    GlobalMemoryService mappingStore;
+    std::error_code ec;
+    fs::create_directories(fs::path(snapshotPath).parent_path(), ec);
+    if (fs::exists(snapshotPath)) {
+        mappingStore.LoadSnapshot(snapshotPath);
+    }
+    mappingStore.EnableDeltaLog(snapshotPath);
+    
+    // 创建聚合服务，先恢复映射再开始接受请求
+    auto rootService = kj::heap<RootService>(dispatcher, memoryManager, transportManager,
+                                             coolingService, mappingStore);
+    size_t restored = rootService->restoreMappings();
+    if (restored > 0) {
+        std::cout << "已从快照恢复 " << restored << " 个内存映射" << std::endl;
+    }
+    // 恢复后立即生成新快照，合并已重放的日志
+    mappingStore.SaveSnapshot(snapshotPath);
+
+    capnp::EzRpcServer server(kj::mv(rootService), "127.0.0.1:12345");
+    
+    // 启动服务
+    auto& waitScope = server.getWaitScope();
+    uint16_t port = server.getPort().wait(waitScope);
+    std::cout << "Launcher RPC服务已启动，端口: " << port << std::endl;
+
+    // 运行健康检查线程
+    std::thread healthCheckThread([&]{
+        for (uint64_t round = 1; ; ++round) {
+            std::this_thread::sleep_for(std::chrono::seconds(5));
+            
+            // 增强健康检查：包括内存和GPU利用率监控
+            dispatcher.PerformHealthCheck();
+
+            // 每分钟生成一次全量快照，增量日志随之轮转
+            if (round % 12 == 0) {
+                mappingStore.SaveSnapshot(snapshotPath);
+            }
+            
+            // 记录节点状态
+            dispatcher.ForEachNode([](const RemoteNode& node) {
+                std::cout << "节点 " << node.id << " - "
+                          << "可用内存: " << node.available_memory << " MB, "
+                          << "GPU利用率: " << node.gpu_utilization << "%" 
+                          << std::endl;
+            });
+        }
+    });
+
+    // 运行配置监视线程
+    std::thread configWatcherThread([&]{
+        ConfigWatcher(dispatcher, configPath);
+    });
+
+    // 设置线程分离
+    healthCheckThread.detach();
+    configWatcherThread.detach();
+
+    // 等待服务终止
+    kj::NEVER_DONE.wait(waitScope);
+    return 0;
+}
@@ -0,0 +1,237 @@
+#pragma once
+
+// 分配区间索引：按起始地址有序存放互不重叠的区间[base, base+size)，
+// 分配内部的任意地址都能在O(log n)内解析到所属分配及偏移。
+// 结构为两层B+树：叶子为最多kLeafCapacity个条目的有序数组，
+// 内层为叶子首地址的有序数组，查找只访问少量连续内存。
+// 读操作持共享锁，可并发执行；值以引用计数持有，Lookup返回的句柄在条目被删除后仍然有效。
+// 叶子写时复制：Freeze只复制叶子指针，之后的写操作遇到被冻结视图共享的叶子时先复制再修改。
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class AllocationIndex {
+public:
+    static constexpr size_t kLeafCapacity = 64;
+
+    struct Resolved {
+        uintptr_t base;
+        size_t offset;                   // 查询地址相对base的偏移
+        T value;
+    };
+
+    // 与已有区间重叠时失败
+    bool Insert(uintptr_t base, size_t size, T value) {
+        return Emplace(base, size, std::move(value));
+    }
+
+    // 原位构造值，T可以不可移动（如含原子量）
+    template <typename... Args>
+    bool Emplace(uintptr_t base, size_t size, Args&&... args) {
+        size = size ? size : 1;
+        std::unique_lock<std::shared_mutex> lock(index_mutex);
+        if (leaf_keys.empty()) {
+            leaf_keys.push_back(base);
+            leaf_nodes.push_back(std::make_shared<Leaf>());
+        }
+
+        // 小于所有起始地址时放入第一个叶子
+        size_t index = LeafFor(base);
+        const Leaf& current = *leaf_nodes[index];
+        size_t pos = UpperBound(current, base);
+
+        // 与前一个、后一个区间比较
+        if (pos > 0 && current.spans[pos - 1].base + current.spans[pos - 1].size > base) return false;
+        if (pos < current.spans.size()) {
+            if (current.spans[pos].base < base + size) return false;
+        } else if (index + 1 < leaf_keys.size() && leaf_keys[index + 1] < base + size) {
+            return false;
+        }
+
+        Leaf& leaf = MutableLeaf(index);
+        leaf.spans.insert(leaf.spans.begin() + pos, Span{base, size});
+        leaf.values.insert(leaf.values.begin() + pos, std::make_shared<T>(std::forward<Args>(args)...));
+        leaf_keys[index] = leaf.spans.front().base;
+        ++count;
+
+        if (leaf.spans.size() > kLeafCapacity) {
+            Split(index);
+        }
+        return true;
+    }
+
+    // 只接受分配起始地址
+    bool Erase(uintptr_t base) {
+        return Take(base) != nullptr;
+    }
+
+    // 删除并返回条目的值；同一base并发Take时只有一方得到非空结果
+    std::shared_ptr<T> Take(uintptr_t base) {
+        std::unique_lock<std::shared_mutex> lock(index_mutex);
+        if (leaf_keys.empty() || base < leaf_keys.front()) return nullptr;
+        size_t index = LeafFor(base);
+        size_t pos = UpperBound(*leaf_nodes[index], base);
+        if (pos == 0 || leaf_nodes[index]->spans[pos - 1].base != base) return nullptr;
+
+        Leaf& leaf = MutableLeaf(index);
+        std::shared_ptr<T> value = std::move(leaf.values[pos - 1]);
+        leaf.spans.erase(leaf.spans.begin() + pos - 1);
+        leaf.values.erase(leaf.values.begin() + pos - 1);
+        --count;
+
+        if (leaf.spans.empty()) {
+            leaf_keys.erase(leaf_keys.begin() + index);
+            leaf_nodes.erase(leaf_nodes.begin() + index);
+        } else {
+            leaf_keys[index] = leaf.spans.front().base;
+        }
+        return value;
+    }
+
+    std::optional<Resolved> Find(uintptr_t ptr) const {
+        std::shared_lock<std::shared_mutex> lock(index_mutex);
+        const Leaf* leaf;
+        size_t pos;
+        if (!Locate(ptr, leaf, pos)) return std::nullopt;
+        uintptr_t base = leaf->spans[pos].base;
+        return Resolved{base, ptr - base, *leaf->values[pos]};
+    }
+
+    // 返回条目值的引用计数句柄，条目随后被Erase时句柄仍然有效
+    std::shared_ptr<T> Lookup(uintptr_t ptr, size_t* offset = nullptr) const {
+        std::shared_lock<std::shared_mutex> lock(index_mutex);
+        const Leaf* leaf;
+        size_t pos;
+        if (!Locate(ptr, leaf, pos)) return nullptr;
+        if (offset) *offset = ptr - leaf->spans[pos].base;
+        return leaf->values[pos];
+    }
+
+    // 在共享锁内访问ptr所属分配，fn(base, offset, value)；未命中返回false
+    template <typename Fn>
+    bool Visit(uintptr_t ptr, Fn&& fn) {
+        std::shared_lock<std::shared_mutex> lock(index_mutex);
+        const Leaf* leaf;
+        size_t pos;
+        if (!Locate(ptr, leaf, pos)) return false;
+        uintptr_t base = leaf->spans[pos].base;
+        fn(base, ptr - base, *leaf->values[pos]);
+        return true;
+    }
+
+    // 在共享锁内按地址顺序访问，fn(base, size, value)
+    template <typename Fn>
+    void ForEach(Fn&& fn) const {
+        std::shared_lock<std::shared_mutex> lock(index_mutex);
+        for (const auto& leaf : leaf_nodes) {
+            for (size_t i = 0; i < leaf->spans.size(); ++i) {
+                fn(leaf->spans[i].base, leaf->spans[i].size, static_cast<const T&>(*leaf->values[i]));
+            }
+        }
+    }
+
+    size_t Size() const {
+        std::shared_lock<std::shared_mutex> lock(index_mutex);
+        return count;
+    }
+
+private:
+    struct Span {
+        uintptr_t base;
+        size_t size;
+    };
+
+    // 区间连续存放供二分查找，值单独分配并以引用计数持有，拆分叶子不移动值本身
+    struct Leaf {
+        std::vector<Span> spans;
+        std::vector<std::shared_ptr<T>> values;
+    };
+
+public:
+    // 冻结时刻的只读视图，不持有索引的锁，遍历期间索引可以并发增删
+    class Frozen {
+    public:
+        // 按地址顺序访问，fn(base, size, value)
+        template <typename Fn>
+        void ForEach(Fn&& fn) const {
+            for (const auto& leaf : leaves_) {
+                for (size_t i = 0; i < leaf->spans.size(); ++i) {
+                    fn(leaf->spans[i].base, leaf->spans[i].size, static_cast<const T&>(*leaf->values[i]));
+                }
+            }
+        }
+        size_t Size() const { return count_; }
+
+    private:
+        friend class AllocationIndex;
+        std::vector<std::shared_ptr<const Leaf>> leaves_;
+        size_t count_ = 0;
+    };
+
+    // 锁内只复制叶子指针（O(n / kLeafCapacity)）
+    Frozen Freeze() const {
+        Frozen frozen;
+        std::shared_lock<std::shared_mutex> lock(index_mutex);
+        frozen.leaves_.assign(leaf_nodes.begin(), leaf_nodes.end());
+        frozen.count_ = count;
+        return frozen;
+    }
+
+private:
+    // 修改前调用（持独占锁）：叶子仍被冻结视图引用时先复制一份。
+    // 独占锁下不会产生新的引用，use_count为1即只有索引自身持有
+    Leaf& MutableLeaf(size_t index) {
+        if (leaf_nodes[index].use_count() > 1) {
+            leaf_nodes[index] = std::make_shared<Leaf>(*leaf_nodes[index]);
+        }
+        return *leaf_nodes[index];
+    }
+
+    // 首个起始地址不大于addr的叶子；addr小于所有键时为第一个叶子
+    size_t LeafFor(uintptr_t addr) const {
+        size_t index = std::upper_bound(leaf_keys.begin(), leaf_keys.end(), addr) - leaf_keys.begin();
+        return index ? index - 1 : 0;
+    }
+
+    static size_t UpperBound(const Leaf& leaf, uintptr_t addr) {
+        return std::upper_bound(leaf.spans.begin(), leaf.spans.end(), addr,
+                                [](uintptr_t value, const Span& span) { return value < span.base; }) -
+               leaf.spans.begin();
+    }
+
+    // 叶子满时对半拆分，上半部分成为新叶子
+    void Split(size_t index) {
+        Leaf& leaf = MutableLeaf(index);
+        size_t half = leaf.spans.size() / 2;
+        auto upper = std::make_shared<Leaf>();
+        upper->spans.assign(leaf.spans.begin() + half, leaf.spans.end());
+        upper->values.assign(std::make_move_iterator(leaf.values.begin() + half),
+                             std::make_move_iterator(leaf.values.end()));
+        leaf.spans.resize(half);
+        leaf.values.resize(half);
+        leaf_keys.insert(leaf_keys.begin() + index + 1, upper->spans.front().base);
+        leaf_nodes.insert(leaf_nodes.begin() + index + 1, std::move(upper));
+    }
+
+    // 起始地址不大于ptr的最后一个区间，且ptr落在其中
+    bool Locate(uintptr_t ptr, const Leaf*& leaf, size_t& pos) const {
+        if (leaf_keys.empty() || ptr < leaf_keys.front()) return false;
+        leaf = leaf_nodes[LeafFor(ptr)].get();
+        pos = UpperBound(*leaf, ptr) - 1;
+        return ptr - leaf->spans[pos].base < leaf->spans[pos].size;
+    }
+
+    // 内层为叶子首地址的有序数组，拆分/删除叶子时整体移动（每kLeafCapacity/2次插入至多一次）
+    std::vector<uintptr_t> leaf_keys;
+    std::vector<std::shared_ptr<Leaf>> leaf_nodes;
+    size_t count = 0;
+    mutable std::shared_mutex index_mutex;
+};
@@ -0,0 +1,341 @@
+#include "fake_address_space.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+constexpr uint32_t kRefillShift = 4;
+constexpr size_t kCacheRefill = size_t(1) << kRefillShift;  // 线程缓存一次从arena取出的块数
+constexpr size_t kCacheLimit = 64;       // 每阶缓存上限，超出时归还一半
+}
+
+// 线程本地的小块缓存，按arena区分。arena被销毁后对应条目作废
+struct FakeAddressSpace::ThreadCache {
+    struct Entry {
+        std::weak_ptr<Arena> arena;
+        std::array<std::vector<uint64_t>, kMaxCachedOrder - kMinOrder + 1> blocks;
+    };
+
+    std::unordered_map<const Arena*, Entry> entries;
+    const Arena* last = nullptr;          // 连续操作同一arena时跳过查表
+    Entry* last_entry = nullptr;
+
+    Entry& For(Arena* arena) {
+        if (arena == last && !last_entry->arena.expired()) return *last_entry;
+        Entry& entry = entries[arena];
+        // 新条目，或旧arena已销毁后地址被复用
+        if (entry.arena.expired()) {
+            entry.arena = arena->weak_from_this();
+            for (auto& blocks : entry.blocks) blocks.clear();
+        }
+        last = arena;
+        last_entry = &entry;
+        return entry;
+    }
+
+    // 线程退出时归还缓存块，使其可以合并
+    ~ThreadCache() {
+        for (auto& [key, entry] : entries) {
+            auto arena = entry.arena.lock();
+            if (!arena) continue;
+            std::lock_guard<std::mutex> lock(arena->mutex);
+            for (uint32_t i = 0; i < entry.blocks.size(); ++i) {
+                for (uint64_t offset : entry.blocks[i]) {
+                    arena->FreeLocked(offset, kMinOrder + i);
+                }
+            }
+        }
+    }
+};
+
+// ---------------- FreeBitmap ----------------
+
+namespace {
+constexpr uint32_t kWordShift = 6;
+
+// 最低置位的位置（de Bruijn序列），w非零
+uint32_t LowestBit(uint64_t w) {
+    static constexpr uint8_t kTable[64] = {
+        0,  1,  48, 2,  57, 49, 28, 3,  61, 58, 50, 42, 38, 29, 17, 4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9,  13, 8,  7,  6,
+    };
+    return kTable[((w & (~w + 1)) * 0x03f79d71b4cb0a89ull) >> 58];
+}
+}
+
+const uint64_t* FakeAddressSpace::FreeBitmap::WordTable::Find(uint64_t key) const {
+    if (slots_.empty()) return nullptr;
+    size_t mask = slots_.size() - 1;
+    for (size_t i = (key * 0x9e3779b97f4a7c15ull) >> 32 & mask;; i = (i + 1) & mask) {
+        if (slots_[i].key == key) return &slots_[i].word;
+        if (slots_[i].key == kEmptyKey) return nullptr;
+    }
+}
+
+uint64_t& FakeAddressSpace::FreeBitmap::WordTable::Get(uint64_t key) {
+    if (uint64_t* word = Find(key)) return *word;
+    // 装载率不超过1/2
+    if ((used_ + 1) * 2 > slots_.size()) Grow();
+    size_t mask = slots_.size() - 1;
+    size_t i = (key * 0x9e3779b97f4a7c15ull) >> 32 & mask;
+    while (slots_[i].key != kEmptyKey) i = (i + 1) & mask;
+    slots_[i].key = key;
+    ++used_;
+    return slots_[i].word;
+}
+
+void FakeAddressSpace::FreeBitmap::WordTable::Grow() {
+    std::vector<Slot> old(std::max<size_t>(16, slots_.size() * 2));
+    old.swap(slots_);
+    size_t mask = slots_.size() - 1;
+    for (const Slot& slot : old) {
+        if (slot.key == kEmptyKey) continue;
+        size_t i = (slot.key * 0x9e3779b97f4a7c15ull) >> 32 & mask;
+        while (slots_[i].key != kEmptyKey) i = (i + 1) & mask;
+        slots_[i] = slot;
+    }
+}
+
+void FakeAddressSpace::FreeBitmap::Init(uint32_t bits) {
+    size_t levels = std::max<uint32_t>(1, (bits + kWordShift - 1) / kWordShift);
+    levels_.assign(levels, {});
+}
+
+void FakeAddressSpace::FreeBitmap::Set(uint64_t index) {
+    for (auto& level : levels_) {
+        uint64_t& word = level.Get(index >> kWordShift);
+        bool wasEmpty = word == 0;
+        word |= uint64_t(1) << (index & 63);
+        // 该字原本非空时上层已有标记
+        if (!wasEmpty) break;
+        index >>= kWordShift;
+    }
+}
+
+bool FakeAddressSpace::FreeBitmap::Clear(uint64_t index) {
+    for (auto& level : levels_) {
+        uint64_t* word = level.Find(index >> kWordShift);
+        if (!word) return false;
+        *word &= ~(uint64_t(1) << (index & 63));
+        if (*word != 0) return false;
+        index >>= kWordShift;
+    }
+    // 顶层字也已清空
+    return true;
+}
+
+bool FakeAddressSpace::FreeBitmap::Empty() const {
+    // 顶层只有0号字
+    const uint64_t* top = levels_.empty() ? nullptr : levels_.back().Find(0);
+    return !top || *top == 0;
+}
+
+bool FakeAddressSpace::FreeBitmap::Test(uint64_t index) const {
+    const uint64_t* word = levels_[0].Find(index >> kWordShift);
+    return word && (*word >> (index & 63)) & 1;
+}
+
+uint64_t FakeAddressSpace::FreeBitmap::First() const {
+    // 自顶层逐级取最低置位
+    uint64_t index = 0;
+    for (size_t level = levels_.size(); level-- > 0;) {
+        index = (index << kWordShift) | LowestBit(*levels_[level].Find(index));
+    }
+    return index;
+}
+
+// ---------------- Arena ----------------
+
+FakeAddressSpace::Arena::Arena() {
+    for (uint32_t order = kMinOrder; order <= kMaxOrder; ++order) {
+        free_blocks_[order].Init(kOffsetBits - order);
+    }
+    SetFree(kMaxOrder, 0);
+}
+
+void FakeAddressSpace::Arena::SetFree(uint32_t order, uint64_t block) {
+    free_blocks_[order].Set(block);
+    nonempty_orders_ |= uint64_t(1) << order;
+}
+
+void FakeAddressSpace::Arena::ClearFree(uint32_t order, uint64_t block) {
+    if (free_blocks_[order].Clear(block)) nonempty_orders_ &= ~(uint64_t(1) << order);
+}
+
+bool FakeAddressSpace::Arena::AllocateLocked(uint32_t order, uint64_t& offset) {
+    // 不低于order的最低非空阶
+    uint64_t candidates = nonempty_orders_ & ~((uint64_t(1) << order) - 1);
+    if (candidates == 0) return false;
+    uint32_t found = LowestBit(candidates);
+
+    uint64_t block = free_blocks_[found].First();
+    ClearFree(found, block);
+    offset = block << found;
+    // 逐级拆分，上半部分放回低一阶空闲表
+    while (found > order) {
+        --found;
+        SetFree(found, (offset >> found) | 1);
+    }
+    allocated += uint64_t(1) << order;
+    return true;
+}
+
+void FakeAddressSpace::Arena::FreeLocked(uint64_t offset, uint32_t order) {
+    allocated -= uint64_t(1) << order;
+    // 伙伴空闲时合并为高一阶的块
+    while (order < kMaxOrder) {
+        uint64_t buddy = (offset >> order) ^ 1;
+        if (!free_blocks_[order].Test(buddy)) break;
+        ClearFree(order, buddy);
+        offset &= ~(uint64_t(1) << order);
+        ++order;
+    }
+    SetFree(order, offset >> order);
+}
+
+bool FakeAddressSpace::Arena::ReserveLocked(uint64_t offset, uint32_t order) {
+    // 找到包含该块的空闲块，逐级拆分，不含目标的一半放回低一阶空闲表
+    for (uint32_t found = order; found <= kMaxOrder; ++found) {
+        if (!free_blocks_[found].Test(offset >> found)) continue;
+        ClearFree(found, offset >> found);
+        while (found > order) {
+            --found;
+            SetFree(found, (offset >> found) ^ 1);
+        }
+        allocated += uint64_t(1) << order;
+        return true;
+    }
+    return false;
+}
+
+// ---------------- FakeAddressSpace ----------------
+
+FakeAddressSpace::FakeAddressSpace()
+    : arena_table_(new std::atomic<Arena*>[size_t(kMaxNodes) << kNumaBits]()) {}
+
+FakeAddressSpace::~FakeAddressSpace() = default;
+
+uint32_t FakeAddressSpace::OrderFor(size_t size) {
+    uint32_t order = kMinOrder;
+    while (order < 64 && (uint64_t(1) << order) < size) ++order;
+    return order;
+}
+
+uint64_t FakeAddressSpace::Compose(uint32_t nodeIndex, uint32_t numa, uint64_t offset) {
+    return (kFakeAddressTag << 60) | (uint64_t(nodeIndex) << 48) | (uint64_t(numa) << kOffsetBits) | offset;
+}
+
+void FakeAddressSpace::FreeBatchLocked(Arena& arena, uint64_t* blocks, size_t count, uint32_t order) {
+    // 排序后，对齐且连续的kCacheRefill块（通常就是一次补充切出的块）作为一个高阶块归还
+    std::sort(blocks, blocks + count);
+    uint64_t groupBytes = uint64_t(kCacheRefill) << order;
+    size_t i = 0;
+    while (i < count) {
+        if (order + kRefillShift <= kMaxOrder && i + kCacheRefill <= count && blocks[i] % groupBytes == 0 &&
+            blocks[i + kCacheRefill - 1] == blocks[i] + groupBytes - (uint64_t(1) << order)) {
+            arena.FreeLocked(blocks[i], order + kRefillShift);
+            i += kCacheRefill;
+        } else {
+            arena.FreeLocked(blocks[i], order);
+            ++i;
+        }
+    }
+}
+
+FakeAddressSpace::ThreadCache& FakeAddressSpace::LocalCache() {
+    thread_local ThreadCache cache;
+    return cache;
+}
+
+FakeAddressSpace::Arena* FakeAddressSpace::ArenaFor(uint32_t nodeIndex, uint32_t numa) {
+    std::atomic<Arena*>& slot = arena_table_[(nodeIndex << kNumaBits) | numa];
+    Arena* arena = slot.load(std::memory_order_acquire);
+    if (arena) return arena;
+
+    std::lock_guard<std::mutex> lock(arenas_mutex_);
+    arena = slot.load(std::memory_order_relaxed);
+    if (!arena) {
+        arenas_.push_back(std::make_shared<Arena>());
+        arena = arenas_.back().get();
+        slot.store(arena, std::memory_order_release);
+    }
+    return arena;
+}
+
+uint64_t FakeAddressSpace::Allocate(uint32_t nodeIndex, int numaId, size_t size) {
+    if (nodeIndex >= kMaxNodes) return 0;
+    uint32_t numa = (numaId < 0 || numaId >= static_cast<int>(kUnknownNuma)) ? kUnknownNuma : numaId;
+    uint32_t order = OrderFor(std::max<size_t>(size, 1));
+    if (order > kMaxOrder) return 0;
+
+    Arena* arena = ArenaFor(nodeIndex, numa);
+    uint64_t offset = 0;
+    if (order <= kMaxCachedOrder) {
+        auto& blocks = LocalCache().For(arena).blocks[order - kMinOrder];
+        if (blocks.empty()) {
+            // 批量补充，摊薄加锁开销：优先取一个高kRefillShift阶的块切成kCacheRefill块，
+            // 一次伙伴操作代替逐块分配。低地址块最后压入，最先分出
+            std::lock_guard<std::mutex> lock(arena->mutex);
+            if (order + kRefillShift <= kMaxOrder && arena->AllocateLocked(order + kRefillShift, offset)) {
+                for (size_t i = kCacheRefill; i-- > 0;) blocks.push_back(offset + (uint64_t(i) << order));
+            } else {
+                for (size_t i = 0; i < kCacheRefill; ++i) {
+                    if (!arena->AllocateLocked(order, offset)) break;
+                    blocks.push_back(offset);
+                }
+                std::reverse(blocks.begin(), blocks.end());
+            }
+        }
+        if (blocks.empty()) return 0;
+        offset = blocks.back();
+        blocks.pop_back();
+    } else {
+        std::lock_guard<std::mutex> lock(arena->mutex);
+        if (!arena->AllocateLocked(order, offset)) return 0;
+    }
+    return Compose(nodeIndex, numa, offset);
+}
+
+void FakeAddressSpace::Free(uint64_t ptr, size_t size) {
+    if (!IsFake(ptr)) return;
+    uint32_t order = OrderFor(std::max<size_t>(size, 1));
+    uint64_t offset = ptr & ((uint64_t(1) << kOffsetBits) - 1);
+    Arena* arena = ArenaFor(NodeOf(ptr), (ptr >> kOffsetBits) & kUnknownNuma);
+
+    if (order <= kMaxCachedOrder) {
+        auto& blocks = LocalCache().For(arena).blocks[order - kMinOrder];
+        blocks.push_back(offset);
+        if (blocks.size() <= kCacheLimit) return;
+
+        // 缓存过多时归还最早放入的一半
+        size_t count = blocks.size() / 2;
+        std::lock_guard<std::mutex> lock(arena->mutex);
+        FreeBatchLocked(*arena, blocks.data(), count, order);
+        blocks.erase(blocks.begin(), blocks.begin() + count);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(arena->mutex);
+    arena->FreeLocked(offset, order);
+}
+
+bool FakeAddressSpace::Reserve(uint64_t ptr, size_t size) {
+    if (!IsFake(ptr)) return false;
+    uint32_t order = OrderFor(std::max<size_t>(size, 1));
+    uint64_t offset = ptr & ((uint64_t(1) << kOffsetBits) - 1);
+    if (order > kMaxOrder || (offset & ((uint64_t(1) << order) - 1)) != 0) return false;
+
+    Arena* arena = ArenaFor(NodeOf(ptr), (ptr >> kOffsetBits) & kUnknownNuma);
+    std::lock_guard<std::mutex> lock(arena->mutex);
+    return arena->ReserveLocked(offset, order);
+}
+
+uint64_t FakeAddressSpace::AllocatedBytes() const {
+    std::lock_guard<std::mutex> lock(arenas_mutex_);
+    uint64_t total = 0;
+    for (const auto& arena : arenas_) {
+        std::lock_guard<std::mutex> arenaLock(arena->mutex);
+        total += arena->allocated;
+    }
+    return total;
+}
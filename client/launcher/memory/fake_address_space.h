@@ -0,0 +1,131 @@
+#pragma once
+
+// 远程分配的伪设备地址空间。
+// 地址布局（64位）：
+//   [63:60] 标记 kFakeAddressTag，与真实设备地址区分
+//   [59:48] 节点下标（NodeIndex，最多4096个节点）
+//   [47:44] NUMA ID（0~14，15表示未知）
+//   [43:0]  (节点, NUMA)独立arena内的偏移，每个arena 16 TiB
+// 由地址即可取出所属节点与NUMA，无需查表。
+// arena内部为伙伴分配器（最小256字节），空闲块记录在各阶的稀疏位图中；
+// 小块经线程本地缓存分配与释放，不加锁。
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class FakeAddressSpace {
+public:
+    static constexpr uint64_t kFakeAddressTag = 0x4;
+    static constexpr uint32_t kNodeBits = 12;
+    static constexpr uint32_t kNumaBits = 4;
+    static constexpr uint32_t kOffsetBits = 44;
+    static constexpr uint32_t kMaxNodes = 1u << kNodeBits;
+    static constexpr uint32_t kUnknownNuma = (1u << kNumaBits) - 1;
+
+    static constexpr uint32_t kMinOrder = 8;                 // 256字节，与cuMemAlloc对齐一致
+    static constexpr uint32_t kMaxOrder = kOffsetBits;
+    static constexpr uint32_t kMaxCachedOrder = 16;          // 64 KiB及以下走线程缓存
+
+    static bool IsFake(uint64_t ptr) { return (ptr >> 60) == kFakeAddressTag; }
+    static uint32_t NodeOf(uint64_t ptr) { return (ptr >> 48) & (kMaxNodes - 1); }
+    // 未知NUMA返回-1
+    static int NumaOf(uint64_t ptr) {
+        uint32_t numa = (ptr >> kOffsetBits) & kUnknownNuma;
+        return numa == kUnknownNuma ? -1 : static_cast<int>(numa);
+    }
+
+    FakeAddressSpace();
+    ~FakeAddressSpace();
+
+    FakeAddressSpace(const FakeAddressSpace&) = delete;
+    FakeAddressSpace& operator=(const FakeAddressSpace&) = delete;
+
+    // 为节点分配size字节的地址区间（按2的幂向上取整），失败返回0
+    uint64_t Allocate(uint32_t nodeIndex, int numaId, size_t size);
+    // size须与分配时一致
+    void Free(uint64_t ptr, size_t size);
+    // 把已知地址区间标记为已分配（启动时按快照恢复），区间已被占用时返回false
+    bool Reserve(uint64_t ptr, size_t size);
+
+    // 各arena已分出的字节数（含线程缓存中暂存的空闲块）
+    uint64_t AllocatedBytes() const;
+
+private:
+    // 稀疏分层位图：每64位一个字，上层每位表示下层对应字非空，只为用到过的字分配存储。
+    // 置位/清位/测试与查找最低置位均为O(层数)，层数不超过ceil(44/6)
+    class FreeBitmap {
+    public:
+        void Init(uint32_t bits);
+        void Set(uint64_t index);
+        // 返回清位后位图是否变为空
+        bool Clear(uint64_t index);
+        bool Test(uint64_t index) const;
+        bool Empty() const;
+        uint64_t First() const;             // 调用方保证非空
+
+    private:
+        // 字号 → 字的开放寻址表（线性探测）。字只增不删，清空后保留供再次置位
+        class WordTable {
+        public:
+            const uint64_t* Find(uint64_t key) const;
+            uint64_t* Find(uint64_t key) {
+                return const_cast<uint64_t*>(static_cast<const WordTable*>(this)->Find(key));
+            }
+            uint64_t& Get(uint64_t key);    // 不存在时插入0
+
+        private:
+            static constexpr uint64_t kEmptyKey = ~uint64_t(0);
+            struct Slot {
+                uint64_t key = kEmptyKey;
+                uint64_t word = 0;
+            };
+            void Grow();
+
+            std::vector<Slot> slots_;
+            size_t used_ = 0;
+        };
+
+        // levels_[0]为叶子，levels_[l]的字号为index >> (6 * (l + 1))
+        std::vector<WordTable> levels_;
+    };
+
+    class Arena : public std::enable_shared_from_this<Arena> {
+    public:
+        Arena();
+
+        // 持有mutex调用
+        bool AllocateLocked(uint32_t order, uint64_t& offset);
+        void FreeLocked(uint64_t offset, uint32_t order);
+        bool ReserveLocked(uint64_t offset, uint32_t order);
+
+        std::mutex mutex;
+        uint64_t allocated = 0;
+
+    private:
+        void SetFree(uint32_t order, uint64_t block);
+        void ClearFree(uint32_t order, uint64_t block);
+
+        // 每阶一个空闲位图，按块号（offset >> order）置位，优先分配低地址以保持局部性
+        std::array<FreeBitmap, kMaxOrder + 1> free_blocks_;
+        uint64_t nonempty_orders_ = 0;      // 第order位：该阶有空闲块，分配时不必逐阶查空
+    };
+
+    struct ThreadCache;
+
+    static uint32_t OrderFor(size_t size);
+    static uint64_t Compose(uint32_t nodeIndex, uint32_t numa, uint64_t offset);
+    // arena在地址空间析构前一直有效
+    Arena* ArenaFor(uint32_t nodeIndex, uint32_t numa);
+    static ThreadCache& LocalCache();
+    // 归还线程缓存中的count个块，持有arena->mutex调用；会重排blocks
+    static void FreeBatchLocked(Arena& arena, uint64_t* blocks, size_t count, uint32_t order);
+
+    // (节点<<4 | NUMA) → arena，按需创建后只读，查找不加锁
+    std::unique_ptr<std::atomic<Arena*>[]> arena_table_;
+    mutable std::mutex arenas_mutex_;               // 仅在创建arena及统计时使用
+    std::vector<std::shared_ptr<Arena>> arenas_;
+};
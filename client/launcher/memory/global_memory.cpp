@@ -1,48 +1,140 @@
-#include "global_memory.h"
-#include <fstream>
-#include <nlohmann/json.hpp>
-#include <optional>
-
-using json = nlohmann::json;
-
-void GlobalMemoryService::AddMapping(uintptr_t dptr, RemoteAllocInfo info) {
-    std::unique_lock<std::shared_mutex> lock(table_mutex);
-    info.access_count = 0;
-    info.last_access = std::chrono::steady_clock::now();
-    ptr_table[dptr] = info;
-}
-
-std::optional<RemoteAllocInfo> GlobalMemoryService::GetMapping(uintptr_t dptr) {
-    std::shared_lock<std::shared_mutex> lock(table_mutex);
-    auto it = ptr_table.find(dptr);
-    if (it != ptr_table.end()) {
-        // 更新访问计数和时间
-        it->second.access_count++;
-        it->second.last_access = std::chrono::steady_clock::now();
-    }
-    return it != ptr_table.end() ? std::optional<RemoteAllocInfo>(it->second) : std::nullopt;
-}
-
-void GlobalMemoryService::RemoveMapping(uintptr_t dptr) {
-    std::unique_lock<std::shared_mutex> lock(table_mutex);
-    ptr_table.erase(dptr);
-}
-
-void GlobalMemoryService::SaveSnapshot(const std::string& path) {
-    std::shared_lock<std::shared_mutex> lock(table_mutex);
-    json j;
-    for (const auto& entry : ptr_table) {
-        j[std::to_string(entry.first)] = {
-            {"node_id", entry.second.node_id},
-            {"size", entry.second.size},
-            {"remote_handle", entry.second.remote_handle}
-        };
-    }
-    
-    std::ofstream file(path);
-    if (file.is_open()) {
-        file << j.dump(4);
-    } else {
-        std::cerr << "Failed to save memory mapping snapshot" << std::endl;
-    }
-}
+#include "global_memory.h"
+#include <algorithm>
+#include <iostream>
+#include <optional>
+
+namespace {
+int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t system_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+}
+
+bool GlobalMemoryService::AddMapping(uintptr_t dptr, RemoteAllocInfo info) {
+    size_t size = info.size;
+    uint64_t remoteHandle = info.remote_handle;
+    std::string nodeId = info.node_id;
+    if (!ptr_table.Emplace(dptr, size, std::move(info))) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(delta_mutex);
+    if (delta_log.IsOpen()) {
+        delta_log.AppendAdd(delta_sequence++, dptr, size, remoteHandle, nodeId);
+    }
+    return true;
+}
+
+MappingRef GlobalMemoryService::Resolve(uintptr_t dptr) {
+    MappingRef ref;
+    std::shared_ptr<MappedAllocation> entry = ptr_table.Lookup(dptr, &ref.offset);
+    if (entry) {
+        // 更新访问计数和时间
+        entry->access_count.fetch_add(1, std::memory_order_relaxed);
+        entry->last_access.store(steady_now_ns(), std::memory_order_relaxed);
+        ref.entry = std::move(entry);
+    }
+    return ref;
+}
+
+std::optional<RemoteAllocInfo> GlobalMemoryService::GetMapping(uintptr_t dptr, size_t* offset) {
+    MappingRef ref = Resolve(dptr);
+    if (!ref) {
+        return std::nullopt;
+    }
+    if (offset) *offset = ref.offset;
+    RemoteAllocInfo info = *ref;
+    info.access_count = ref.entry->access_count.load(std::memory_order_relaxed);
+    info.last_access = std::chrono::steady_clock::time_point(
+        std::chrono::nanoseconds(ref.entry->last_access.load(std::memory_order_relaxed)));
+    return info;
+}
+
+void GlobalMemoryService::RemoveMapping(uintptr_t dptr) {
+    if (!ptr_table.Erase(dptr)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(delta_mutex);
+    if (delta_log.IsOpen()) {
+        delta_log.AppendRemove(delta_sequence++, dptr);
+    }
+}
+
+bool GlobalMemoryService::SaveSnapshot(const std::string& path) {
+    // last_access为steady_clock时间，换算为system_clock以便重启后使用
+    const int64_t steadyNow = steady_now_ns();
+    const int64_t systemNow = system_now_ns();
+
+    uint64_t sequence;
+    AllocationIndex<MappedAllocation>::Frozen frozen;
+    {
+        // 持日志锁使冻结视图与日志切换对齐：sequence之前的变更都已包含在视图中。
+        // 锁内只复制叶子指针，逐条复制记录在锁外进行，不阻塞并发的增删
+        std::lock_guard<std::mutex> lock(delta_mutex);
+        sequence = delta_sequence;
+        frozen = ptr_table.Freeze();
+        delta_log.Flush();
+        delta_log.Rotate();
+    }
+
+    MappingSnapshot snapshot;
+    snapshot.Reserve(frozen.Size());
+    frozen.ForEach([&](uintptr_t base, size_t size, const MappedAllocation& entry) {
+        const RemoteAllocInfo& info = entry.info;
+        int64_t idle = steadyNow - entry.last_access.load(std::memory_order_relaxed);
+        snapshot.Add(base, size, info.remote_handle, info.node_id,
+                     entry.access_count.load(std::memory_order_relaxed), systemNow - idle);
+    });
+
+    if (!snapshot.Write(path, sequence)) {
+        std::cerr << "Failed to save memory mapping snapshot" << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(delta_mutex);
+    delta_log.DropRotated();
+    return true;
+}
+
+bool GlobalMemoryService::LoadSnapshot(const std::string& path) {
+    const int64_t steadyNow = steady_now_ns();
+    const int64_t systemNow = system_now_ns();
+
+    auto restore = [&](const MappingRecord& record) {
+        RemoteAllocInfo info{record.nodeId, static_cast<size_t>(record.size), record.remoteHandle};
+        ptr_table.Emplace(record.base, record.size, std::move(info));
+        auto entry = ptr_table.Lookup(record.base);
+        if (entry && record.lastAccessNs != 0) {
+            entry->access_count.store(record.accessCount, std::memory_order_relaxed);
+            entry->last_access.store(steadyNow - (systemNow - record.lastAccessNs), std::memory_order_relaxed);
+        }
+    };
+
+    uint64_t sequence = 0;
+    if (!MappingSnapshot::Read(path, &sequence, restore)) {
+        std::cerr << "Failed to load memory mapping snapshot " << path << std::endl;
+        return false;
+    }
+    // 日志重放是幂等的：已存在的映射Emplace失败，不存在的Erase无效果
+    uint64_t next = MappingDeltaLog::Replay(path + ".log", sequence, restore,
+                                            [this](uint64_t base) { ptr_table.Erase(base); });
+
+    std::lock_guard<std::mutex> lock(delta_mutex);
+    delta_sequence = std::max(delta_sequence, next);
+    return true;
+}
+
+bool GlobalMemoryService::EnableDeltaLog(const std::string& path) {
+    std::lock_guard<std::mutex> lock(delta_mutex);
+    return delta_log.Open(path + ".log");
+}
+
+void GlobalMemoryService::FlushDeltaLog() {
+    std::lock_guard<std::mutex> lock(delta_mutex);
+    delta_log.Flush();
+}
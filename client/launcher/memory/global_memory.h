@@ -1,40 +1,88 @@
-#pragma once
-
-#include <string>
-#include <optional>
-#include <shared_mutex>
-#include <unordered_map>
-#include <vector>
-#include <chrono>
-#include "launcher_client.h"
-
-struct RemoteAllocInfo {
-    std::string node_id;
-    size_t size;
-    uint64_t remote_handle;
-    uint32_t access_count = 0;                           // 访问计数器
-    std::chrono::steady_clock::time_point last_access;   // 最后访问时间
-};
-
-// 全局内存服务类
-class GlobalMemoryService {
-    std::unordered_map<uintptr_t, RemoteAllocInfo> ptr_table;
-    std::shared_mutex table_mutex;
-
-public:
-    void AddMapping(uintptr_t dptr, RemoteAllocInfo info);
-    std::optional<RemoteAllocInfo> GetMapping(uintptr_t dptr);
-    void RemoveMapping(uintptr_t dptr);
-    void SaveSnapshot(const std::string& path);
-    
-    // 获取所有内存指针
-    std::vector<uintptr_t> GetAllPointers() {
-        std::shared_lock<std::shared_mutex> lock(table_mutex);
-        std::vector<uintptr_t> pointers;
-        pointers.reserve(ptr_table.size());
-        for (const auto& pair : ptr_table) {
-            pointers.push_back(pair.first);
-        }
-        return pointers;
-    }
-};
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <optional>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include <chrono>
+#include "allocation_index.h"
+#include "mapping_snapshot.h"
+#include "launcher_client.h"
+
+struct RemoteAllocInfo {
+    std::string node_id;
+    size_t size;
+    uint64_t remote_handle;
+    uint32_t access_count = 0;                           // 访问计数器
+    std::chrono::steady_clock::time_point last_access;   // 最后访问时间
+};
+
+// 映射表条目：描述信息登记后只读，访问统计为relaxed原子量，
+// 并发查找之间不产生写冲突
+struct MappedAllocation {
+    explicit MappedAllocation(RemoteAllocInfo alloc)
+        : info(std::move(alloc)),
+          last_access(std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now().time_since_epoch()).count()) {}
+
+    const RemoteAllocInfo info;                          // 其中的访问统计字段不使用
+    std::atomic<uint32_t> access_count{0};
+    std::atomic<int64_t> last_access;                    // steady_clock计时（纳秒）
+};
+
+// 轻量查找结果，不复制字符串；持有条目的引用计数，并发RemoveMapping之后仍可安全读取
+struct MappingRef {
+    std::shared_ptr<const MappedAllocation> entry;
+    size_t offset = 0;                                   // 相对分配起点的偏移
+
+    explicit operator bool() const { return entry != nullptr; }
+    const RemoteAllocInfo* operator->() const { return &entry->info; }
+    const RemoteAllocInfo& operator*() const { return entry->info; }
+};
+
+// 全局内存服务类
+class GlobalMemoryService {
+    // 按地址区间索引，设备指针可以指向分配内部
+    AllocationIndex<MappedAllocation> ptr_table;
+
+    // 增量日志：映射变更在索引更新后追加，sequence单调递增
+    std::mutex delta_mutex;
+    MappingDeltaLog delta_log;
+    uint64_t delta_sequence = 0;
+
+public:
+    // 与已有分配区间重叠时返回false
+    bool AddMapping(uintptr_t dptr, RemoteAllocInfo info);
+    // 查找并记录一次访问，dptr可为分配内部地址
+    MappingRef Resolve(uintptr_t dptr);
+    // 返回副本（含访问统计），offset返回相对分配起点的偏移
+    std::optional<RemoteAllocInfo> GetMapping(uintptr_t dptr, size_t* offset = nullptr);
+    void RemoveMapping(uintptr_t dptr);
+
+    // 二进制全量快照：锁内只冻结索引（复制叶子指针），复制记录、序列化与写文件在锁外完成
+    bool SaveSnapshot(const std::string& path);
+    // 加载快照并重放其后的增量日志，用于launcher重启
+    bool LoadSnapshot(const std::string& path);
+    // 在两次全量快照之间把每次变更追加到path.log
+    bool EnableDeltaLog(const std::string& path);
+    void FlushDeltaLog();
+    
+    // 按地址顺序访问全部映射，fn(base, info)；用于启动时从快照恢复调度器状态
+    template <typename Fn>
+    void ForEachMapping(Fn&& fn) const {
+        ptr_table.ForEach([&](uintptr_t base, size_t, const MappedAllocation& entry) { fn(base, entry.info); });
+    }
+
+    // 获取所有内存指针（分配起始地址）
+    std::vector<uintptr_t> GetAllPointers() {
+        std::vector<uintptr_t> pointers;
+        pointers.reserve(ptr_table.Size());
+        ptr_table.ForEach([&](uintptr_t base, size_t, const MappedAllocation&) {
+            pointers.push_back(base);
+        });
+        return pointers;
+    }
+};
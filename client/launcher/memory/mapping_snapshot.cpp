@@ -0,0 +1,269 @@
+#include "mapping_snapshot.h"
+#include "crc32c.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#ifdef _WIN32
+#include <io.h>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr char kSnapshotMagic[8] = {'G', 'M', 'A', 'P', 'S', 'N', 'P', '1'};
+constexpr char kLogMagic[8] = {'G', 'M', 'A', 'P', 'L', 'O', 'G', '1'};
+constexpr uint32_t kSnapshotVersion = 1;
+
+bool ReadFile(const std::string& path, std::vector<char>& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// 把已写入的数据落盘
+bool SyncFile(FILE* file) {
+    if (fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// 以temp原子替换path：替换前path保持旧内容，不存在既无旧快照也无新快照的时刻
+bool AtomicReplace(const std::string& temp, const std::string& path) {
+#ifdef _WIN32
+    return MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (std::rename(temp.c_str(), path.c_str()) != 0) return false;
+    // 同步所在目录，使重命名本身在掉电后仍然有效
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int fd = open(dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+    return true;
+#endif
+}
+}
+
+// ---------------- MappingSnapshot ----------------
+
+void MappingSnapshot::Add(uint64_t base, uint64_t size, uint64_t remoteHandle, const std::string& nodeId,
+                          uint32_t accessCount, int64_t lastAccessNs) {
+    auto it = node_offsets_.find(nodeId);
+    if (it == node_offsets_.end()) {
+        it = node_offsets_.emplace(nodeId, static_cast<uint32_t>(strings_.size())).first;
+        strings_ += nodeId;
+    }
+
+    SnapshotEntry entry = {};
+    entry.base = base;
+    entry.size = size;
+    entry.remoteHandle = remoteHandle;
+    entry.lastAccessNs = lastAccessNs;
+    entry.accessCount = accessCount;
+    entry.nodeOffset = it->second;
+    entry.nodeLength = static_cast<uint32_t>(nodeId.size());
+    entries_.push_back(entry);
+}
+
+bool MappingSnapshot::Write(const std::string& path, uint64_t sequence) const {
+    SnapshotHeader header = {};
+    memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+    header.version = kSnapshotVersion;
+    header.entryCount = entries_.size();
+    header.stringBytes = strings_.size();
+    header.sequence = sequence;
+    header.createdNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    header.checksum = Crc32c(entries_.data(), entries_.size() * sizeof(SnapshotEntry));
+    header.checksum = Crc32c(strings_.data(), strings_.size(), header.checksum);
+
+    const std::string temp = path + ".tmp";
+    FILE* file = fopen(temp.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Failed to open snapshot file " << temp << std::endl;
+        return false;
+    }
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(entries_.data(), sizeof(SnapshotEntry), entries_.size(), file) == entries_.size() &&
+                   fwrite(strings_.data(), 1, strings_.size(), file) == strings_.size() &&
+                   SyncFile(file);
+    if (fclose(file) != 0 || !written) {
+        std::cerr << "Failed to write snapshot file " << temp << std::endl;
+        std::remove(temp.c_str());
+        return false;
+    }
+    // 新快照落盘后再替换，替换失败时旧快照保持不变
+    if (!AtomicReplace(temp, path)) {
+        std::cerr << "Failed to replace snapshot file " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool MappingSnapshot::Read(const std::string& path, uint64_t* sequence,
+                           const std::function<void(const MappingRecord&)>& fn) {
+    std::vector<char> data;
+    if (!ReadFile(path, data) || data.size() < sizeof(SnapshotHeader)) return false;
+
+    SnapshotHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+    if (memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0 || header.version != kSnapshotVersion) {
+        std::cerr << "Unrecognized snapshot format in " << path << std::endl;
+        return false;
+    }
+    uint64_t entryBytes = header.entryCount * sizeof(SnapshotEntry);
+    if (header.entryCount > data.size() / sizeof(SnapshotEntry) ||
+        sizeof(SnapshotHeader) + entryBytes + header.stringBytes != data.size()) {
+        std::cerr << "Truncated snapshot " << path << std::endl;
+        return false;
+    }
+    const char* entries = data.data() + sizeof(SnapshotHeader);
+    const char* strings = entries + entryBytes;
+    uint32_t checksum = Crc32c(entries, entryBytes);
+    if (Crc32c(strings, header.stringBytes, checksum) != header.checksum) {
+        std::cerr << "Snapshot checksum mismatch in " << path << std::endl;
+        return false;
+    }
+
+    MappingRecord record;
+    for (uint64_t i = 0; i < header.entryCount; ++i) {
+        SnapshotEntry entry;
+        memcpy(&entry, entries + i * sizeof(SnapshotEntry), sizeof(entry));
+        if (uint64_t(entry.nodeOffset) + entry.nodeLength > header.stringBytes) return false;
+        record.base = entry.base;
+        record.size = entry.size;
+        record.remoteHandle = entry.remoteHandle;
+        record.accessCount = entry.accessCount;
+        record.lastAccessNs = entry.lastAccessNs;
+        record.nodeId.assign(strings + entry.nodeOffset, entry.nodeLength);
+        fn(record);
+    }
+    if (sequence) *sequence = header.sequence;
+    return true;
+}
+
+// ---------------- MappingDeltaLog ----------------
+
+bool MappingDeltaLog::Open(const std::string& path) {
+    Close();
+    path_ = path;
+    std::ifstream existing(path, std::ios::binary);
+    bool empty = !existing.is_open() || existing.peek() == std::ifstream::traits_type::eof();
+    existing.close();
+
+    file_.open(path, std::ios::binary | std::ios::app);
+    if (!file_.is_open()) {
+        std::cerr << "Failed to open mapping delta log " << path << std::endl;
+        return false;
+    }
+    if (empty) {
+        file_.write(kLogMagic, sizeof(kLogMagic));
+    }
+    return true;
+}
+
+void MappingDeltaLog::Close() {
+    if (file_.is_open()) {
+        file_.close();
+    }
+}
+
+void MappingDeltaLog::Append(const DeltaRecord& record, const std::string& nodeId) {
+    file_.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    file_.write(nodeId.data(), nodeId.size());
+}
+
+void MappingDeltaLog::AppendAdd(uint64_t sequence, uint64_t base, uint64_t size, uint64_t remoteHandle,
+                                const std::string& nodeId) {
+    DeltaRecord record = {};
+    record.op = kDeltaAdd;
+    record.nodeLength = static_cast<uint32_t>(nodeId.size());
+    record.sequence = sequence;
+    record.base = base;
+    record.size = size;
+    record.remoteHandle = remoteHandle;
+    Append(record, nodeId);
+}
+
+void MappingDeltaLog::AppendRemove(uint64_t sequence, uint64_t base) {
+    DeltaRecord record = {};
+    record.op = kDeltaRemove;
+    record.sequence = sequence;
+    record.base = base;
+    Append(record, std::string());
+}
+
+void MappingDeltaLog::Flush() {
+    if (file_.is_open()) file_.flush();
+}
+
+void MappingDeltaLog::Rotate() {
+    if (!file_.is_open()) return;
+    const std::string rotated = path_ + ".old";
+    if (std::ifstream(rotated).is_open()) return;
+
+    file_.close();
+    if (std::rename(path_.c_str(), rotated.c_str()) != 0) {
+        std::cerr << "Failed to rotate mapping delta log " << path_ << std::endl;
+    }
+    Open(path_);
+}
+
+void MappingDeltaLog::DropRotated() {
+    if (path_.empty()) return;
+    std::remove((path_ + ".old").c_str());
+}
+
+uint64_t MappingDeltaLog::Replay(const std::string& path, uint64_t minSequence,
+                                 const std::function<void(const MappingRecord&)>& onAdd,
+                                 const std::function<void(uint64_t base)>& onRemove) {
+    uint64_t next = minSequence;
+    for (const std::string& file : {path + ".old", path}) {
+        std::vector<char> data;
+        if (!ReadFile(file, data) || data.size() < sizeof(kLogMagic) ||
+            memcmp(data.data(), kLogMagic, sizeof(kLogMagic)) != 0) {
+            continue;
+        }
+
+        // 崩溃可能留下不完整的尾部记录，读到该处停止
+        size_t offset = sizeof(kLogMagic);
+        MappingRecord record;
+        while (offset + sizeof(DeltaRecord) <= data.size()) {
+            DeltaRecord delta;
+            memcpy(&delta, data.data() + offset, sizeof(delta));
+            offset += sizeof(delta);
+            if (offset + delta.nodeLength > data.size()) break;
+            const char* node = data.data() + offset;
+            offset += delta.nodeLength;
+            if (delta.sequence < minSequence) continue;
+            next = std::max(next, delta.sequence + 1);
+
+            if (delta.op == kDeltaAdd) {
+                record.base = delta.base;
+                record.size = delta.size;
+                record.remoteHandle = delta.remoteHandle;
+                record.accessCount = 0;
+                record.lastAccessNs = 0;
+                record.nodeId.assign(node, delta.nodeLength);
+                onAdd(record);
+            } else if (delta.op == kDeltaRemove) {
+                onRemove(delta.base);
+            }
+        }
+    }
+    return next;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+// 映射表的二进制快照与增量日志。
+// 快照布局（小端、定长记录，可直接mmap读取）：
+//   SnapshotHeader | SnapshotEntry × entryCount | 节点ID字符串表
+// 增量日志：LogHeader后追加DeltaRecord（+节点ID），sequence不小于快照sequence的记录在加载时重放。
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#pragma pack(push, 1)
+struct SnapshotHeader {
+    char magic[8];                      // "GMAPSNP1"
+    uint32_t version;
+    uint32_t checksum;                  // 条目与字符串表的CRC32C
+    uint64_t entryCount;
+    uint64_t stringBytes;
+    uint64_t sequence;                  // 快照时的增量日志序号
+    int64_t createdNs;                  // system_clock纳秒
+};
+
+struct SnapshotEntry {
+    uint64_t base;
+    uint64_t size;
+    uint64_t remoteHandle;
+    int64_t lastAccessNs;               // system_clock纳秒
+    uint32_t accessCount;
+    uint32_t nodeOffset;                // 节点ID在字符串表中的偏移
+    uint32_t nodeLength;
+    uint32_t reserved;
+};
+
+struct DeltaRecord {
+    uint8_t op;                         // kDeltaAdd / kDeltaRemove
+    uint8_t reserved[3];
+    uint32_t nodeLength;                // 之后紧跟的节点ID字节数
+    uint64_t sequence;
+    uint64_t base;
+    uint64_t size;
+    uint64_t remoteHandle;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(SnapshotHeader) == 48, "SnapshotHeader must be 48 bytes");
+static_assert(sizeof(SnapshotEntry) == 48, "SnapshotEntry must be 48 bytes");
+
+constexpr uint8_t kDeltaAdd = 1;
+constexpr uint8_t kDeltaRemove = 2;
+
+// 加载得到的一条映射
+struct MappingRecord {
+    uint64_t base = 0;
+    uint64_t size = 0;
+    uint64_t remoteHandle = 0;
+    uint32_t accessCount = 0;
+    int64_t lastAccessNs = 0;           // system_clock纳秒
+    std::string nodeId;
+};
+
+class MappingSnapshot {
+public:
+    void Reserve(size_t entries) { entries_.reserve(entries); }
+
+    // 节点ID去重后存入字符串表
+    void Add(uint64_t base, uint64_t size, uint64_t remoteHandle, const std::string& nodeId,
+             uint32_t accessCount, int64_t lastAccessNs);
+
+    // 先写临时文件再改名，中途失败不破坏已有快照
+    bool Write(const std::string& path, uint64_t sequence) const;
+
+    // 校验后逐条回调，返回快照sequence；失败返回false
+    static bool Read(const std::string& path, uint64_t* sequence,
+                     const std::function<void(const MappingRecord&)>& fn);
+
+private:
+    std::vector<SnapshotEntry> entries_;
+    std::string strings_;
+    std::unordered_map<std::string, uint32_t> node_offsets_;
+};
+
+class MappingDeltaLog {
+public:
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return file_.is_open(); }
+
+    void AppendAdd(uint64_t sequence, uint64_t base, uint64_t size, uint64_t remoteHandle,
+                   const std::string& nodeId);
+    void AppendRemove(uint64_t sequence, uint64_t base);
+    void Flush();
+
+    // 全量快照开始时调用：当前日志改名为.old并开始新日志。
+    // 上次快照未完成（.old仍在）时继续写当前日志
+    void Rotate();
+    // 全量快照写入成功后删除.old
+    void DropRotated();
+
+    // 依次重放path.old与path中sequence不小于minSequence的记录，返回下一个可用sequence
+    static uint64_t Replay(const std::string& path, uint64_t minSequence,
+                       const std::function<void(const MappingRecord&)>& onAdd,
+                       const std::function<void(uint64_t base)>& onRemove);
+
+private:
+    void Append(const DeltaRecord& record, const std::string& nodeId);
+
+    std::string path_;
+    std::ofstream file_;
+};
@@ -0,0 +1,227 @@
+#include "node_selector.h"
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+namespace {
+// 综合得分的权重
+constexpr double kMemoryWeight = 0.3;
+constexpr double kLatencyWeight = 0.2;
+constexpr double kLoadWeight = 0.2;
+constexpr double kPriorityWeight = 0.1;
+constexpr double kNumaWeight = 0.2;     // NUMA亲和性权重
+
+constexpr int kSampleAttempts = 8;      // PowerOfTwo每个样本的重试次数
+
+// 与分配大小、NUMA位置无关的部分，用于桶内排序
+double StaticScore(const NodeMetrics& node) {
+    double latency_score = 1.0 / (1.0 + node.network_latency);
+    double load_score = 1.0 - ((node.cpu_usage + node.gpu_utilization) / 200.0);
+    double priority_score = node.priority / 100.0;
+    return kLatencyWeight * latency_score + kLoadWeight * load_score + kPriorityWeight * priority_score;
+}
+
+size_t BucketOf(size_t available) {
+    size_t bucket = 0;
+    while (available >>= 1) ++bucket;
+    return bucket;
+}
+
+uint64_t NextRandom() {
+    thread_local std::minstd_rand engine(std::random_device{}());
+    return engine();
+}
+}
+
+// ---------------- NodeTable ----------------
+
+NodeTable::NodeTable() : slots_(new Slot[kCapacity]) {}
+
+bool NodeTable::Set(NodeIndex index, const NodeMetrics& metrics) {
+    if (index >= kCapacity) return false;
+    uint64_t words[kWords] = {};
+    std::memcpy(words, &metrics, sizeof(metrics));
+
+    Slot& slot = slots_[index];
+    uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kWords; ++i) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+
+    if (index >= count_.load(std::memory_order_relaxed)) {
+        // 中间未设置的槽为默认值（可用内存为0，不会被选中）
+        count_.store(index + 1, std::memory_order_release);
+    }
+    return true;
+}
+
+NodeMetrics NodeTable::Get(NodeIndex index) const {
+    const Slot& slot = slots_[index];
+    uint64_t words[kWords];
+    uint32_t before, after;
+    do {
+        before = slot.sequence.load(std::memory_order_acquire);
+        for (size_t i = 0; i < kWords; ++i) {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = slot.sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    NodeMetrics metrics;
+    std::memcpy(&metrics, words, sizeof(metrics));
+    return metrics;
+}
+
+double CalculateNodeScore(const NodeMetrics& node, size_t required_memory, int numaId) {
+    // 内存得分 (可用内存比例)
+    double memory_score = 0.0;
+    if (node.total_memory > 0) {
+        memory_score = static_cast<double>(node.available_memory - required_memory) / node.total_memory;
+    }
+
+    // NUMA亲和性得分 (相同NUMA节点得1分，跨NUMA得0.5分)
+    double numa_score = (node.numaId == numaId) ? 1.0 : 0.5;
+
+    // 综合得分（延迟、负载、优先级见StaticScore）
+    return kMemoryWeight * memory_score + StaticScore(node) + kNumaWeight * numa_score;
+}
+
+NodeSelectionPolicy ParseNodeSelectionPolicy(const std::string& name) {
+    if (name == "p2c") return NodeSelectionPolicy::PowerOfTwo;
+    if (name == "bucketed") return NodeSelectionPolicy::Bucketed;
+    return NodeSelectionPolicy::Exhaustive;
+}
+
+const char* NodeSelectionPolicyName(NodeSelectionPolicy policy) {
+    switch (policy) {
+        case NodeSelectionPolicy::PowerOfTwo: return "p2c";
+        case NodeSelectionPolicy::Bucketed:   return "bucketed";
+        default:                              return "exhaustive";
+    }
+}
+
+// ---------------- NodeSelector ----------------
+
+NodeSelector::NodeSelector(NodeSelectionPolicy policy) : policy_(policy) {
+    for (auto& bucket : buckets_) {
+        bucket = std::make_shared<const Bucket>();
+    }
+}
+
+bool NodeSelector::Update(NodeIndex index, const NodeMetrics& metrics) {
+    if (!table_.Set(index, metrics)) return false;
+    if (index >= node_bucket_.size()) {
+        node_bucket_.resize(index + 1, kNoBucket);
+        static_score_.resize(index + 1, 0.0);
+    }
+
+    size_t previous = node_bucket_[index];
+    size_t next = metrics.available_memory ? BucketOf(metrics.available_memory) : kNoBucket;
+    double score = StaticScore(metrics);
+    if (previous == next && static_score_[index] == score) return true;
+
+    // 只复制受影响的一到两个桶
+    static_score_[index] = score;
+    node_bucket_[index] = next;
+    if (previous != kNoBucket && previous != next) Reposition(previous, index, false);
+    if (next != kNoBucket) Reposition(next, index, true);
+    return true;
+}
+
+void NodeSelector::Reposition(size_t bucket, NodeIndex index, bool insert) {
+    auto updated = std::make_shared<Bucket>(*std::atomic_load(&buckets_[bucket]));
+    updated->erase(std::remove(updated->begin(), updated->end(), index), updated->end());
+    if (insert) {
+        auto position = std::lower_bound(updated->begin(), updated->end(), index, [&](NodeIndex a, NodeIndex b) {
+            return static_score_[a] > static_score_[b];
+        });
+        updated->insert(position, index);
+    }
+    uint64_t bit = uint64_t(1) << bucket;
+    bool empty = updated->empty();
+    std::atomic_store(&buckets_[bucket], std::shared_ptr<const Bucket>(std::move(updated)));
+    if (empty) {
+        nonempty_.fetch_and(~bit, std::memory_order_release);
+    } else {
+        nonempty_.fetch_or(bit, std::memory_order_release);
+    }
+}
+
+NodeIndex NodeSelector::Select(size_t required_memory, int numaId, NodeMetrics* selected) const {
+    switch (Policy()) {
+        case NodeSelectionPolicy::PowerOfTwo: return SelectPowerOfTwo(required_memory, numaId, selected);
+        case NodeSelectionPolicy::Bucketed:   return SelectBucketed(required_memory, numaId, selected);
+        default:                              return SelectExhaustive(required_memory, numaId, selected);
+    }
+}
+
+NodeIndex NodeSelector::SelectExhaustive(size_t required_memory, int numaId, NodeMetrics* selected) const {
+    NodeIndex best_index = kInvalidNodeIndex;
+    double best_score = -1.0;
+
+    for (NodeIndex i = 0, n = static_cast<NodeIndex>(table_.size()); i < n; ++i) {
+        NodeMetrics node = table_.Get(i);
+        // 跳过内存不足的节点
+        if (node.available_memory < required_memory) continue;
+
+        double score = CalculateNodeScore(node, required_memory, numaId);
+        if (score > best_score) {
+            best_score = score;
+            best_index = i;
+            if (selected) *selected = node;
+        }
+    }
+    return best_index;
+}
+
+NodeIndex NodeSelector::SelectPowerOfTwo(size_t required_memory, int numaId, NodeMetrics* selected) const {
+    size_t size = table_.size();
+    if (size == 0) return kInvalidNodeIndex;
+
+    NodeIndex candidates[2];
+    NodeMetrics metrics[2];
+    int found = 0;
+    for (int attempt = 0; attempt < 2 * kSampleAttempts && found < 2; ++attempt) {
+        NodeIndex i = static_cast<NodeIndex>(NextRandom() % size);
+        if (found == 1 && candidates[0] == i && size > 1) continue;
+        metrics[found] = table_.Get(i);
+        if (metrics[found].available_memory < required_memory) continue;
+        candidates[found++] = i;
+    }
+    // 可容纳的节点太少，采样命中率低时退回全量扫描
+    if (found == 0) return SelectExhaustive(required_memory, numaId, selected);
+
+    int best = found == 2 && CalculateNodeScore(metrics[1], required_memory, numaId) >
+                                 CalculateNodeScore(metrics[0], required_memory, numaId) ? 1 : 0;
+    if (selected) *selected = metrics[best];
+    return candidates[best];
+}
+
+NodeIndex NodeSelector::SelectBucketed(size_t required_memory, int numaId, NodeMetrics* selected) const {
+    NodeIndex best_index = kInvalidNodeIndex;
+    double best_score = -1.0;
+
+    // 低于required_memory所在桶的节点都放不下；所在桶内需逐个检查
+    uint64_t nonempty = nonempty_.load(std::memory_order_acquire);
+    for (size_t b = BucketOf(required_memory); b < kBucketCount; ++b) {
+        if (!(nonempty >> b & 1)) continue;
+        std::shared_ptr<const Bucket> bucket = std::atomic_load(&buckets_[b]);
+        size_t scored = 0;
+        for (NodeIndex i : *bucket) {
+            NodeMetrics node = table_.Get(i);
+            if (node.available_memory < required_memory) continue;
+            double score = CalculateNodeScore(node, required_memory, numaId);
+            if (score > best_score) {
+                best_score = score;
+                best_index = i;
+                if (selected) *selected = node;
+            }
+            if (++scored == kBucketCandidates) break;
+        }
+    }
+    return best_index;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+// 分配时的节点选择。写入方（节点增删、健康数据更新）在Dispatcher锁内逐个节点更新指标，
+// 只调整该节点所在的桶；选择方无锁读取节点表与各桶，不持有全局锁。
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 节点在Dispatcher中的稠密下标，LoadConfig/AddNode时分配，与AllocationPlan.targetNodeId一致
+using NodeIndex = uint32_t;
+constexpr NodeIndex kInvalidNodeIndex = UINT32_MAX;
+
+// 节点能力位
+enum NodeCapability : uint8_t {
+    kNodeRdma = 1 << 0,
+    kNodeNvLink = 1 << 1,
+    kNodeGdr = 1 << 2,
+};
+
+// 调度热路径使用的单个节点指标
+struct NodeMetrics {
+    size_t total_memory = 0;
+    size_t available_memory = 0;
+    double network_latency = 0.0;
+    double cpu_usage = 0.0;
+    double gpu_utilization = 0.0;
+    int priority = 0;
+    int numaId = -1;
+    uint8_t capabilities = 0;
+
+    bool Has(NodeCapability capability) const { return (capabilities & capability) != 0; }
+    // 显存占用比例，总量未知时为0
+    double MemoryUtilization() const {
+        return total_memory ? 1.0 - static_cast<double>(available_memory) / total_memory : 0.0;
+    }
+};
+
+// 按NodeIndex连续排列的节点指标。容量固定、元素不移动，选择节点时顺序扫描连续内存。
+// 写入方串行更新；读取方经序列锁无锁读取，得到的单节点副本各字段来自同一次更新
+class NodeTable {
+public:
+    static constexpr size_t kCapacity = 4096;   // 与伪地址中的节点位数一致
+
+    NodeTable();
+
+    size_t size() const { return count_.load(std::memory_order_acquire); }
+    // 写入方调用，index超出当前大小时扩展；超出容量返回false
+    bool Set(NodeIndex index, const NodeMetrics& metrics);
+    NodeMetrics Get(NodeIndex index) const;
+
+private:
+    static constexpr size_t kWords = (sizeof(NodeMetrics) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // 一个节点占一条缓存行
+    struct alignas(64) Slot {
+        std::atomic<uint32_t> sequence{0};      // 奇数表示正在写入
+        std::atomic<uint64_t> words[kWords];
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> count_{0};
+};
+
+// 计算节点综合得分（增强NUMA感知）
+double CalculateNodeScore(const NodeMetrics& node, size_t required_memory, int numaId);
+
+enum class NodeSelectionPolicy : uint8_t {
+    Exhaustive,     // 对所有节点打分，结果最优，耗时随节点数线性增长
+    PowerOfTwo,     // 随机取两个可容纳的节点，选得分高者
+    Bucketed,       // 按可用内存分桶，只对各桶中静态得分最高的少数节点打分
+};
+
+// 配置中的名称：exhaustive / p2c / bucketed，无法识别时为Exhaustive
+NodeSelectionPolicy ParseNodeSelectionPolicy(const std::string& name);
+const char* NodeSelectionPolicyName(NodeSelectionPolicy policy);
+
+class NodeSelector {
+public:
+    // Bucketed策略下每个桶参与打分的候选数
+    static constexpr size_t kBucketCandidates = 4;
+    static constexpr size_t kBucketCount = 64;             // 与nonempty_位数一致
+
+    explicit NodeSelector(NodeSelectionPolicy policy = NodeSelectionPolicy::Exhaustive);
+
+    void SetPolicy(NodeSelectionPolicy policy) { policy_.store(policy, std::memory_order_relaxed); }
+    NodeSelectionPolicy Policy() const { return policy_.load(std::memory_order_relaxed); }
+
+    // 更新一个节点的指标并调整其所在的桶，由写入方串行调用；超出节点表容量返回false
+    bool Update(NodeIndex index, const NodeMetrics& metrics);
+
+    // 选择可容纳required_memory的节点，无可用节点返回kInvalidNodeIndex。可并发调用。
+    // selected返回打分时读到的该节点指标，调用方据此决策而不再读取节点本身
+    NodeIndex Select(size_t required_memory, int numaId, NodeMetrics* selected = nullptr) const;
+
+    size_t Size() const { return table_.size(); }
+
+private:
+    using Bucket = std::vector<NodeIndex>;
+    static constexpr size_t kNoBucket = kBucketCount;
+
+    NodeIndex SelectExhaustive(size_t required_memory, int numaId, NodeMetrics* selected) const;
+    NodeIndex SelectPowerOfTwo(size_t required_memory, int numaId, NodeMetrics* selected) const;
+    NodeIndex SelectBucketed(size_t required_memory, int numaId, NodeMetrics* selected) const;
+
+    // 以复制后替换的方式把index移出bucket，insert为true时再按静态得分插入
+    void Reposition(size_t bucket, NodeIndex index, bool insert);
+
+    std::atomic<NodeSelectionPolicy> policy_;
+    NodeTable table_;
+    // buckets_[b]为可用内存位于[2^b, 2^(b+1))的节点，按静态得分降序；通过std::atomic_load/atomic_store访问
+    std::array<std::shared_ptr<const Bucket>, kBucketCount> buckets_;
+    std::atomic<uint64_t> nonempty_{0};     // 非空桶的位图，选择时跳过空桶
+    // 写入方私有：各节点当前所在的桶与静态得分
+    std::vector<size_t> node_bucket_;
+    std::vector<double> static_score_;
+};
@@ -0,0 +1,70 @@
+#include "access_pattern.h"
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+
+namespace {
+constexpr float kStreamingRatio = 0.75f;     // 前进步长占比阈值
+constexpr double kPeriodicCv = 0.25;         // 间隔变异系数阈值
+}
+
+const char* AccessPatternName(AccessPattern pattern) {
+    switch (pattern) {
+        case AccessPattern::OneShot:   return "one-shot";
+        case AccessPattern::Streaming: return "streaming";
+        case AccessPattern::Periodic:  return "periodic";
+        case AccessPattern::Random:    return "random";
+        default:                       return "unknown";
+    }
+}
+
+void AccessPatternTracker::record(int64_t time_ns, uint64_t offset) {
+    if (accesses_++ == 0) {
+        last_time_ns_ = time_ns;
+        last_offset_ = offset;
+        return;
+    }
+
+    float interval_us = static_cast<float>(std::max<int64_t>(0, time_ns - last_time_ns_) / 1000);
+    uint8_t forward = offset > last_offset_ ? 1 : 0;
+    last_time_ns_ = time_ns;
+    last_offset_ = offset;
+
+    intervals_[head_] = interval_us;
+    forward_bits_ = static_cast<uint8_t>((forward_bits_ & ~(1u << head_)) | (forward << head_));
+    head_ = static_cast<uint8_t>((head_ + 1) % kHistory);
+    if (filled_ < kHistory) ++filled_;
+}
+
+AccessPattern AccessPatternTracker::classify() const {
+    if (accesses_ <= 1) return AccessPattern::OneShot;
+    if (filled_ < kHistory / 2) return AccessPattern::Unknown;
+
+    // 未填满时尚未写入的样本为0，不影响计数与求和
+    if (std::bitset<kHistory>(forward_bits_).count() >= kStreamingRatio * filled_) {
+        return AccessPattern::Streaming;
+    }
+
+    double sum = 0.0;
+    double sq_sum = 0.0;
+    for (float interval : intervals_) {
+        sum += interval;
+        sq_sum += static_cast<double>(interval) * interval;
+    }
+    double mean = sum / filled_;
+    double variance = std::max(0.0, sq_sum / filled_ - mean * mean);
+    if (mean > 0.0 && std::sqrt(variance) < kPeriodicCv * mean) {
+        return AccessPattern::Periodic;
+    }
+    return AccessPattern::Random;
+}
+
+float AccessPatternTracker::stabilityFactor() const {
+    switch (classify()) {
+        case AccessPattern::Periodic:  return 0.9f;  // 周期性复用，适合驻留
+        case AccessPattern::Random:    return 0.5f;
+        case AccessPattern::Streaming: return 0.3f;  // 扫描后通常不再访问
+        case AccessPattern::OneShot:   return 0.2f;
+        default:                       return 0.5f;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// 单个分配的访问模式识别：保留最近kHistory次访问的间隔与偏移步长。
+// 记录在每次访问的热路径上，只写入环形历史；统计量在分类时由这kHistory个样本算出
+#include <array>
+#include <cstdint>
+
+enum class AccessPattern : uint8_t {
+    Unknown,        // 样本不足
+    OneShot,        // 只访问过一次
+    Streaming,      // 偏移单调前进（顺序/定步长扫描）
+    Periodic,       // 访问间隔稳定，反复访问同一区域
+    Random,         // 无明显规律
+};
+
+const char* AccessPatternName(AccessPattern pattern);
+
+class AccessPatternTracker {
+public:
+    static constexpr uint32_t kHistory = 8;
+    static_assert(kHistory <= 8, "forward_bits_ holds one bit per sample");
+
+    void record(int64_t time_ns, uint64_t offset);
+    AccessPattern classify() const;
+
+    // 稳定性评分中的模式因子 (0.0~1.0)
+    float stabilityFactor() const;
+
+    uint64_t accesses() const { return accesses_; }
+
+private:
+    int64_t last_time_ns_ = 0;
+    uint64_t last_offset_ = 0;
+    uint64_t accesses_ = 0;
+
+    // 环形历史：访问间隔（微秒）与偏移是否前进（第i位对应第i个样本）
+    std::array<float, kHistory> intervals_{};
+    uint8_t forward_bits_ = 0;
+    uint8_t head_ = 0;
+    uint8_t filled_ = 0;
+};
@@ -1,140 +1,269 @@
-#include "cooling_service.h"
-#include <iostream>
-#include <chrono>
-#include <cmath> // 用于std::exp
-#include "global_memory.h"
-
-CoolingService::CoolingService() 
-    : cooling_interval_(10), 
-      decay_amount_(1),
-      access_threshold_(4),
-      access_window_(5) {}
-
-CoolingService::~CoolingService() {
-    Stop();
-}
-
-void CoolingService::Start() {
-    if (running_) return;
-    running_ = true;
-    worker_ = std::thread(&CoolingService::Run, this);
-    std::cout << "Cooling service started" << std::endl;
-}
-
-void CoolingService::Stop() {
-    if (!running_) return;
-    running_ = false;
-    if (worker_.joinable()) {
-        worker_.join();
-    }
-    std::cout << "Cooling service stopped" << std::endl;
-}
-
-void CoolingService::RecordAccess(uintptr_t ptr) {
-    std::unique_lock<std::shared_mutex> lock(data_mutex_);
-    auto now = std::chrono::steady_clock::now();
-    
-    // 更新访问记录
-    auto& record = access_records_[ptr];
-    record.access_count++;
-    record.last_access = now;
-    
-    // 获取NUMA节点（简化实现，实际应从全局内存服务获取）
-    record.numaId = GlobalMemory::GetNumaNodeForPtr(ptr);
-    
-    // 计算瞬时热度（基于最近访问）
-    auto time_since_last = std::chrono::duration_cast<std::chrono::milliseconds>(now - record.last_access).count();
-    if (time_since_last > 0) {
-        record.temperature = 1.0f / time_since_last;
-    } else {
-        record.temperature = 1.0f; // 最大值
-    }
-}
-
-bool CoolingService::isHotData(uintptr_t ptr) const {
-    std::shared_lock<std::shared_mutex> lock(data_mutex_);
-    auto it = access_records_.find(ptr);
-    if (it == access_records_.end()) {
-        return false; // 没有访问记录，视为冷数据
-    }
-    
-    const auto& record = it->second;
-    return record.temperature > 0.8f; // 热度阈值
-}
-
-uint32_t CoolingService::getMobility(uintptr_t ptr) const {
-    std::shared_lock<std::shared_mutex> lock(data_mutex_);
-    auto it = access_records_.find(ptr);
-    if (it == access_records_.end()) {
-        return 0;
-    }
-    return it->second.mobility_count;
-}
-
-float CoolingService::getStability(uintptr_t ptr) const {
-    std::shared_lock<std::shared_mutex> lock(data_mutex_);
-    auto it = access_records_.find(ptr);
-    if (it == access_records_.end()) {
-        return 0.0f;
-    }
-    return it->second.stability_score;
-}
-
-int CoolingService::getNumaId(uintptr_t ptr) const {
-    std::shared_lock<std::shared_mutex> lock(data_mutex_);
-    auto it = access_records_.find(ptr);
-    if (it == access_records_.end()) {
-        return -1;
-    }
-    return it->second.numaId;
-}
-
-float CoolingService::getTemperature(uintptr_t ptr) const {
-    std::shared_lock<std::shared_mutex> lock(data_mutex_);
-    auto it = access_records_.find(ptr);
-    if (it == access_records_.end()) {
-        return 0.0f;
-    }
-    return it->second.temperature;
-}
-
-void CoolingService::Run() {
-    while (running_) {
-        std::this_thread::sleep_for(cooling_interval_);
-        
-        auto now = std::chrono::steady_clock::now();
-        std::unique_lock<std::shared_mutex> lock(data_mutex_);
-        
-        // 清理过期的访问记录并更新指标
-        for (auto it = access_records_.begin(); it != access_records_.end();) {
-            auto& record = it->second;
-            auto duration = std::chrono::duration_cast<std::chrono::seconds>(now - record.last_access);
-            
-            // 1. 衰减访问计数
-            if (duration > access_window_) {
-                if (record.access_count > decay_amount_) {
-                    record.access_count -= decay_amount_;
-                } else {
-                    it = access_records_.erase(it);
-                    continue;
-                }
-            }
-            
-            // 2. 计算稳定性评分（增强版）
-            // 基于访问频率、规律性和生存时间
-            float frequency_factor = std::min(1.0f, record.access_count / 100.0f);
-            float time_factor = 1.0f - std::exp(-duration.count() / 3600.0f); // 1小时半衰期
-            float pattern_factor = 0.5f; // 简化版，实际应分析访问模式
-            
-            record.stability_score = frequency_factor * pattern_factor * time_factor;
-            
-            // 3. 更新温度（随时间衰减）
-            auto time_since_last = std::chrono::duration_cast<std::chrono::milliseconds>(now - record.last_access).count();
-            if (time_since_last > 0) {
-                record.temperature = record.temperature * std::exp(-0.001 * time_since_last);
-            }
-            
-            ++it;
-        }
-    }
-}
+#include "cooling_service.h"
+#include "../logging/async_logger.h"
+#include <chrono>
+#include <algorithm>
+#include <cmath> // 用于std::exp
+#include "../memory/fake_address_space.h"
+
+namespace {
+int64_t steady_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+CoolingService::CoolingService() : CoolingService(steady_now_ns) {}
+
+CoolingService::CoolingService(Clock clock)
+    : clock_(clock),
+      expiry_wheel_(tickOf(clock_())),
+      cooling_interval_(10), 
+      decay_amount_(1),
+      access_threshold_(4),
+      access_window_(5) {}
+
+CoolingService::~CoolingService() {
+    Stop();
+}
+
+void CoolingService::Start() {
+    if (running_) return;
+    running_ = true;
+    worker_ = std::thread(&CoolingService::Run, this);
+    LOG_INFO("Cooling service started");
+}
+
+void CoolingService::Stop() {
+    if (!running_) return;
+    running_ = false;
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    LOG_INFO("Cooling service stopped");
+}
+
+// ===== RecordTable =====
+
+// 高6位已用于选择分片，槽号取其下的位
+size_t CoolingService::RecordTable::IndexOf(uintptr_t ptr) const {
+    uint64_t hash = static_cast<uint64_t>(ptr >> 4) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(hash >> 26) & (slots_.size() - 1);
+}
+
+CoolingService::AccessRecord* CoolingService::RecordTable::Find(uintptr_t ptr) {
+    if (slots_.empty()) return nullptr;
+    size_t mask = slots_.size() - 1;
+    for (size_t i = IndexOf(ptr);; i = (i + 1) & mask) {
+        if (slots_[i].key == ptr) return &slots_[i].record;
+        if (slots_[i].key == kEmptyKey) return nullptr;
+    }
+}
+
+CoolingService::AccessRecord& CoolingService::RecordTable::Get(uintptr_t ptr, bool& inserted) {
+    inserted = false;
+    if (AccessRecord* record = Find(ptr)) return *record;
+    // 装载率不超过1/2
+    if ((used_ + 1) * 2 > slots_.size()) Grow();
+    size_t mask = slots_.size() - 1;
+    size_t i = IndexOf(ptr);
+    while (slots_[i].key != kEmptyKey) i = (i + 1) & mask;
+    slots_[i].key = ptr;
+    ++used_;
+    inserted = true;
+    return slots_[i].record;
+}
+
+void CoolingService::RecordTable::Erase(uintptr_t ptr) {
+    if (slots_.empty()) return;
+    size_t mask = slots_.size() - 1;
+    size_t hole = IndexOf(ptr);
+    while (slots_[hole].key != ptr) {
+        if (slots_[hole].key == kEmptyKey) return;
+        hole = (hole + 1) & mask;
+    }
+    // 后续连续的条目中，起始槽不在(hole, j]内的前移填补空位
+    for (size_t j = (hole + 1) & mask; slots_[j].key != kEmptyKey; j = (j + 1) & mask) {
+        size_t home = IndexOf(slots_[j].key);
+        bool between = hole < j ? (home > hole && home <= j) : (home > hole || home <= j);
+        if (!between) {
+            slots_[hole] = slots_[j];
+            hole = j;
+        }
+    }
+    slots_[hole] = Slot();
+    --used_;
+}
+
+void CoolingService::RecordTable::Grow() {
+    std::vector<Slot> old(std::max<size_t>(16, slots_.size() * 2));
+    old.swap(slots_);
+    size_t mask = slots_.size() - 1;
+    for (const Slot& slot : old) {
+        if (slot.key == kEmptyKey) continue;
+        size_t i = IndexOf(slot.key);
+        while (slots_[i].key != kEmptyKey) i = (i + 1) & mask;
+        slots_[i] = slot;
+    }
+}
+
+// ===== CoolingService =====
+
+CoolingService::Shard& CoolingService::shardFor(uintptr_t ptr) {
+    // 分配地址低位对齐，乘法哈希后取高位
+    uint64_t hash = static_cast<uint64_t>(ptr >> 4) * 0x9E3779B97F4A7C15ull;
+    return shards_[hash >> 58];
+}
+
+const CoolingService::Shard& CoolingService::shardFor(uintptr_t ptr) const {
+    return const_cast<CoolingService*>(this)->shardFor(ptr);
+}
+
+// 距上次访问超过access_window_后，每个cooling_interval_衰减decay_amount_，
+// 第k次衰减覆盖(窗口+(k-1)周期, 窗口+k周期]，与expiryTime一致
+uint64_t CoolingService::decayedCount(uint64_t count, int64_t idle_ns) const {
+    auto idle = std::chrono::nanoseconds(idle_ns);
+    if (idle <= access_window_) return count;
+    auto interval = std::chrono::nanoseconds(cooling_interval_);
+    uint64_t steps = static_cast<uint64_t>((idle - access_window_ + interval - std::chrono::nanoseconds(1)) / interval);
+    uint64_t decay = steps * decay_amount_;
+    return count > decay ? count - decay : 0;
+}
+
+// 计数衰减到0的时刻，即记录的过期时间
+int64_t CoolingService::expiryTime(uint64_t count, int64_t last_access) const {
+    uint64_t steps = std::max<uint64_t>(1, (count + decay_amount_ - 1) / decay_amount_);
+    auto idle = std::chrono::nanoseconds(access_window_) +
+                std::chrono::nanoseconds(cooling_interval_) * static_cast<int64_t>(steps - 1);
+    return last_access + idle.count() + 1;
+}
+
+uint64_t CoolingService::tickOf(int64_t time_ns) const {
+    return static_cast<uint64_t>(time_ns / std::chrono::nanoseconds(wheel_tick_).count());
+}
+
+void CoolingService::RecordAccess(uintptr_t ptr, uint64_t offset) {
+    Shard& shard = shardFor(ptr);
+    int64_t now = clock_();
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        bool inserted = false;
+        AccessRecord& record = shard.records.Get(ptr, inserted);
+        if (!inserted) {
+            // 先结算空闲期间的衰减，再计入本次访问（并发记录的时间戳可能略早于上次）
+            int64_t idle_ns = std::max<int64_t>(0, now - record.last_access);
+            record.access_count = decayedCount(record.access_count, idle_ns) + 1;
+            record.last_access = std::max(record.last_access, now);
+
+            // 计算瞬时热度（基于与上次访问的间隔）
+            int64_t since_last_ms = idle_ns / 1000000;
+            record.temperature = since_last_ms > 0 ? 1.0f / since_last_ms : 1.0f;
+            record.pattern.record(now, offset);
+            return;
+        }
+
+        // 首次访问：NUMA节点编码在伪地址中
+        record.access_count = 1;
+        record.last_access = now;
+        record.numaId = FakeAddressSpace::IsFake(ptr) ? FakeAddressSpace::NumaOf(ptr) : -1;
+        record.temperature = 1.0f;
+        record.pattern.record(now, offset);
+    }
+    // 新记录加入过期时间轮
+    std::lock_guard<std::mutex> lock(wheel_mutex_);
+    expiry_wheel_.schedule(ptr, tickOf(expiryTime(1, now)) + 1);
+}
+
+AccessSnapshot CoolingService::snapshot(uintptr_t ptr) const {
+    AccessSnapshot result;
+    const Shard& shard = shardFor(ptr);
+    uint64_t count;
+    int64_t last_access;
+    float temperature;
+    float pattern_factor;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const AccessRecord* record = shard.records.Find(ptr);
+        if (!record) {
+            return result; // 没有访问记录，视为冷数据
+        }
+        count = record->access_count;
+        last_access = record->last_access;
+        temperature = record->temperature;
+        result.mobility = record->mobility_count;
+        result.numaId = record->numaId;
+        result.pattern = record->pattern.classify();
+        pattern_factor = record->pattern.stabilityFactor();
+    }
+
+    int64_t idle_ns = std::max<int64_t>(0, clock_() - last_access);
+    result.tracked = true;
+    result.accessCount = decayedCount(count, idle_ns);
+
+    // 温度随空闲时间指数衰减
+    double idle_ms = idle_ns / 1e6;
+    result.temperature = static_cast<float>(temperature * std::exp(-0.001 * idle_ms));
+    result.hot = result.temperature > 0.8f; // 热度阈值
+
+    // 稳定性评分：基于访问频率、访问模式和生存时间
+    float frequency_factor = std::min(1.0f, result.accessCount / 100.0f);
+    float time_factor = 1.0f - std::exp(-static_cast<float>(idle_ms / 1000.0) / 3600.0f); // 1小时半衰期
+    result.stability = frequency_factor * pattern_factor * time_factor;
+    return result;
+}
+
+bool CoolingService::isHotData(uintptr_t ptr) const {
+    return snapshot(ptr).hot;
+}
+
+uint32_t CoolingService::getMobility(uintptr_t ptr) const {
+    return snapshot(ptr).mobility;
+}
+
+float CoolingService::getStability(uintptr_t ptr) const {
+    return snapshot(ptr).stability;
+}
+
+int CoolingService::getNumaId(uintptr_t ptr) const {
+    return snapshot(ptr).numaId;
+}
+
+float CoolingService::getTemperature(uintptr_t ptr) const {
+    return snapshot(ptr).temperature;
+}
+
+// 处理时间轮中到期的记录：计数已衰减到0的删除，期间有访问的按新的过期时间重新排期
+void CoolingService::expireDue() {
+    int64_t now = clock_();
+    due_.clear();
+    {
+        std::lock_guard<std::mutex> lock(wheel_mutex_);
+        expiry_wheel_.advance(tickOf(now), [this](uintptr_t ptr) { due_.push_back(ptr); });
+    }
+    if (due_.empty()) return;
+
+    std::vector<std::pair<uintptr_t, uint64_t>> reschedule;
+    for (uintptr_t ptr : due_) {
+        Shard& shard = shardFor(ptr);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const AccessRecord* record = shard.records.Find(ptr);
+        if (!record) continue;
+        int64_t expiry = expiryTime(record->access_count, record->last_access);
+        if (expiry <= now) {
+            shard.records.Erase(ptr);
+        } else {
+            reschedule.emplace_back(ptr, tickOf(expiry) + 1);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(wheel_mutex_);
+    for (const auto& entry : reschedule) {
+        expiry_wheel_.schedule(entry.first, entry.second);
+    }
+}
+
+void CoolingService::Run() {
+    while (running_) {
+        std::this_thread::sleep_for(wheel_tick_);
+        expireDue();
+    }
+}
@@ -1,58 +1,133 @@
-#pragma once
-
-#include <thread>
-#include <atomic>
-#include <shared_mutex>
-#include <unordered_map>
-#include <chrono>
-#include "global_memory.h"
-
-class CoolingService {
-public:
-    static CoolingService& Instance() {
-        static CoolingService instance;
-        return instance;
-    }
-
-    void Start();
-    void Stop();
-    void RecordAccess(uintptr_t ptr);
-
-    // 获取数据热度状态 (热/冷)
-    bool isHotData(uintptr_t ptr) const;
-    
-    // 获取数据流动性（迁移次数）
-    uint32_t getMobility(uintptr_t ptr) const;
-    
-    // 获取数据稳定性评分
-    float getStability(uintptr_t ptr) const;
-    
-    // 获取NUMA节点标识符
-    int getNumaId(uintptr_t ptr) const;
-    
-    // 获取数据热度值
-    float getTemperature(uintptr_t ptr) const;
-
-private:
-    struct AccessRecord {
-        uint64_t access_count = 0;
-        std::chrono::steady_clock::time_point last_access;
-        uint32_t mobility_count = 0;         // 迁移次数
-        float stability_score = 0.0f;        // 稳定性评分 (0.0~1.0)
-        int numaId = -1;                     // NUMA节点标识符
-        float temperature = 0.0f;            // 数据热度值
-    };
-
-    void Run();
-
-    std::thread worker_;
-    std::atomic<bool> running_{false};
-    mutable std::shared_mutex data_mutex_;
-    std::unordered_map<uintptr_t, AccessRecord> access_records_;
-    
-    // 冷却参数 (默认值)
-    std::chrono::seconds cooling_interval_{10};  // 冷却周期
-    uint32_t decay_amount_{1};                   // 每次衰减值
-    uint32_t access_threshold_{4};               // 访问阈值
-    std::chrono::seconds access_window_{5};       // 访问时间窗口
-};
+#pragma once
+
+#include <thread>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include "access_pattern.h"
+#include "timing_wheel.h"
+
+// 单个地址的全部数据特性，一次查找取得
+struct AccessSnapshot {
+    bool tracked = false;                // 是否有访问记录
+    bool hot = false;
+    uint64_t accessCount = 0;
+    uint32_t mobility = 0;
+    float stability = 0.0f;
+    int numaId = -1;
+    float temperature = 0.0f;
+    AccessPattern pattern = AccessPattern::Unknown;
+};
+
+class CoolingService {
+public:
+    static CoolingService& Instance() {
+        static CoolingService instance;
+        return instance;
+    }
+
+    // 时间源（steady_clock纳秒），测试可注入假时钟
+    using Clock = int64_t (*)();
+
+    CoolingService();
+    explicit CoolingService(Clock clock);
+    ~CoolingService();
+
+    void Start();
+    void Stop();
+    // 处理时间轮中到期的记录，工作线程每个时间轮tick调用一次
+    void expireDue();
+    // offset为本次访问在分配内的偏移，用于识别访问模式
+    void RecordAccess(uintptr_t ptr, uint64_t offset = 0);
+
+    // 获取全部数据特性（单次查找）
+    AccessSnapshot snapshot(uintptr_t ptr) const;
+
+    // 获取数据热度状态 (热/冷)
+    bool isHotData(uintptr_t ptr) const;
+    
+    // 获取数据流动性（迁移次数）
+    uint32_t getMobility(uintptr_t ptr) const;
+    
+    // 获取数据稳定性评分
+    float getStability(uintptr_t ptr) const;
+    
+    // 获取NUMA节点标识符
+    int getNumaId(uintptr_t ptr) const;
+    
+    // 获取数据热度值
+    float getTemperature(uintptr_t ptr) const;
+
+private:
+    // 记录由所在分片的互斥锁保护。每次访问只做几次算术运算，临界区很短，
+    // 普通互斥锁比共享锁加原子计数与自旋锁的组合便宜。
+    // 衰减不回写，读取时按距上次访问的时间推算（见snapshot）
+    struct AccessRecord {
+        uint64_t access_count = 0;      // 上次访问时的计数
+        int64_t last_access = 0;        // steady_clock计时（纳秒）
+        uint32_t mobility_count = 0;    // 迁移次数
+        int numaId = -1;                // NUMA节点标识符
+        float temperature = 0.0f;       // 上次访问时的热度值
+        AccessPatternTracker pattern;
+    };
+
+    // 地址 → 记录的开放寻址表（线性探测），记录直接存放在槽中，查找不经过节点指针。
+    // 删除时后移填补空位，不留墓碑
+    class RecordTable {
+    public:
+        AccessRecord* Find(uintptr_t ptr);
+        const AccessRecord* Find(uintptr_t ptr) const {
+            return const_cast<RecordTable*>(this)->Find(ptr);
+        }
+        // 不存在时插入默认记录，inserted报告是否为新插入
+        AccessRecord& Get(uintptr_t ptr, bool& inserted);
+        void Erase(uintptr_t ptr);
+
+    private:
+        static constexpr uintptr_t kEmptyKey = ~uintptr_t(0);
+        struct Slot {
+            uintptr_t key = kEmptyKey;
+            AccessRecord record;
+        };
+        size_t IndexOf(uintptr_t ptr) const;
+        void Grow();
+
+        std::vector<Slot> slots_;
+        size_t used_ = 0;
+    };
+
+    // 按指针哈希分片
+    static constexpr size_t kShardCount = 64;
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        RecordTable records;
+    };
+
+    Shard& shardFor(uintptr_t ptr);
+    const Shard& shardFor(uintptr_t ptr) const;
+    uint64_t decayedCount(uint64_t count, int64_t idle_ns) const;
+    int64_t expiryTime(uint64_t count, int64_t last_access) const;
+    uint64_t tickOf(int64_t time_ns) const;
+    void Run();
+
+    std::thread worker_;
+    std::atomic<bool> running_{false};
+    std::array<Shard, kShardCount> shards_;
+
+    // 过期时间轮：每条记录一个条目，到期时按最新访问时间复查，
+    // 未过期的重新排期。访问路径不触碰时间轮
+    Clock clock_;
+    std::chrono::milliseconds wheel_tick_{100};
+    std::mutex wheel_mutex_;
+    TimingWheel<uintptr_t> expiry_wheel_;
+    std::vector<uintptr_t> due_;                 // 仅工作线程使用
+    
+    // 冷却参数 (默认值)
+    std::chrono::seconds cooling_interval_{10};  // 冷却周期
+    uint32_t decay_amount_{1};                   // 每次衰减值
+    uint32_t access_threshold_{4};               // 访问阈值
+    std::chrono::seconds access_window_{5};       // 访问时间窗口
+};
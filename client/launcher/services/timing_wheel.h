@@ -0,0 +1,94 @@
+#pragma once
+
+// 分层时间轮：4层×64槽，每层槽宽为下一层整圈。
+// 条目只在到期或所在上层槽位被下放时移动，推进代价与到期数量成正比。
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+template <typename Key>
+class TimingWheel {
+public:
+    static constexpr int kLevels = 4;
+    static constexpr unsigned kSlotBits = 6;
+    static constexpr size_t kSlots = size_t(1) << kSlotBits;
+    static constexpr uint64_t kMask = kSlots - 1;
+    // 最远可排期的tick数，更远的截断到此处（到期时由调用方复查）
+    static constexpr uint64_t kMaxSpan = (kSlots - 1) << (kSlotBits * (kLevels - 1));
+
+    explicit TimingWheel(uint64_t startTick = 0) : current_(startTick) {}
+
+    uint64_t currentTick() const { return current_; }
+    size_t size() const { return size_; }
+
+    // 在deadlineTick到期；已过期的在下一个tick触发
+    void schedule(const Key& key, uint64_t deadlineTick) {
+        place(Entry{key, std::max(deadlineTick, current_ + 1)});
+        ++size_;
+    }
+
+    // 推进到nowTick，对每个到期条目调用onExpire(key)。回调中可以再次schedule
+    template <typename Fn>
+    void advance(uint64_t nowTick, Fn&& onExpire) {
+        std::vector<Entry> due;
+        while (current_ < nowTick) {
+            ++current_;
+
+            // 跨入上层槽位的时间段时由高到低逐层下放
+            int top = 0;
+            while (top + 1 < kLevels && (current_ & ((uint64_t(1) << (kSlotBits * (top + 1))) - 1)) == 0) {
+                ++top;
+            }
+            for (int level = top; level >= 1; --level) {
+                cascade(level, (current_ >> (kSlotBits * level)) & kMask);
+            }
+
+            due.clear();
+            due.swap(slots_[0][current_ & kMask]);
+            size_ -= due.size();
+            for (auto& entry : due) {
+                onExpire(entry.key);
+            }
+        }
+    }
+
+    void clear() {
+        for (auto& level : slots_) {
+            for (auto& slot : level) slot.clear();
+        }
+        size_ = 0;
+    }
+
+private:
+    struct Entry {
+        Key key;
+        uint64_t deadline;
+    };
+
+    // 选择与当前tick仅在该层及以下不同的最低层
+    void place(Entry entry) {
+        entry.deadline = std::min(std::max(entry.deadline, current_), current_ + kMaxSpan);
+        for (int level = 0; level < kLevels; ++level) {
+            unsigned shift = kSlotBits * (level + 1);
+            if (level == kLevels - 1 || (entry.deadline >> shift) == (current_ >> shift)) {
+                slots_[level][(entry.deadline >> (kSlotBits * level)) & kMask].push_back(std::move(entry));
+                return;
+            }
+        }
+    }
+
+    void cascade(int level, size_t index) {
+        std::vector<Entry> entries;
+        entries.swap(slots_[level][index]);
+        for (auto& entry : entries) {
+            place(std::move(entry));
+        }
+    }
+
+    uint64_t current_;
+    size_t size_ = 0;
+    std::array<std::array<std::vector<Entry>, kSlots>, kLevels> slots_;
+};
@@ -0,0 +1,123 @@
+// 访问模式识别的合成轨迹回放：检查各类轨迹的分类准确率，并输出每次记录的耗时
+// 构建（在client/launcher下）：
+//   g++ -std=c++17 -O2 -I. tests/access_pattern_test.cpp services/access_pattern.cpp -o access_pattern_test
+#include "services/access_pattern.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+struct Access {
+    int64_t time_ns;
+    uint64_t offset;
+};
+
+constexpr int64_t kMs = 1000000;
+constexpr uint64_t kAllocSize = 64 << 20;
+
+// 顺序扫描：偏移按固定步长前进，间隔随意
+std::vector<Access> streamingTrace(std::mt19937_64& rng, size_t count) {
+    std::vector<Access> trace;
+    int64_t t = 0;
+    uint64_t offset = 0;
+    uint64_t stride = 4096 << (rng() % 6);
+    for (size_t i = 0; i < count; ++i) {
+        trace.push_back({t, offset});
+        t += kMs / 10 + static_cast<int64_t>(rng() % (5 * kMs));
+        offset += stride;
+    }
+    return trace;
+}
+
+// 周期复用：间隔抖动不超过10%，反复访问同一区域
+std::vector<Access> periodicTrace(std::mt19937_64& rng, size_t count) {
+    std::vector<Access> trace;
+    int64_t period = (1 + static_cast<int64_t>(rng() % 100)) * kMs;
+    int64_t t = 0;
+    for (size_t i = 0; i < count; ++i) {
+        trace.push_back({t, 0});
+        t += period + static_cast<int64_t>(rng() % (period / 10 + 1)) - period / 20;
+    }
+    return trace;
+}
+
+// 随机访问：偏移与间隔均无规律
+std::vector<Access> randomTrace(std::mt19937_64& rng, size_t count) {
+    std::vector<Access> trace;
+    int64_t t = 0;
+    for (size_t i = 0; i < count; ++i) {
+        trace.push_back({t, rng() % kAllocSize});
+        t += static_cast<int64_t>(rng() % (50 * kMs));
+    }
+    return trace;
+}
+
+struct Case {
+    AccessPattern expected;
+    std::vector<Access> (*generate)(std::mt19937_64&, size_t);
+};
+}
+
+int main() {
+    std::mt19937_64 rng(2024);
+    const Case cases[] = {
+        {AccessPattern::Streaming, streamingTrace},
+        {AccessPattern::Periodic, periodicTrace},
+        {AccessPattern::Random, randomTrace},
+    };
+    constexpr size_t kTraces = 1000;
+    constexpr size_t kLength = 32;
+
+    uint64_t recorded = 0;
+    std::chrono::steady_clock::duration elapsed{};
+    for (const auto& c : cases) {
+        size_t correct = 0;
+        for (size_t i = 0; i < kTraces; ++i) {
+            auto trace = c.generate(rng, kLength);
+            AccessPatternTracker tracker;
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& access : trace) tracker.record(access.time_ns, access.offset);
+            elapsed += std::chrono::steady_clock::now() - start;
+            recorded += trace.size();
+            correct += tracker.classify() == c.expected;
+        }
+        double accuracy = 100.0 * correct / kTraces;
+        std::printf("%-10s %6.1f%% correct\n", AccessPatternName(c.expected), accuracy);
+        CHECK(accuracy >= 90.0);
+    }
+
+    // 单次访问与样本不足
+    AccessPatternTracker once;
+    once.record(0, 0);
+    CHECK(once.classify() == AccessPattern::OneShot);
+    AccessPatternTracker few;
+    for (int i = 0; i < 3; ++i) few.record(i * kMs, 0);
+    CHECK(few.classify() == AccessPattern::Unknown);
+
+    // 模式随近期历史变化：周期访问之后转为顺序扫描
+    AccessPatternTracker shifting;
+    for (int i = 0; i < 16; ++i) shifting.record(i * 10 * kMs, 0);
+    CHECK(shifting.classify() == AccessPattern::Periodic);
+    for (uint32_t i = 0; i < AccessPatternTracker::kHistory; ++i) shifting.record((16 + i) * 10 * kMs, (i + 1) * 4096);
+    CHECK(shifting.classify() == AccessPattern::Streaming);
+
+    std::printf("record: %.1f ns/access\n",
+                std::chrono::duration<double, std::nano>(elapsed).count() / recorded);
+    if (g_failures) {
+        std::fprintf(stderr, "access_pattern_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("access_pattern_test: OK\n");
+    return 0;
+}
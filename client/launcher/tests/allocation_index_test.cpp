@@ -0,0 +1,197 @@
+// 分配区间索引测试：内部指针解析、重叠拒绝、叶子拆分/合并、删除后句柄有效、冻结视图不受后续修改影响、
+// 并发读写，并输出查找耗时
+// 构建（在client/launcher下）：
+//   g++ -std=c++17 -O2 -I. tests/allocation_index_test.cpp -pthread -o allocation_index_test
+#include "memory/allocation_index.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+constexpr uintptr_t kBase = 0x200000000000ull;
+
+void testBasic() {
+    AllocationIndex<int> index;
+    CHECK(!index.Find(kBase));
+    CHECK(index.Insert(kBase, 100, 1));
+    CHECK(index.Insert(kBase + 100, 50, 2));      // 紧邻不算重叠
+    CHECK(!index.Insert(kBase + 99, 10, 3));      // 与前一个重叠
+    CHECK(!index.Insert(kBase - 5, 10, 3));       // 与后一个重叠
+    CHECK(!index.Insert(kBase + 10, 1, 3));       // 落在已有分配内部
+    CHECK(index.Size() == 2);
+
+    auto hit = index.Find(kBase + 120);
+    CHECK(hit && hit->base == kBase + 100 && hit->offset == 20 && hit->value == 2);
+    CHECK(!index.Find(kBase + 150));              // 末尾之后
+    CHECK(!index.Find(kBase - 1));
+
+    size_t offset = 0;
+    auto handle = index.Lookup(kBase + 99, &offset);
+    CHECK(handle && *handle == 1 && offset == 99);
+
+    CHECK(!index.Erase(kBase + 1));               // 只接受起始地址
+    CHECK(index.Erase(kBase));
+    CHECK(!index.Erase(kBase));
+    CHECK(!index.Find(kBase + 5));
+    CHECK(index.Size() == 1);
+}
+
+// 删除后已取得的句柄仍然有效；同一地址只有一方Take成功
+void testHandleOutlivesErase() {
+    AllocationIndex<std::vector<int>> index;
+    CHECK(index.Insert(kBase, 4096, std::vector<int>(1000, 7)));
+    auto handle = index.Lookup(kBase + 10);
+    auto taken = index.Take(kBase);
+    CHECK(taken && taken == handle);
+    CHECK(!index.Take(kBase));
+    CHECK(!index.Lookup(kBase + 10));
+    taken.reset();
+    CHECK(handle->size() == 1000 && (*handle)[999] == 7);
+}
+
+// 大量分配触发叶子拆分，乱序删除后剩余分配仍可解析
+void testSplitAndErase() {
+    AllocationIndex<size_t> index;
+    std::mt19937_64 rng(1);
+    std::vector<std::pair<uintptr_t, size_t>> spans;
+    uintptr_t cursor = kBase;
+    for (size_t i = 0; i < 20000; ++i) {
+        size_t size = 1 + rng() % 8192;
+        spans.emplace_back(cursor, size);
+        cursor += size + rng() % 64;
+    }
+    std::vector<size_t> order(spans.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+    for (size_t i : order) CHECK(index.Insert(spans[i].first, spans[i].second, i));
+    CHECK(index.Size() == spans.size());
+
+    for (size_t i = 0; i < spans.size(); i += 2) CHECK(index.Erase(spans[i].first));
+    for (size_t i = 0; i < spans.size(); ++i) {
+        auto hit = index.Find(spans[i].first + spans[i].second - 1);
+        if (i % 2) {
+            CHECK(hit && hit->value == i && hit->offset == spans[i].second - 1);
+        } else {
+            CHECK(!hit);
+        }
+    }
+
+    uintptr_t previous = 0;
+    size_t visited = 0;
+    index.ForEach([&](uintptr_t base, size_t, const size_t&) {
+        CHECK(base > previous);
+        previous = base;
+        ++visited;
+    });
+    CHECK(visited == spans.size() / 2);
+}
+
+// 冻结视图与索引共享叶子，之后的插入、删除与拆分只复制被修改的叶子
+void testFreeze() {
+    AllocationIndex<size_t> index;
+    for (size_t i = 0; i < 1000; ++i) CHECK(index.Insert(kBase + i * 4096, 4096, i));
+    auto frozen = index.Freeze();
+
+    for (size_t i = 0; i < 1000; i += 2) CHECK(index.Erase(kBase + i * 4096));
+    for (size_t i = 1000; i < 3000; ++i) CHECK(index.Insert(kBase + i * 4096, 4096, i));
+    CHECK(index.Size() == 2500);
+
+    size_t visited = 0;
+    bool ordered = true;
+    frozen.ForEach([&](uintptr_t base, size_t size, const size_t& value) {
+        ordered = ordered && base == kBase + visited * 4096 && size == 4096 && value == visited;
+        ++visited;
+    });
+    CHECK(ordered && visited == 1000 && frozen.Size() == 1000);
+    CHECK(!index.Find(kBase) && index.Find(kBase + 4096)->value == 1);
+}
+
+// 读者持有句柄期间写者删除并重新插入，读到的值始终完整
+void testConcurrent() {
+    struct Entry {
+        uint64_t a;
+        uint64_t b;
+    };
+    AllocationIndex<Entry> index;
+    constexpr size_t kSlots = 256;
+    for (size_t i = 0; i < kSlots; ++i) index.Insert(kBase + i * 4096, 4096, Entry{i, ~i});
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> torn{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&, t] {
+            std::mt19937_64 rng(t);
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto entry = index.Lookup(kBase + (rng() % kSlots) * 4096 + rng() % 4096);
+                if (entry && entry->a != ~entry->b) torn.fetch_add(1);
+            }
+        });
+    }
+    std::mt19937_64 rng(99);
+    for (size_t i = 0; i < 200000; ++i) {
+        size_t slot = rng() % kSlots;
+        uintptr_t base = kBase + slot * 4096;
+        if (index.Erase(base)) {
+            uint64_t value = rng();
+            index.Insert(base, 4096, Entry{value, ~value});
+        }
+    }
+    stop = true;
+    for (auto& reader : readers) reader.join();
+    CHECK(torn.load() == 0);
+    CHECK(index.Size() == kSlots);
+}
+
+void benchLookup() {
+    AllocationIndex<int> index;
+    std::mt19937_64 rng(3);
+    std::vector<std::pair<uintptr_t, size_t>> spans;
+    uintptr_t cursor = kBase;
+    for (int i = 0; i < 1000000; ++i) {
+        size_t size = 256 + rng() % 65536;
+        spans.emplace_back(cursor, size);
+        index.Insert(cursor, size, i);
+        cursor += (size + 255) & ~uintptr_t(255);
+    }
+    std::vector<uintptr_t> queries;
+    for (int i = 0; i < 2000000; ++i) {
+        auto& span = spans[rng() % spans.size()];
+        queries.push_back(span.first + rng() % span.second);
+    }
+    size_t hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uintptr_t ptr : queries) hits += index.Find(ptr).has_value();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / queries.size();
+    CHECK(hits == queries.size());
+    std::printf("Find: %.0f ns/lookup over %zu allocations\n", ns, spans.size());
+}
+}
+
+int main() {
+    testBasic();
+    testHandleOutlivesErase();
+    testSplitAndErase();
+    testFreeze();
+    testConcurrent();
+    benchLookup();
+    if (g_failures) {
+        std::fprintf(stderr, "allocation_index_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("allocation_index_test: OK\n");
+    return 0;
+}
@@ -0,0 +1,146 @@
+// 异步日志测试：记录格式化、已退出线程的丢弃数在缓冲回收后仍计入总数，
+// 并对比分配决策路径上cout+endl（持锁）与异步日志的决策吞吐
+// 构建（在client/launcher下）：
+//   g++ -std=c++17 -O2 -I. tests/async_logger_test.cpp logging/async_logger.cpp -pthread -o async_logger_test
+// 日志输出重定向到空设备，结果写到stderr
+#include "logging/async_logger.h"
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+#ifdef _WIN32
+constexpr const char* kNullDevice = "NUL";
+#else
+constexpr const char* kNullDevice = "/dev/null";
+#endif
+
+std::string Body(const std::string& line) {
+    // 去掉时间、级别与线程号前缀
+    size_t pos = line.find("] ", line.find("] ") + 2);
+    return pos == std::string::npos ? line : line.substr(pos + 2);
+}
+
+void testFormat() {
+    LogRecord record{};
+    record.format = "ptr {:x} node {} temp {} size {} neg {} ok {} extra {}";
+    record.level = LogLevel::Info;
+    record.Add(static_cast<uintptr_t>(0xdeadbeef));
+    record.Add(std::string("node-1"));
+    record.Add(0.5f);
+    record.Add(static_cast<size_t>(4096));
+    record.Add(-3);
+    record.Add(true);
+
+    std::string line;
+    AsyncLogger::Format(record, line);
+    CHECK(line.find("INFO") != std::string::npos);
+    // 参数不足的占位符输出为空
+    CHECK(Body(line) == "ptr 0xdeadbeef node node-1 temp 0.5 size 4096 neg -3 ok true extra ");
+
+    LogRecord longText{};
+    longText.format = "{}";
+    longText.Add(std::string(200, 'a'));
+    line.clear();
+    AsyncLogger::Format(longText, line);
+    CHECK(Body(line) == std::string(LogRecord::kTextBytes, 'a'));
+}
+
+// 在一个短命线程中连续写入超过缓冲容量的记录
+void Burst() {
+    std::thread([] {
+        for (size_t i = 0; i < 4 * LogRing::kCapacity; ++i) LOG_INFO("burst {}", i);
+    }).join();
+}
+
+void testDroppedAfterRetire() {
+    AsyncLogger& logger = AsyncLogger::Instance();
+    logger.SetFlushInterval(std::chrono::milliseconds(1000));
+    Burst();
+    // 第一次取空缓冲，第二次回收已退出线程的缓冲
+    logger.Flush();
+    logger.Flush();
+    uint64_t first = logger.DroppedCount();
+    CHECK(first > 0);
+
+    Burst();
+    logger.Flush();
+    logger.Flush();
+    CHECK(logger.DroppedCount() > first);
+    logger.SetFlushInterval(std::chrono::milliseconds(10));
+}
+
+// 原分配决策的同步输出：持锁逐行cout并flush
+std::mutex g_decision_mutex;
+void ConsoleDecision(uintptr_t ptr, size_t size) {
+    std::lock_guard<std::mutex> lock(g_decision_mutex);
+    auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::cout << "[" << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << "] Data at 0x" << std::hex << ptr
+              << std::dec << " - Heat: HOT, Temp: " << 0.5f << ", Mobility: " << 3 << ", Stability: " << 0.7f
+              << ", Pattern: periodic, NUMA: " << 1 << " (size: " << size << " bytes)" << std::endl;
+    std::cout << "  - Using RDMA for reads and UDP for writes" << std::endl;
+    std::cout << "  - NUMA mismatch: source=" << 1 << ", target=" << 2 << std::endl;
+    std::cout << "  - Enabling prefetch for cross-NUMA transfer" << std::endl;
+    std::cout << "  - Target node has NVLink support" << std::endl;
+}
+
+// 现在的决策日志：采样的Info加默认关闭的Debug
+void AsyncDecision(uintptr_t ptr, size_t size) {
+    LAUNCHER_LOG_SAMPLED(LogLevel::Info, 64,
+                         "Data at {:x} - Heat: {}, Temp: {}, Mobility: {}, Stability: {}, Pattern: {}, NUMA: {} (size: {} bytes)",
+                         ptr, "HOT", 0.5f, 3u, 0.7f, "periodic", 1, size);
+    LOG_DEBUG("  - Using RDMA for reads and UDP for writes");
+    LOG_DEBUG("  - NUMA mismatch: source={}, target={}", 1, 2);
+    LOG_DEBUG("  - Enabling prefetch for cross-NUMA transfer");
+    LOG_DEBUG("  - Target node has NVLink support");
+}
+
+template <typename Fn>
+void benchDecisions(const char* name, Fn&& fn, int threads) {
+    const int perThread = 200000 / threads;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < perThread; ++i) fn(uintptr_t(0x200000000000) + i, 4096);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(stderr, "%-24s threads=%d  %.2f M decisions/s\n", name, threads, perThread * threads / seconds / 1e6);
+}
+}
+
+int main() {
+    if (!std::freopen(kNullDevice, "w", stdout)) return 1;
+
+    testFormat();
+    testDroppedAfterRetire();
+    for (int threads : {1, 4}) {
+        benchDecisions("cout+endl under mutex", ConsoleDecision, threads);
+        benchDecisions("async (sampled info)", AsyncDecision, threads);
+        AsyncLogger::Instance().Flush();
+    }
+    if (g_failures) {
+        std::fprintf(stderr, "async_logger_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::fprintf(stderr, "async_logger_test: OK\n");
+    return 0;
+}
@@ -0,0 +1,236 @@
+// 冷却服务测试：未记录地址视为冷数据、NUMA取自伪地址、假时钟下计数按空闲时间惰性衰减且再次访问从衰减后的值累加、
+// 过期时间轮只删除计数已衰减到0的记录（期间有访问的重新排期）、多线程并发记录（含同一地址的首次插入竞争）
+// 计数不丢失，并对比单锁全局表与分片表的RecordAccess吞吐
+// 构建（在client/launcher下）：
+//   g++ -std=c++17 -O2 -I. tests/cooling_service_test.cpp services/cooling_service.cpp services/access_pattern.cpp
+//       memory/fake_address_space.cpp logging/async_logger.cpp -pthread -o cooling_service_test
+#include "services/cooling_service.h"
+#include "memory/fake_address_space.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+std::vector<uintptr_t> MakePointers(FakeAddressSpace& space, size_t count) {
+    std::vector<uintptr_t> ptrs;
+    for (size_t i = 0; i < count; ++i) {
+        ptrs.push_back(space.Allocate(static_cast<uint32_t>(i % 16), static_cast<int>(i % 4), 4096));
+    }
+    return ptrs;
+}
+
+void testSnapshot() {
+    CoolingService service;
+    FakeAddressSpace space;
+    uintptr_t ptr = space.Allocate(3, 2, 1 << 20);
+    CHECK(!service.snapshot(ptr).tracked && !service.isHotData(ptr));
+
+    for (int i = 0; i < 10; ++i) service.RecordAccess(ptr, uint64_t(i) * 4096);
+    AccessSnapshot snapshot = service.snapshot(ptr);
+    CHECK(snapshot.tracked && snapshot.accessCount == 10);
+    CHECK(snapshot.numaId == 2 && service.getNumaId(ptr) == 2);
+    CHECK(snapshot.mobility == 0);
+
+    // 非伪地址的NUMA未知
+    service.RecordAccess(0x7f0000001000ull);
+    CHECK(service.getNumaId(0x7f0000001000ull) == -1);
+}
+
+// 假时钟（纳秒），从整秒开始使时间轮tick边界可预期
+std::atomic<int64_t> g_fakeNow{1000000000000ll};
+int64_t FakeNow() { return g_fakeNow.load(); }
+
+constexpr int64_t kMs = 1000000;
+constexpr int64_t kSec = 1000 * kMs;
+
+// 默认参数：访问窗口5秒内不衰减，此后每10秒减1（区间左开右闭）
+void testLazyDecay() {
+    CoolingService service(FakeNow);
+    uintptr_t ptr = 0x7f0000010000ull;
+    const int64_t t0 = g_fakeNow.load();
+    for (int i = 0; i < 3; ++i) service.RecordAccess(ptr);
+    CHECK(service.snapshot(ptr).accessCount == 3);
+
+    g_fakeNow = t0 + 5 * kSec;
+    CHECK(service.snapshot(ptr).accessCount == 3);
+    g_fakeNow = t0 + 5 * kSec + 1;
+    CHECK(service.snapshot(ptr).accessCount == 2);
+    g_fakeNow = t0 + 15 * kSec;
+    CHECK(service.snapshot(ptr).accessCount == 2);
+    g_fakeNow = t0 + 15 * kSec + 1;
+    CHECK(service.snapshot(ptr).accessCount == 1);
+    g_fakeNow = t0 + 25 * kSec;
+    CHECK(service.snapshot(ptr).accessCount == 1);
+    g_fakeNow = t0 + 25 * kSec + 1;
+    AccessSnapshot snapshot = service.snapshot(ptr);
+    CHECK(snapshot.tracked && snapshot.accessCount == 0);
+
+    // 读取不回写：回到较早的时间点读到的仍是未衰减的值
+    g_fakeNow = t0 + 6 * kSec;
+    CHECK(service.snapshot(ptr).accessCount == 2);
+
+    // 再次访问先结算衰减再加1，并以本次访问时间重新计算
+    g_fakeNow = t0 + 16 * kSec;
+    service.RecordAccess(ptr);
+    CHECK(service.snapshot(ptr).accessCount == 2);
+    g_fakeNow = t0 + 21 * kSec;
+    CHECK(service.snapshot(ptr).accessCount == 2);
+    g_fakeNow = t0 + 21 * kSec + 1;
+    CHECK(service.snapshot(ptr).accessCount == 1);
+    g_fakeNow = t0 + 100 * kSec;
+    service.RecordAccess(ptr);
+    CHECK(service.snapshot(ptr).accessCount == 1);
+}
+
+// 时间轮tick为100毫秒：记录在计数衰减到0的时刻之后的下一个tick删除，之前到期的复查按最新访问重新排期
+void testExpiry() {
+    g_fakeNow = 2000 * kSec;
+    const int64_t t0 = g_fakeNow.load();
+    CoolingService service(FakeNow);
+    uintptr_t once = 0x7f0000020000ull;      // 访问一次
+    uintptr_t thrice = 0x7f0000030000ull;    // 访问三次，衰减到0需25秒
+    uintptr_t renewed = 0x7f0000040000ull;   // 首次排期到期前再次访问
+    service.RecordAccess(once);
+    for (int i = 0; i < 3; ++i) service.RecordAccess(thrice);
+    service.RecordAccess(renewed);
+    g_fakeNow = t0 + 4 * kSec;
+    service.RecordAccess(renewed);           // 计数2，衰减到0在t0+19秒
+
+    g_fakeNow = t0 + 5 * kSec;
+    service.expireDue();
+    CHECK(service.snapshot(once).tracked);
+    g_fakeNow = t0 + 5 * kSec + 100 * kMs;
+    service.expireDue();
+    CHECK(!service.snapshot(once).tracked);
+    CHECK(service.snapshot(thrice).tracked && service.snapshot(renewed).tracked);
+
+    // 大步推进：跨过多个tick时一次处理全部到期条目
+    g_fakeNow = t0 + 19 * kSec;
+    service.expireDue();
+    CHECK(service.snapshot(renewed).tracked && service.snapshot(renewed).accessCount == 1);
+    g_fakeNow = t0 + 19 * kSec + 100 * kMs;
+    service.expireDue();
+    CHECK(!service.snapshot(renewed).tracked);
+    CHECK(service.snapshot(thrice).tracked);
+
+    g_fakeNow = t0 + 25 * kSec;
+    service.expireDue();
+    CHECK(service.snapshot(thrice).tracked);
+    g_fakeNow = t0 + 25 * kSec + 200 * kMs;
+    service.expireDue();
+    CHECK(!service.snapshot(thrice).tracked);
+
+    // 删除后再次访问作为新记录，重新加入时间轮
+    service.RecordAccess(thrice);
+    CHECK(service.snapshot(thrice).accessCount == 1);
+    g_fakeNow = t0 + 31 * kSec;
+    service.expireDue();
+    CHECK(!service.snapshot(thrice).tracked);
+}
+
+// 访问窗口内没有衰减，所有线程的记录次数之和应等于总访问次数
+void testConcurrentRecords() {
+    CoolingService service;
+    FakeAddressSpace space;
+    std::vector<uintptr_t> ptrs = MakePointers(space, 512);
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 50000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                service.RecordAccess(ptrs[(i * 7 + t) % ptrs.size()], uint64_t(i % 64) * 256);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    uint64_t total = 0;
+    for (uintptr_t ptr : ptrs) total += service.snapshot(ptr).accessCount;
+    CHECK(total == uint64_t(kThreads) * kPerThread);
+}
+
+// 原实现：一把读写锁以独占方式保护整张表，每次记录更新计数、时间与瞬时热度
+// （原实现还逐次查询GlobalMemory::GetNumaNodeForPtr，该函数并不存在，这里省略）
+class GlobalLockTable {
+public:
+    void RecordAccess(uintptr_t ptr) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto now = std::chrono::steady_clock::now();
+        auto& record = records_[ptr];
+        record.count++;
+        record.last = now;
+        auto since_last = std::chrono::duration_cast<std::chrono::milliseconds>(now - record.last).count();
+        record.temperature = since_last > 0 ? 1.0f / since_last : 1.0f;
+    }
+
+private:
+    struct Record {
+        uint64_t count = 0;
+        std::chrono::steady_clock::time_point last;
+        float temperature = 0.0f;
+    };
+    std::shared_mutex mutex_;
+    std::unordered_map<uintptr_t, Record> records_;
+};
+
+template <typename Fn>
+double RecordsPerSecond(int threads, Fn&& record) {
+    constexpr int kTotal = 2000000;
+    const int perThread = kTotal / threads;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < perThread; ++i) record(t, i);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    return perThread * threads / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void benchRecordAccess() {
+    FakeAddressSpace space;
+    std::vector<uintptr_t> ptrs = MakePointers(space, 4096);
+    for (int threads : {1, 4}) {
+        GlobalLockTable global;
+        CoolingService sharded;
+        double before = RecordsPerSecond(threads, [&](int t, int i) {
+            global.RecordAccess(ptrs[(i * 13 + t * 977) % ptrs.size()]);
+        });
+        double after = RecordsPerSecond(threads, [&](int t, int i) {
+            sharded.RecordAccess(ptrs[(i * 13 + t * 977) % ptrs.size()], uint64_t(i % 64) * 256);
+        });
+        std::printf("threads=%d  global lock %.2f M/s  sharded %.2f M/s\n", threads, before / 1e6, after / 1e6);
+    }
+}
+}
+
+int main() {
+    testSnapshot();
+    testLazyDecay();
+    testExpiry();
+    testConcurrentRecords();
+    benchRecordAccess();
+    if (g_failures) {
+        std::fprintf(stderr, "cooling_service_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("cooling_service_test: OK\n");
+    return 0;
+}
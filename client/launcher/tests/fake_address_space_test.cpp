@@ -0,0 +1,195 @@
+// 伪地址空间测试：地址编码、随机分配/释放无重叠、全部释放后伙伴完全合并、按快照预占、
+// 多线程经线程缓存分配，并输出与operator new(1)的分配耗时对比
+// 构建（在client/launcher下）：
+//   g++ -std=c++17 -O2 -I. tests/fake_address_space_test.cpp memory/fake_address_space.cpp -pthread -o fake_address_space_test
+#include "memory/fake_address_space.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+constexpr size_t kLarge = size_t(1) << 20;     // 超出线程缓存的阶，直接走arena
+
+void testEncoding() {
+    FakeAddressSpace space;
+    uint64_t ptr = space.Allocate(4095, 3, 1000);
+    CHECK(FakeAddressSpace::IsFake(ptr) && FakeAddressSpace::NodeOf(ptr) == 4095 && FakeAddressSpace::NumaOf(ptr) == 3);
+    CHECK(ptr % 1024 == 0);
+    uint64_t unknown = space.Allocate(7, -1, 1);
+    CHECK(FakeAddressSpace::NodeOf(unknown) == 7 && FakeAddressSpace::NumaOf(unknown) == -1 && unknown % 256 == 0);
+    CHECK(space.Allocate(FakeAddressSpace::kMaxNodes, 0, 1) == 0);
+    CHECK(space.Allocate(0, 0, (uint64_t(1) << FakeAddressSpace::kOffsetBits) + 1) == 0);
+    CHECK(!FakeAddressSpace::IsFake(0x7f0000001000ull));
+    space.Free(ptr, 1000);
+    space.Free(unknown, 1);
+}
+
+// 随机大小的分配与乱序释放，存活区间两两不重叠；全部释放后可再分出整个arena
+void testRandomNoOverlap() {
+    FakeAddressSpace space;
+    std::mt19937_64 rng(3);
+    std::map<uint64_t, uint64_t> live;      // 起点 → 终点
+    std::vector<std::pair<uint64_t, size_t>> blocks;
+    int overlaps = 0;
+    for (int i = 0; i < 100000; ++i) {
+        if (blocks.empty() || rng() % 3) {
+            size_t size = (rng() % 4 ? rng() % 70000 : rng() % (size_t(1) << 30)) + 1;
+            uint32_t node = static_cast<uint32_t>(rng() % 3);
+            uint64_t ptr = space.Allocate(node, 0, size);
+            CHECK(ptr && FakeAddressSpace::NodeOf(ptr) == node);
+            auto next = live.upper_bound(ptr);
+            if (next != live.end() && next->first < ptr + size) ++overlaps;
+            if (next != live.begin() && std::prev(next)->second > ptr) ++overlaps;
+            live[ptr] = ptr + size;
+            blocks.emplace_back(ptr, size);
+        } else {
+            size_t k = rng() % blocks.size();
+            live.erase(blocks[k].first);
+            space.Free(blocks[k].first, blocks[k].second);
+            blocks[k] = blocks.back();
+            blocks.pop_back();
+        }
+    }
+    CHECK(overlaps == 0);
+    for (auto [ptr, size] : blocks) space.Free(ptr, size);
+
+    // 线程缓存中暂存的小块计入已分配，大块应全部合并回去
+    std::vector<uint64_t> large;
+    for (int i = 0; i < 1000; ++i) large.push_back(space.Allocate(9, 1, kLarge));
+    uint64_t before = space.AllocatedBytes();
+    for (uint64_t ptr : large) space.Free(ptr, kLarge);
+    CHECK(before - space.AllocatedBytes() == large.size() * kLarge);
+    uint64_t whole = space.Allocate(9, 1, uint64_t(1) << FakeAddressSpace::kOffsetBits);
+    CHECK(whole != 0);
+    space.Free(whole, uint64_t(1) << FakeAddressSpace::kOffsetBits);
+}
+
+// 新实例按快照中的地址预占后，分配不会再分出这些区间；重复预占失败
+void testReserve() {
+    FakeAddressSpace original;
+    std::vector<uint64_t> ptrs;
+    for (int i = 0; i < 64; ++i) ptrs.push_back(original.Allocate(2, 1, kLarge));
+
+    FakeAddressSpace restored;
+    for (size_t i = 0; i < ptrs.size(); i += 2) CHECK(restored.Reserve(ptrs[i], kLarge));
+    CHECK(!restored.Reserve(ptrs[0], kLarge));
+    CHECK(!restored.Reserve(ptrs[1] + 256, kLarge));       // 未按阶对齐
+    std::set<uint64_t> reserved;
+    for (size_t i = 0; i < ptrs.size(); i += 2) reserved.insert(ptrs[i]);
+    for (int i = 0; i < 256; ++i) {
+        uint64_t ptr = restored.Allocate(2, 1, kLarge);
+        CHECK(ptr && reserved.count(ptr) == 0);
+    }
+    CHECK(restored.AllocatedBytes() == (32 + 256) * kLarge);
+}
+
+void testThreads() {
+    FakeAddressSpace space;
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 20000;
+    std::vector<std::vector<uint64_t>> results(kThreads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937_64 rng(t);
+            std::vector<uint64_t> scratch;
+            for (int i = 0; i < kPerThread; ++i) {
+                uint64_t ptr = space.Allocate(0, 0, 4096);
+                if (rng() % 2) {
+                    results[t].push_back(ptr);
+                } else {
+                    scratch.push_back(ptr);
+                }
+                if (scratch.size() > 100) {
+                    for (uint64_t p : scratch) space.Free(p, 4096);
+                    scratch.clear();
+                }
+            }
+            for (uint64_t p : scratch) space.Free(p, 4096);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    std::vector<uint64_t> all;
+    for (auto& r : results) all.insert(all.end(), r.begin(), r.end());
+    std::sort(all.begin(), all.end());
+    CHECK(std::adjacent_find(all.begin(), all.end()) == all.end());
+    CHECK(std::find(all.begin(), all.end(), 0ull) == all.end());
+}
+
+template <typename Fn>
+void bench(const char* name, size_t ops, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::printf("%-34s %6.1f ns/op\n", name,
+                std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ops);
+}
+
+// 原实现用operator new(1)生成伪地址，这里在相同的存活规模下对比：
+// 工作集32（线程缓存命中的稳态）、1M存活块（单arena，以及16个arena交替）与64 MiB大块
+void benchAllocate() {
+    constexpr size_t kOps = 1000000;
+    constexpr size_t kWorkingSet = 32;
+    std::vector<void*> heap(kOps);
+    std::vector<uint64_t> fake(kOps);
+    bench("operator new(1), working set 32", kOps, [&] {
+        for (size_t round = 0; round < kOps / kWorkingSet; ++round) {
+            for (size_t i = 0; i < kWorkingSet; ++i) heap[i] = ::operator new(1);
+            for (size_t i = 0; i < kWorkingSet; ++i) ::operator delete(heap[i]);
+        }
+    });
+    bench("operator new(1), 1M live", kOps, [&] {
+        for (auto& p : heap) p = ::operator new(1);
+        for (void* p : heap) ::operator delete(p);
+    });
+
+    FakeAddressSpace space;
+    bench("4 KiB, working set 32", kOps, [&] {
+        for (size_t round = 0; round < kOps / kWorkingSet; ++round) {
+            for (size_t i = 0; i < kWorkingSet; ++i) fake[i] = space.Allocate(3, 0, 4096);
+            for (size_t i = 0; i < kWorkingSet; ++i) space.Free(fake[i], 4096);
+        }
+    });
+    bench("4 KiB, 1M live", kOps, [&] {
+        for (size_t i = 0; i < kOps; ++i) fake[i] = space.Allocate(3, 0, 4096);
+        for (uint64_t p : fake) space.Free(p, 4096);
+    });
+    bench("4 KiB, 1M live, 16 arenas", kOps, [&] {
+        for (size_t i = 0; i < kOps; ++i) fake[i] = space.Allocate(i & 15, 0, 4096);
+        for (uint64_t p : fake) space.Free(p, 4096);
+    });
+    bench("64 MiB, 100k live", kOps / 10, [&] {
+        for (size_t i = 0; i < kOps / 10; ++i) fake[i] = space.Allocate(3, 0, 64 << 20);
+        for (size_t i = 0; i < kOps / 10; ++i) space.Free(fake[i], 64 << 20);
+    });
+}
+}
+
+int main() {
+    testEncoding();
+    testRandomNoOverlap();
+    testReserve();
+    testThreads();
+    benchAllocate();
+    if (g_failures) {
+        std::fprintf(stderr, "fake_address_space_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("fake_address_space_test: OK\n");
+    return 0;
+}
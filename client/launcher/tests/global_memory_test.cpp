@@ -0,0 +1,156 @@
+// GlobalMemoryService查找路径测试：Resolve返回的引用在并发RemoveMapping后仍可读取，
+// 快照与增量日志可恢复全部映射，并对比GetMapping（复制）与Resolve（引用）的多线程查找耗时
+// 构建（在client/launcher下，launcher_client.h需要Cap'n Proto生成的头文件）：
+//   g++ -std=c++17 -O2 -I. -I../../proto/proto -I../data_transfer/include tests/global_memory_test.cpp
+//       memory/global_memory.cpp memory/mapping_snapshot.cpp ../data_transfer/src/crc32c.cpp -pthread -o global_memory_test
+#include "memory/global_memory.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+constexpr uintptr_t kBase = 0x200000000000ull;
+
+void testResolve() {
+    GlobalMemoryService service;
+    CHECK(service.AddMapping(kBase, RemoteAllocInfo{"node-a", 4096, 11}));
+    CHECK(!service.AddMapping(kBase + 100, RemoteAllocInfo{"node-b", 10, 12}));
+
+    MappingRef ref = service.Resolve(kBase + 100);
+    CHECK(ref && ref.offset == 100 && ref->remote_handle == 11 && ref->node_id == "node-a");
+    service.Resolve(kBase);
+
+    size_t offset = 0;
+    auto copy = service.GetMapping(kBase + 7, &offset);
+    CHECK(copy && offset == 7 && copy->access_count == 3);
+
+    // 删除后已取得的引用仍指向完整条目
+    service.RemoveMapping(kBase);
+    CHECK(!service.Resolve(kBase));
+    CHECK(ref->node_id == "node-a" && ref->size == 4096);
+}
+
+// 快照之后的变更写入增量日志，重启时快照加重放日志得到最终状态
+void testSnapshotRestore() {
+    const std::string path = "global_memory_test.snap";
+    std::remove(path.c_str());
+    std::remove((path + ".log").c_str());
+    {
+        GlobalMemoryService service;
+        CHECK(service.EnableDeltaLog(path));
+        for (uint64_t i = 0; i < 100; ++i) service.AddMapping(kBase + i * 4096, RemoteAllocInfo{"node-a", 4096, i});
+        CHECK(service.SaveSnapshot(path));
+        service.RemoveMapping(kBase);
+        service.AddMapping(kBase + 100 * 4096, RemoteAllocInfo{"node-b", 8192, 100});
+        service.FlushDeltaLog();
+    }
+
+    GlobalMemoryService restored;
+    CHECK(restored.LoadSnapshot(path));
+    size_t count = 0;
+    restored.ForEachMapping([&](uintptr_t base, const RemoteAllocInfo& info) {
+        CHECK(base != kBase && info.remote_handle == (base - kBase) / 4096);
+        ++count;
+    });
+    CHECK(count == 100);
+    auto added = restored.GetMapping(kBase + 100 * 4096 + 5000);
+    CHECK(added && added->node_id == "node-b" && added->size == 8192);
+
+    std::remove(path.c_str());
+    std::remove((path + ".log").c_str());
+}
+
+// 查找线程持有引用期间，写线程反复删除并重新登记同一批地址
+void testConcurrentRemove() {
+    GlobalMemoryService service;
+    constexpr size_t kSlots = 128;
+    auto nodeName = [](uint64_t handle) { return "node-with-a-long-identifier-" + std::to_string(handle); };
+    for (size_t i = 0; i < kSlots; ++i) service.AddMapping(kBase + i * 4096, RemoteAllocInfo{nodeName(i), 4096, i});
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> mismatches{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&, t] {
+            uint64_t i = t;
+            while (!stop.load(std::memory_order_relaxed)) {
+                MappingRef ref = service.Resolve(kBase + (i++ % kSlots) * 4096 + 8);
+                if (ref && ref->node_id != nodeName(ref->remote_handle)) mismatches.fetch_add(1);
+            }
+        });
+    }
+    for (uint64_t round = 0; round < 20000; ++round) {
+        size_t slot = round % kSlots;
+        service.RemoveMapping(kBase + slot * 4096);
+        uint64_t handle = kSlots + round;
+        service.AddMapping(kBase + slot * 4096, RemoteAllocInfo{nodeName(handle), 4096, handle});
+    }
+    stop = true;
+    for (auto& reader : readers) reader.join();
+    CHECK(mismatches.load() == 0);
+}
+
+void benchLookup() {
+    GlobalMemoryService service;
+    std::vector<uintptr_t> bases;
+    for (uint64_t i = 0; i < 100000; ++i) {
+        uintptr_t base = kBase + i * 4096;
+        service.AddMapping(base, RemoteAllocInfo{"node-with-a-long-identifier-" + std::to_string(i % 8), 4096, i});
+        bases.push_back(base);
+    }
+    constexpr int kThreads = 8;
+    constexpr int kLookups = 200000;
+    auto run = [&](bool byRef) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        std::atomic<uint64_t> sink{0};
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                uint64_t sum = 0;
+                for (int i = 0; i < kLookups; ++i) {
+                    uintptr_t ptr = bases[(i * 31 + t * 7) % bases.size()] + 100;
+                    if (byRef) {
+                        MappingRef ref = service.Resolve(ptr);
+                        sum += ref->remote_handle + ref.offset;
+                    } else {
+                        auto info = service.GetMapping(ptr);
+                        sum += info->remote_handle;
+                    }
+                }
+                sink.fetch_add(sum);
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+               (double(kThreads) * kLookups);
+    };
+    std::printf("GetMapping (copy): %.0f ns/op\n", run(false));
+    std::printf("Resolve (ref):     %.0f ns/op\n", run(true));
+}
+}
+
+int main() {
+    testResolve();
+    testConcurrentRemove();
+    testSnapshotRestore();
+    benchLookup();
+    if (g_failures) {
+        std::fprintf(stderr, "global_memory_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("global_memory_test: OK\n");
+    return 0;
+}
@@ -0,0 +1,154 @@
+// 节点选择模拟：16/256/4096个节点下各策略的决策延迟p50/p99、相对全量扫描的放置质量（得分比），
+// 单节点指标更新的耗时，以及选择期间并发更新时结果始终为可容纳的节点
+// 构建（在client/launcher下）：
+//   g++ -std=c++17 -O2 -I. tests/node_selector_bench.cpp node_selector.cpp -pthread -o node_selector_bench
+#include "node_selector.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+NodeMetrics RandomNode(std::mt19937_64& rng) {
+    NodeMetrics node;
+    node.total_memory = (size_t(16) << 30) << (rng() % 3);
+    node.available_memory = rng() % node.total_memory;
+    node.network_latency = (rng() % 1000) / 10.0;
+    node.cpu_usage = static_cast<double>(rng() % 100);
+    node.gpu_utilization = static_cast<double>(rng() % 100);
+    node.priority = static_cast<int>(rng() % 100);
+    node.numaId = static_cast<int>(rng() % 4);
+    return node;
+}
+
+// 桶随更新调整后，Bucketed与全量扫描对同一请求仍选中可容纳的节点
+void testUpdate() {
+    NodeSelector selector(NodeSelectionPolicy::Bucketed);
+    NodeMetrics node;
+    node.total_memory = size_t(64) << 30;
+    node.available_memory = size_t(1) << 30;
+    for (NodeIndex i = 0; i < 8; ++i) CHECK(selector.Update(i, node));
+    CHECK(selector.Select(size_t(2) << 30, 0) == kInvalidNodeIndex);
+
+    node.available_memory = size_t(32) << 30;
+    CHECK(selector.Update(5, node));
+    NodeMetrics selected;
+    CHECK(selector.Select(size_t(2) << 30, 0, &selected) == 5 && selected.available_memory == node.available_memory);
+
+    node.available_memory = 0;
+    CHECK(selector.Update(5, node));
+    CHECK(selector.Select(size_t(2) << 30, 0) == kInvalidNodeIndex);
+    CHECK(!selector.Update(NodeTable::kCapacity, node));
+}
+
+void testConcurrentUpdate() {
+    NodeSelector selector(NodeSelectionPolicy::Bucketed);
+    std::mt19937_64 rng(3);
+    for (NodeIndex i = 0; i < 256; ++i) selector.Update(i, RandomNode(rng));
+
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        std::mt19937_64 local(4);
+        while (!stop.load(std::memory_order_relaxed)) {
+            selector.Update(static_cast<NodeIndex>(local() % 256), RandomNode(local));
+        }
+    });
+    std::atomic<int> bad{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; ++t) {
+        readers.emplace_back([&, t] {
+            for (int k = 0; k < 200000; ++k) {
+                size_t size = size_t(1) << (20 + (k + t) % 14);
+                NodeMetrics selected;
+                NodeIndex index = selector.Select(size, k % 4, &selected);
+                if (index != kInvalidNodeIndex && selected.available_memory < size) ++bad;
+            }
+        });
+    }
+    for (auto& reader : readers) reader.join();
+    stop = true;
+    writer.join();
+    CHECK(bad.load() == 0);
+}
+
+void simulate(size_t count) {
+    std::mt19937_64 rng(1);
+    std::vector<NodeMetrics> nodes;
+    NodeSelector exhaustive;
+    for (size_t i = 0; i < count; ++i) {
+        nodes.push_back(RandomNode(rng));
+        exhaustive.Update(static_cast<NodeIndex>(i), nodes.back());
+    }
+
+    for (auto policy : {NodeSelectionPolicy::Exhaustive, NodeSelectionPolicy::PowerOfTwo,
+                        NodeSelectionPolicy::Bucketed}) {
+        NodeSelector selector(policy);
+        for (size_t i = 0; i < count; ++i) selector.Update(static_cast<NodeIndex>(i), nodes[i]);
+
+        std::vector<double> latency;
+        double quality = 0.0;
+        int compared = 0;
+        int missed = 0;
+        std::mt19937_64 requests(2);
+        for (int k = 0; k < 20000; ++k) {
+            size_t size = size_t(1) << (20 + requests() % 14);
+            int numa = static_cast<int>(requests() % 4);
+            auto start = std::chrono::steady_clock::now();
+            NodeIndex chosen = selector.Select(size, numa);
+            latency.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+
+            NodeIndex best = exhaustive.Select(size, numa);
+            if (best == kInvalidNodeIndex) continue;
+            if (chosen == kInvalidNodeIndex) {
+                ++missed;
+                continue;
+            }
+            quality += CalculateNodeScore(nodes[chosen], size, numa) / CalculateNodeScore(nodes[best], size, numa);
+            ++compared;
+        }
+        std::sort(latency.begin(), latency.end());
+        std::printf("nodes=%5zu  %-10s p50 %8.0f ns  p99 %8.0f ns  quality %.3f  missed %d\n", count,
+                    NodeSelectionPolicyName(policy), latency[latency.size() / 2],
+                    latency[latency.size() * 99 / 100], compared ? quality / compared : 0.0, missed);
+        CHECK(missed == 0);
+    }
+
+    // 健康数据更新只调整单个节点所在的桶
+    NodeSelector selector(NodeSelectionPolicy::Bucketed);
+    for (size_t i = 0; i < count; ++i) selector.Update(static_cast<NodeIndex>(i), nodes[i]);
+    const size_t updates = 20000;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t k = 0; k < updates; ++k) {
+        selector.Update(static_cast<NodeIndex>(k % count), RandomNode(rng));
+    }
+    std::printf("nodes=%5zu  update %.0f ns/node\n", count,
+                std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / updates);
+}
+}
+
+int main() {
+    testUpdate();
+    testConcurrentUpdate();
+    for (size_t count : {16, 256, 4096}) {
+        simulate(count);
+    }
+    if (g_failures) {
+        std::fprintf(stderr, "node_selector_bench: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("node_selector_bench: OK\n");
+    return 0;
+}
@@ -0,0 +1,101 @@
+// 节点查找基准：16/256/4096个节点下，按字符串ID线性比较查找（原GetNodeById）与按NodeIndex下标读取
+// NodeTable的耗时，以及顺序扫描节点表对全部节点打分一次的耗时
+// 构建（在client/launcher下）：
+//   g++ -std=c++17 -O2 -I. tests/node_table_bench.cpp node_selector.cpp -o node_table_bench
+#include "node_selector.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+// 原节点记录：查找时逐个比较ID字符串
+struct LegacyNode {
+    std::string id;
+    std::string address;
+    size_t available_memory;
+};
+
+template <typename Fn>
+double NsPerOp(size_t ops, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ops; ++i) fn(i);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ops;
+}
+
+void benchNodes(size_t count) {
+    std::vector<LegacyNode> legacy;
+    std::vector<std::string> ids;
+    NodeTable table;
+    for (size_t i = 0; i < count; ++i) {
+        ids.push_back("gpu-node-" + std::to_string(i));
+        size_t available = (size_t(8) << 30) + i * 4096;
+        legacy.push_back({ids.back(), "10.0.0.1", available});
+        NodeMetrics metrics;
+        metrics.total_memory = size_t(16) << 30;
+        metrics.available_memory = available;
+        metrics.network_latency = 0.1 * (i % 10);
+        metrics.cpu_usage = 20.0;
+        metrics.gpu_utilization = 30.0;
+        metrics.priority = static_cast<int>(i % 100);
+        metrics.numaId = static_cast<int>(i % 4);
+        CHECK(table.Set(static_cast<NodeIndex>(i), metrics));
+    }
+    CHECK(table.size() == count);
+
+    // 每次操作查找一个节点，覆盖全部下标
+    volatile size_t sink = 0;
+    const size_t lookups = 2000000 / count * 16;
+    double byId = NsPerOp(lookups, [&](size_t i) {
+        const std::string& key = ids[(i * 7919) % count];
+        for (const auto& node : legacy) {
+            if (node.id == key) {
+                sink = sink + node.available_memory;
+                break;
+            }
+        }
+    });
+    double byIndex = NsPerOp(lookups, [&](size_t i) {
+        sink = sink + table.Get(static_cast<NodeIndex>((i * 7919) % count)).available_memory;
+    });
+
+    const size_t scans = 200000 / count + 1;
+    double scan = NsPerOp(scans, [&](size_t i) {
+        NodeIndex best = kInvalidNodeIndex;
+        double bestScore = -1.0;
+        for (NodeIndex index = 0; index < table.size(); ++index) {
+            double score = CalculateNodeScore(table.Get(index), 1 << 20, static_cast<int>(i % 4));
+            if (score > bestScore) {
+                bestScore = score;
+                best = index;
+            }
+        }
+        sink = sink + best;
+    });
+
+    std::printf("nodes=%5zu  lookup by id %9.1f ns  by index %5.2f ns  score all %9.0f ns\n",
+                count, byId, byIndex, scan);
+}
+}
+
+int main() {
+    for (size_t count : {16, 256, 4096}) {
+        benchNodes(count);
+    }
+    if (g_failures) {
+        std::fprintf(stderr, "node_table_bench: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("node_table_bench: OK\n");
+    return 0;
+}
@@ -0,0 +1,192 @@
+// 路径规划测试：64节点×8 GPU的模拟拓扑上，小传输选ZMQ、大传输选RDMA，直连退化的节点经中继更快，
+// 节点内走NVLink，不可达与未知设备，更换拓扑后缓存失效，YAML拓扑解析；并输出冷/热规划耗时
+// 构建（在client/launcher下）：
+//   g++ -std=c++17 -O2 -I. tests/path_planner_test.cpp topology/path_planner.cpp topology/topology_graph.cpp logging/async_logger.cpp -lyaml-cpp -pthread -o path_planner_test
+#include "topology/path_planner.h"
+#include <yaml-cpp/yaml.h>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+constexpr int kNodes = 64;
+constexpr int kGpus = 8;
+constexpr int kDegraded = 8;        // n0..n7与本地主机之间只有退化的直连链路
+
+std::string NodeId(int n) { return "n" + std::to_string(n); }
+
+std::shared_ptr<TopologyGraph> BuildGraph() {
+    auto graph = std::make_shared<TopologyGraph>();
+    graph->AddDevice(TopologyGraph::HostId(TopologyGraph::kLocalNode), TopologyGraph::kLocalNode, DeviceKind::Host);
+    for (int n = 0; n < kNodes; ++n) {
+        std::string id = NodeId(n);
+        graph->AddDevice(TopologyGraph::HostId(id), id, DeviceKind::Host, 0);
+        for (int k = 0; k < kGpus; ++k) {
+            graph->AddDevice(TopologyGraph::GpuId(id, k), id, DeviceKind::Gpu, k / 4);
+            graph->AddLink(TopologyGraph::HostId(id), TopologyGraph::GpuId(id, k), LinkType::XBus,
+                           LinkTransport::Direct, 24000, 10);
+        }
+        for (int a = 0; a < kGpus; ++a) {
+            for (int b = a + 1; b < kGpus; ++b) {
+                graph->AddLink(TopologyGraph::GpuId(id, a), TopologyGraph::GpuId(id, b), LinkType::NvLink,
+                               LinkTransport::Direct, 300000, 2);
+            }
+        }
+    }
+    std::string local = TopologyGraph::HostId(TopologyGraph::kLocalNode);
+    for (int n = 0; n < kNodes; ++n) {
+        if (n < kDegraded) {
+            graph->AddLink(local, TopologyGraph::HostId(NodeId(n)), LinkType::Network, LinkTransport::Rdma, 1200, 30);
+            graph->AddLink(local, TopologyGraph::HostId(NodeId(n)), LinkType::Network, LinkTransport::Zmq, 400, 15);
+        } else {
+            graph->ConnectHosts(TopologyGraph::kLocalNode, NodeId(n), 10);
+        }
+        for (int m = n + 1; m < kNodes; ++m) graph->ConnectHosts(NodeId(n), NodeId(m), 5);
+    }
+    return graph;
+}
+
+const PlanHop* FirstNetworkHop(const TransferPlan& plan) {
+    for (const PlanHop& hop : plan.hops) {
+        if (hop.type == LinkType::Network) return &hop;
+    }
+    return nullptr;
+}
+
+void testSizeDependentTransport(PathPlanner& planner) {
+    std::string local = TopologyGraph::HostId(TopologyGraph::kLocalNode);
+    TransferPlan small = planner.Plan(local, TopologyGraph::GpuId("n20", 3), 512);
+    TransferPlan large = planner.Plan(local, TopologyGraph::GpuId("n20", 3), 64 << 20);
+    CHECK(small.found && large.found);
+    CHECK(small.entryNode == "n20" && large.entryNode == "n20");
+    const PlanHop* smallHop = FirstNetworkHop(small);
+    const PlanHop* largeHop = FirstNetworkHop(large);
+    CHECK(smallHop && smallHop->transport == LinkTransport::Zmq);
+    CHECK(largeHop && largeHop->transport == LinkTransport::Rdma);
+    CHECK(large.DominantType() == LinkType::Network);
+    CHECK(small.estimatedUs < large.estimatedUs);
+}
+
+// 到n3的直连只有1.2 GB/s，大传输经其他节点中继的估算耗时应低于直连
+void testRelay(PathPlanner& planner) {
+    std::string local = TopologyGraph::HostId(TopologyGraph::kLocalNode);
+    uint64_t size = 64 << 20;
+    TransferPlan plan = planner.Plan(local, TopologyGraph::GpuId("n3", 1), size);
+    CHECK(plan.found && !plan.entryNode.empty() && plan.entryNode != "n3");
+    double direct = 30 + size / 1200.0 + 10 + size / 24000.0;
+    CHECK(plan.estimatedUs < direct);
+    std::printf("degraded node, 64 MiB: direct %.0f us, planned %.0f us via %s\n", direct, plan.estimatedUs,
+                plan.entryNode.c_str());
+}
+
+void testLocalAndUnreachable(PathPlanner& planner) {
+    TransferPlan same = planner.Plan(TopologyGraph::GpuId("n5", 0), TopologyGraph::GpuId("n5", 0), 4096);
+    CHECK(same.found && same.hops.empty() && same.entryNode.empty());
+
+    TransferPlan nvlink = planner.Plan(TopologyGraph::GpuId("n5", 0), TopologyGraph::GpuId("n5", 7), 1 << 20);
+    CHECK(nvlink.found && nvlink.hops.size() == 1 && nvlink.hops[0].type == LinkType::NvLink);
+    CHECK(nvlink.entryNode.empty());
+
+    CHECK(!planner.Plan("missing/gpu0", TopologyGraph::GpuId("n5", 0), 1).found);
+
+    auto isolated = std::make_shared<TopologyGraph>(*planner.Topology());
+    isolated->AddDevice("island/gpu0", "island", DeviceKind::Gpu);
+    PathPlanner other;
+    other.SetTopology(isolated);
+    CHECK(!other.Plan(TopologyGraph::GpuId("n5", 0), "island/gpu0", 1).found);
+}
+
+// 同一大小类命中缓存；更换拓扑后重新规划
+void testCache() {
+    auto graph = std::make_shared<TopologyGraph>();
+    graph->AddDevice("a/host", "a", DeviceKind::Host);
+    graph->AddDevice("b/host", "b", DeviceKind::Host);
+    graph->AddLink("a/host", "b/host", LinkType::Network, LinkTransport::Zmq, 100, 5);
+    PathPlanner planner;
+    planner.SetTopology(graph);
+    TransferPlan first = planner.Plan("a/host", "b/host", 1000);
+    planner.Plan("a/host", "b/host", 1023);
+    CHECK(planner.GetStats().cacheHits == 1);
+    CHECK(first.hops.size() == 1 && first.hops[0].transport == LinkTransport::Zmq);
+
+    auto faster = std::make_shared<TopologyGraph>(*graph);
+    faster->AddLink("a/host", "b/host", LinkType::Network, LinkTransport::Rdma, 10000, 5);
+    planner.SetTopology(faster);
+    TransferPlan second = planner.Plan("a/host", "b/host", 1000);
+    CHECK(second.hops.size() == 1 && second.hops[0].transport == LinkTransport::Rdma);
+    CHECK(planner.GetStats().cacheHits == 1);
+}
+
+void testYaml() {
+    YAML::Node topology = YAML::Load(R"(
+devices:
+  - {id: local/host, node: local, type: host}
+  - {id: a/host, node: a, type: host, numa: 0}
+  - {id: a/gpu0, node: a, type: gpu, numa: 0}
+links:
+  - {from: local/host, to: a/host, type: network, transport: zmq, bandwidth: 1200, latency_us: 8}
+  - {from: a/host, to: a/gpu0, type: pcie, bandwidth: 24000, latency_us: 10}
+)");
+    auto graph = std::make_shared<TopologyGraph>();
+    CHECK(graph->LoadYaml(topology) && graph->DeviceCount() == 3);
+    PathPlanner planner;
+    planner.SetTopology(graph);
+    TransferPlan plan = planner.Plan("local/host", "a/gpu0", 4096);
+    CHECK(plan.found && plan.hops.size() == 2 && plan.entryNode == "a");
+
+    TopologyGraph bad;
+    CHECK(!bad.LoadYaml(YAML::Load("links:\n  - {from: x, to: y, type: warp}\n")));
+}
+
+void benchPlan(const std::shared_ptr<TopologyGraph>& graph) {
+    std::mt19937 rng(1);
+    std::vector<std::pair<uint32_t, uint32_t>> queries;
+    for (int i = 0; i < 2000; ++i) {
+        queries.emplace_back(static_cast<uint32_t>(rng() % graph->DeviceCount()),
+                             static_cast<uint32_t>(rng() % graph->DeviceCount()));
+    }
+    PathPlanner planner;
+    planner.SetTopology(graph);
+    auto start = std::chrono::steady_clock::now();
+    for (auto [src, dst] : queries) planner.Plan(src, dst, 1 << 20);
+    auto cold = std::chrono::steady_clock::now();
+    constexpr int kRounds = 50;
+    for (int round = 0; round < kRounds; ++round) {
+        for (auto [src, dst] : queries) planner.Plan(src, dst, 1 << 20);
+    }
+    auto cached = std::chrono::steady_clock::now();
+    std::printf("devices %zu  cold plan %.1f us  cached plan %.2f us\n", graph->DeviceCount(),
+                std::chrono::duration<double, std::micro>(cold - start).count() / queries.size(),
+                std::chrono::duration<double, std::micro>(cached - cold).count() / (kRounds * queries.size()));
+}
+}
+
+int main() {
+    auto graph = BuildGraph();
+    PathPlanner planner;
+    planner.SetTopology(graph);
+    testSizeDependentTransport(planner);
+    testRelay(planner);
+    testLocalAndUnreachable(planner);
+    testCache();
+    testYaml();
+    benchPlan(graph);
+    if (g_failures) {
+        std::fprintf(stderr, "path_planner_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("path_planner_test: OK\n");
+    return 0;
+}
@@ -0,0 +1,261 @@
+// 内存注册缓存测试（软件verbs）：区间命中与内部偏移命中、相邻空闲注册合并、邻居在用时临时注册、
+// 超过固定上限按LRU淘汰且不淘汰在用注册、作废空闲/在用注册、导出内存注销后同一地址重新分配
+// 拿到新的rkey而旧rkey失效、多线程借用与作废不泄漏也不重复注销，并对比按起始指针注册的次数与固定内存
+// 构建（在client/launcher下）：
+//   g++ -std=c++17 -O2 -I. tests/rdma_mr_cache_test.cpp transport/rdma_transport.cpp transport/rdma_connection.cpp
+//       transport/rdma_verbs.cpp transport/rdma_mr_cache.cpp logging/async_logger.cpp -libverbs -pthread -o rdma_mr_cache_test
+#include "transport/rdma_transport.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+constexpr size_t kPage = 4096;
+
+// 统计注册与注销次数，live为当前仍有效的注册数
+class CountingVerbs : public SoftVerbs {
+public:
+    explicit CountingVerbs(SoftFabric& fabric) : SoftVerbs(fabric) {}
+
+    ibv_mr* RegMr(void* addr, size_t length, int access) override {
+        registrations++;
+        live++;
+        return SoftVerbs::RegMr(addr, length, access);
+    }
+    void DeregMr(ibv_mr* mr) override {
+        if (mr) live--;
+        SoftVerbs::DeregMr(mr);
+    }
+
+    std::atomic<int> registrations{0};
+    std::atomic<int> live{0};
+};
+
+struct Arena {
+    explicit Arena(size_t pages) : bytes(pages * kPage) {
+        base = static_cast<uint8_t*>(std::aligned_alloc(kPage, bytes));
+    }
+    ~Arena() { std::free(base); }
+    uint8_t* page(size_t n) const { return base + n * kPage; }
+
+    size_t bytes;
+    uint8_t* base;
+};
+
+void testHitMissMerge() {
+    SoftFabric fabric;
+    CountingVerbs verbs(fabric);
+    Arena arena(8);
+    {
+        RdmaRegistrationCache cache(verbs);
+        RdmaMrHandle first = cache.Acquire(arena.page(0), kPage);
+        CHECK(first.valid() && !first.temporary);
+        cache.Release(first);
+
+        // 已注册区间内部的偏移命中同一注册
+        RdmaMrHandle inner = cache.Acquire(arena.page(0) + 100, 200);
+        CHECK(inner.valid() && inner.lkey == first.lkey);
+        cache.Release(inner);
+        RdmaMrCacheStats stats = cache.GetStats();
+        CHECK(stats.hits == 1 && stats.misses == 1 && stats.regions == 1);
+
+        // 相邻且空闲：合并为一个注册，旧注册被注销
+        RdmaMrHandle next = cache.Acquire(arena.page(1), kPage);
+        CHECK(next.valid() && !next.temporary && next.start == reinterpret_cast<uintptr_t>(arena.page(0)));
+        stats = cache.GetStats();
+        CHECK(stats.merges == 1 && stats.regions == 1 && stats.pinnedBytes == 2 * kPage);
+        CHECK(verbs.live == 1);
+
+        // 邻居在用：不能合并，临时注册在归还时注销
+        RdmaMrHandle busy = cache.Acquire(arena.page(2), kPage);
+        CHECK(busy.valid() && busy.temporary != nullptr);
+        CHECK(cache.GetStats().regions == 1 && verbs.live == 2);
+        cache.Release(busy);
+        CHECK(verbs.live == 1);
+        cache.Release(next);
+    }
+    CHECK(verbs.live == 0);
+}
+
+void testEviction() {
+    SoftFabric fabric;
+    CountingVerbs verbs(fabric);
+    Arena arena(16);
+    RdmaRegistrationCache cache(verbs, 4 * kPage);
+
+    // 互不相邻的2页注册，上限只够两个
+    auto region = [&](int n) { return arena.page(n * 3); };
+    for (int n = 0; n < 4; ++n) cache.Release(cache.Acquire(region(n), 2 * kPage));
+    RdmaMrCacheStats stats = cache.GetStats();
+    CHECK(stats.pinnedBytes <= 4 * kPage && stats.evictions == 2 && verbs.live == 2);
+
+    // 最早使用的已被淘汰，最近的仍命中
+    uint64_t misses = stats.misses;
+    cache.Release(cache.Acquire(region(3), 2 * kPage));
+    CHECK(cache.GetStats().misses == misses);
+    cache.Release(cache.Acquire(region(0), 2 * kPage));
+    CHECK(cache.GetStats().misses == misses + 1);
+
+    // 在用的注册不淘汰：暂时超出上限，归还后补做淘汰
+    std::vector<RdmaMrHandle> held;
+    for (int n = 0; n < 4; ++n) held.push_back(cache.Acquire(region(n), 2 * kPage));
+    CHECK(cache.GetStats().pinnedBytes == 8 * kPage);
+    for (auto& handle : held) cache.Release(handle);
+    CHECK(cache.GetStats().pinnedBytes <= 4 * kPage);
+    cache.Clear();
+    CHECK(verbs.live == 0);
+}
+
+void testInvalidate() {
+    SoftFabric fabric;
+    CountingVerbs verbs(fabric);
+    Arena arena(4);
+    RdmaRegistrationCache cache(verbs);
+
+    RdmaMrHandle idle = cache.Acquire(arena.page(0), 2 * kPage);
+    cache.Release(idle);
+    cache.Invalidate(arena.page(1), 1);
+    CHECK(cache.GetStats().regions == 0 && verbs.live == 0);
+    RdmaMrHandle again = cache.Acquire(arena.page(0), kPage);
+    CHECK(again.valid() && again.lkey != idle.lkey && cache.GetStats().misses == 2);
+
+    // 在用的注册移出缓存，借用者仍可使用，最后一次归还时注销
+    cache.Invalidate(arena.page(0), kPage);
+    CHECK(cache.GetStats().regions == 0 && verbs.live == 1);
+    CHECK(fabric.CheckRemote(again.rkey, reinterpret_cast<uint64_t>(arena.page(0)), kPage));
+    RdmaMrHandle fresh = cache.Acquire(arena.page(0), kPage);
+    CHECK(fresh.valid() && !fresh.temporary && fresh.lkey != again.lkey && verbs.live == 2);
+    cache.Release(again);
+    CHECK(verbs.live == 1 && !fabric.CheckRemote(again.rkey, reinterpret_cast<uint64_t>(arena.page(0)), kPage));
+    cache.Release(again);                 // 重复归还被忽略
+    CHECK(verbs.live == 1);
+    cache.Release(fresh);
+    cache.Clear();
+    CHECK(verbs.live == 0);
+}
+
+// 导出内存注销后释放并在同一地址重新分配：新注册不能命中旧的注册
+void testFreeThenReallocate() {
+    SoftFabric fabric;
+    RdmaTransport sender{std::make_unique<SoftVerbs>(fabric)};
+    RdmaTransport receiver{std::make_unique<SoftVerbs>(fabric)};
+    RdmaPeerInfo infoA, infoB;
+    CHECK(sender.Initialize() && receiver.Initialize());
+    CHECK(sender.PrepareConnection(1, infoA) && receiver.PrepareConnection(0, infoB));
+    CHECK(sender.Connect(1, infoB) && receiver.Connect(0, infoA));
+
+    std::vector<uint8_t> source(8 * kPage, 5);
+    Arena arena(8);
+    uint64_t remote = reinterpret_cast<uint64_t>(arena.base);
+    uint32_t oldKey = 0;
+    CHECK(receiver.RegisterMemory(arena.base, arena.bytes, &oldKey));
+    CHECK(sender.Transfer(1, source.data(), source.size(), remote, oldKey));
+    receiver.UnregisterMemory(arena.base);
+    CHECK(receiver.GetRegistrationStats().regions == 0);
+
+    // 同一地址再次注册（模拟释放后重新分配）得到新的注册，旧rkey已失效
+    uint32_t newKey = 0;
+    CHECK(receiver.RegisterMemory(arena.base, arena.bytes, &newKey));
+    CHECK(newKey != oldKey);
+    std::fill(source.begin(), source.end(), 9);
+    CHECK(sender.Transfer(1, source.data(), source.size(), remote, newKey));
+    CHECK(arena.base[arena.bytes - 1] == 9);
+    CHECK(!sender.Transfer(1, source.data(), source.size(), remote, oldKey));
+    receiver.UnregisterMemory(arena.base);
+
+    // 发送端本地缓冲区的缓存注册在释放前作废
+    CHECK(sender.GetRegistrationStats().regions == 1);
+    sender.InvalidateMemory(source.data(), source.size());
+    CHECK(sender.GetRegistrationStats().regions == 0);
+}
+
+// 多线程借用、归还与作废交错，结束后没有泄漏的注册
+void testConcurrent() {
+    SoftFabric fabric;
+    CountingVerbs verbs(fabric);
+    Arena arena(64);
+    {
+        RdmaRegistrationCache cache(verbs, 16 * kPage);
+        std::atomic<uint64_t> acquires{0};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([&, t] {
+                std::mt19937 rng(t);
+                for (int i = 0; i < 20000; ++i) {
+                    size_t page = rng() % 60;
+                    size_t pages = 1 + rng() % 4;
+                    if (rng() % 16 == 0) {
+                        cache.Invalidate(arena.page(page), pages * kPage);
+                        continue;
+                    }
+                    RdmaMrHandle handle = cache.Acquire(arena.page(page), pages * kPage);
+                    acquires++;
+                    cache.Release(handle);
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        RdmaMrCacheStats stats = cache.GetStats();
+        CHECK(stats.hits + stats.misses == acquires);
+        CHECK(stats.pinnedBytes <= 16 * kPage);
+        CHECK(verbs.live == static_cast<int>(stats.regions));
+    }
+    CHECK(verbs.live == 0);
+}
+
+// 原实现按起始指针精确匹配且从不注销：池内不同偏移的拷贝各注册一次，固定内存只增不减。
+// 软件verbs的注册只是一次堆分配，耗时没有参考意义，这里比较注册次数与固定内存
+void reportRegistrations(const char* name, size_t hotPages, int coldPercent) {
+    SoftFabric fabric;
+    CountingVerbs verbs(fabric);
+    Arena arena(1024);
+    RdmaRegistrationCache cache(verbs, 256 * kPage);
+    std::mt19937 rng(7);
+    std::set<uintptr_t> exactKeys;
+    uint64_t exactPinned = 0;
+    constexpr int kCopies = 200000;
+    for (int i = 0; i < kCopies; ++i) {
+        size_t page = static_cast<int>(rng() % 100) < coldPercent ? rng() % 1023 : rng() % hotPages;
+        uint8_t* ptr = arena.page(page) + (rng() % 64) * 64;
+        if (exactKeys.insert(reinterpret_cast<uintptr_t>(ptr)).second) exactPinned += kPage;
+        cache.Release(cache.Acquire(ptr, kPage));
+    }
+    RdmaMrCacheStats stats = cache.GetStats();
+    std::printf("%-22s exact-pointer map %6zu registrations %6.1f MiB pinned | "
+                "cache %6d registrations %5.1f%% hits %4.1f MiB pinned\n",
+                name, exactKeys.size(), exactPinned / 1048576.0, verbs.registrations.load(),
+                100.0 * stats.hits / (stats.hits + stats.misses), stats.pinnedBytes / 1048576.0);
+}
+}
+
+int main() {
+    testHitMissMerge();
+    testEviction();
+    testInvalidate();
+    testFreeThenReallocate();
+    testConcurrent();
+    reportRegistrations("64-page pool", 64, 0);
+    reportRegistrations("64-page pool + 5% cold", 64, 5);
+    reportRegistrations("1024-page sweep", 1023, 100);
+    if (g_failures) {
+        std::fprintf(stderr, "rdma_mr_cache_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("rdma_mr_cache_test: OK\n");
+    return 0;
+}
@@ -0,0 +1,255 @@
+// 中转缓冲池测试：按大小类取整与复用、超大缓冲与缓存上限、预热、借出缓冲的移动语义、
+// 注册/注销成对、多线程借还、释放缓冲前RDMA注册缓存已作废，并对比每次传输申请+注册与从池借用的耗时
+// 构建（在client/launcher下）：
+//   g++ -std=c++17 -O2 -I. tests/staging_pool_test.cpp transport/plank/staging_pool.cpp transport/rdma_transport.cpp
+//       transport/rdma_connection.cpp transport/rdma_verbs.cpp transport/rdma_mr_cache.cpp logging/async_logger.cpp
+//       -libverbs -pthread -o staging_pool_test
+#include "transport/plank/staging_pool.h"
+#include "transport/rdma_transport.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+// 记录注册/注销的缓冲，检查二者成对且注销的都是注册过的缓冲
+struct CountingRegistrar {
+    std::mutex mutex;
+    std::set<void*> registered;
+    std::atomic<int> registrations{0};
+    std::atomic<int> bad{0};
+
+    StagingRegistrar get() {
+        StagingRegistrar registrar;
+        registrar.registerMemory = [this](void* ptr, size_t) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!registered.insert(ptr).second) ++bad;
+            ++registrations;
+            return true;
+        };
+        registrar.unregisterMemory = [this](void* ptr, size_t) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (registered.erase(ptr) != 1) ++bad;
+        };
+        return registrar;
+    }
+};
+
+void testReuse() {
+    MallocHostAllocator allocator;
+    CountingRegistrar registrar;
+    {
+        StagingBufferPool pool(allocator, registrar.get());
+        void* first = nullptr;
+        {
+            StagingBuffer buffer = pool.Borrow(100 * 1024);
+            CHECK(buffer && buffer.capacity() == 128 * 1024);
+            first = buffer.data();
+        }
+        // 同一大小类取回同一缓冲，不再注册
+        StagingBuffer again = pool.Borrow(65 * 1024);
+        CHECK(again.data() == first && registrar.registrations == 1);
+        StagingBuffer other = pool.Borrow(1);
+        CHECK(other.capacity() == 64 * 1024 && other.data() != first);
+
+        StagingBuffer moved = std::move(again);
+        CHECK(!again && moved.data() == first);
+        moved = std::move(other);
+        CHECK(!other && pool.GetStats().outstanding == 1 && pool.GetStats().cachedBytes == 128 * 1024);
+        moved.Reset();
+
+        StagingPoolStats stats = pool.GetStats();
+        CHECK(stats.borrows == 3 && stats.hits == 1 && stats.allocations == 2 && stats.outstanding == 0);
+        CHECK(stats.cachedBytes == 192 * 1024);
+    }
+    CHECK(registrar.registered.empty() && registrar.bad == 0);
+}
+
+void testLimits() {
+    MallocHostAllocator allocator;
+    CountingRegistrar registrar;
+    StagingPoolConfig config;
+    config.maxBufferSize = 1 << 20;
+    config.maxCachedBytes = 2 << 20;
+    {
+        StagingBufferPool pool(allocator, registrar.get(), config);
+        // 超出最大大小类的缓冲按原大小临时申请，归还时直接释放
+        {
+            StagingBuffer big = pool.Borrow((1 << 20) + 1);
+            CHECK(big.capacity() == (1 << 20) + 1);
+        }
+        CHECK(pool.GetStats().cachedBytes == 0 && pool.GetStats().releases == 1);
+
+        // 缓存上限为2 MiB：三个1 MiB缓冲归还后只保留两个
+        {
+            std::vector<StagingBuffer> buffers;
+            for (int i = 0; i < 3; ++i) buffers.push_back(pool.Borrow(1 << 20));
+        }
+        CHECK(pool.GetStats().cachedBytes == (2 << 20) && pool.GetStats().releases == 2);
+
+        // 预热同样受上限约束
+        pool.Trim();
+        CHECK(pool.GetStats().cachedBytes == 0);
+        CHECK(pool.Prewarm(1 << 20, 4) == 2);
+        CHECK(pool.Prewarm((1 << 20) + 1, 1) == 0);
+        StagingBuffer warm = pool.Borrow(1 << 20);
+        CHECK(pool.GetStats().hits == 1);
+    }
+    CHECK(registrar.registered.empty() && registrar.bad == 0);
+}
+
+void testThreads() {
+    MallocHostAllocator allocator;
+    CountingRegistrar registrar;
+    {
+        StagingBufferPool pool(allocator, registrar.get());
+        std::atomic<int> overlaps{0};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([&, t] {
+                for (int i = 0; i < 20000; ++i) {
+                    StagingBuffer buffer = pool.Borrow(size_t(64 * 1024) << ((i + t) % 4));
+                    // 借出期间独占：写入标记后读回应不变
+                    auto* bytes = static_cast<unsigned char*>(buffer.data());
+                    bytes[0] = static_cast<unsigned char>(t);
+                    std::this_thread::yield();
+                    if (bytes[0] != t) ++overlaps;
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        CHECK(overlaps == 0);
+        CHECK(pool.GetStats().outstanding == 0);
+    }
+    CHECK(registrar.registered.empty() && registrar.bad == 0);
+}
+
+// 释放缓冲时RDMA注册缓存中不能留有覆盖它的注册：超大缓冲、超出缓存上限与Trim三条路径
+class CheckingAllocator : public MallocHostAllocator {
+public:
+    explicit CheckingAllocator(RdmaTransport& transport) : transport_(transport) {}
+
+    void* Allocate(size_t size) override {
+        live++;
+        return MallocHostAllocator::Allocate(size);
+    }
+    void Free(void* ptr, size_t size) override {
+        // 本缓冲已注销，缓存中只剩其余仍在池中的缓冲
+        if (transport_.GetRegistrationStats().regions != static_cast<uint64_t>(--live)) ++stale;
+        MallocHostAllocator::Free(ptr, size);
+    }
+
+    int live = 0;
+    int stale = 0;
+
+private:
+    RdmaTransport& transport_;
+};
+
+void testRegistrationDroppedBeforeFree() {
+    SoftFabric fabric;
+    RdmaTransport local{std::make_unique<SoftVerbs>(fabric)};
+    RdmaTransport peer{std::make_unique<SoftVerbs>(fabric)};
+    RdmaPeerInfo localInfo, peerInfo;
+    CHECK(local.Initialize() && peer.Initialize());
+    CHECK(local.PrepareConnection(1, localInfo) && peer.PrepareConnection(0, peerInfo));
+    CHECK(local.Connect(1, peerInfo) && peer.Connect(0, localInfo));
+
+    std::vector<uint8_t> target(4 << 20);
+    uint32_t targetKey = 0;
+    CHECK(peer.RegisterMemory(target.data(), target.size(), &targetKey));
+
+    StagingRegistrar registrar;
+    registrar.registerMemory = [&](void* ptr, size_t size) { return local.RegisterMemory(ptr, size); };
+    registrar.unregisterMemory = [&](void* ptr, size_t) { local.UnregisterMemory(ptr); };
+
+    CheckingAllocator allocator(local);
+    StagingPoolConfig config;
+    config.maxBufferSize = 1 << 20;
+    config.maxCachedBytes = 2 << 20;
+    {
+        StagingBufferPool pool(allocator, registrar, config);
+        auto send = [&](StagingBuffer& buffer, size_t size) {
+            std::memset(buffer.data(), 0x5A, size);
+            CHECK(local.Transfer(1, buffer.data(), size, reinterpret_cast<uint64_t>(target.data()), targetKey));
+        };
+        {
+            StagingBuffer big = pool.Borrow((1 << 20) + 4096);
+            send(big, big.capacity());
+        }
+        {
+            std::vector<StagingBuffer> buffers;
+            for (int i = 0; i < 3; ++i) {
+                buffers.push_back(pool.Borrow(1 << 20));
+                send(buffers.back(), 1 << 20);
+            }
+        }
+        CHECK(allocator.live == 2);
+        pool.Trim();
+        CHECK(allocator.live == 0);
+
+        // 释放后重新申请的缓冲可能落在同一地址，注册与传输仍然有效
+        StagingBuffer fresh = pool.Borrow(1 << 20);
+        send(fresh, 1 << 20);
+        CHECK(target[(1 << 20) - 1] == 0x5A);
+    }
+    CHECK(allocator.stale == 0 && allocator.live == 0);
+    CHECK(local.GetRegistrationStats().regions == 0);
+    peer.UnregisterMemory(target.data());
+}
+
+// 以写满缓冲近似固定页的开销
+void benchTransfers() {
+    MallocHostAllocator allocator;
+    const size_t sizes[] = {64 << 10, 300 << 10, 1 << 20, 4 << 20, 16 << 20};
+    constexpr int kTransfers = 2000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kTransfers; ++i) {
+        size_t size = sizes[i % 5];
+        void* ptr = allocator.Allocate(size);
+        std::memset(ptr, i, size);
+        allocator.Free(ptr, size);
+    }
+    double perTransfer = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    StagingBufferPool pool(allocator);
+    for (size_t size : sizes) pool.Prewarm(size, 1);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kTransfers; ++i) {
+        size_t size = sizes[i % 5];
+        StagingBuffer buffer = pool.Borrow(size);
+        std::memset(buffer.data(), i, size);
+    }
+    double pooled = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    std::printf("allocate per transfer %.1f us, pooled %.1f us, hit rate %.3f\n", perTransfer / kTransfers,
+                pooled / kTransfers, double(pool.GetStats().hits) / pool.GetStats().borrows);
+}
+}
+
+int main() {
+    testReuse();
+    testLimits();
+    testThreads();
+    testRegistrationDroppedBeforeFree();
+    benchTransfers();
+    if (g_failures) {
+        std::fprintf(stderr, "staging_pool_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("staging_pool_test: OK\n");
+    return 0;
+}
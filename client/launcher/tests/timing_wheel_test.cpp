@@ -0,0 +1,207 @@
+// 分层时间轮测试：各层槽宽边界上的条目恰在到期tick触发、已过期与超出最远排期的截断、起始tick位于整圈边界前
+// 与大数值时槽号回绕、回调中重新排期（含排到当前tick），以及随机排期/推进步长下与有序参考模型逐tick一致
+// 构建（在client/launcher下）：
+//   g++ -std=c++17 -O2 -I. tests/timing_wheel_test.cpp -o timing_wheel_test
+#include "services/timing_wheel.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+using Wheel = TimingWheel<int>;
+
+// 逐tick推进，记录每个条目触发时的tick
+std::map<int, uint64_t> RunUntil(Wheel& wheel, uint64_t endTick) {
+    std::map<int, uint64_t> fired;
+    while (wheel.currentTick() < endTick) {
+        uint64_t tick = wheel.currentTick() + 1;
+        wheel.advance(tick, [&](int key) { fired.emplace(key, tick); });
+    }
+    return fired;
+}
+
+// 每层槽宽（1、64、4096、262144个tick）两侧的到期时间都恰好在到期tick触发
+void testLevelBoundaries() {
+    for (uint64_t start : {uint64_t(0), uint64_t(1000), Wheel::kSlots * Wheel::kSlots - 3}) {
+        Wheel wheel(start);
+        std::vector<uint64_t> offsets = {1, 2, 63, 64, 65, 127, 128, 4095, 4096, 4097, 262143, 262144, 262145,
+                                         Wheel::kMaxSpan - 1, Wheel::kMaxSpan};
+        for (size_t i = 0; i < offsets.size(); ++i) wheel.schedule(int(i), start + offsets[i]);
+        CHECK(wheel.size() == offsets.size());
+
+        std::map<int, uint64_t> fired;
+        // 大跨度推进与逐tick推进的结果相同：先一步跨到最后一个条目之前，再逐tick走完
+        wheel.advance(start + offsets.back() - 1, [&](int key) { fired.emplace(key, 0); });
+        CHECK(fired.size() == offsets.size() - 1);
+        auto rest = RunUntil(wheel, start + offsets.back());
+        CHECK(rest.size() == 1 && rest.count(int(offsets.size() - 1)) == 1 &&
+              rest.begin()->second == start + offsets.back());
+        CHECK(wheel.size() == 0);
+
+        Wheel stepped(start);
+        for (size_t i = 0; i < offsets.size() - 2; ++i) stepped.schedule(int(i), start + offsets[i]);
+        fired = RunUntil(stepped, start + 262146);
+        CHECK(fired.size() == offsets.size() - 2);
+        for (const auto& [key, tick] : fired) CHECK(tick == start + offsets[key]);
+    }
+}
+
+// 已过期（含当前tick）的条目在下一个tick触发；超出最远排期的截断到current+kMaxSpan
+void testClamping() {
+    Wheel wheel(500);
+    wheel.schedule(1, 0);
+    wheel.schedule(2, 500);
+    wheel.schedule(3, Wheel::kMaxSpan * 4);
+    auto fired = RunUntil(wheel, 501);
+    CHECK(fired.size() == 2 && fired[1] == 501 && fired[2] == 501);
+
+    fired.clear();
+    wheel.advance(500 + Wheel::kMaxSpan - 1, [&](int key) { fired.emplace(key, 0); });
+    CHECK(fired.empty() && wheel.size() == 1);
+    fired = RunUntil(wheel, 500 + Wheel::kMaxSpan);
+    CHECK(fired.size() == 1 && fired[3] == 500 + Wheel::kMaxSpan);
+
+    wheel.schedule(4, wheel.currentTick() + 10);
+    wheel.clear();
+    CHECK(wheel.size() == 0);
+    fired = RunUntil(wheel, wheel.currentTick() + 20);
+    CHECK(fired.empty());
+}
+
+// 起始tick很大且紧靠各层整圈边界：槽号回绕后仍按绝对tick到期
+void testWraparound() {
+    const uint64_t bases[] = {(uint64_t(1) << 24) - 2, (uint64_t(1) << 40) - 5, (uint64_t(1) << 62) + 61};
+    for (uint64_t start : bases) {
+        Wheel wheel(start);
+        std::vector<uint64_t> deadlines;
+        for (uint64_t offset = 1; offset < 3 * Wheel::kSlots * Wheel::kSlots; offset = offset * 3 + 1) {
+            deadlines.push_back(start + offset);
+        }
+        for (size_t i = 0; i < deadlines.size(); ++i) wheel.schedule(int(i), deadlines[i]);
+        auto fired = RunUntil(wheel, deadlines.back());
+        CHECK(fired.size() == deadlines.size());
+        for (const auto& [key, tick] : fired) CHECK(tick == deadlines[key]);
+    }
+
+    // 同一槽位的条目跨整圈：相差64个tick的两个条目落在同一0层槽号，只在各自那一圈触发
+    Wheel wheel(63);
+    wheel.schedule(1, 70);
+    wheel.schedule(2, 70 + 64);
+    wheel.schedule(3, 70 + 4096);
+    auto fired = RunUntil(wheel, 70 + 4096);
+    CHECK(fired.size() == 3 && fired[1] == 70 && fired[2] == 134 && fired[3] == 70 + 4096);
+}
+
+// 回调中重新排期：CoolingService到期复查时把仍被访问的记录排到新的过期时间
+void testReschedule() {
+    Wheel wheel(0);
+    std::vector<std::pair<int, uint64_t>> fired;
+    wheel.schedule(1, 10);
+    wheel.schedule(2, 10);
+    int renewals[3] = {0, 0, 0};
+    auto onExpire = [&](int key) {
+        fired.emplace_back(key, wheel.currentTick());
+        if (renewals[key]++ >= 3) return;
+        if (key == 1) {
+            wheel.schedule(1, wheel.currentTick() + 100);   // 跨到上层槽位
+        } else {
+            wheel.schedule(2, wheel.currentTick());         // 排到当前tick：下一个tick触发
+        }
+    };
+    for (uint64_t tick = 1; tick <= 400; ++tick) wheel.advance(tick, onExpire);
+    std::vector<std::pair<int, uint64_t>> firedOf1, firedOf2;
+    for (const auto& entry : fired) (entry.first == 1 ? firedOf1 : firedOf2).push_back(entry);
+    CHECK(firedOf1 == (std::vector<std::pair<int, uint64_t>>{{1, 10}, {1, 110}, {1, 210}, {1, 310}}));
+    CHECK(firedOf2 == (std::vector<std::pair<int, uint64_t>>{{2, 10}, {2, 11}, {2, 12}, {2, 13}}));
+    CHECK(wheel.size() == 0);
+
+    // 一次推进多个tick时，回调中排到推进范围内的条目在同一次advance中触发
+    Wheel jump(0);
+    std::vector<uint64_t> ticks;
+    jump.schedule(7, 5);
+    jump.advance(1000, [&](int key) {
+        ticks.push_back(jump.currentTick());
+        if (ticks.size() < 4) jump.schedule(key, jump.currentTick() + 200);
+    });
+    CHECK(ticks == (std::vector<uint64_t>{5, 205, 405, 605}));
+}
+
+// 随机排期、随机步长推进（含跨多层的大步长）并在回调中随机续期，与有序参考模型比较每个条目的触发tick
+void testRandomAgainstModel() {
+    std::mt19937_64 rng(13);
+    for (int round = 0; round < 20; ++round) {
+        uint64_t start = rng() % (uint64_t(1) << 30);
+        Wheel wheel(start);
+        std::multimap<uint64_t, int> model;           // 到期tick -> 键
+        int nextKey = 0;
+        auto deadlineNear = [&](uint64_t now) {
+            switch (rng() % 4) {
+            case 0: return now + rng() % 64;
+            case 1: return now + rng() % 4096;
+            case 2: return now + rng() % 300000;
+            default: return now + rng() % (Wheel::kMaxSpan + 1);
+            }
+        };
+        auto add = [&](uint64_t deadline) {
+            uint64_t now = wheel.currentTick();
+            wheel.schedule(nextKey, deadline);
+            model.emplace(std::max(deadline, now + 1), nextKey);
+            ++nextKey;
+        };
+        for (int i = 0; i < 2000; ++i) add(deadlineNear(start));
+
+        int mismatches = 0;
+        for (int step = 0; step < 400 && !model.empty(); ++step) {
+            uint64_t target = wheel.currentTick() + (rng() % 8 == 0 ? rng() % 100000 : rng() % 300);
+            std::vector<std::pair<uint64_t, int>> fired;
+            wheel.advance(target, [&](int key) {
+                uint64_t now = wheel.currentTick();
+                fired.emplace_back(now, key);
+                if (rng() % 4 == 0) add(deadlineNear(now));
+            });
+            // 参考模型：到期tick不晚于target的条目，按tick顺序触发（同tick内顺序不限）
+            for (const auto& [tick, key] : fired) {
+                auto range = model.equal_range(tick);
+                auto it = range.first;
+                while (it != range.second && it->second != key) ++it;
+                if (it == range.second) {
+                    ++mismatches;
+                } else {
+                    model.erase(it);
+                }
+            }
+            if (!model.empty() && model.begin()->first <= target) ++mismatches;
+            if (wheel.size() != model.size()) ++mismatches;
+            for (int i = 0; i < 5; ++i) add(deadlineNear(wheel.currentTick()));
+        }
+        CHECK(mismatches == 0);
+    }
+}
+}
+
+int main() {
+    testLevelBoundaries();
+    testClamping();
+    testWraparound();
+    testReschedule();
+    testRandomAgainstModel();
+    if (g_failures) {
+        std::fprintf(stderr, "timing_wheel_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("timing_wheel_test: OK\n");
+    return 0;
+}
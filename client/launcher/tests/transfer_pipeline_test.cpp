@@ -0,0 +1,277 @@
+// 跳板分片流水线测试（MemcpyCopyEngine，主机内存模拟设备）：分片边界与非整分片的最后一片、
+// 深度1/2/N（含多于分片数）下使用的中转槽数与数据正确、发送端经写入窗口交给接收端的环回传输、
+// 发送/接收回调失败与拷贝提交/完成失败时返回失败且等待全部在途拷贝后才归还中转缓冲
+// 构建（在client/launcher下）：
+//   g++ -std=c++17 -O2 -I. tests/transfer_pipeline_test.cpp transport/plank/transfer_pipeline.cpp
+//       transport/plank/staging_pool.cpp logging/async_logger.cpp -pthread -o transfer_pipeline_test
+#include "transport/plank/transfer_pipeline.h"
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                   \
+        }                                                                   \
+    } while (0)
+
+constexpr size_t kChunk = 64 * 1024;
+
+uint64_t Device(const std::vector<uint8_t>& buffer) { return reinterpret_cast<uint64_t>(buffer.data()); }
+
+std::vector<uint8_t> Pattern(size_t size, int seed) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i) data[i] = static_cast<uint8_t>(i * 31 + seed);
+    return data;
+}
+
+// 包装MemcpyCopyEngine：记录各槽提交与等待的拷贝数，可在第N次提交或等待时注入失败
+class TrackingEngine : public CopyEngine {
+public:
+    bool CopyToHostAsync(void* dst, uint64_t src, size_t size, size_t slot) override {
+        if (!Submitted(slot)) return false;
+        return inner_.CopyToHostAsync(dst, src, size, slot);
+    }
+    bool CopyToDeviceAsync(uint64_t dst, const void* src, size_t size, size_t slot) override {
+        if (!Submitted(slot)) return false;
+        return inner_.CopyToDeviceAsync(dst, src, size, slot);
+    }
+    bool Wait(size_t slot) override {
+        bool ok = inner_.Wait(slot);
+        if (slot < submitted.size()) waited[slot] = submitted[slot];
+        return ok && ++waits != failWaitAt;
+    }
+
+    // 所有提交过的拷贝都已被等待
+    bool Drained() const { return submitted == waited; }
+
+    int failSubmitAt = -1;
+    int failWaitAt = -1;
+    std::vector<int> submitted;
+    std::vector<int> waited;
+
+private:
+    bool Submitted(size_t slot) {
+        if (++submits == failSubmitAt) return false;
+        if (slot >= submitted.size()) {
+            submitted.resize(slot + 1, 0);
+            waited.resize(slot + 1, 0);
+        }
+        ++submitted[slot];
+        return true;
+    }
+
+    MemcpyCopyEngine inner_;
+    int submits = 0;
+    int waits = 0;
+};
+
+struct Fixture {
+    explicit Fixture(size_t depth) : pipeline(engine, pool, {kChunk, depth}) {}
+
+    MallocHostAllocator allocator;
+    StagingBufferPool pool{allocator};
+    TrackingEngine engine;
+    TransferPipeline pipeline;
+};
+
+const size_t kSizes[] = {1, kChunk - 1, kChunk, kChunk + 1, 3 * kChunk, 5 * kChunk + 17};
+
+// 分片按顺序、边界对齐到chunkSize，最后一片为余数；同时在用的中转槽数为min(depth, 分片数)
+void testSendChunks() {
+    for (size_t depth : {size_t(1), size_t(2), size_t(4), size_t(16)}) {
+        for (size_t size : kSizes) {
+            Fixture fixture(depth);
+            std::vector<uint8_t> source = Pattern(size, 3);
+            std::vector<uint8_t> received(size, 0);
+            std::vector<size_t> offsets;
+            std::set<const void*> slots;
+            bool ok = fixture.pipeline.Send(Device(source), size, [&](const void* data, size_t length, size_t offset) {
+                offsets.push_back(offset);
+                slots.insert(data);
+                bool boundary = offset % kChunk == 0 && length == std::min(kChunk, size - offset);
+                std::memcpy(received.data() + offset, data, length);
+                return boundary;
+            });
+            size_t chunks = (size + kChunk - 1) / kChunk;
+            CHECK(ok);
+            CHECK(offsets.size() == chunks);
+            for (size_t i = 0; i < offsets.size(); ++i) CHECK(offsets[i] == i * kChunk);
+            CHECK(slots.size() == std::min(depth, chunks));
+            CHECK(received == source);
+            CHECK(fixture.engine.Drained() && fixture.pool.GetStats().outstanding == 0);
+        }
+    }
+}
+
+// 接收端：回调写入中转槽，返回后HtoD，Receive返回时全部数据已到设备
+void testReceiveChunks() {
+    for (size_t depth : {size_t(1), size_t(2), size_t(4), size_t(16)}) {
+        for (size_t size : kSizes) {
+            Fixture fixture(depth);
+            std::vector<uint8_t> expected = Pattern(size, 5);
+            std::vector<uint8_t> device(size + 1, 0);
+            size_t calls = 0;
+            bool ok = fixture.pipeline.Receive(Device(device), size, [&](void* data, size_t length, size_t offset) {
+                ++calls;
+                std::memcpy(data, expected.data() + offset, length);
+                return offset == (calls - 1) * kChunk && length == std::min(kChunk, size - offset);
+            });
+            CHECK(ok);
+            CHECK(calls == (size + kChunk - 1) / kChunk);
+            CHECK(std::memcmp(device.data(), expected.data(), size) == 0 && device[size] == 0);
+            CHECK(fixture.engine.Drained() && fixture.pool.GetStats().outstanding == 0);
+        }
+    }
+    Fixture fixture(2);
+    CHECK(fixture.pipeline.Receive(0, 0, [](void*, size_t, size_t) { return false; }));
+    CHECK(fixture.pipeline.Send(0, 0, [](const void*, size_t, size_t) { return false; }));
+}
+
+// 环回：接收端逐片发布中转槽作为写入窗口，发送端写入后通知，模拟PlankTransport的控制面交互
+class Mailbox {
+public:
+    struct Window {
+        void* data;
+        size_t length;
+        size_t offset;
+    };
+
+    void Post(const Window& window) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        windows_.push_back(window);
+        cv_.notify_all();
+    }
+    Window Take() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return !windows_.empty(); });
+        Window window = windows_.front();
+        windows_.pop_front();
+        return window;
+    }
+    void MarkWritten(size_t offset) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        written_.insert(offset);
+        cv_.notify_all();
+    }
+    void WaitWritten(size_t offset) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return written_.count(offset) != 0; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Window> windows_;
+    std::set<size_t> written_;
+};
+
+void testLoopback() {
+    for (size_t depth : {size_t(1), size_t(2), size_t(3)}) {
+        constexpr size_t kSize = 7 * kChunk + 1234;
+        Fixture sender(depth);
+        Fixture receiver(depth);
+        std::vector<uint8_t> source = Pattern(kSize, 9);
+        std::vector<uint8_t> target(kSize, 0);
+        Mailbox mailbox;
+
+        bool received = false;
+        std::thread thread([&] {
+            received = receiver.pipeline.Receive(Device(target), kSize, [&](void* data, size_t length, size_t offset) {
+                mailbox.Post({data, length, offset});
+                mailbox.WaitWritten(offset);
+                return true;
+            });
+        });
+        bool sent = sender.pipeline.Send(Device(source), kSize, [&](const void* data, size_t length, size_t offset) {
+            Mailbox::Window window = mailbox.Take();
+            if (window.offset != offset || window.length < length) return false;
+            std::memcpy(window.data, data, length);
+            mailbox.MarkWritten(offset);
+            return true;
+        });
+        thread.join();
+        CHECK(sent && received);
+        CHECK(target == source);
+    }
+}
+
+// 失败后返回false，且所有已提交的拷贝都已等待完成，中转缓冲全部归还
+void testFailures() {
+    constexpr size_t kSize = 6 * kChunk + 100;
+    for (size_t depth : {size_t(1), size_t(2), size_t(4)}) {
+        for (int failAt = 1; failAt <= 7; failAt += 3) {
+            std::vector<uint8_t> source = Pattern(kSize, 1);
+            std::vector<uint8_t> device(kSize, 0);
+            {
+                Fixture fixture(depth);
+                int calls = 0;
+                CHECK(!fixture.pipeline.Send(Device(source), kSize, [&](const void*, size_t, size_t) {
+                    return ++calls != failAt;
+                }));
+                CHECK(fixture.engine.Drained() && fixture.pool.GetStats().outstanding == 0);
+            }
+            {
+                Fixture fixture(depth);
+                int calls = 0;
+                CHECK(!fixture.pipeline.Receive(Device(device), kSize, [&](void*, size_t, size_t) {
+                    return ++calls != failAt;
+                }));
+                CHECK(fixture.engine.Drained() && fixture.pool.GetStats().outstanding == 0);
+            }
+            for (bool submitFailure : {true, false}) {
+                Fixture fixture(depth);
+                (submitFailure ? fixture.engine.failSubmitAt : fixture.engine.failWaitAt) = failAt;
+                CHECK(!fixture.pipeline.Send(Device(source), kSize, [](const void*, size_t, size_t) { return true; }));
+                CHECK(fixture.engine.Drained() && fixture.pool.GetStats().outstanding == 0);
+            }
+            for (bool submitFailure : {true, false}) {
+                Fixture fixture(depth);
+                (submitFailure ? fixture.engine.failSubmitAt : fixture.engine.failWaitAt) = failAt;
+                CHECK(!fixture.pipeline.Receive(Device(device), kSize, [](void*, size_t, size_t) { return true; }));
+                CHECK(fixture.engine.Drained() && fixture.pool.GetStats().outstanding == 0);
+            }
+        }
+    }
+
+    // 最后一次等待（收尾的Drain）失败也要报告
+    Fixture fixture(2);
+    std::vector<uint8_t> device(3 * kChunk, 0);
+    fixture.engine.failWaitAt = 3;
+    CHECK(!fixture.pipeline.Receive(Device(device), device.size(), [](void*, size_t, size_t) { return true; }));
+
+    // 借不到中转缓冲
+    class FailingAllocator : public HostAllocator {
+    public:
+        void* Allocate(size_t) override { return nullptr; }
+        void Free(void*, size_t) override {}
+    } failing;
+    StagingBufferPool pool(failing);
+    TrackingEngine engine;
+    TransferPipeline pipeline(engine, pool, {kChunk, 2});
+    CHECK(!pipeline.Send(Device(device), device.size(), [](const void*, size_t, size_t) { return true; }));
+    CHECK(engine.submitted.empty());
+}
+}
+
+int main() {
+    testSendChunks();
+    testReceiveChunks();
+    testLoopback();
+    testFailures();
+    if (g_failures) {
+        std::fprintf(stderr, "transfer_pipeline_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("transfer_pipeline_test: OK\n");
+    return 0;
+}
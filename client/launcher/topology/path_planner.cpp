@@ -0,0 +1,150 @@
+#include "path_planner.h"
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <queue>
+
+double TransferPlan::BottleneckMBps() const {
+    double bottleneck = std::numeric_limits<double>::infinity();
+    for (const auto& hop : hops) {
+        bottleneck = std::min(bottleneck, hop.bandwidthMBps);
+    }
+    return hops.empty() ? 0.0 : bottleneck;
+}
+
+LinkType TransferPlan::DominantType() const {
+    LinkType type = LinkType::NvLink;
+    for (const auto& hop : hops) {
+        type = std::max(type, hop.type);
+    }
+    return type;
+}
+
+PathPlanner::PathPlanner() : snapshot_(std::make_shared<Snapshot>()) {
+    snapshot_->graph = std::make_shared<TopologyGraph>();
+}
+
+void PathPlanner::SetTopology(std::shared_ptr<const TopologyGraph> graph) {
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->graph = graph ? std::move(graph) : std::make_shared<TopologyGraph>();
+    std::atomic_store(&snapshot_, std::move(snapshot));
+}
+
+std::shared_ptr<const TopologyGraph> PathPlanner::Topology() const {
+    return std::atomic_load(&snapshot_)->graph;
+}
+
+uint32_t PathPlanner::SizeClass(uint64_t size) {
+    uint32_t bits = 0;
+    while (size) {
+        ++bits;
+        size >>= 1;
+    }
+    return bits;
+}
+
+PathPlanner::Route PathPlanner::ShortestRoute(const TopologyGraph& graph, uint32_t src, uint32_t dst, uint64_t size) {
+    Route route;
+    size_t count = graph.DeviceCount();
+    if (src >= count || dst >= count) return route;
+    if (src == dst) {
+        route.found = true;
+        return route;
+    }
+
+    constexpr double kInf = std::numeric_limits<double>::infinity();
+    std::vector<double> cost(count, kInf);
+    std::vector<const TopologyLink*> via(count, nullptr);     // 到达该设备所用的链路
+    std::vector<uint32_t> prev(count, TopologyGraph::kInvalidDevice);
+
+    using Entry = std::pair<double, uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    cost[src] = 0.0;
+    queue.push({0.0, src});
+    while (!queue.empty()) {
+        auto [current, device] = queue.top();
+        queue.pop();
+        if (current > cost[device]) continue;
+        if (device == dst) break;
+        for (const auto& link : graph.Links(device)) {
+            double next = current + link.CostUs(size);
+            if (next < cost[link.to]) {
+                cost[link.to] = next;
+                via[link.to] = &link;
+                prev[link.to] = device;
+                queue.push({next, link.to});
+            }
+        }
+    }
+    if (cost[dst] == kInf) return route;
+
+    for (uint32_t device = dst; device != src; device = prev[device]) {
+        const TopologyLink* link = via[device];
+        route.hops.push_back({prev[device], device, link->type, link->transport, link->bandwidthMBps, link->latencyUs});
+    }
+    std::reverse(route.hops.begin(), route.hops.end());
+    for (const auto& hop : route.hops) {
+        if (hop.type == LinkType::Network) {
+            route.entryNode = graph.Device(hop.to).node;
+            break;
+        }
+    }
+    route.found = true;
+    return route;
+}
+
+TransferPlan PathPlanner::Plan(const std::string& src, const std::string& dst, uint64_t size) {
+    auto snapshot = std::atomic_load(&snapshot_);
+    uint32_t a = snapshot->graph->Find(src);
+    uint32_t b = snapshot->graph->Find(dst);
+    if (a == TopologyGraph::kInvalidDevice || b == TopologyGraph::kInvalidDevice) {
+        plans_.fetch_add(1, std::memory_order_relaxed);
+        return TransferPlan();
+    }
+    return Plan(a, b, size);
+}
+
+TransferPlan PathPlanner::Plan(uint32_t src, uint32_t dst, uint64_t size) {
+    plans_.fetch_add(1, std::memory_order_relaxed);
+    auto snapshot = std::atomic_load(&snapshot_);
+    uint32_t sizeClass = SizeClass(size);
+    uint64_t key = (uint64_t(src) << 38) | (uint64_t(dst) << 8) | sizeClass;
+
+    TransferPlan plan;
+    bool cached = false;
+    {
+        std::shared_lock<std::shared_mutex> lock(snapshot->mutex);
+        auto it = snapshot->routes.find(key);
+        if (it != snapshot->routes.end()) {
+            plan.found = it->second.found;
+            plan.hops = it->second.hops;
+            plan.entryNode = it->second.entryNode;
+            cached = true;
+        }
+    }
+    if (cached) {
+        cache_hits_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        // 按大小类上界规划，同一类内的传输共用路径
+        uint64_t representative = sizeClass >= 64 ? UINT64_MAX : (uint64_t(1) << sizeClass) - 1;
+        Route route = ShortestRoute(*snapshot->graph, src, dst, std::max<uint64_t>(representative, 1));
+        plan.found = route.found;
+        plan.hops = route.hops;
+        plan.entryNode = route.entryNode;
+
+        std::unique_lock<std::shared_mutex> lock(snapshot->mutex);
+        snapshot->routes.emplace(key, std::move(route));
+    }
+
+    for (const auto& hop : plan.hops) {
+        plan.estimatedUs += hop.latencyUs + double(size) / hop.bandwidthMBps;
+    }
+    return plan;
+}
+
+PathPlannerStats PathPlanner::GetStats() const {
+    PathPlannerStats stats;
+    stats.plans = plans_.load(std::memory_order_relaxed);
+    stats.cacheHits = cache_hits_.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+// 传输路径规划：在拓扑图上按传输大小求耗时最短的路径，并决定每一跳的传输方式。
+// 每条链路的耗时为 latencyUs + size / bandwidthMBps（逐跳存储转发），小传输偏向延迟低的链路，
+// 大传输偏向带宽高的链路。结果按(源, 目的, 大小类)缓存，大小类为size的二进制位数。
+#include "topology_graph.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct PlanHop {
+    uint32_t from = 0;
+    uint32_t to = 0;
+    LinkType type = LinkType::Network;
+    LinkTransport transport = LinkTransport::Rdma;
+    double bandwidthMBps = 0.0;
+    double latencyUs = 0.0;
+};
+
+struct TransferPlan {
+    bool found = false;
+    std::vector<PlanHop> hops;          // 源与目的相同时为空
+    std::string entryNode;              // 首个网络跳到达的节点，即数据应发往的节点；无网络跳时为空
+    double estimatedUs = 0.0;           // 按实际大小估算的耗时
+
+    double BottleneckMBps() const;
+    // 整条路径对应的PathType：含网络跳即为network，其次xbus
+    LinkType DominantType() const;
+};
+
+struct PathPlannerStats {
+    uint64_t plans = 0;
+    uint64_t cacheHits = 0;
+};
+
+class PathPlanner {
+public:
+    PathPlanner();
+
+    // 发布新的拓扑，旧拓扑上的缓存一并丢弃；进行中的规划继续使用旧拓扑
+    void SetTopology(std::shared_ptr<const TopologyGraph> graph);
+    std::shared_ptr<const TopologyGraph> Topology() const;
+
+    TransferPlan Plan(const std::string& src, const std::string& dst, uint64_t size);
+    TransferPlan Plan(uint32_t src, uint32_t dst, uint64_t size);
+
+    PathPlannerStats GetStats() const;
+
+    static uint32_t SizeClass(uint64_t size);
+
+private:
+    struct Route {
+        bool found = false;
+        std::vector<PlanHop> hops;
+        std::string entryNode;
+    };
+
+    // 拓扑与其路径缓存一起替换，缓存不会混入旧拓扑的结果
+    struct Snapshot {
+        std::shared_ptr<const TopologyGraph> graph;
+        mutable std::shared_mutex mutex;
+        std::unordered_map<uint64_t, Route> routes;
+    };
+
+    static Route ShortestRoute(const TopologyGraph& graph, uint32_t src, uint32_t dst, uint64_t size);
+
+    std::shared_ptr<Snapshot> snapshot_;    // 经std::atomic_load/atomic_store访问
+    std::atomic<uint64_t> plans_{0};
+    std::atomic<uint64_t> cache_hits_{0};
+};
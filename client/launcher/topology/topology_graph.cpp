@@ -0,0 +1,125 @@
+#include "topology_graph.h"
+#include "../logging/async_logger.h"
+#include <yaml-cpp/yaml.h>
+
+namespace {
+// 默认链路参数（带宽MB/s，延迟us）
+constexpr double kPcieBandwidth = 24000.0;      // PCIe 4.0 x16
+constexpr double kPcieLatency = 10.0;
+constexpr double kRdmaBandwidth = 12000.0;      // 100Gb RoCE
+constexpr double kRdmaSetupLatency = 20.0;      // 内存注册与WR提交
+constexpr double kZmqBandwidth = 1200.0;
+constexpr double kZmqSetupLatency = 5.0;
+
+bool ParseLinkType(const std::string& name, LinkType& type) {
+    if (name == "nvlink") type = LinkType::NvLink;
+    else if (name == "xbus" || name == "pcie") type = LinkType::XBus;
+    else if (name == "network") type = LinkType::Network;
+    else return false;
+    return true;
+}
+
+bool ParseTransport(const std::string& name, LinkTransport& transport) {
+    if (name == "direct") transport = LinkTransport::Direct;
+    else if (name == "zmq") transport = LinkTransport::Zmq;
+    else if (name == "rdma") transport = LinkTransport::Rdma;
+    else return false;
+    return true;
+}
+}
+
+const char* LinkTypeName(LinkType type) {
+    switch (type) {
+        case LinkType::NvLink: return "nvlink";
+        case LinkType::XBus: return "xbus";
+        case LinkType::Network: return "network";
+    }
+    return "unknown";
+}
+
+const char* LinkTransportName(LinkTransport transport) {
+    switch (transport) {
+        case LinkTransport::Direct: return "direct";
+        case LinkTransport::Zmq: return "zmq";
+        case LinkTransport::Rdma: return "rdma";
+    }
+    return "unknown";
+}
+
+uint32_t TopologyGraph::AddDevice(const std::string& id, const std::string& node, DeviceKind kind, int numaNode) {
+    auto it = ids_.find(id);
+    if (it != ids_.end()) return it->second;
+
+    uint32_t index = static_cast<uint32_t>(devices_.size());
+    devices_.push_back({id, node, kind, numaNode});
+    links_.emplace_back();
+    ids_.emplace(id, index);
+    return index;
+}
+
+bool TopologyGraph::AddLink(const std::string& from, const std::string& to, LinkType type, LinkTransport transport,
+                            double bandwidthMBps, double latencyUs, bool bidirectional) {
+    uint32_t a = Find(from);
+    uint32_t b = Find(to);
+    if (a == kInvalidDevice || b == kInvalidDevice || a == b || bandwidthMBps <= 0.0) {
+        return false;
+    }
+    links_[a].push_back({b, type, transport, bandwidthMBps, latencyUs});
+    if (bidirectional) {
+        links_[b].push_back({a, type, transport, bandwidthMBps, latencyUs});
+    }
+    return true;
+}
+
+uint32_t TopologyGraph::Find(const std::string& id) const {
+    auto it = ids_.find(id);
+    return it != ids_.end() ? it->second : kInvalidDevice;
+}
+
+bool TopologyGraph::LoadYaml(const YAML::Node& topology) {
+    for (const auto& device : topology["devices"]) {
+        std::string kind = device["type"].as<std::string>("gpu");
+        if (kind != "gpu" && kind != "host") {
+            LOG_ERROR("Unknown topology device type: {}", kind);
+            return false;
+        }
+        AddDevice(device["id"].as<std::string>(), device["node"].as<std::string>(""),
+                  kind == "gpu" ? DeviceKind::Gpu : DeviceKind::Host, device["numa"].as<int>(-1));
+    }
+
+    for (const auto& link : topology["links"]) {
+        LinkType type;
+        std::string typeName = link["type"].as<std::string>("network");
+        if (!ParseLinkType(typeName, type)) {
+            LOG_ERROR("Unknown topology link type: {}", typeName);
+            return false;
+        }
+        LinkTransport transport = type == LinkType::Network ? LinkTransport::Rdma : LinkTransport::Direct;
+        if (link["transport"] && !ParseTransport(link["transport"].as<std::string>(), transport)) {
+            LOG_ERROR("Unknown topology link transport: {}", link["transport"].as<std::string>());
+            return false;
+        }
+
+        std::string from = link["from"].as<std::string>();
+        std::string to = link["to"].as<std::string>();
+        if (!AddLink(from, to, type, transport, link["bandwidth"].as<double>(0.0),
+                     link["latency_us"].as<double>(0.0), link["bidirectional"].as<bool>(true))) {
+            LOG_ERROR("Invalid topology link {} -> {}", from, to);
+            return false;
+        }
+    }
+    return true;
+}
+
+void TopologyGraph::AddNodeDefaults(const std::string& node, int numaNode) {
+    AddDevice(HostId(node), node, DeviceKind::Host, numaNode);
+    AddDevice(GpuId(node), node, DeviceKind::Gpu, numaNode);
+    AddLink(HostId(node), GpuId(node), LinkType::XBus, LinkTransport::Direct, kPcieBandwidth, kPcieLatency);
+}
+
+void TopologyGraph::ConnectHosts(const std::string& a, const std::string& b, double networkLatencyUs) {
+    AddLink(HostId(a), HostId(b), LinkType::Network, LinkTransport::Zmq,
+            kZmqBandwidth, networkLatencyUs + kZmqSetupLatency);
+    AddLink(HostId(a), HostId(b), LinkType::Network, LinkTransport::Rdma,
+            kRdmaBandwidth, networkLatencyUs + kRdmaSetupLatency);
+}
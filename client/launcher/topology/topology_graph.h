@@ -0,0 +1,86 @@
+#pragma once
+
+// 设备拓扑图：顶点为各节点的主机内存与GPU，边为NVLink/PCIe/网络链路。
+// 对应gpu-control.capnp中Path/Step/PathType的模型，由配置的topology段加载，
+// 未配置时按节点列表生成默认拓扑。
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace YAML { class Node; }
+
+// 对应PathType
+enum class LinkType : uint8_t {
+    NvLink,
+    XBus,       // PCIe
+    Network,
+};
+
+// 链路上实际使用的传输方式
+enum class LinkTransport : uint8_t {
+    Direct,     // 节点内拷贝（cudaMemcpy/NVLink P2P）
+    Zmq,
+    Rdma,
+};
+
+// 对应MemType
+enum class DeviceKind : uint8_t {
+    Gpu,
+    Host,
+};
+
+struct TopologyDevice {
+    std::string id;             // 全局唯一，约定为"<节点ID>/host"、"<节点ID>/gpu<N>"
+    std::string node;           // 所属节点ID
+    DeviceKind kind = DeviceKind::Host;
+    int numaNode = -1;
+};
+
+struct TopologyLink {
+    uint32_t to = 0;
+    LinkType type = LinkType::Network;
+    LinkTransport transport = LinkTransport::Rdma;
+    double bandwidthMBps = 0.0;     // 与Path.bandwidth一致，单位MB/s
+    double latencyUs = 0.0;         // 单次传输的固定开销（含建立/注册）
+
+    // 经该链路传输size字节的耗时（微秒）
+    double CostUs(uint64_t size) const {
+        return latencyUs + (bandwidthMBps > 0.0 ? double(size) / bandwidthMBps : 1e18);
+    }
+};
+
+const char* LinkTypeName(LinkType type);
+const char* LinkTransportName(LinkTransport transport);
+
+class TopologyGraph {
+public:
+    static constexpr uint32_t kInvalidDevice = UINT32_MAX;
+    static constexpr const char* kLocalNode = "local";     // Launcher所在主机
+
+    static std::string HostId(const std::string& node) { return node + "/host"; }
+    static std::string GpuId(const std::string& node, int gpu = 0) { return node + "/gpu" + std::to_string(gpu); }
+
+    // 已存在同ID设备时返回其下标
+    uint32_t AddDevice(const std::string& id, const std::string& node, DeviceKind kind, int numaNode = -1);
+    bool AddLink(const std::string& from, const std::string& to, LinkType type, LinkTransport transport,
+                 double bandwidthMBps, double latencyUs, bool bidirectional = true);
+
+    uint32_t Find(const std::string& id) const;
+    const TopologyDevice& Device(uint32_t index) const { return devices_[index]; }
+    const std::vector<TopologyLink>& Links(uint32_t index) const { return links_[index]; }
+    size_t DeviceCount() const { return devices_.size(); }
+
+    // 解析topology段：devices列出设备，links列出链路
+    bool LoadYaml(const YAML::Node& topology);
+
+    // 默认拓扑：节点主机与一块GPU经PCIe相连
+    void AddNodeDefaults(const std::string& node, int numaNode);
+    // 两节点主机间加入ZMQ与RDMA两条网络链路，延迟取节点测得的网络延迟
+    void ConnectHosts(const std::string& a, const std::string& b, double networkLatencyUs);
+
+private:
+    std::vector<TopologyDevice> devices_;
+    std::vector<std::vector<TopologyLink>> links_;      // 按起点设备下标
+    std::unordered_map<std::string, uint32_t> ids_;
+};
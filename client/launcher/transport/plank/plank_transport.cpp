@@ -1,66 +1,231 @@
-#include "plank_transport.h"
-#include "../rdma_transport.h"
-#include "../zmq_transport.h"
-#include <cuda_runtime.h>
-#include <iostream>
-#include <memory>
-
-class PlankTransportImpl : public PlankTransport {
-public:
-    PlankTransportImpl() 
-        : rdma_transport_(createRdmaTransport()),
-          zmq_transport_(createZmqTransport()) {}
-    
-    bool sendData(uint64_t src_handle, uint64_t dst_handle, 
-                 const void* data, size_t size, int src_node, int dst_node) override {
-        // 对于冷数据使用ZMQ UDP传输
-        return zmq_transport_->send(dst_node, data, size);
-    }
-    
-    bool receiveData(uint64_t src_handle, uint64_t dst_handle,
-                    void* buffer, size_t size, int src_node, int dst_node) override {
-        // 对于冷数据使用ZMQ UDP接收
-        return zmq_transport_->receive(src_node, buffer, size);
-    }
-    
-    bool transferGpuBuffer(uint64_t src_gpu_handle, uint64_t dst_gpu_handle,
-                          size_t size, int src_node, int dst_node) override {
-        // 1. 源节点：通过UVM实现GPU-CPU零拷贝
-        void* host_ptr = nullptr;
-        cudaError_t err = cudaHostAlloc(&host_ptr, size, cudaHostAllocMapped);
-        if (err != cudaSuccess) {
-            std::cerr << "cudaHostAlloc failed: " << cudaGetErrorString(err) << std::endl;
-            return false;
-        }
-        
-        // 2. 从GPU复制数据到CPU缓冲区
-        err = cudaMemcpy(host_ptr, reinterpret_cast<void*>(src_gpu_handle), size, cudaMemcpyDeviceToHost);
-        if (err != cudaSuccess) {
-            std::cerr << "cudaMemcpy DtoH failed: " << cudaGetErrorString(err) << std::endl;
-            cudaFreeHost(host_ptr);
-            return false;
-        }
-        
-        // 3. 使用RDMA将数据发送到目标节点
-        if (!rdma_transport_->send(dst_node, host_ptr, size)) {
-            std::cerr << "RDMA transfer failed" << std::endl;
-            cudaFreeHost(host_ptr);
-            return false;
-        }
-        
-        // 4. 目标节点：通过cudaMemcpyHtoD将数据复制到GPU
-        // 注意：在实际应用中，这一步需要在目标节点上执行
-        // 这里简化处理，实际需要RPC通知目标节点
-        
-        cudaFreeHost(host_ptr);
-        return true;
-    }
-
-private:
-    std::unique_ptr<RdmaTransport> rdma_transport_;
-    std::unique_ptr<ZmqTransport> zmq_transport_;
-};
-
-std::unique_ptr<PlankTransport> createPlankTransport() {
-    return std::make_unique<PlankTransportImpl>();
-}
+#include "plank_transport.h"
+#include "../rdma_transport.h"
+#include "../zmq_transport.h"
+#include "staging_pool.h"
+#include "transfer_pipeline.h"
+#include "../../logging/async_logger.h"
+#include <cuda_runtime.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// CUDA固定内存，映射到设备地址空间以便零拷贝
+class CudaPinnedAllocator : public HostAllocator {
+public:
+    void* Allocate(size_t size) override {
+        void* ptr = nullptr;
+        cudaError_t err = cudaHostAlloc(&ptr, size, cudaHostAllocMapped);
+        if (err != cudaSuccess) {
+            LOG_ERROR("cudaHostAlloc failed: {}", cudaGetErrorString(err));
+            return nullptr;
+        }
+        return ptr;
+    }
+
+    void Free(void* ptr, size_t) override {
+        cudaFreeHost(ptr);
+    }
+};
+
+// 在独立流上异步拷贝，每个中转槽一个事件标记最近一次拷贝的完成
+class CudaCopyEngine : public CopyEngine {
+public:
+    CudaCopyEngine() {
+        cudaError_t err = cudaStreamCreateWithFlags(&stream_, cudaStreamNonBlocking);
+        if (err != cudaSuccess) {
+            LOG_ERROR("cudaStreamCreate failed: {}", cudaGetErrorString(err));
+            stream_ = nullptr;
+        }
+    }
+
+    ~CudaCopyEngine() override {
+        for (cudaEvent_t event : events_) {
+            if (event) cudaEventDestroy(event);
+        }
+        if (stream_) cudaStreamDestroy(stream_);
+    }
+
+    bool CopyToHostAsync(void* dst, uint64_t src, size_t size, size_t slot) override {
+        return Submit(dst, reinterpret_cast<const void*>(src), size, cudaMemcpyDeviceToHost, slot);
+    }
+
+    bool CopyToDeviceAsync(uint64_t dst, const void* src, size_t size, size_t slot) override {
+        return Submit(reinterpret_cast<void*>(dst), src, size, cudaMemcpyHostToDevice, slot);
+    }
+
+    bool Wait(size_t slot) override {
+        if (slot >= events_.size() || !events_[slot]) return true;
+        cudaError_t err = cudaEventSynchronize(events_[slot]);
+        if (err != cudaSuccess) {
+            LOG_ERROR("cudaEventSynchronize failed: {}", cudaGetErrorString(err));
+            return false;
+        }
+        return true;
+    }
+
+private:
+    bool Submit(void* dst, const void* src, size_t size, cudaMemcpyKind kind, size_t slot) {
+        if (!stream_) return false;
+        if (slot >= events_.size()) events_.resize(slot + 1, nullptr);
+        if (!events_[slot] && cudaEventCreateWithFlags(&events_[slot], cudaEventDisableTiming) != cudaSuccess) {
+            events_[slot] = nullptr;
+            return false;
+        }
+        cudaError_t err = cudaMemcpyAsync(dst, src, size, kind, stream_);
+        if (err == cudaSuccess) err = cudaEventRecord(events_[slot], stream_);
+        if (err != cudaSuccess) {
+            LOG_ERROR("cudaMemcpyAsync failed: {}", cudaGetErrorString(err));
+            return false;
+        }
+        return true;
+    }
+
+    cudaStream_t stream_ = nullptr;
+    std::vector<cudaEvent_t> events_;
+};
+
+class PlankTransportImpl : public PlankTransport {
+public:
+    PlankTransportImpl(PlankControl& control, const TransferPipelineConfig& config)
+        : control_(control),
+          rdma_transport_(std::make_unique<RdmaTransport>()),
+          zmq_transport_(std::make_unique<ZmqTransport>()),
+          staging_pool_(pinned_allocator_, makeRegistrar()),
+          pipeline_(copy_engine_, staging_pool_, config) {
+        if (!rdma_transport_->Initialize()) {
+            LOG_ERROR("RDMA initialization failed, GPU buffer transfers unavailable");
+        }
+    }
+    
+    bool sendData(uint64_t src_handle, uint64_t dst_handle, 
+                 const void* data, size_t size, int src_node, int dst_node) override {
+        // 对于冷数据使用ZMQ UDP传输
+        return zmq_transport_->send(dst_node, data, size);
+    }
+    
+    bool receiveData(uint64_t src_handle, uint64_t dst_handle,
+                    void* buffer, size_t size, int src_node, int dst_node) override {
+        // 对于冷数据使用ZMQ UDP接收
+        return zmq_transport_->receive(src_node, buffer, size);
+    }
+    
+    bool transferGpuBuffer(uint64_t src_gpu_handle, uint64_t dst_gpu_handle,
+                          size_t size, int src_node, int dst_node) override {
+        if (!ensureConnected(dst_node)) {
+            return false;
+        }
+        // 目标节点在receiveGpuBuffer中逐片发布写入窗口
+        if (!control_.notifyReceive(dst_node, dst_gpu_handle, size, src_node)) {
+            LOG_ERROR("Failed to notify node {} to receive GPU buffer", dst_node);
+            return false;
+        }
+        // 源节点：分片DtoH到已注册的中转缓冲，拷贝与RDMA写入重叠进行
+        bool ok = pipeline_.Send(src_gpu_handle, size, [&](const void* data, size_t length, size_t offset) {
+            PlankWindow window;
+            if (!control_.waitWindow(dst_node, dst_gpu_handle, offset, &window) || window.length < length) {
+                return false;
+            }
+            return rdma_transport_->Transfer(dst_node, const_cast<void*>(data), length, window.address, window.rkey) &&
+                   control_.notifyWritten(dst_node, dst_gpu_handle, offset);
+        });
+        if (!ok) {
+            LOG_ERROR("GPU buffer transfer to node {} failed", dst_node);
+            dropConnection(dst_node);
+        }
+        return ok;
+    }
+
+    bool receiveGpuBuffer(uint64_t dst_gpu_handle, size_t size, int src_node) override {
+        if (!ensureConnected(src_node)) {
+            return false;
+        }
+        // 目标节点：发布中转槽作为写入窗口，写入完成后HtoD，与下一片的写入重叠进行
+        bool ok = pipeline_.Receive(dst_gpu_handle, size, [&](void* data, size_t length, size_t offset) {
+            PlankWindow window;
+            window.transfer = dst_gpu_handle;
+            window.offset = offset;
+            window.address = reinterpret_cast<uint64_t>(data);
+            window.length = length;
+            if (!lookupRkey(data, &window.rkey)) {
+                LOG_ERROR("Staging buffer {:x} is not registered for RDMA", window.address);
+                return false;
+            }
+            return control_.postWindow(src_node, window) &&
+                   control_.waitWritten(src_node, dst_gpu_handle, offset);
+        });
+        if (!ok) {
+            LOG_ERROR("GPU buffer receive from node {} failed", src_node);
+            dropConnection(src_node);
+        }
+        return ok;
+    }
+
+private:
+    // 首次与对端传输时建立RDMA连接：准备本端QP，经控制面交换端点信息后连接。
+    // 两端都在各自的首次传输中调用，交换在控制面上配对
+    bool ensureConnected(int node) {
+        std::lock_guard<std::mutex> lock(connect_mutex_);
+        if (connected_.count(node)) return true;
+        RdmaPeerInfo local, remote;
+        if (!rdma_transport_->PrepareConnection(node, local) ||
+            !control_.exchangePeerInfo(node, local, &remote) ||
+            !rdma_transport_->Connect(node, remote)) {
+            LOG_ERROR("Failed to connect RDMA to node {}", node);
+            rdma_transport_->Disconnect(node);
+            return false;
+        }
+        connected_.insert(node);
+        return true;
+    }
+
+    // 传输失败后连接可能已不可用，下一次传输重新握手
+    void dropConnection(int node) {
+        std::lock_guard<std::mutex> lock(connect_mutex_);
+        if (connected_.erase(node)) rdma_transport_->Disconnect(node);
+    }
+
+    // 缓冲入池时注册到RDMA保护域并记录rkey，释放时注销
+    StagingRegistrar makeRegistrar() {
+        StagingRegistrar registrar;
+        registrar.registerMemory = [this](void* ptr, size_t size) {
+            uint32_t rkey = 0;
+            if (!rdma_transport_->RegisterMemory(ptr, size, &rkey)) return false;
+            std::lock_guard<std::mutex> lock(rkey_mutex_);
+            rkeys_[ptr] = rkey;
+            return true;
+        };
+        // UnregisterMemory同时作废注册缓存中覆盖该缓冲的注册（含发送时按本地缓冲借用的）
+        registrar.unregisterMemory = [this](void* ptr, size_t) {
+            rdma_transport_->UnregisterMemory(ptr);
+            std::lock_guard<std::mutex> lock(rkey_mutex_);
+            rkeys_.erase(ptr);
+        };
+        return registrar;
+    }
+
+    bool lookupRkey(void* ptr, uint32_t* rkey) {
+        std::lock_guard<std::mutex> lock(rkey_mutex_);
+        auto it = rkeys_.find(ptr);
+        if (it == rkeys_.end()) return false;
+        *rkey = it->second;
+        return true;
+    }
+
+    PlankControl& control_;
+    std::unique_ptr<RdmaTransport> rdma_transport_;
+    std::unique_ptr<ZmqTransport> zmq_transport_;
+    std::mutex connect_mutex_;
+    std::unordered_set<int> connected_;            // 已建立RDMA连接的节点
+    std::mutex rkey_mutex_;
+    std::unordered_map<void*, uint32_t> rkeys_;    // 中转缓冲 -> 远端访问密钥
+    CudaPinnedAllocator pinned_allocator_;
+    StagingBufferPool staging_pool_;     // 析构时先于传输对象释放缓冲并注销
+    CudaCopyEngine copy_engine_;
+    TransferPipeline pipeline_;
+};
+
+std::unique_ptr<PlankTransport> createPlankTransport(PlankControl& control, const TransferPipelineConfig& config) {
+    return std::make_unique<PlankTransportImpl>(control, config);
+}
@@ -1,28 +1,65 @@
-#ifndef PLANK_TRANSPORT_H
-#define PLANK_TRANSPORT_H
-
-#include <cstdint>
-#include <vector>
-#include <memory>
-
-class PlankTransport {
-public:
-    virtual ~PlankTransport() = default;
-    
-    // 发送数据到目标节点（使用跳板机制）
-    virtual bool sendData(uint64_t src_handle, uint64_t dst_handle, 
-                         const void* data, size_t size, int src_node, int dst_node) = 0;
-                         
-    // 从源节点接收数据（使用跳板机制）
-    virtual bool receiveData(uint64_t src_handle, uint64_t dst_handle,
-                            void* buffer, size_t size, int src_node, int dst_node) = 0;
-    
-    // 跨节点传输GPU缓冲区（GDR-to-GDR）
-    virtual bool transferGpuBuffer(uint64_t src_gpu_handle, uint64_t dst_gpu_handle,
-                                  size_t size, int src_node, int dst_node) = 0;
-};
-
-// 创建跳板传输实例
-std::unique_ptr<PlankTransport> createPlankTransport();
-
-#endif // PLANK_TRANSPORT_H
+#ifndef PLANK_TRANSPORT_H
+#define PLANK_TRANSPORT_H
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include "transfer_pipeline.h"
+#include "../rdma_verbs.h"
+
+// 目标节点上一个分片的写入窗口：已注册的中转缓冲地址与远端访问密钥
+struct PlankWindow {
+    uint64_t transfer = 0;      // 传输标识，取dst_gpu_handle
+    uint64_t offset = 0;        // 分片在整个缓冲中的偏移
+    uint64_t address = 0;
+    uint32_t rkey = 0;
+    uint64_t length = 0;
+};
+
+// 跳板传输的控制面，由Launcher之间的RPC实现（本仓库尚无该RPC，目前只有接口）。
+// 数据由源节点RDMA写入目标节点的中转缓冲，控制面只传递连接信息、开始通知、写入窗口与写入完成通知
+class PlankControl {
+public:
+    virtual ~PlankControl() = default;
+
+    // 与对端交换RDMA端点信息：发出本端信息并等待对端的信息。
+    // 两端在与对方的首次传输前（以及连接出错后）各调用一次
+    virtual bool exchangePeerInfo(int peer_node, const RdmaPeerInfo& local, RdmaPeerInfo* remote) = 0;
+
+    // 源节点：通知目标节点开始接收，目标节点收到后在工作线程上调用receiveGpuBuffer
+    virtual bool notifyReceive(int dst_node, uint64_t dst_gpu_handle, size_t size, int src_node) = 0;
+    // 目标节点：发布下一片的写入窗口
+    virtual bool postWindow(int src_node, const PlankWindow& window) = 0;
+    // 源节点：等待目标节点发布该分片的写入窗口
+    virtual bool waitWindow(int dst_node, uint64_t transfer, uint64_t offset, PlankWindow* window) = 0;
+    // 源节点：通知目标节点该分片已写入
+    virtual bool notifyWritten(int dst_node, uint64_t transfer, uint64_t offset) = 0;
+    // 目标节点：等待该分片写入完成
+    virtual bool waitWritten(int src_node, uint64_t transfer, uint64_t offset) = 0;
+};
+
+class PlankTransport {
+public:
+    virtual ~PlankTransport() = default;
+    
+    // 发送数据到目标节点（使用跳板机制）
+    virtual bool sendData(uint64_t src_handle, uint64_t dst_handle, 
+                         const void* data, size_t size, int src_node, int dst_node) = 0;
+                         
+    // 从源节点接收数据（使用跳板机制）
+    virtual bool receiveData(uint64_t src_handle, uint64_t dst_handle,
+                            void* buffer, size_t size, int src_node, int dst_node) = 0;
+    
+    // 跨节点传输GPU缓冲区（GDR-to-GDR），按分片流水线发送到目标节点的dst_gpu_handle
+    virtual bool transferGpuBuffer(uint64_t src_gpu_handle, uint64_t dst_gpu_handle,
+                                  size_t size, int src_node, int dst_node) = 0;
+
+    // 目标节点接收transferGpuBuffer发出的数据并写入GPU缓冲区
+    virtual bool receiveGpuBuffer(uint64_t dst_gpu_handle, size_t size, int src_node) = 0;
+};
+
+// 创建跳板传输实例，control须在实例销毁前保持有效
+std::unique_ptr<PlankTransport> createPlankTransport(
+    PlankControl& control, const TransferPipelineConfig& config = TransferPipelineConfig());
+
+#endif // PLANK_TRANSPORT_H
@@ -0,0 +1,166 @@
+#include "staging_pool.h"
+#include "../../logging/async_logger.h"
+#include <cstdlib>
+
+namespace {
+constexpr size_t kPageSize = 4096;
+}
+
+// ---------------- MallocHostAllocator ----------------
+
+void* MallocHostAllocator::Allocate(size_t size) {
+    return std::aligned_alloc(kPageSize, (size + kPageSize - 1) & ~(kPageSize - 1));
+}
+
+void MallocHostAllocator::Free(void* ptr, size_t) {
+    std::free(ptr);
+}
+
+// ---------------- StagingBuffer ----------------
+
+StagingBuffer& StagingBuffer::operator=(StagingBuffer&& other) noexcept {
+    if (this != &other) {
+        Reset();
+        pool_ = other.pool_;
+        data_ = other.data_;
+        capacity_ = other.capacity_;
+        other.pool_ = nullptr;
+        other.data_ = nullptr;
+        other.capacity_ = 0;
+    }
+    return *this;
+}
+
+void StagingBuffer::Reset() {
+    if (pool_ && data_) {
+        pool_->Return(data_, capacity_);
+    }
+    pool_ = nullptr;
+    data_ = nullptr;
+    capacity_ = 0;
+}
+
+// ---------------- StagingBufferPool ----------------
+
+StagingBufferPool::StagingBufferPool(HostAllocator& allocator, StagingRegistrar registrar,
+                                     const StagingPoolConfig& config)
+    : allocator_(allocator), registrar_(std::move(registrar)), config_(config) {
+    class_count_ = 1;
+    while (class_count_ < kMaxClasses && ClassSize(class_count_ - 1) < config_.maxBufferSize) {
+        ++class_count_;
+    }
+}
+
+StagingBufferPool::~StagingBufferPool() {
+    Trim();
+}
+
+size_t StagingBufferPool::ClassFor(size_t size) const {
+    size_t index = 0;
+    while (index < class_count_ && ClassSize(index) < size) ++index;
+    return index;   // 等于class_count_表示超出池的范围
+}
+
+void* StagingBufferPool::AllocateBuffer(size_t size) {
+    void* ptr = allocator_.Allocate(size);
+    if (!ptr) {
+        LOG_ERROR("Failed to allocate {} byte staging buffer", size);
+        return nullptr;
+    }
+    if (registrar_.registerMemory && !registrar_.registerMemory(ptr, size)) {
+        LOG_ERROR("Failed to register {} byte staging buffer", size);
+        allocator_.Free(ptr, size);
+        return nullptr;
+    }
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    return ptr;
+}
+
+// 超大、超出缓存上限与Trim释放的缓冲都经此处：先注销再释放
+void StagingBufferPool::FreeBuffer(void* ptr, size_t size) {
+    if (registrar_.unregisterMemory) registrar_.unregisterMemory(ptr, size);
+    allocator_.Free(ptr, size);
+    releases_.fetch_add(1, std::memory_order_relaxed);
+}
+
+StagingBuffer StagingBufferPool::Borrow(size_t size) {
+    borrows_.fetch_add(1, std::memory_order_relaxed);
+    size_t index = ClassFor(size);
+    size_t capacity = index < class_count_ ? ClassSize(index) : size;
+
+    void* ptr = nullptr;
+    if (index < class_count_) {
+        SizeClass& sizeClass = classes_[index];
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        if (!sizeClass.free.empty()) {
+            ptr = sizeClass.free.back();
+            sizeClass.free.pop_back();
+        }
+    }
+    if (ptr) {
+        cached_bytes_.fetch_sub(capacity, std::memory_order_relaxed);
+        hits_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        ptr = AllocateBuffer(capacity);
+        if (!ptr) return StagingBuffer();
+    }
+    outstanding_.fetch_add(1, std::memory_order_relaxed);
+    return StagingBuffer(this, ptr, capacity);
+}
+
+void StagingBufferPool::Return(void* data, size_t capacity) {
+    outstanding_.fetch_sub(1, std::memory_order_relaxed);
+    size_t index = ClassFor(capacity);
+    // 超出大小类的临时缓冲及超出缓存上限的缓冲直接释放
+    if (index >= class_count_ ||
+        cached_bytes_.fetch_add(capacity, std::memory_order_relaxed) + capacity > config_.maxCachedBytes) {
+        if (index < class_count_) cached_bytes_.fetch_sub(capacity, std::memory_order_relaxed);
+        FreeBuffer(data, capacity);
+        return;
+    }
+    SizeClass& sizeClass = classes_[index];
+    std::lock_guard<std::mutex> lock(sizeClass.mutex);
+    sizeClass.free.push_back(data);
+}
+
+size_t StagingBufferPool::Prewarm(size_t size, size_t count) {
+    size_t index = ClassFor(size);
+    if (index >= class_count_) return 0;
+    size_t capacity = ClassSize(index);
+
+    size_t added = 0;
+    for (; added < count; ++added) {
+        if (cached_bytes_.load(std::memory_order_relaxed) + capacity > config_.maxCachedBytes) break;
+        void* ptr = AllocateBuffer(capacity);
+        if (!ptr) break;
+        cached_bytes_.fetch_add(capacity, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(classes_[index].mutex);
+        classes_[index].free.push_back(ptr);
+    }
+    return added;
+}
+
+void StagingBufferPool::Trim() {
+    for (size_t index = 0; index < class_count_; ++index) {
+        std::vector<void*> buffers;
+        {
+            std::lock_guard<std::mutex> lock(classes_[index].mutex);
+            buffers.swap(classes_[index].free);
+        }
+        for (void* ptr : buffers) {
+            cached_bytes_.fetch_sub(ClassSize(index), std::memory_order_relaxed);
+            FreeBuffer(ptr, ClassSize(index));
+        }
+    }
+}
+
+StagingPoolStats StagingBufferPool::GetStats() const {
+    StagingPoolStats stats;
+    stats.borrows = borrows_.load(std::memory_order_relaxed);
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.allocations = allocations_.load(std::memory_order_relaxed);
+    stats.releases = releases_.load(std::memory_order_relaxed);
+    stats.cachedBytes = cached_bytes_.load(std::memory_order_relaxed);
+    stats.outstanding = outstanding_.load(std::memory_order_relaxed);
+    return stats;
+}
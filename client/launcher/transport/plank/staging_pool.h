@@ -0,0 +1,129 @@
+#pragma once
+
+// 跳板传输的主机中转缓冲池。
+// 固定（pinned）内存的申请/释放与RDMA注册代价很高，缓冲按2的幂大小类预先申请并注册，
+// 传输时借用、结束后归还，不再逐次申请。主机内存来源经HostAllocator抽象，
+// 无GPU环境可使用MallocHostAllocator。
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// 主机缓冲分配接口
+class HostAllocator {
+public:
+    virtual ~HostAllocator() = default;
+    virtual void* Allocate(size_t size) = 0;
+    virtual void Free(void* ptr, size_t size) = 0;
+};
+
+// 普通页对齐内存，用于无GPU环境的测试与基准
+class MallocHostAllocator : public HostAllocator {
+public:
+    void* Allocate(size_t size) override;
+    void Free(void* ptr, size_t size) override;
+};
+
+// 缓冲进入/离开池时的RDMA注册，未设置时不注册。
+// 缓冲在unregisterMemory返回后立即释放：实现必须注销覆盖[ptr, ptr+size)的全部注册，
+// 包括注册缓存中留存的，否则之后分配到同一地址的缓冲会用到失效的lkey/rkey
+struct StagingRegistrar {
+    std::function<bool(void* ptr, size_t size)> registerMemory;
+    std::function<void(void* ptr, size_t size)> unregisterMemory;
+};
+
+struct StagingPoolConfig {
+    size_t minBufferSize = 64 * 1024;                    // 最小大小类
+    size_t maxBufferSize = 256 * 1024 * 1024;            // 超过时临时申请，不入池
+    size_t maxCachedBytes = size_t(1) << 30;             // 池中空闲缓冲总量上限
+};
+
+struct StagingPoolStats {
+    uint64_t borrows = 0;
+    uint64_t hits = 0;             // 直接取自空闲缓冲
+    uint64_t allocations = 0;      // 新申请（并注册）的缓冲
+    uint64_t releases = 0;         // 超出上限或关闭时释放的缓冲
+    uint64_t cachedBytes = 0;      // 池中空闲缓冲字节
+    uint64_t outstanding = 0;      // 借出未还的缓冲
+};
+
+class StagingBufferPool;
+
+// 借出的缓冲，析构时归还
+class StagingBuffer {
+public:
+    StagingBuffer() = default;
+    StagingBuffer(StagingBuffer&& other) noexcept { *this = std::move(other); }
+    StagingBuffer& operator=(StagingBuffer&& other) noexcept;
+    StagingBuffer(const StagingBuffer&) = delete;
+    StagingBuffer& operator=(const StagingBuffer&) = delete;
+    ~StagingBuffer() { Reset(); }
+
+    void* data() const { return data_; }
+    size_t capacity() const { return capacity_; }
+    explicit operator bool() const { return data_ != nullptr; }
+
+    void Reset();
+
+private:
+    friend class StagingBufferPool;
+    StagingBuffer(StagingBufferPool* pool, void* data, size_t capacity)
+        : pool_(pool), data_(data), capacity_(capacity) {}
+
+    StagingBufferPool* pool_ = nullptr;
+    void* data_ = nullptr;
+    size_t capacity_ = 0;
+};
+
+class StagingBufferPool {
+public:
+    StagingBufferPool(HostAllocator& allocator, StagingRegistrar registrar = StagingRegistrar(),
+                      const StagingPoolConfig& config = StagingPoolConfig());
+    ~StagingBufferPool();
+
+    StagingBufferPool(const StagingBufferPool&) = delete;
+    StagingBufferPool& operator=(const StagingBufferPool&) = delete;
+
+    // 借用至少size字节的缓冲，失败时返回空缓冲
+    StagingBuffer Borrow(size_t size);
+
+    // 预先申请count个能容纳size的缓冲，避免首次传输时付出固定与注册的开销
+    size_t Prewarm(size_t size, size_t count);
+
+    // 释放所有空闲缓冲
+    void Trim();
+
+    StagingPoolStats GetStats() const;
+
+private:
+    friend class StagingBuffer;
+    static constexpr size_t kMaxClasses = 32;
+
+    struct alignas(64) SizeClass {
+        std::mutex mutex;
+        std::vector<void*> free;
+    };
+
+    size_t ClassFor(size_t size) const;
+    size_t ClassSize(size_t index) const { return config_.minBufferSize << index; }
+    void* AllocateBuffer(size_t size);
+    void FreeBuffer(void* ptr, size_t size);
+    void Return(void* data, size_t capacity);
+
+    HostAllocator& allocator_;
+    StagingRegistrar registrar_;
+    StagingPoolConfig config_;
+    size_t class_count_;
+    std::array<SizeClass, kMaxClasses> classes_;
+
+    std::atomic<uint64_t> cached_bytes_{0};
+    std::atomic<uint64_t> borrows_{0};
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> allocations_{0};
+    std::atomic<uint64_t> releases_{0};
+    std::atomic<uint64_t> outstanding_{0};
+};
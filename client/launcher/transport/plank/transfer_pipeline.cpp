@@ -0,0 +1,186 @@
+#include "transfer_pipeline.h"
+#include "../../logging/async_logger.h"
+#include <algorithm>
+#include <cstring>
+
+// ---------------- MemcpyCopyEngine ----------------
+
+MemcpyCopyEngine::MemcpyCopyEngine() : worker_([this] { WorkerLoop(); }) {}
+
+MemcpyCopyEngine::~MemcpyCopyEngine() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+}
+
+void MemcpyCopyEngine::Submit(void* dst, const void* src, size_t size, size_t slot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (slot >= submitted_.size()) {
+            submitted_.resize(slot + 1, 0);
+            completed_.resize(slot + 1, 0);
+        }
+        ++submitted_[slot];
+        jobs_.push_back({dst, src, size, slot});
+    }
+    cv_.notify_all();
+}
+
+bool MemcpyCopyEngine::CopyToHostAsync(void* dst, uint64_t src, size_t size, size_t slot) {
+    Submit(dst, reinterpret_cast<const void*>(src), size, slot);
+    return true;
+}
+
+bool MemcpyCopyEngine::CopyToDeviceAsync(uint64_t dst, const void* src, size_t size, size_t slot) {
+    Submit(reinterpret_cast<void*>(dst), src, size, slot);
+    return true;
+}
+
+bool MemcpyCopyEngine::Wait(size_t slot) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (slot >= submitted_.size()) return true;
+    cv_.wait(lock, [&] { return completed_[slot] == submitted_[slot]; });
+    return true;
+}
+
+void MemcpyCopyEngine::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [&] { return stopping_ || !jobs_.empty(); });
+        if (jobs_.empty()) return;
+        Job job = jobs_.front();
+        jobs_.pop_front();
+
+        lock.unlock();
+        std::memcpy(job.dst, job.src, job.size);
+        lock.lock();
+        ++completed_[job.slot];
+        cv_.notify_all();
+    }
+}
+
+// ---------------- TransferPipeline ----------------
+
+TransferPipeline::TransferPipeline(CopyEngine& engine, StagingBufferPool& pool,
+                                   const TransferPipelineConfig& config)
+    : engine_(engine), pool_(pool), config_(config) {
+    config_.chunkSize = std::max<size_t>(config_.chunkSize, 4096);
+    config_.depth = std::max<size_t>(config_.depth, 1);
+}
+
+bool TransferPipeline::BorrowSlots(size_t size, std::vector<StagingBuffer>& slots) {
+    size_t chunks = (size + config_.chunkSize - 1) / config_.chunkSize;
+    size_t count = std::min(config_.depth, chunks);
+    size_t slotSize = std::min(size, config_.chunkSize);
+    for (size_t i = 0; i < count; ++i) {
+        StagingBuffer buffer = pool_.Borrow(slotSize);
+        if (!buffer) {
+            LOG_ERROR("Failed to borrow {} byte staging slot", slotSize);
+            return false;
+        }
+        slots.push_back(std::move(buffer));
+    }
+    return true;
+}
+
+bool TransferPipeline::Drain(std::vector<bool>& pending) {
+    bool ok = true;
+    for (size_t slot = 0; slot < pending.size(); ++slot) {
+        if (pending[slot]) {
+            ok = engine_.Wait(slot) && ok;
+            pending[slot] = false;
+        }
+    }
+    return ok;
+}
+
+bool TransferPipeline::Send(uint64_t srcDevice, size_t size, const ChunkSender& send) {
+    if (size == 0) return true;
+    std::vector<StagingBuffer> slots;
+    if (!BorrowSlots(size, slots)) return false;
+
+    size_t chunks = (size + config_.chunkSize - 1) / config_.chunkSize;
+    std::vector<bool> pending(slots.size(), false);
+    auto submit = [&](size_t chunk) {
+        size_t slot = chunk % slots.size();
+        size_t offset = chunk * config_.chunkSize;
+        size_t length = std::min(config_.chunkSize, size - offset);
+        pending[slot] = true;
+        return engine_.CopyToHostAsync(slots[slot].data(), srcDevice + offset, length, slot);
+    };
+
+    // 先填满所有槽，之后每发出一片即在该槽提交下一轮拷贝
+    for (size_t chunk = 0; chunk < slots.size(); ++chunk) {
+        if (!submit(chunk)) {
+            LOG_ERROR("DtoH copy submit failed at chunk {}", chunk);
+            Drain(pending);
+            return false;
+        }
+    }
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        size_t slot = chunk % slots.size();
+        size_t offset = chunk * config_.chunkSize;
+        size_t length = std::min(config_.chunkSize, size - offset);
+
+        pending[slot] = false;
+        if (!engine_.Wait(slot)) {
+            LOG_ERROR("DtoH copy failed at chunk {}", chunk);
+            Drain(pending);
+            return false;
+        }
+        if (!send(slots[slot].data(), length, offset)) {
+            LOG_ERROR("Chunk send failed at offset {}", offset);
+            Drain(pending);
+            return false;
+        }
+        if (chunk + slots.size() < chunks && !submit(chunk + slots.size())) {
+            LOG_ERROR("DtoH copy submit failed at chunk {}", chunk + slots.size());
+            Drain(pending);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TransferPipeline::Receive(uint64_t dstDevice, size_t size, const ChunkReceiver& receive) {
+    if (size == 0) return true;
+    std::vector<StagingBuffer> slots;
+    if (!BorrowSlots(size, slots)) return false;
+
+    size_t chunks = (size + config_.chunkSize - 1) / config_.chunkSize;
+    std::vector<bool> pending(slots.size(), false);
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        size_t slot = chunk % slots.size();
+        size_t offset = chunk * config_.chunkSize;
+        size_t length = std::min(config_.chunkSize, size - offset);
+
+        // 槽中上一片的HtoD完成后才能写入新数据
+        if (pending[slot]) {
+            pending[slot] = false;
+            if (!engine_.Wait(slot)) {
+                LOG_ERROR("HtoD copy failed before chunk {}", chunk);
+                Drain(pending);
+                return false;
+            }
+        }
+        if (!receive(slots[slot].data(), length, offset)) {
+            LOG_ERROR("Chunk receive failed at offset {}", offset);
+            Drain(pending);
+            return false;
+        }
+        pending[slot] = true;
+        if (!engine_.CopyToDeviceAsync(dstDevice + offset, slots[slot].data(), length, slot)) {
+            LOG_ERROR("HtoD copy submit failed at chunk {}", chunk);
+            Drain(pending);
+            return false;
+        }
+    }
+    if (!Drain(pending)) {
+        LOG_ERROR("HtoD copy failed while draining");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+// 跳板传输的分片流水线。
+// 发送：设备 -> 中转缓冲（DtoH）-> 网络；接收：网络 -> 中转缓冲 -> 设备（HtoD）。
+// 缓冲按chunkSize分片，depth个中转槽轮转使用：第N片在网络上传输时，后续分片的拷贝已在进行，
+// 两段耗时相互重叠而非相加。设备拷贝经CopyEngine抽象，无GPU环境可使用MemcpyCopyEngine。
+#include "staging_pool.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct TransferPipelineConfig {
+    size_t chunkSize = 4 * 1024 * 1024;    // 单个分片字节数
+    size_t depth = 2;                       // 同时占用的中转槽数，2即双缓冲
+};
+
+// 设备拷贝引擎。拷贝异步提交，按槽号等待完成；同一槽的拷贝按提交顺序完成
+class CopyEngine {
+public:
+    virtual ~CopyEngine() = default;
+    virtual bool CopyToHostAsync(void* dst, uint64_t src, size_t size, size_t slot) = 0;
+    virtual bool CopyToDeviceAsync(uint64_t dst, const void* src, size_t size, size_t slot) = 0;
+    // 等待该槽最近一次提交的拷贝完成，返回拷贝是否成功
+    virtual bool Wait(size_t slot) = 0;
+};
+
+// 以主机内存模拟设备的拷贝引擎：设备地址即主机指针，由后台线程执行memcpy
+class MemcpyCopyEngine : public CopyEngine {
+public:
+    MemcpyCopyEngine();
+    ~MemcpyCopyEngine() override;
+
+    bool CopyToHostAsync(void* dst, uint64_t src, size_t size, size_t slot) override;
+    bool CopyToDeviceAsync(uint64_t dst, const void* src, size_t size, size_t slot) override;
+    bool Wait(size_t slot) override;
+
+private:
+    struct Job {
+        void* dst;
+        const void* src;
+        size_t size;
+        size_t slot;
+    };
+
+    void Submit(void* dst, const void* src, size_t size, size_t slot);
+    void WorkerLoop();
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Job> jobs_;
+    std::vector<uint64_t> submitted_;       // 各槽已提交的拷贝数
+    std::vector<uint64_t> completed_;       // 各槽已完成的拷贝数
+    bool stopping_ = false;
+    std::thread worker_;
+};
+
+// 网络段：逐片发送/接收，offset为分片在整个缓冲中的偏移。返回时缓冲即可复用
+using ChunkSender = std::function<bool(const void* data, size_t size, size_t offset)>;
+using ChunkReceiver = std::function<bool(void* data, size_t size, size_t offset)>;
+
+class TransferPipeline {
+public:
+    TransferPipeline(CopyEngine& engine, StagingBufferPool& pool,
+                     const TransferPipelineConfig& config = TransferPipelineConfig());
+
+    // 设备 -> 中转 -> 网络
+    bool Send(uint64_t srcDevice, size_t size, const ChunkSender& send);
+    // 网络 -> 中转 -> 设备
+    bool Receive(uint64_t dstDevice, size_t size, const ChunkReceiver& receive);
+
+    const TransferPipelineConfig& GetConfig() const { return config_; }
+
+private:
+    // 借用本次传输所需的中转槽
+    bool BorrowSlots(size_t size, std::vector<StagingBuffer>& slots);
+    // 等待所有在途拷贝，保证中转缓冲归还前不再被DMA访问
+    bool Drain(std::vector<bool>& pending);
+
+    CopyEngine& engine_;
+    StagingBufferPool& pool_;
+    TransferPipelineConfig config_;
+};
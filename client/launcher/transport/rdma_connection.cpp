@@ -0,0 +1,236 @@
+#include "rdma_connection.h"
+#include "../logging/async_logger.h"
+#include <thread>
+
+RdmaConnectionManager::RdmaConnectionManager(RdmaVerbs& verbs, const RdmaConnectionConfig& config)
+    : m_verbs(verbs), m_config(config), m_wcBuffer(config.pollBatch) {}
+
+RdmaConnectionManager::~RdmaConnectionManager() {
+    Shutdown();
+}
+
+bool RdmaConnectionManager::Initialize() {
+    m_sendCq = m_verbs.CreateCq(m_config.cqDepth);
+    m_recvCq = m_verbs.CreateCq(m_config.cqDepth);
+    if (!m_sendCq || !m_recvCq) {
+        LOG_ERROR("Failed to create shared completion queues");
+        return false;
+    }
+    return true;
+}
+
+void RdmaConnectionManager::Shutdown() {
+    {
+        std::unique_lock<std::shared_mutex> lock(m_connectionsMutex);
+        for (auto& pair : m_connections) {
+            pair.second->connected = false;
+            m_verbs.DestroyQp(pair.second->qp);
+            pair.second->qp = nullptr;
+        }
+        m_connections.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(m_cqMutex);
+    m_pending.clear();
+    if (m_sendCq) {
+        m_verbs.DestroyCq(m_sendCq);
+        m_sendCq = nullptr;
+    }
+    if (m_recvCq) {
+        m_verbs.DestroyCq(m_recvCq);
+        m_recvCq = nullptr;
+    }
+}
+
+bool RdmaConnectionManager::Prepare(int peerId, RdmaPeerInfo& local) {
+    std::unique_lock<std::shared_mutex> lock(m_connectionsMutex);
+    auto it = m_connections.find(peerId);
+    if (it != m_connections.end()) {
+        local = it->second->local;
+        return true;
+    }
+
+    ibv_qp* qp = m_verbs.CreateQp(m_sendCq, m_recvCq, m_config.sendQueueDepth, 1);
+    if (!qp) {
+        LOG_ERROR("Failed to create queue pair for peer {}", peerId);
+        return false;
+    }
+
+    auto connection = std::make_shared<RdmaConnection>();
+    connection->peerId = peerId;
+    connection->qp = qp;
+    connection->local = m_verbs.QueryLocal(qp);
+    local = connection->local;
+    m_connections[peerId] = std::move(connection);
+    return true;
+}
+
+bool RdmaConnectionManager::Connect(int peerId, const RdmaPeerInfo& remote) {
+    auto connection = Get(peerId);
+    if (!connection) {
+        RdmaPeerInfo local;
+        if (!Prepare(peerId, local)) {
+            return false;
+        }
+        connection = Get(peerId);
+    }
+
+    std::lock_guard<std::mutex> lock(connection->sendMutex);
+    if (connection->connected) {
+        return true;
+    }
+    if (connection->qpError) {
+        // ERR状态的QP不能直接转INIT：先结束旧WR再复位
+        FailPending(connection.get());
+        connection->outstanding.store(0, std::memory_order_release);
+        if (!m_verbs.ResetQp(connection->qp)) {
+            LOG_ERROR("Failed to reset queue pair for peer {}", peerId);
+            return false;
+        }
+        connection->qpError = false;
+    }
+    if (!m_verbs.ConnectQp(connection->qp, connection->local, remote)) {
+        return false;
+    }
+    connection->remote = remote;
+    connection->connected = true;
+    return true;
+}
+
+void RdmaConnectionManager::Disconnect(int peerId) {
+    std::shared_ptr<RdmaConnection> connection;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_connectionsMutex);
+        auto it = m_connections.find(peerId);
+        if (it == m_connections.end()) return;
+        connection = std::move(it->second);
+        m_connections.erase(it);
+    }
+
+    std::lock_guard<std::mutex> sendLock(connection->sendMutex);
+    connection->connected = false;
+    m_verbs.DestroyQp(connection->qp);
+    connection->qp = nullptr;
+
+    // 已销毁QP上的WR不会再产生完成事件，直接结束对应的等待
+    FailPending(connection.get());
+}
+
+void RdmaConnectionManager::FailPending(RdmaConnection* connection) {
+    std::lock_guard<std::mutex> cqLock(m_cqMutex);
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (it->second.connection == connection) {
+            it->second.completion->failed = true;
+            it->second.completion->remaining.fetch_sub(1, std::memory_order_release);
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::shared_ptr<RdmaConnection> RdmaConnectionManager::Get(int peerId) {
+    std::shared_lock<std::shared_mutex> lock(m_connectionsMutex);
+    auto it = m_connections.find(peerId);
+    return it != m_connections.end() ? it->second : nullptr;
+}
+
+bool RdmaConnectionManager::Post(RdmaConnection& connection, ibv_send_wr* wr, RdmaCompletion& completion) {
+    uint32_t count = 0;
+    for (ibv_send_wr* p = wr; p; p = p->next) {
+        ++count;
+    }
+    if (count == 0) return true;
+    if (count > m_config.sendQueueDepth) {
+        LOG_ERROR("WR chain exceeds send queue depth");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> sendLock(connection.sendMutex);
+    if (!connection.connected) {
+        return false;
+    }
+
+    // 等待发送队列槽位
+    while (connection.outstanding.load(std::memory_order_acquire) + count > m_config.sendQueueDepth) {
+        if (PollOnce() == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    // 链尾必须签名，否则其槽位无法回收
+    ibv_send_wr* last = wr;
+    while (last->next) last = last->next;
+    last->send_flags |= IBV_SEND_SIGNALED;
+
+    {
+        std::lock_guard<std::mutex> cqLock(m_cqMutex);
+        uint32_t covers = 0;
+        for (ibv_send_wr* p = wr; p; p = p->next) {
+            ++covers;
+            if (p->send_flags & IBV_SEND_SIGNALED) {
+                p->wr_id = m_nextWrId.fetch_add(1, std::memory_order_relaxed);
+                m_pending.emplace(p->wr_id, PendingWr{&completion, &connection, covers});
+                completion.remaining.fetch_add(1, std::memory_order_relaxed);
+                covers = 0;
+            } else {
+                p->wr_id = 0;
+            }
+        }
+    }
+    connection.outstanding.fetch_add(count, std::memory_order_acq_rel);
+
+    ibv_send_wr* bad = nullptr;
+    if (m_verbs.PostSend(connection.qp, wr, &bad)) {
+        LOG_ERROR("Failed to post RDMA operation to peer {}", connection.peerId);
+        // 从bad开始的WR未被接收，撤销其登记
+        std::lock_guard<std::mutex> cqLock(m_cqMutex);
+        uint32_t rejected = 0;
+        for (ibv_send_wr* p = bad; p; p = p->next) {
+            ++rejected;
+            if (p->wr_id && m_pending.erase(p->wr_id)) {
+                completion.remaining.fetch_sub(1, std::memory_order_release);
+            }
+        }
+        connection.outstanding.fetch_sub(rejected, std::memory_order_acq_rel);
+        completion.failed = true;
+        return false;
+    }
+    return true;
+}
+
+int RdmaConnectionManager::PollOnce() {
+    std::lock_guard<std::mutex> lock(m_cqMutex);
+    if (!m_sendCq) return 0;
+
+    int n = m_verbs.PollCq(m_sendCq, m_config.pollBatch, m_wcBuffer.data());
+    for (int i = 0; i < n; ++i) {
+        const ibv_wc& wc = m_wcBuffer[i];
+        // 非签名WR只会在出错时产生完成事件，其错误会随后续签名WR的flush一起上报
+        auto it = m_pending.find(wc.wr_id);
+        if (it == m_pending.end()) continue;
+
+        PendingWr pending = it->second;
+        m_pending.erase(it);
+        pending.connection->outstanding.fetch_sub(pending.covers, std::memory_order_acq_rel);
+        if (wc.status != IBV_WC_SUCCESS) {
+            LOG_ERROR("RDMA completion error on peer {}: {}", pending.connection->peerId,
+                      ibv_wc_status_str(wc.status));
+            pending.completion->failed = true;
+            // QP已进入错误状态，需要经控制面重新建连（Connect时复位QP）
+            pending.connection->connected = false;
+            pending.connection->qpError = true;
+        }
+        pending.completion->remaining.fetch_sub(1, std::memory_order_release);
+    }
+    return n > 0 ? n : 0;
+}
+
+bool RdmaConnectionManager::Wait(RdmaCompletion& completion) {
+    while (completion.remaining.load(std::memory_order_acquire) > 0) {
+        if (PollOnce() == 0) {
+            std::this_thread::yield();
+        }
+    }
+    return !completion.failed.load(std::memory_order_acquire);
+}
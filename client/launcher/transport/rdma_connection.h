@@ -0,0 +1,84 @@
+#pragma once
+
+#include "rdma_verbs.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+// 一次传输的完成状态，由等待者持有
+struct RdmaCompletion {
+    std::atomic<uint32_t> remaining{0};   // 尚未完成的签名WR数量
+    std::atomic<bool> failed{false};
+};
+
+// 到单个对端的长连接
+struct RdmaConnection {
+    int peerId = -1;
+    ibv_qp* qp = nullptr;
+    RdmaPeerInfo local;
+    RdmaPeerInfo remote;
+    std::atomic<bool> connected{false};
+    std::atomic<bool> qpError{false};     // 出现完成错误，QP处于ERR，重连前需复位
+    bool gdrEnabled = false;
+    std::mutex sendMutex;                 // 串行化同一QP上的post
+    std::atomic<uint32_t> outstanding{0}; // 已提交未回收的WR数量，不超过发送队列深度
+};
+
+struct RdmaConnectionConfig {
+    uint32_t sendQueueDepth = 1024;       // 每个QP的发送队列深度
+    int cqDepth = 8192;                   // 共享CQ深度
+    int pollBatch = 64;                   // 单次ibv_poll_cq的最大条目数
+};
+
+// RDMA连接管理器
+// 每个对端只建立一次RC QP，所有QP共享一对CQ。传输只需post_send，
+// 完成事件按wr_id分发给等待者；任何等待中的线程都可以驱动共享CQ的轮询。
+class RdmaConnectionManager {
+public:
+    RdmaConnectionManager(RdmaVerbs& verbs, const RdmaConnectionConfig& config = RdmaConnectionConfig());
+    ~RdmaConnectionManager();
+
+    bool Initialize();
+    void Shutdown();
+
+    // 为对端创建QP（幂等），返回本端信息供控制面交换
+    bool Prepare(int peerId, RdmaPeerInfo& local);
+    // 使用对端信息将QP切换到RTS；完成错误后再次调用时先将QP复位（QP号不变，对端无需重新交换信息）
+    bool Connect(int peerId, const RdmaPeerInfo& remote);
+    void Disconnect(int peerId);
+    std::shared_ptr<RdmaConnection> Get(int peerId);
+
+    // 提交WR链：wr_id由管理器分配，签名WR登记到completion；
+    // 发送队列已满时先轮询CQ回收槽位
+    bool Post(RdmaConnection& connection, ibv_send_wr* wr, RdmaCompletion& completion);
+    // 等待completion上的全部签名WR完成
+    bool Wait(RdmaCompletion& completion);
+
+private:
+    struct PendingWr {
+        RdmaCompletion* completion;
+        RdmaConnection* connection;
+        uint32_t covers;                  // 该签名WR回收的发送队列槽位（含之前的非签名WR）
+    };
+
+    // 轮询一次共享CQ，返回处理的条目数
+    int PollOnce();
+    // 结束connection上全部未完成的WR（QP已销毁或复位，不会再产生完成事件）
+    void FailPending(RdmaConnection* connection);
+
+    RdmaVerbs& m_verbs;
+    RdmaConnectionConfig m_config;
+    ibv_cq* m_sendCq = nullptr;
+    ibv_cq* m_recvCq = nullptr;
+
+    std::shared_mutex m_connectionsMutex;
+    std::unordered_map<int, std::shared_ptr<RdmaConnection>> m_connections;
+
+    std::mutex m_cqMutex;                 // 保护CQ轮询、m_pending与m_wcBuffer
+    std::vector<ibv_wc> m_wcBuffer;
+    std::unordered_map<uint64_t, PendingWr> m_pending;
+    std::atomic<uint64_t> m_nextWrId{1};  // 0保留给非签名WR
+};
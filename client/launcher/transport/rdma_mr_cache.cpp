@@ -0,0 +1,276 @@
+#include "rdma_mr_cache.h"
+#include "../logging/async_logger.h"
+#include <algorithm>
+
+RdmaRegistrationCache::RdmaRegistrationCache(RdmaVerbs& verbs, size_t maxPinnedBytes)
+    : m_verbs(verbs), m_maxPinnedBytes(maxPinnedBytes) {}
+
+RdmaRegistrationCache::~RdmaRegistrationCache() {
+    Clear();
+}
+
+// 查找完整覆盖[start, end)的注册
+RdmaRegistrationCache::RegionMap::iterator RdmaRegistrationCache::FindCovering(uintptr_t start, uintptr_t end) {
+    auto it = m_regions.upper_bound(start);
+    if (it == m_regions.begin()) {
+        return m_regions.end();
+    }
+    --it;
+    return it->second.end >= end ? it : m_regions.end();
+}
+
+bool RdmaRegistrationCache::Overlaps(uintptr_t start, uintptr_t end) const {
+    auto it = m_regions.lower_bound(start);
+    if (it != m_regions.end() && it->first < end) return true;
+    return it != m_regions.begin() && std::prev(it)->second.end > start;
+}
+
+void RdmaRegistrationCache::Erase(RegionMap::iterator it, std::vector<ibv_mr*>& victims) {
+    m_pinnedBytes -= it->second.end - it->first;
+    m_lru.erase(it->second.lru);
+    victims.push_back(it->second.mr);
+    m_regions.erase(it);
+}
+
+// 从LRU尾部淘汰空闲注册，直到固定内存回到上限以内
+void RdmaRegistrationCache::EvictLocked(std::vector<ibv_mr*>& victims) {
+    if (m_pinnedBytes <= m_maxPinnedBytes) return;
+
+    std::vector<uintptr_t> keys;
+    size_t freed = 0;
+    for (auto r = m_lru.rbegin(); r != m_lru.rend() && m_pinnedBytes - freed > m_maxPinnedBytes; ++r) {
+        const auto& region = m_regions.at(*r);
+        if (region.users == 0) {
+            keys.push_back(*r);
+            freed += region.end - *r;
+        }
+    }
+    for (uintptr_t key : keys) {
+        Erase(m_regions.find(key), victims);
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// 注销耗时较长，在锁外执行
+void RdmaRegistrationCache::Deregister(std::vector<ibv_mr*>& victims) {
+    for (ibv_mr* mr : victims) {
+        m_verbs.DeregMr(mr);
+    }
+    victims.clear();
+}
+
+RdmaMrHandle RdmaRegistrationCache::Acquire(void* addr, size_t length) {
+    uintptr_t start = reinterpret_cast<uintptr_t>(addr);
+    uintptr_t end = start + length;
+    RdmaMrHandle handle;
+    std::vector<ibv_mr*> victims;
+    // 未命中时按页对齐注册：固定本来就以页为单位，同一页内其他偏移的拷贝随后都能命中
+    uintptr_t mergedStart = start & ~(kPageBytes - 1);
+    uintptr_t mergedEnd = (end + kPageBytes - 1) & ~(kPageBytes - 1);
+    size_t merged = 0;
+    bool busy = false;
+    uint64_t invalidations = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto covering = FindCovering(start, end);
+        if (covering != m_regions.end()) {
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            covering->second.users++;
+            m_lru.splice(m_lru.begin(), m_lru, covering->second.lru);
+            handle.lkey = covering->second.mr->lkey;
+            handle.rkey = covering->second.mr->rkey;
+            handle.start = covering->first;
+            handle.mr = covering->second.mr;
+            return handle;
+        }
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+
+        // 收集与请求区间重叠或相邻的注册
+        auto first = m_regions.lower_bound(mergedStart);
+        if (first != m_regions.begin() && std::prev(first)->second.end >= mergedStart) {
+            --first;
+        }
+        auto last = first;
+        uintptr_t spanStart = mergedStart;
+        uintptr_t spanEnd = mergedEnd;
+        while (last != m_regions.end() && last->first <= mergedEnd) {
+            spanStart = std::min(spanStart, last->first);
+            spanEnd = std::max(spanEnd, last->second.end);
+            ++last;
+        }
+        // 合并结果超过上限的1/4时只合并重叠的注册：否则注册随合并越来越大，
+        // 归还后一次淘汰就丢掉整片热区
+        const bool mergeAdjacent = spanEnd - spanStart <= m_maxPinnedBytes / 4;
+        auto candidate = [&](RegionMap::const_iterator it) {
+            return mergeAdjacent || (it->first < mergedEnd && it->second.end > mergedStart);
+        };
+        for (auto it = first; it != last; ++it) {
+            busy |= candidate(it) && it->second.users > 0;
+        }
+
+        // 待合并的注册正在使用时只做临时注册；否则移出缓存，注册合并后的区间
+        if (!busy) {
+            for (auto it = first; it != last;) {
+                auto next = std::next(it);
+                if (candidate(it)) {
+                    mergedStart = std::min(mergedStart, it->first);
+                    mergedEnd = std::max(mergedEnd, it->second.end);
+                    Erase(it, victims);
+                    ++merged;
+                }
+                it = next;
+            }
+        }
+        invalidations = m_invalidations;
+    }
+
+    if (busy) {
+        handle.temporary = m_verbs.RegMr(addr, length, kAccess);
+        if (!handle.temporary) {
+            LOG_ERROR("Failed to register memory region");
+            return handle;
+        }
+        handle.lkey = handle.temporary->lkey;
+        handle.rkey = handle.temporary->rkey;
+        return handle;
+    }
+
+    ibv_mr* mr = m_verbs.RegMr(reinterpret_cast<void*>(mergedStart), mergedEnd - mergedStart, kAccess);
+    if (!mr && (merged > 0 || mergedStart != start || mergedEnd != end)) {
+        // 合并或对齐后的区间可能跨越不同分配，退回只注册请求区间
+        mergedStart = start;
+        mergedEnd = end;
+        mr = m_verbs.RegMr(addr, length, kAccess);
+    } else if (merged > 0) {
+        m_merges.fetch_add(merged, std::memory_order_relaxed);
+    }
+    if (!mr) {
+        LOG_ERROR("Failed to register memory region");
+        Deregister(victims);
+        return handle;
+    }
+    handle.lkey = mr->lkey;
+    handle.rkey = mr->rkey;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // 注册期间其他线程可能已缓存了重叠区间，或合并进来的内存已被释放：此次注册只临时使用
+        if (m_invalidations != invalidations || Overlaps(mergedStart, mergedEnd)) {
+            handle.temporary = mr;
+        } else {
+            m_lru.push_front(mergedStart);
+            Region region;
+            region.end = mergedEnd;
+            region.mr = mr;
+            region.users = 1;
+            region.lru = m_lru.begin();
+            m_regions.emplace(mergedStart, region);
+            m_pinnedBytes += mergedEnd - mergedStart;
+
+            handle.start = mergedStart;
+            handle.mr = mr;
+            EvictLocked(victims);
+        }
+    }
+
+    Deregister(victims);
+    return handle;
+}
+
+void RdmaRegistrationCache::Release(const RdmaMrHandle& handle) {
+    if (!handle.valid()) return;
+    if (handle.temporary) {
+        m_verbs.DeregMr(handle.temporary);
+        return;
+    }
+
+    std::vector<ibv_mr*> victims;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_regions.find(handle.start);
+        if (it != m_regions.end() && it->second.mr == handle.mr) {
+            if (it->second.users == 0) return;
+            it->second.users--;
+            // 全部注册都在使用时可能暂时超出上限，归还后补做淘汰
+            EvictLocked(victims);
+        } else {
+            auto retired = m_retired.find(handle.mr);
+            if (retired == m_retired.end()) return;
+            if (--retired->second == 0) {
+                victims.push_back(retired->first);
+                m_retired.erase(retired);
+            }
+        }
+    }
+    Deregister(victims);
+}
+
+void RdmaRegistrationCache::Invalidate(void* addr, size_t length) {
+    uintptr_t start = reinterpret_cast<uintptr_t>(addr);
+    uintptr_t end = start + length;
+    std::vector<ibv_mr*> victims;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_invalidations++;
+        auto it = m_regions.upper_bound(start);
+        if (it != m_regions.begin() && std::prev(it)->second.end > start) {
+            --it;
+        }
+        while (it != m_regions.end() && it->first < end) {
+            auto next = std::next(it);
+            if (it->second.users > 0) {
+                // 借用者仍持有lkey/rkey，移出缓存后由最后一次Release注销
+                m_retired.emplace(it->second.mr, it->second.users);
+                m_pinnedBytes -= it->second.end - it->first;
+                m_lru.erase(it->second.lru);
+                m_regions.erase(it);
+            } else {
+                Erase(it, victims);
+            }
+            it = next;
+        }
+    }
+    Deregister(victims);
+}
+
+void RdmaRegistrationCache::Clear() {
+    std::vector<ibv_mr*> victims;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& pair : m_regions) {
+            victims.push_back(pair.second.mr);
+        }
+        for (auto& pair : m_retired) {
+            victims.push_back(pair.first);
+        }
+        m_regions.clear();
+        m_retired.clear();
+        m_lru.clear();
+        m_pinnedBytes = 0;
+    }
+    Deregister(victims);
+}
+
+void RdmaRegistrationCache::SetMaxPinnedBytes(size_t bytes) {
+    std::vector<ibv_mr*> victims;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxPinnedBytes = bytes;
+        EvictLocked(victims);
+    }
+    Deregister(victims);
+}
+
+RdmaMrCacheStats RdmaRegistrationCache::GetStats() const {
+    RdmaMrCacheStats stats;
+    stats.hits = m_hits.load(std::memory_order_relaxed);
+    stats.misses = m_misses.load(std::memory_order_relaxed);
+    stats.evictions = m_evictions.load(std::memory_order_relaxed);
+    stats.merges = m_merges.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stats.pinnedBytes = m_pinnedBytes;
+    stats.regions = m_regions.size();
+    return stats;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "rdma_verbs.h"
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// 一次借用的注册结果
+struct RdmaMrHandle {
+    uint32_t lkey = 0;
+    uint32_t rkey = 0;
+    uintptr_t start = 0;                  // 所在注册区间起点（缓存键）
+    ibv_mr* mr = nullptr;                 // 借用的缓存注册，区间作废后仍据此归还
+    ibv_mr* temporary = nullptr;          // 无法进入缓存时的临时注册，归还时注销
+    bool valid() const { return mr != nullptr || temporary != nullptr; }
+};
+
+struct RdmaMrCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t merges = 0;
+    uint64_t pinnedBytes = 0;
+    uint64_t regions = 0;
+};
+
+// 内存注册缓存
+// 以地址区间查找覆盖的注册；未命中时按页对齐，并与相邻/重叠的空闲注册合并后重新注册；
+// 固定内存总量超过上限时按LRU注销未被使用的注册。
+// 注册与注销（固定/解除固定页面）都在锁外执行。
+class RdmaRegistrationCache {
+public:
+    static constexpr size_t kDefaultMaxPinnedBytes = size_t(8) << 30;
+
+    RdmaRegistrationCache(RdmaVerbs& verbs, size_t maxPinnedBytes = kDefaultMaxPinnedBytes);
+    ~RdmaRegistrationCache();
+
+    // 借用覆盖[addr, addr+length)的注册，使用期间不会被淘汰
+    RdmaMrHandle Acquire(void* addr, size_t length);
+    void Release(const RdmaMrHandle& handle);
+
+    // 内存释放前调用：与区间相交的注册移出缓存，空闲的立即注销，
+    // 仍在使用的在最后一个借用者归还时注销
+    void Invalidate(void* addr, size_t length);
+    void Clear();
+
+    void SetMaxPinnedBytes(size_t bytes);
+    RdmaMrCacheStats GetStats() const;
+
+private:
+    struct Region {
+        uintptr_t end = 0;
+        ibv_mr* mr = nullptr;
+        uint32_t users = 0;
+        std::list<uintptr_t>::iterator lru;
+    };
+    using RegionMap = std::map<uintptr_t, Region>;
+
+    static constexpr uintptr_t kPageBytes = 4096;
+    static constexpr int kAccess = IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE | IBV_ACCESS_REMOTE_READ;
+
+    RegionMap::iterator FindCovering(uintptr_t start, uintptr_t end);
+    bool Overlaps(uintptr_t start, uintptr_t end) const;
+    void Erase(RegionMap::iterator it, std::vector<ibv_mr*>& victims);
+    void EvictLocked(std::vector<ibv_mr*>& victims);
+    void Deregister(std::vector<ibv_mr*>& victims);
+
+    RdmaVerbs& m_verbs;
+    mutable std::mutex m_mutex;
+    RegionMap m_regions;                  // 按起始地址排序，区间互不重叠
+    std::list<uintptr_t> m_lru;           // 头部为最近使用
+    size_t m_maxPinnedBytes;
+    size_t m_pinnedBytes = 0;
+    std::unordered_map<ibv_mr*, uint32_t> m_retired; // 已作废但仍被借用的注册 -> 借用数
+    uint64_t m_invalidations = 0;         // 锁外注册期间发生过作废时，新注册不进入缓存
+
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_evictions{0};
+    std::atomic<uint64_t> m_merges{0};
+};
@@ -1,179 +1,235 @@
-#include "rdma_transport.h"
-#include <iostream>
-
-// 传输类型定义
-enum TransferType {
-    STANDARD = 0,
-    GDR = 1
-};
-
-RdmaTransport::RdmaTransport() {}
-
-RdmaTransport::~RdmaTransport() {
-    Cleanup();
-}
-
-bool RdmaTransport::Initialize() {
-    // 获取RDMA设备列表
-    ibv_device** dev_list = ibv_get_device_list(nullptr);
-    if (!dev_list) {
-        std::cerr << "Failed to get IB devices list" << std::endl;
-        return false;
-    }
-    
-    // 选择第一个可用设备
-    for (ibv_device** p = dev_list; *p; ++p) {
-        m_context = ibv_open_device(*p);
-        if (m_context) break;
-    }
-    
-    ibv_free_device_list(dev_list);
-    
-    if (!m_context) {
-        std::cerr << "No RDMA device available" << std::endl;
-        return false;
-    }
-    
-    return CreateProtectionDomain();
-}
-
-bool RdmaTransport::CreateProtectionDomain() {
-    m_protectionDomain = ibv_alloc_pd(m_context);
-    if (!m_protectionDomain) {
-        std::cerr << "Failed to allocate protection domain" << std::endl;
-        return false;
-    }
-    return true;
-}
-
-bool RdmaTransport::RegisterMemory(void* ptr, size_t size) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
-    // 检查是否已注册
-    if (m_memoryRegions.find(ptr) != m_memoryRegions.end()) {
-        return true;
-    }
-    
-    // 注册内存区域
-    ibv_mr* mr = ibv_reg_mr(m_protectionDomain, ptr, size,
-                            IBV_ACCESS_LOCAL_WRITE |
-                            IBV_ACCESS_REMOTE_WRITE |
-                            IBV_ACCESS_REMOTE_READ);
-    if (!mr) {
-        std::cerr << "Failed to register memory region" << std::endl;
-        return false;
-    }
-    
-    m_memoryRegions[ptr] = mr;
-    return true;
-}
-
-bool RdmaTransport::Transfer(void* localBuffer, size_t bufferSize, 
-                          uint64_t remoteAddr, uint32_t remoteKey, 
-                          TransferType type) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
-    // 查找本地内存区域
-    auto it = m_memoryRegions.find(localBuffer);
-    if (it == m_memoryRegions.end()) {
-        if (!RegisterMemory(localBuffer, bufferSize)) {
-            return false;
-        }
-        it = m_memoryRegions.find(localBuffer);
-    }
-    
-    // 创建队列对
-    ibv_qp_init_attr qp_init_attr = {};
-    qp_init_attr.send_cq = ibv_create_cq(m_context, 1, nullptr, nullptr, 0);
-    qp_init_attr.recv_cq = ibv_create_cq(m_context, 1, nullptr, nullptr, 0);
-    qp_init_attr.qp_type = IBV_QPT_RC;
-    qp_init_attr.cap.max_send_wr = 1;
-    qp_init_attr.cap.max_recv_wr = 1;
-    qp_init_attr.cap.max_send_sge = 1;
-    qp_init_attr.cap.max_recv_sge = 1;
-    
-    ibv_qp* qp = ibv_create_qp(m_protectionDomain, &qp_init_attr);
-    if (!qp) {
-        std::cerr << "Failed to create queue pair" << std::endl;
-        return false;
-    }
-    
-    // 根据传输类型设置操作
-    ibv_wr_opcode opcode;
-    if (type == TransferType::GDR) {
-        // 启用GPU直接RDMA
-        if (!EnableGdr(qp)) {
-            ibv_destroy_qp(qp);
-            return false;
-        }
-        opcode = IBV_WR_RDMA_WRITE;
-    } else {
-        opcode = IBV_WR_RDMA_WRITE;
-    }
-    
-    // 执行RDMA操作
-    ibv_sge sge;
-    sge.addr = reinterpret_cast<uint64_t>(localBuffer);
-    sge.length = bufferSize;
-    sge.lkey = it->second->lkey;
-    
-    ibv_send_wr wr = {};
-    wr.wr_id = 0;
-    wr.opcode = opcode;
-    wr.sg_list = &sge;
-    wr.num_sge = 1;
-    wr.send_flags = IBV_SEND_SIGNALED;
-    wr.wr.rdma.remote_addr = remoteAddr;
-    wr.wr.rdma.rkey = remoteKey;
-    
-    ibv_send_wr* bad_wr = nullptr;
-    if (ibv_post_send(qp, &wr, &bad_wr)) {
-        std::cerr << "Failed to post RDMA operation" << std::endl;
-        ibv_destroy_qp(qp);
-        return false;
-    }
-    
-    // 等待完成
-    ibv_wc wc;
-    int ret;
-    do {
-        ret = ibv_poll_cq(qp_init_attr.send_cq, 1, &wc);
-    } while (ret == 0);
-    
-    ibv_destroy_qp(qp);
-    return wc.status == IBV_WC_SUCCESS;
-}
-
-bool RdmaTransport::EnableGdr(ibv_qp* qp) {
-    #ifdef ENABLE_GDR
-    ibv_exp_gid_attr gid_attr = {
-        .type = IBV_EXP_GID_ATTR_TYPE_ROCE_V2,
-        .is_grh = 1
-    };
-    if (ibv_exp_modify_qp(qp, &gid_attr, IBV_EXP_QP_GID_ATTR)) {
-        std::cerr << "Failed to enable GDR support" << std::endl;
-        return false;
-    }
-    return true;
-    #else
-    std::cerr << "GDR support not compiled in" << std::endl;
-    return false;
-    #endif
-}
-
-void RdmaTransport::Cleanup() {
-    for (auto& pair : m_memoryRegions) {
-        ibv_dereg_mr(pair.second);
-    }
-    m_memoryRegions.clear();
-    
-    if (m_protectionDomain) {
-        ibv_dealloc_pd(m_protectionDomain);
-        m_protectionDomain = nullptr;
-    }
-    
-    if (m_context) {
-        ibv_close_device(m_context);
-        m_context = nullptr;
-    }
-}
+#include "rdma_transport.h"
+#include "../logging/async_logger.h"
+#include <algorithm>
+#include <chrono>
+
+RdmaTransport::RdmaTransport(std::unique_ptr<RdmaVerbs> verbs, const RdmaConnectionConfig& config,
+                             const RdmaChunkConfig& chunkConfig, size_t maxPinnedBytes)
+    : m_verbs(verbs ? std::move(verbs) : std::make_unique<IbVerbs>()),
+      m_connections(*m_verbs, config),
+      m_registrations(*m_verbs, maxPinnedBytes),
+      m_sendQueueDepth(std::max<uint32_t>(config.sendQueueDepth, 1)),
+      m_chunkSize(chunkConfig.chunkSize),
+      m_signalInterval(ClampSignalInterval(chunkConfig.signalInterval)) {}
+
+RdmaTransport::~RdmaTransport() {
+    Cleanup();
+}
+
+bool RdmaTransport::Initialize() {
+    if (!m_verbs->Open()) {
+        return false;
+    }
+    // 设备打开后才能得到路径MTU
+    m_chunkSize = AlignChunk(m_chunkSize);
+    // 共享CQ在初始化时创建一次，之后所有连接复用
+    return m_connections.Initialize();
+}
+
+size_t RdmaTransport::AlignChunk(size_t chunkSize) const {
+    size_t mtu = std::max<uint32_t>(m_verbs->PathMtuBytes(), 1);
+    // sge长度为32位，单个分片不超过1GiB
+    chunkSize = std::min<size_t>(std::max(chunkSize, mtu), size_t(1) << 30);
+    return (chunkSize + mtu - 1) / mtu * mtu;
+}
+
+uint32_t RdmaTransport::ClampSignalInterval(uint32_t interval) const {
+    // 每组分片作为一条WR链提交，超过发送队列深度的链会被拒绝
+    return std::clamp<uint32_t>(interval, 1, m_sendQueueDepth);
+}
+
+void RdmaTransport::SetChunkConfig(const RdmaChunkConfig& config) {
+    m_chunkSize = AlignChunk(config.chunkSize);
+    m_signalInterval = ClampSignalInterval(config.signalInterval);
+}
+
+RdmaChunkConfig RdmaTransport::GetChunkConfig() const {
+    RdmaChunkConfig config;
+    config.chunkSize = m_chunkSize;
+    config.signalInterval = m_signalInterval;
+    return config;
+}
+
+bool RdmaTransport::PrepareConnection(int peerId, RdmaPeerInfo& local) {
+    return m_connections.Prepare(peerId, local);
+}
+
+bool RdmaTransport::Connect(int peerId, const RdmaPeerInfo& remote) {
+    return m_connections.Connect(peerId, remote);
+}
+
+void RdmaTransport::Disconnect(int peerId) {
+    m_connections.Disconnect(peerId);
+}
+
+bool RdmaTransport::RegisterMemory(void* ptr, size_t size, uint32_t* rkey) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_exportedRegions.find(ptr);
+        if (it != m_exportedRegions.end()) {
+            if (rkey) *rkey = it->second.handle.rkey;
+            return true;
+        }
+    }
+
+    // 注册可能需要固定页面，不持有m_mutex
+    RdmaMrHandle handle = m_registrations.Acquire(ptr, size);
+    if (!handle.valid()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto inserted = m_exportedRegions.emplace(ptr, ExportedRegion{handle, size});
+    if (!inserted.second) {
+        // 并发注册了同一地址，沿用先完成的注册
+        m_registrations.Release(handle);
+    }
+    if (rkey) *rkey = inserted.first->second.handle.rkey;
+    return true;
+}
+
+// 导出的内存通常在注销后随即释放，缓存中覆盖它的注册一并作废，
+// 否则之后分配到同一地址的缓冲区会命中已失效的lkey/rkey
+void RdmaTransport::UnregisterMemory(void* ptr) {
+    ExportedRegion region;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_exportedRegions.find(ptr);
+        if (it == m_exportedRegions.end()) return;
+        region = it->second;
+        m_exportedRegions.erase(it);
+    }
+    m_registrations.Release(region.handle);
+    m_registrations.Invalidate(ptr, region.size);
+}
+
+void RdmaTransport::InvalidateMemory(void* ptr, size_t size) {
+    m_registrations.Invalidate(ptr, size);
+}
+
+bool RdmaTransport::Transfer(int peerId, void* localBuffer, size_t bufferSize,
+                          uint64_t remoteAddr, uint32_t remoteKey, 
+                          TransferType type) {
+    auto connection = m_connections.Get(peerId);
+    if (!connection || !connection->connected) {
+        LOG_ERROR("No RDMA connection to peer {}", peerId);
+        return false;
+    }
+
+    // 根据传输类型设置操作，GDR只需在连接上启用一次
+    if (type == TransferType::GDR && !connection->gdrEnabled) {
+        std::lock_guard<std::mutex> lock(connection->sendMutex);
+        if (!connection->gdrEnabled) {
+            if (!EnableGdr(connection->qp)) {
+                return false;
+            }
+            connection->gdrEnabled = true;
+        }
+    }
+    
+    if (bufferSize == 0) {
+        return true;
+    }
+
+    // 查找覆盖本地缓冲区的注册（可位于已注册缓冲区内部）
+    RdmaMrHandle registration = m_registrations.Acquire(localBuffer, bufferSize);
+    if (!registration.valid()) {
+        return false;
+    }
+    const uint32_t lkey = registration.lkey;
+
+    // 执行RDMA操作：每组signalInterval个分片作为一条WR链提交，链尾签名
+    const size_t chunkSize = m_chunkSize.load(std::memory_order_relaxed);
+    const uint32_t interval = m_signalInterval.load(std::memory_order_relaxed);
+    const size_t chunks = (bufferSize + chunkSize - 1) / chunkSize;
+    const size_t group = std::min<size_t>(chunks, interval);
+
+    std::vector<ibv_sge> sges(group);
+    std::vector<ibv_send_wr> wrs(group);
+    auto* base = static_cast<uint8_t*>(localBuffer);
+    auto start = std::chrono::steady_clock::now();
+
+    RdmaCompletion completion;
+    bool posted = true;
+    size_t offset = 0;
+    while (offset < bufferSize && posted) {
+        size_t count = 0;
+        for (; count < group && offset < bufferSize; ++count) {
+            size_t length = std::min(chunkSize, bufferSize - offset);
+            sges[count].addr = reinterpret_cast<uint64_t>(base + offset);
+            sges[count].length = static_cast<uint32_t>(length);
+            sges[count].lkey = lkey;
+
+            ibv_send_wr& wr = wrs[count];
+            wr = {};
+            wr.opcode = IBV_WR_RDMA_WRITE;
+            wr.sg_list = &sges[count];
+            wr.num_sge = 1;
+            wr.wr.rdma.remote_addr = remoteAddr + offset;
+            wr.wr.rdma.rkey = remoteKey;
+            if (count > 0) {
+                wrs[count - 1].next = &wr;
+            }
+            offset += length;
+        }
+        // 链尾由连接管理器设置签名；verbs在post时复制WR，数组可复用
+        posted = m_connections.Post(*connection, wrs.data(), completion);
+    }
+    
+    // 等待完成
+    bool ok = m_connections.Wait(completion) && posted;
+    m_registrations.Release(registration);
+    if (ok) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        RecordTransfer(chunkSize, chunks, bufferSize, static_cast<uint64_t>(elapsed));
+    }
+    return ok;
+}
+
+void RdmaTransport::RecordTransfer(size_t chunkSize, size_t chunks, size_t bytes, uint64_t elapsedNs) {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    auto& stats = m_chunkStats[chunkSize];
+    stats.transfers++;
+    stats.chunks += chunks;
+    stats.bytes += bytes;
+    stats.totalNs += elapsedNs;
+    stats.minNs = std::min(stats.minNs, elapsedNs);
+    stats.maxNs = std::max(stats.maxNs, elapsedNs);
+}
+
+std::map<size_t, RdmaChunkStats> RdmaTransport::GetChunkStats() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return m_chunkStats;
+}
+
+void RdmaTransport::ResetChunkStats() {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_chunkStats.clear();
+}
+
+bool RdmaTransport::EnableGdr([[maybe_unused]] ibv_qp* qp) {
+    #ifdef ENABLE_GDR
+    ibv_exp_gid_attr gid_attr = {
+        .type = IBV_EXP_GID_ATTR_TYPE_ROCE_V2,
+        .is_grh = 1
+    };
+    if (ibv_exp_modify_qp(qp, &gid_attr, IBV_EXP_QP_GID_ATTR)) {
+        LOG_ERROR("Failed to enable GDR support");
+        return false;
+    }
+    return true;
+    #else
+    LOG_ERROR("GDR support not compiled in");
+    return false;
+    #endif
+}
+
+void RdmaTransport::Cleanup() {
+    m_connections.Shutdown();
+
+    m_exportedRegions.clear();
+    m_registrations.Clear();
+    
+    m_verbs->Close();
+}
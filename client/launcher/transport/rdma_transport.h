@@ -1,47 +1,110 @@
-#pragma once
-
-#include <infiniband/verbs.h>
-#include <vector>
-#include <memory>
-#include <mutex>
-#include <unordered_map>
-
-// 传输类型定义
-enum TransferType {
-    STANDARD = 0,
-    GDR = 1
-};
-
-class RdmaTransport {
-public:
-    RdmaTransport();
-    ~RdmaTransport();
-
-    // 初始化RDMA环境
-    bool Initialize();
-
-    // 注册内存区域
-    bool RegisterMemory(void* ptr, size_t size);
-
-    // 执行RDMA传输 (支持GDR-to-GDR)
-    bool Transfer(void* localBuffer, size_t bufferSize, 
-                  uint64_t remoteAddr, uint32_t remoteKey, 
-                  TransferType type = STANDARD);
-
-private:
-    struct ibv_context* m_context = nullptr;
-    struct ibv_pd* m_protectionDomain = nullptr;
-    std::mutex m_mutex;
-
-    // 内存区域映射
-    std::unordered_map<void*, struct ibv_mr*> m_memoryRegions;
-
-    // 创建保护域
-    bool CreateProtectionDomain();
-    
-    // 启用GPU直接RDMA支持
-    bool EnableGdr(ibv_qp* qp);
-
-    // 销毁资源
-    void Cleanup();
-};
+#pragma once
+
+#include <infiniband/verbs.h>
+#include <atomic>
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "rdma_verbs.h"
+#include "rdma_connection.h"
+#include "rdma_mr_cache.h"
+
+// 传输类型定义
+enum TransferType {
+    STANDARD = 0,
+    GDR = 1
+};
+
+// 分片传输参数
+struct RdmaChunkConfig {
+    size_t chunkSize = 1 << 20;           // 单个WR的字节数，按路径MTU向上对齐
+    uint32_t signalInterval = 16;         // 每N个WR签名一次，不超过发送队列深度
+};
+
+// 按分片大小统计的传输指标
+struct RdmaChunkStats {
+    uint64_t transfers = 0;
+    uint64_t chunks = 0;
+    uint64_t bytes = 0;
+    uint64_t totalNs = 0;
+    uint64_t minNs = UINT64_MAX;
+    uint64_t maxNs = 0;
+
+    double ThroughputGBps() const { return totalNs ? static_cast<double>(bytes) / totalNs : 0.0; }
+    double AvgLatencyUs() const { return transfers ? totalNs / 1000.0 / transfers : 0.0; }
+    // 单个分片的平均耗时（流水线下近似为分片间隔）
+    double AvgChunkUs() const { return chunks ? totalNs / 1000.0 / chunks : 0.0; }
+};
+
+class RdmaTransport {
+public:
+    // verbs为空时使用libibverbs；传入SoftVerbs可在无网卡环境下运行
+    explicit RdmaTransport(std::unique_ptr<RdmaVerbs> verbs = nullptr,
+                           const RdmaConnectionConfig& config = RdmaConnectionConfig(),
+                           const RdmaChunkConfig& chunkConfig = RdmaChunkConfig(),
+                           size_t maxPinnedBytes = RdmaRegistrationCache::kDefaultMaxPinnedBytes);
+    ~RdmaTransport();
+
+    // 初始化RDMA环境
+    bool Initialize();
+
+    // 建立到对端的长连接：先Prepare得到本端信息，经控制面交换后Connect
+    bool PrepareConnection(int peerId, RdmaPeerInfo& local);
+    bool Connect(int peerId, const RdmaPeerInfo& remote);
+    void Disconnect(int peerId);
+
+    // 注册供对端访问的内存区域，rkey非空时返回远端访问密钥；注销前不会被淘汰
+    bool RegisterMemory(void* ptr, size_t size, uint32_t* rkey = nullptr);
+    // 注销并作废覆盖该区域的缓存注册，之后即可释放内存
+    void UnregisterMemory(void* ptr);
+    // 内存释放前调用，丢弃缓存中覆盖该区间的注册
+    void InvalidateMemory(void* ptr, size_t size);
+    RdmaMrCacheStats GetRegistrationStats() const { return m_registrations.GetStats(); }
+
+    // 执行RDMA传输 (支持GDR-to-GDR)
+    // 大缓冲区按分片拆成多个WR连续提交，只等待最后的完成事件
+    bool Transfer(int peerId, void* localBuffer, size_t bufferSize,
+                  uint64_t remoteAddr, uint32_t remoteKey, 
+                  TransferType type = STANDARD);
+
+    // 运行时调整分片参数，用于按网络调优
+    void SetChunkConfig(const RdmaChunkConfig& config);
+    RdmaChunkConfig GetChunkConfig() const;
+
+    // 以分片大小为键的统计快照
+    std::map<size_t, RdmaChunkStats> GetChunkStats() const;
+    void ResetChunkStats();
+
+private:
+    std::unique_ptr<RdmaVerbs> m_verbs;
+    RdmaConnectionManager m_connections;
+    RdmaRegistrationCache m_registrations;
+    std::mutex m_mutex;
+
+    uint32_t m_sendQueueDepth;            // 一条WR链不能超过发送队列深度
+    std::atomic<size_t> m_chunkSize;
+    std::atomic<uint32_t> m_signalInterval;
+
+    mutable std::mutex m_statsMutex;
+    std::map<size_t, RdmaChunkStats> m_chunkStats;
+
+    // 显式注册（对端可见）的内存区域
+    struct ExportedRegion {
+        RdmaMrHandle handle;
+        size_t size = 0;
+    };
+    std::unordered_map<void*, ExportedRegion> m_exportedRegions;
+
+    size_t AlignChunk(size_t chunkSize) const;
+    uint32_t ClampSignalInterval(uint32_t interval) const;
+    void RecordTransfer(size_t chunkSize, size_t chunks, size_t bytes, uint64_t elapsedNs);
+
+    // 启用GPU直接RDMA支持
+    bool EnableGdr(ibv_qp* qp);
+
+    // 销毁资源
+    void Cleanup();
+};
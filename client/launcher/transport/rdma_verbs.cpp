@@ -0,0 +1,369 @@
+#include "rdma_verbs.h"
+#include "../logging/async_logger.h"
+#include <cerrno>
+#include <cstring>
+#include <random>
+
+// ---------------- IbVerbs ----------------
+
+IbVerbs::IbVerbs(uint8_t portNum, int gidIndex)
+    : m_portNum(portNum), m_gidIndex(gidIndex) {}
+
+IbVerbs::~IbVerbs() {
+    Close();
+}
+
+bool IbVerbs::Open() {
+    // 获取RDMA设备列表
+    ibv_device** dev_list = ibv_get_device_list(nullptr);
+    if (!dev_list) {
+        LOG_ERROR("Failed to get IB devices list");
+        return false;
+    }
+
+    // 选择第一个可用设备
+    for (ibv_device** p = dev_list; *p; ++p) {
+        m_context = ibv_open_device(*p);
+        if (m_context) break;
+    }
+
+    ibv_free_device_list(dev_list);
+
+    if (!m_context) {
+        LOG_ERROR("No RDMA device available");
+        return false;
+    }
+
+    m_protectionDomain = ibv_alloc_pd(m_context);
+    if (!m_protectionDomain) {
+        LOG_ERROR("Failed to allocate protection domain");
+        return false;
+    }
+
+    ibv_port_attr port_attr = {};
+    if (ibv_query_port(m_context, m_portNum, &port_attr) == 0) {
+        m_activeMtu = port_attr.active_mtu;
+    }
+    return true;
+}
+
+void IbVerbs::Close() {
+    if (m_protectionDomain) {
+        ibv_dealloc_pd(m_protectionDomain);
+        m_protectionDomain = nullptr;
+    }
+    if (m_context) {
+        ibv_close_device(m_context);
+        m_context = nullptr;
+    }
+}
+
+ibv_cq* IbVerbs::CreateCq(int depth) {
+    return ibv_create_cq(m_context, depth, nullptr, nullptr, 0);
+}
+
+void IbVerbs::DestroyCq(ibv_cq* cq) {
+    if (cq) ibv_destroy_cq(cq);
+}
+
+ibv_qp* IbVerbs::CreateQp(ibv_cq* sendCq, ibv_cq* recvCq, uint32_t maxSendWr, uint32_t maxRecvWr) {
+    ibv_qp_init_attr qp_init_attr = {};
+    qp_init_attr.send_cq = sendCq;
+    qp_init_attr.recv_cq = recvCq;
+    qp_init_attr.qp_type = IBV_QPT_RC;
+    qp_init_attr.sq_sig_all = 0;
+    qp_init_attr.cap.max_send_wr = maxSendWr;
+    qp_init_attr.cap.max_recv_wr = maxRecvWr;
+    qp_init_attr.cap.max_send_sge = 1;
+    qp_init_attr.cap.max_recv_sge = 1;
+    return ibv_create_qp(m_protectionDomain, &qp_init_attr);
+}
+
+void IbVerbs::DestroyQp(ibv_qp* qp) {
+    if (qp) ibv_destroy_qp(qp);
+}
+
+RdmaPeerInfo IbVerbs::QueryLocal(ibv_qp* qp) {
+    RdmaPeerInfo info;
+    info.qpNum = qp->qp_num;
+
+    static thread_local std::mt19937 rng(std::random_device{}());
+    info.psn = rng() & 0xffffff;
+
+    ibv_port_attr port_attr = {};
+    if (ibv_query_port(m_context, m_portNum, &port_attr) == 0) {
+        info.lid = port_attr.lid;
+    }
+    ibv_gid gid = {};
+    if (ibv_query_gid(m_context, m_portNum, m_gidIndex, &gid) == 0) {
+        memcpy(info.gid, gid.raw, sizeof(info.gid));
+    }
+    return info;
+}
+
+bool IbVerbs::ConnectQp(ibv_qp* qp, const RdmaPeerInfo& local, const RdmaPeerInfo& remote) {
+    // RESET -> INIT
+    ibv_qp_attr attr = {};
+    attr.qp_state = IBV_QPS_INIT;
+    attr.pkey_index = 0;
+    attr.port_num = m_portNum;
+    attr.qp_access_flags = IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE | IBV_ACCESS_REMOTE_READ;
+    if (ibv_modify_qp(qp, &attr,
+                      IBV_QP_STATE | IBV_QP_PKEY_INDEX | IBV_QP_PORT | IBV_QP_ACCESS_FLAGS)) {
+        LOG_ERROR("Failed to modify QP to INIT");
+        return false;
+    }
+
+    // INIT -> RTR
+    attr = {};
+    attr.qp_state = IBV_QPS_RTR;
+    attr.path_mtu = m_activeMtu;
+    attr.dest_qp_num = remote.qpNum;
+    attr.rq_psn = remote.psn;
+    attr.max_dest_rd_atomic = 16;
+    attr.min_rnr_timer = 12;
+    attr.ah_attr.dlid = remote.lid;
+    attr.ah_attr.sl = 0;
+    attr.ah_attr.src_path_bits = 0;
+    attr.ah_attr.port_num = m_portNum;
+    // RoCE需要GRH
+    attr.ah_attr.is_global = 1;
+    memcpy(attr.ah_attr.grh.dgid.raw, remote.gid, sizeof(remote.gid));
+    attr.ah_attr.grh.sgid_index = m_gidIndex;
+    attr.ah_attr.grh.hop_limit = 1;
+    if (ibv_modify_qp(qp, &attr,
+                      IBV_QP_STATE | IBV_QP_AV | IBV_QP_PATH_MTU | IBV_QP_DEST_QPN |
+                      IBV_QP_RQ_PSN | IBV_QP_MAX_DEST_RD_ATOMIC | IBV_QP_MIN_RNR_TIMER)) {
+        LOG_ERROR("Failed to modify QP to RTR");
+        return false;
+    }
+
+    // RTR -> RTS
+    attr = {};
+    attr.qp_state = IBV_QPS_RTS;
+    attr.timeout = 14;
+    attr.retry_cnt = 7;
+    attr.rnr_retry = 7;
+    attr.sq_psn = local.psn;
+    attr.max_rd_atomic = 16;
+    if (ibv_modify_qp(qp, &attr,
+                      IBV_QP_STATE | IBV_QP_TIMEOUT | IBV_QP_RETRY_CNT | IBV_QP_RNR_RETRY |
+                      IBV_QP_SQ_PSN | IBV_QP_MAX_QP_RD_ATOMIC)) {
+        LOG_ERROR("Failed to modify QP to RTS");
+        return false;
+    }
+    return true;
+}
+
+ibv_mr* IbVerbs::RegMr(void* addr, size_t length, int access) {
+    return ibv_reg_mr(m_protectionDomain, addr, length, access);
+}
+
+void IbVerbs::DeregMr(ibv_mr* mr) {
+    if (mr) ibv_dereg_mr(mr);
+}
+
+bool IbVerbs::ResetQp(ibv_qp* qp) {
+    ibv_qp_attr attr = {};
+    attr.qp_state = IBV_QPS_RESET;
+    if (ibv_modify_qp(qp, &attr, IBV_QP_STATE)) {
+        LOG_ERROR("Failed to modify QP to RESET");
+        return false;
+    }
+    return true;
+}
+
+int IbVerbs::PostSend(ibv_qp* qp, ibv_send_wr* wr, ibv_send_wr** badWr) {
+    return ibv_post_send(qp, wr, badWr);
+}
+
+int IbVerbs::PollCq(ibv_cq* cq, int numEntries, ibv_wc* wc) {
+    return ibv_poll_cq(cq, numEntries, wc);
+}
+
+uint32_t IbVerbs::PathMtuBytes() const {
+    // IBV_MTU_256 = 1 ... IBV_MTU_4096 = 5
+    return 128u << static_cast<int>(m_activeMtu);
+}
+
+// ---------------- SoftFabric ----------------
+
+void SoftFabric::AddQp(SoftQp* qp) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_qps[qp->qp.qp_num] = qp;
+}
+
+void SoftFabric::RemoveQp(uint32_t qpNum) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_qps.erase(qpNum);
+}
+
+SoftFabric::SoftQp* SoftFabric::FindQp(uint32_t qpNum) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_qps.find(qpNum);
+    return it != m_qps.end() ? it->second : nullptr;
+}
+
+void SoftFabric::AddMr(ibv_mr* mr) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mrs[mr->rkey] = mr;
+}
+
+void SoftFabric::RemoveMr(uint32_t rkey) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mrs.erase(rkey);
+}
+
+bool SoftFabric::CheckRemote(uint32_t rkey, uint64_t addr, size_t length) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_mrs.find(rkey);
+    if (it == m_mrs.end()) return false;
+    uint64_t start = reinterpret_cast<uint64_t>(it->second->addr);
+    return addr >= start && addr + length <= start + it->second->length;
+}
+
+// ---------------- SoftVerbs ----------------
+
+SoftVerbs::SoftVerbs(SoftFabric& fabric) : m_fabric(fabric) {}
+
+SoftVerbs::~SoftVerbs() {}
+
+ibv_cq* SoftVerbs::CreateCq(int depth) {
+    auto* cq = new SoftCq();
+    cq->cq.cqe = depth;
+    return &cq->cq;
+}
+
+void SoftVerbs::DestroyCq(ibv_cq* cq) {
+    delete reinterpret_cast<SoftCq*>(cq);
+}
+
+ibv_qp* SoftVerbs::CreateQp(ibv_cq* sendCq, ibv_cq* recvCq, uint32_t, uint32_t) {
+    auto* qp = new SoftFabric::SoftQp();
+    qp->qp.qp_num = m_fabric.NextQpNum();
+    qp->qp.send_cq = sendCq;
+    qp->qp.recv_cq = recvCq;
+    qp->qp.qp_type = IBV_QPT_RC;
+    qp->qp.state = IBV_QPS_RESET;
+    qp->sendCq = sendCq;
+    m_fabric.AddQp(qp);
+    return &qp->qp;
+}
+
+void SoftVerbs::DestroyQp(ibv_qp* qp) {
+    if (!qp) return;
+    m_fabric.RemoveQp(qp->qp_num);
+    delete reinterpret_cast<SoftFabric::SoftQp*>(qp);
+}
+
+RdmaPeerInfo SoftVerbs::QueryLocal(ibv_qp* qp) {
+    RdmaPeerInfo info;
+    info.qpNum = qp->qp_num;
+    return info;
+}
+
+bool SoftVerbs::ConnectQp(ibv_qp* qp, const RdmaPeerInfo&, const RdmaPeerInfo& remote) {
+    auto* soft = reinterpret_cast<SoftFabric::SoftQp*>(qp);
+    if (qp->state != IBV_QPS_RESET) {
+        LOG_ERROR("Soft verbs: QP {} is not in RESET", qp->qp_num);
+        return false;
+    }
+    if (!m_fabric.FindQp(remote.qpNum)) {
+        LOG_ERROR("Soft verbs: remote QP {} not found", remote.qpNum);
+        return false;
+    }
+    soft->remoteQpNum = remote.qpNum;
+    soft->connected = true;
+    qp->state = IBV_QPS_RTS;
+    return true;
+}
+
+bool SoftVerbs::ResetQp(ibv_qp* qp) {
+    auto* soft = reinterpret_cast<SoftFabric::SoftQp*>(qp);
+    soft->connected = false;
+    soft->remoteQpNum = 0;
+    qp->state = IBV_QPS_RESET;
+    return true;
+}
+
+ibv_mr* SoftVerbs::RegMr(void* addr, size_t length, int access) {
+    auto* mr = new ibv_mr();
+    mr->addr = addr;
+    mr->length = length;
+    mr->lkey = m_fabric.NextKey();
+    mr->rkey = (access & (IBV_ACCESS_REMOTE_WRITE | IBV_ACCESS_REMOTE_READ)) ? mr->lkey : 0;
+    if (mr->rkey) {
+        m_fabric.AddMr(mr);
+    }
+    return mr;
+}
+
+void SoftVerbs::DeregMr(ibv_mr* mr) {
+    if (!mr) return;
+    if (mr->rkey) {
+        m_fabric.RemoveMr(mr->rkey);
+    }
+    delete mr;
+}
+
+// 逐个执行WR：READ/WRITE直接在进程内拷贝，签名的WR以及出错的WR产生完成事件
+int SoftVerbs::PostSend(ibv_qp* qp, ibv_send_wr* wr, ibv_send_wr** badWr) {
+    auto* soft = reinterpret_cast<SoftFabric::SoftQp*>(qp);
+    if (!soft->connected) {
+        if (badWr) *badWr = wr;
+        return EINVAL;
+    }
+    auto* cq = reinterpret_cast<SoftCq*>(soft->sendCq);
+
+    for (; wr; wr = wr->next) {
+        ibv_wc wc = {};
+        wc.wr_id = wr->wr_id;
+        wc.qp_num = qp->qp_num;
+        wc.status = IBV_WC_SUCCESS;
+
+        size_t length = 0;
+        for (int i = 0; i < wr->num_sge; ++i) {
+            length += wr->sg_list[i].length;
+        }
+        uint64_t remote = wr->wr.rdma.remote_addr;
+        if (qp->state == IBV_QPS_ERR) {
+            wc.status = IBV_WC_WR_FLUSH_ERR;
+        } else if (!m_fabric.CheckRemote(wr->wr.rdma.rkey, remote, length)) {
+            wc.status = IBV_WC_REM_ACCESS_ERR;
+            // QP进入ERR，同一链中其后的WR以FLUSH_ERR完成，之后的post被拒绝
+            soft->connected = false;
+            qp->state = IBV_QPS_ERR;
+        } else {
+            for (int i = 0; i < wr->num_sge; ++i) {
+                auto* local = reinterpret_cast<void*>(wr->sg_list[i].addr);
+                auto* target = reinterpret_cast<void*>(remote);
+                if (wr->opcode == IBV_WR_RDMA_READ) {
+                    memcpy(local, target, wr->sg_list[i].length);
+                    wc.opcode = IBV_WC_RDMA_READ;
+                } else {
+                    memcpy(target, local, wr->sg_list[i].length);
+                    wc.opcode = IBV_WC_RDMA_WRITE;
+                }
+                remote += wr->sg_list[i].length;
+            }
+            wc.byte_len = static_cast<uint32_t>(length);
+        }
+
+        if ((wr->send_flags & IBV_SEND_SIGNALED) || wc.status != IBV_WC_SUCCESS) {
+            std::lock_guard<std::mutex> lock(cq->mutex);
+            cq->completions.push_back(wc);
+        }
+    }
+    return 0;
+}
+
+int SoftVerbs::PollCq(ibv_cq* cq, int numEntries, ibv_wc* wc) {
+    auto* soft = reinterpret_cast<SoftCq*>(cq);
+    std::lock_guard<std::mutex> lock(soft->mutex);
+    int count = 0;
+    while (count < numEntries && !soft->completions.empty()) {
+        wc[count++] = soft->completions.front();
+        soft->completions.pop_front();
+    }
+    return count;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <infiniband/verbs.h>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// 对端QP连接信息（通过控制面交换，对应memcopy.capnp中的RdmaEndpoint）
+struct RdmaPeerInfo {
+    uint32_t qpNum = 0;
+    uint32_t psn = 0;
+    uint16_t lid = 0;
+    uint8_t gid[16] = {};
+};
+
+// verbs操作抽象
+// RdmaTransport只通过该接口访问HCA，便于在没有网卡的机器上用软件实现替换
+class RdmaVerbs {
+public:
+    virtual ~RdmaVerbs() = default;
+
+    virtual bool Open() = 0;
+    virtual void Close() = 0;
+
+    virtual ibv_cq* CreateCq(int depth) = 0;
+    virtual void DestroyCq(ibv_cq* cq) = 0;
+
+    virtual ibv_qp* CreateQp(ibv_cq* sendCq, ibv_cq* recvCq, uint32_t maxSendWr, uint32_t maxRecvWr) = 0;
+    virtual void DestroyQp(ibv_qp* qp) = 0;
+    // 查询本端连接信息
+    virtual RdmaPeerInfo QueryLocal(ibv_qp* qp) = 0;
+    // RESET -> INIT -> RTR -> RTS
+    virtual bool ConnectQp(ibv_qp* qp, const RdmaPeerInfo& local, const RdmaPeerInfo& remote) = 0;
+    // 任意状态 -> RESET：完成错误使QP进入ERR后，重新ConnectQp前必须先复位（QP号不变）
+    virtual bool ResetQp(ibv_qp* qp) = 0;
+
+    virtual ibv_mr* RegMr(void* addr, size_t length, int access) = 0;
+    virtual void DeregMr(ibv_mr* mr) = 0;
+
+    virtual int PostSend(ibv_qp* qp, ibv_send_wr* wr, ibv_send_wr** badWr) = 0;
+    virtual int PollCq(ibv_cq* cq, int numEntries, ibv_wc* wc) = 0;
+
+    // 当前端口的路径MTU（字节），分片大小按其对齐
+    virtual uint32_t PathMtuBytes() const = 0;
+};
+
+// 基于libibverbs的实现
+class IbVerbs : public RdmaVerbs {
+public:
+    explicit IbVerbs(uint8_t portNum = 1, int gidIndex = 0);
+    ~IbVerbs() override;
+
+    bool Open() override;
+    void Close() override;
+
+    ibv_cq* CreateCq(int depth) override;
+    void DestroyCq(ibv_cq* cq) override;
+
+    ibv_qp* CreateQp(ibv_cq* sendCq, ibv_cq* recvCq, uint32_t maxSendWr, uint32_t maxRecvWr) override;
+    void DestroyQp(ibv_qp* qp) override;
+    RdmaPeerInfo QueryLocal(ibv_qp* qp) override;
+    bool ConnectQp(ibv_qp* qp, const RdmaPeerInfo& local, const RdmaPeerInfo& remote) override;
+    bool ResetQp(ibv_qp* qp) override;
+
+    ibv_mr* RegMr(void* addr, size_t length, int access) override;
+    void DeregMr(ibv_mr* mr) override;
+
+    int PostSend(ibv_qp* qp, ibv_send_wr* wr, ibv_send_wr** badWr) override;
+    int PollCq(ibv_cq* cq, int numEntries, ibv_wc* wc) override;
+    uint32_t PathMtuBytes() const override;
+
+    ibv_context* Context() const { return m_context; }
+    ibv_pd* ProtectionDomain() const { return m_protectionDomain; }
+
+private:
+    ibv_context* m_context = nullptr;
+    ibv_pd* m_protectionDomain = nullptr;
+    uint8_t m_portNum;
+    int m_gidIndex;
+    ibv_mtu m_activeMtu = IBV_MTU_1024;
+};
+
+// 软件verbs共享的"网络"：同一进程内多个SoftVerbs实例通过它互相寻址QP和rkey
+class SoftFabric {
+public:
+    struct SoftQp;
+
+    void AddQp(SoftQp* qp);
+    void RemoveQp(uint32_t qpNum);
+    SoftQp* FindQp(uint32_t qpNum);
+
+    void AddMr(ibv_mr* mr);
+    void RemoveMr(uint32_t rkey);
+    // 校验rkey覆盖[addr, addr+length)
+    bool CheckRemote(uint32_t rkey, uint64_t addr, size_t length);
+
+    uint32_t NextQpNum() { return m_nextQpNum.fetch_add(1, std::memory_order_relaxed); }
+    uint32_t NextKey() { return m_nextKey.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<uint32_t, SoftQp*> m_qps;
+    std::unordered_map<uint32_t, ibv_mr*> m_mrs;
+    std::atomic<uint32_t> m_nextQpNum{1};
+    std::atomic<uint32_t> m_nextKey{1};
+};
+
+// 软件verbs：在同一进程内用memcpy模拟RDMA READ/WRITE，完成事件立即入队。
+// 两个挂在同一SoftFabric上的RdmaTransport即构成可压测的环回端点对。
+// 与硬件一样，出错的WR使QP进入ERR，之后的post被拒绝，只有RESET状态的QP可以ConnectQp。
+class SoftVerbs : public RdmaVerbs {
+public:
+    explicit SoftVerbs(SoftFabric& fabric);
+    ~SoftVerbs() override;
+
+    bool Open() override { return true; }
+    void Close() override {}
+
+    ibv_cq* CreateCq(int depth) override;
+    void DestroyCq(ibv_cq* cq) override;
+
+    ibv_qp* CreateQp(ibv_cq* sendCq, ibv_cq* recvCq, uint32_t maxSendWr, uint32_t maxRecvWr) override;
+    void DestroyQp(ibv_qp* qp) override;
+    RdmaPeerInfo QueryLocal(ibv_qp* qp) override;
+    bool ConnectQp(ibv_qp* qp, const RdmaPeerInfo& local, const RdmaPeerInfo& remote) override;
+    bool ResetQp(ibv_qp* qp) override;
+
+    ibv_mr* RegMr(void* addr, size_t length, int access) override;
+    void DeregMr(ibv_mr* mr) override;
+
+    int PostSend(ibv_qp* qp, ibv_send_wr* wr, ibv_send_wr** badWr) override;
+    int PollCq(ibv_cq* cq, int numEntries, ibv_wc* wc) override;
+    uint32_t PathMtuBytes() const override { return 4096; }
+
+private:
+    struct SoftCq {
+        ibv_cq cq{};                 // 必须为首成员，ibv_cq*与SoftCq*互相转换
+        std::mutex mutex;
+        std::deque<ibv_wc> completions;
+    };
+
+    SoftFabric& m_fabric;
+};
+
+struct SoftFabric::SoftQp {
+    ibv_qp qp{};                     // 必须为首成员，ibv_qp*与SoftQp*互相转换
+    ibv_cq* sendCq = nullptr;
+    uint32_t remoteQpNum = 0;
+    bool connected = false;
+};
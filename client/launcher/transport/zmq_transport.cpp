@@ -1,83 +1,126 @@
-#include "zmq_transport.h"
-#include <iostream>
-#include <thread>
-#include <zlib.h>
-
-void zmq_do_nothing_free_fn(void* data, void* hint) {}
-
-ZmqTransport::ZmqTransport() {}
-ZmqTransport::~ZmqTransport() { 
-    if (m_context) zmq_ctx_destroy(m_context); 
-}
-
-bool ZmqTransport::Initialize() {
-    m_context = zmq_ctx_new();
-    return m_context != nullptr;
-}
-
-uint32_t calculate_crc32(const void* data, size_t length) {
-    return crc32(0, reinterpret_cast<const Bytef*>(data), length);
-}
-
-bool ZmqTransport::Transfer(
-    const std::string& targetIp,
-    USHORT targetPort,
-    void* localBuffer,
-    size_t bufferSize)
-{
-    if (!m_context) return false;
-    
-    void* socket = zmq_socket(m_context, ZMQ_DGRAM);
-    if (!socket) {
-        std::cerr << "zmq_socket failed: " << zmq_strerror(zmq_errno()) << std::endl;
-        return false;
-    }
-
-    std::string endpoint = "udp://" + targetIp + ":" + std::to_string(targetPort);
-    if (zmq_connect(socket, endpoint.c_str()) != 0) {
-        std::cerr << "zmq_connect failed: " << zmq_strerror(zmq_errno()) << std::endl;
-        zmq_close(socket);
-        return false;
-    }
-
-    // 准备带CRC校验的数据包
-    size_t packetSize = bufferSize + sizeof(uint32_t);
-    std::vector<uint8_t> packet(packetSize);
-    
-    // 复制原始数据
-    memcpy(packet.data(), localBuffer, bufferSize);
-    
-    // 计算并附加CRC32
-    uint32_t crc = calculate_crc32(localBuffer, bufferSize);
-    memcpy(packet.data() + bufferSize, &crc, sizeof(uint32_t));
-
-    int retries = 0;
-    const int max_retries = 3;
-    bool success = false;
-    
-    while (retries < max_retries && !success) {
-        zmq_msg_t msg;
-        if (zmq_msg_init_data(&msg, packet.data(), packetSize, zmq_do_nothing_free_fn, nullptr) != 0) {
-            std::cerr << "zmq_msg_init_data failed (retry " << retries << "): " 
-                      << zmq_strerror(zmq_errno()) << std::endl;
-            retries++;
-            continue;
-        }
-        
-        if (zmq_msg_send(&msg, socket, 0) != -1) {
-            success = true;
-        } else {
-            std::cerr << "zmq_msg_send failed (retry " << retries << "): " 
-                      << zmq_strerror(zmq_errno()) << std::endl;
-            zmq_msg_close(&msg);
-            retries++;
-        }
-        
-        if (!success && retries < max_retries) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
-    }
-    
-    zmq_close(socket);
-    return success;
-}
+#include "zmq_transport.h"
+#include "crc32c.h"
+#include "../logging/async_logger.h"
+#include <atomic>
+#include <condition_variable>
+#include <random>
+#include <thread>
+
+ZmqTransport::ZmqTransport(ZmqSocketPool* pool, const ZmqTransportConfig& config)
+    : m_pool(pool), m_config(config) {}
+ZmqTransport::~ZmqTransport() {}
+
+bool ZmqTransport::Initialize() {
+    if (!m_pool) m_pool = &ZmqSocketPool::Instance();
+    return m_pool->context() != nullptr;
+}
+
+// 传输ID：高32位为进程随机种子，避免不同发送端冲突
+static uint64_t next_transfer_id() {
+    static const uint64_t seed = static_cast<uint64_t>(std::random_device{}()) << 32;
+    static std::atomic<uint32_t> counter{0};
+    return seed | counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool ZmqTransport::Transfer(
+    const std::string& targetIp,
+    USHORT targetPort,
+    void* localBuffer,
+    size_t bufferSize)
+{
+    if (!m_pool) return false;
+
+    if (m_config.reliable) {
+        return TransferReliable(targetIp + ":" + std::to_string(targetPort), localBuffer, bufferSize);
+    }
+    return TransferDatagram("udp://" + targetIp + ":" + std::to_string(targetPort), localBuffer, bufferSize);
+}
+
+// 分片 + 选择重传：丢失的分片由接收端NACK后单独重传
+bool ZmqTransport::TransferReliable(const std::string& peer, void* localBuffer, size_t bufferSize) {
+    ZmqSocketLease socket = m_pool->acquire(m_config.localEndpoint, ZMQ_DGRAM, true);
+    if (!socket) {
+        return false;
+    }
+    ZmqDatagramChannel channel(std::move(socket), peer);
+    ReliableSender sender(channel, m_config.reliability);
+    bool ok = sender.send(next_transfer_id(), 0, 0, localBuffer, bufferSize);
+    if (!ok) {
+        LOG_ERROR("Reliable transfer to {} failed after {} retransmissions", peer,
+                  sender.stats().retransmissions);
+    }
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_reliableStats.fragmentsSent += sender.stats().fragmentsSent;
+    m_reliableStats.retransmissions += sender.stats().retransmissions;
+    m_reliableStats.feedbackReceived += sender.stats().feedbackReceived;
+    m_reliableStats.timeouts += sender.stats().timeouts;
+    return ok;
+}
+
+bool ZmqTransport::Receive(void* buffer, size_t bufferSize, int timeoutMs) {
+    if (!m_pool) return false;
+    ZmqSocketLease socket = m_pool->acquire(m_config.localEndpoint, ZMQ_DGRAM, true);
+    if (!socket) {
+        return false;
+    }
+    ZmqDatagramChannel channel(std::move(socket));
+    ReliableReceiver receiver(channel, m_config.reliability);
+    return receiver.receive(buffer, bufferSize, timeoutMs);
+}
+
+ReliableStats ZmqTransport::GetReliableStats() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return m_reliableStats;
+}
+
+// 零拷贝发送：ZMQ释放负载消息时回调，之后调用方才能复用缓冲区
+struct ZeroCopyRelease {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool released = false;
+};
+
+static void zero_copy_release_fn(void* /*data*/, void* hint) {
+    auto* release = static_cast<ZeroCopyRelease*>(hint);
+    std::lock_guard<std::mutex> lock(release->mutex);
+    release->released = true;
+    release->cv.notify_all();
+}
+
+// 单报文格式：[负载帧（零拷贝）][CRC32C帧（4字节）]
+bool ZmqTransport::TransferDatagram(const std::string& endpoint, void* localBuffer, size_t bufferSize) {
+    uint32_t crc = Crc32c(localBuffer, bufferSize);
+    ZeroCopyRelease release;
+    bool success = false;
+
+    {
+        ZmqSocketLease socket = m_pool->acquire(endpoint, ZMQ_DGRAM);
+        if (!socket) {
+            return false;
+        }
+
+        zmq_msg_t payload;
+        if (zmq_msg_init_data(&payload, localBuffer, bufferSize, zero_copy_release_fn, &release) != 0) {
+            LOG_ERROR("zmq_msg_init_data failed: {}", zmq_strerror(zmq_errno()));
+            return false;
+        }
+
+        if (zmq_msg_send(&payload, socket.socket(), ZMQ_SNDMORE) == -1) {
+            LOG_ERROR("zmq_msg_send failed: {}", zmq_strerror(zmq_errno()));
+            zmq_msg_close(&payload);
+            socket.discard();
+        } else if (zmq_send(socket.socket(), &crc, sizeof(crc), 0) == -1) {
+            // 半条多帧消息留在套接字中，丢弃套接字
+            LOG_ERROR("zmq_send (checksum) failed: {}", zmq_strerror(zmq_errno()));
+            socket.discard();
+        } else {
+            success = true;
+        }
+    }
+
+    // 等待ZMQ释放负载，保证返回后调用方可以修改缓冲区
+    std::unique_lock<std::mutex> lock(release.mutex);
+    release.cv.wait(lock, [&] { return release.released; });
+    return success;
+}
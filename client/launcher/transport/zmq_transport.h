@@ -1,22 +1,46 @@
-#pragma once
-
-#include <string>
-#include <memory>
-#include <zmq.h>
-
-class ZmqTransport {
-public:
-    ZmqTransport();
-    ~ZmqTransport();
-
-    bool Initialize();
-    bool Transfer(
-        const std::string& targetIp,
-        USHORT targetPort,
-        void* localBuffer,
-        size_t bufferSize
-    );
-
-private:
-    void* m_context = nullptr;
-};
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <zmq.h>
+
+#include "zmq_socket_pool.h"
+#include "reliable_transfer.h"
+
+struct ZmqTransportConfig {
+    bool reliable = true;                          // 选择重传；false时为单报文（负载帧+CRC32C帧）
+    std::string localEndpoint = "udp://*:5560";    // 可靠模式下接收数据与反馈的本地端点
+    ReliableConfig reliability;
+};
+
+class ZmqTransport {
+public:
+    // pool为空时使用进程级共享池
+    explicit ZmqTransport(ZmqSocketPool* pool = nullptr,
+                          const ZmqTransportConfig& config = ZmqTransportConfig());
+    ~ZmqTransport();
+
+    bool Initialize();
+    bool Transfer(
+        const std::string& targetIp,
+        USHORT targetPort,
+        void* localBuffer,
+        size_t bufferSize
+    );
+
+    // 可靠模式下在本地端点接收一次传输
+    bool Receive(void* buffer, size_t bufferSize, int timeoutMs);
+
+    ReliableStats GetReliableStats() const;
+
+private:
+    bool TransferReliable(const std::string& peer, void* localBuffer, size_t bufferSize);
+    bool TransferDatagram(const std::string& endpoint, void* localBuffer, size_t bufferSize);
+
+    ZmqSocketPool* m_pool = nullptr;
+    ZmqTransportConfig m_config;
+
+    mutable std::mutex m_statsMutex;
+    ReliableStats m_reliableStats;
+};
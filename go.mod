@@ -1,13 +1,13 @@
-module github.com/hiicl/GPU-over-IP-AC922
-
-go 1.20
-
-require (
-	github.com/openucx/ucx v1.12.1
-	github.com/spf13/cobra v1.7.0
-)
-
-require (
-	github.com/inconshreveable/mousetrap v1.1.0 // indirect
-	github.com/spf13/pflag v1.0.5 // indirect
-)
+module github.com/hiicl/GPU-over-IP-AC922
+
+go 1.20
+
+require (
+	github.com/openucx/ucx v1.12.1
+	github.com/spf13/cobra v1.7.0
+)
+
+require (
+	github.com/inconshreveable/mousetrap v1.1.0 // indirect
+	github.com/spf13/pflag v1.0.5 // indirect
+)
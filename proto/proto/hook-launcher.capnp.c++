@@ -12,7 +12,7 @@ static const ::capnp::_::AlignedData<67> b_ddb256ee5b6b53b3 = {
     113,  94, 165, 177, 235, 173, 187, 218,
       1,   0,   7,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    130,   1,   0,   0, 246,   1,   0,   0,
+    184,   1,   0,   0,  44,   2,   0,   0,
      21,   0,   0,   0, 250,   0,   0,   0,
      33,   0,   0,   0,   7,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
@@ -93,7 +93,7 @@ static const ::capnp::_::AlignedData<130> b_eb7186a22c3fa0de = {
     113,  94, 165, 177, 235, 173, 187, 218,
       1,   0,   7,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    250,   1,   0,   0, 108,   3,   0,   0,
+     48,   2,   0,   0, 162,   3,   0,   0,
      21,   0,   0,   0, 250,   0,   0,   0,
      33,   0,   0,   0,   7,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
@@ -234,7 +234,7 @@ static const ::capnp::_::AlignedData<84> b_f853fd580170b9de = {
     113,  94, 165, 177, 235, 173, 187, 218,
       0,   0,   7,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    152,   3,   0,   0, 159,   4,   0,   0,
+    206,   3,   0,   0, 213,   4,   0,   0,
      21,   0,   0,   0,  26,   1,   0,   0,
      37,   0,   0,   0,   7,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
@@ -333,7 +333,7 @@ static const ::capnp::_::AlignedData<27> b_faacf17de2174649 = {
     113,  94, 165, 177, 235, 173, 187, 218,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    163,   4,   0,   0, 207,   4,   0,   0,
+    217,   4,   0,   0,   5,   5,   0,   0,
      21,   0,   0,   0, 250,   0,   0,   0,
      33,   0,   0,   0,   7,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
@@ -371,7 +371,7 @@ static const ::capnp::_::AlignedData<32> b_98b4ed7091b72c0c = {
     113,  94, 165, 177, 235, 173, 187, 218,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    211,   4,   0,   0,  12,   5,   0,   0,
+      9,   5,   0,   0,  66,   5,   0,   0,
      21,   0,   0,   0,  18,   1,   0,   0,
      37,   0,   0,   0,   7,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
@@ -407,19 +407,19 @@ const ::capnp::_::RawSchema s_98b4ed7091b72c0c = {
 };
 #endif  // !CAPNP_LITE
 CAPNP_DEFINE_ENUM(TransportType_98b4ed7091b72c0c, 98b4ed7091b72c0c);
-static const ::capnp::_::AlignedData<156> b_b5d15336d30e0dd1 = {
+static const ::capnp::_::AlignedData<168> b_b5d15336d30e0dd1 = {
   {   0,   0,   0,   0,   6,   0,   6,   0,
     209,  13,  14, 211,  54,  83, 209, 181,
      20,   0,   0,   0,   3,   0,   0,   0,
     113,  94, 165, 177, 235, 173, 187, 218,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     16,   5,   0,   0, 165,  11,   0,   0,
+     70,   5,   0,   0,  82,  12,   0,   0,
      21,   0,   0,   0,  10,   1,   0,   0,
      37,   0,   0,   0,   7,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     33,   0,   0,   0,   7,   3,   0,   0,
-     61,   2,   0,   0,   7,   0,   0,   0,
+     33,   0,   0,   0,  71,   3,   0,   0,
+    109,   2,   0,   0,   7,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
     104, 111, 111, 107,  45, 108,  97, 117,
     110,  99, 104, 101, 114,  46,  99,  97,
@@ -427,103 +427,111 @@ static const ::capnp::_::AlignedData<156> b_b5d15336d30e0dd1 = {
      76,  97, 117, 110,  99, 104, 101, 114,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   1,   0,   1,   0,
-     48,   0,   0,   0,   3,   0,   5,   0,
+     52,   0,   0,   0,   3,   0,   5,   0,
       2,   0,   0,   0,   0,   0,   0,   0,
     148, 109, 138, 178,  81, 208,   0, 160,
      64, 169, 115,  90,  30, 219, 204, 217,
-    113,   1,   0,   0, 122,   0,   0,   0,
+    145,   1,   0,   0, 122,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    105,   1,   0,   0,   7,   0,   0,   0,
+    137,   1,   0,   0,   7,   0,   0,   0,
       3,   0,   0,   0,   0,   0,   0,   0,
      79, 128, 138, 233, 203,  35,  53, 235,
      57, 143, 233,  65, 190, 158,  56, 250,
-     93,   1,   0,   0, 122,   0,   0,   0,
+    125,   1,   0,   0, 122,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     85,   1,   0,   0,   7,   0,   0,   0,
+    117,   1,   0,   0,   7,   0,   0,   0,
       4,   0,   0,   0,   0,   0,   0,   0,
     133, 157, 208, 110, 172, 187, 182, 128,
      32,  11, 244, 162, 201,  34, 101, 231,
-     73,   1,   0,   0, 114,   0,   0,   0,
+    105,   1,   0,   0, 114,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     65,   1,   0,   0,   7,   0,   0,   0,
+     97,   1,   0,   0,   7,   0,   0,   0,
       5,   0,   0,   0,   0,   0,   0,   0,
     244,   8, 218, 103, 137, 115, 252, 190,
      32,  47, 172,  30, 131,  42, 189, 203,
-     53,   1,   0,   0, 106,   0,   0,   0,
+     85,   1,   0,   0, 106,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     45,   1,   0,   0,   7,   0,   0,   0,
+     77,   1,   0,   0,   7,   0,   0,   0,
       6,   0,   0,   0,   0,   0,   0,   0,
     183,  92, 145, 168, 159,  81, 171, 164,
     176, 231, 149, 175, 239, 141, 173, 140,
-     33,   1,   0,   0, 138,   0,   0,   0,
+     65,   1,   0,   0, 138,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     29,   1,   0,   0,   7,   0,   0,   0,
+     61,   1,   0,   0,   7,   0,   0,   0,
       7,   0,   0,   0,   0,   0,   0,   0,
     223, 230,   2, 188, 231, 234,  71, 187,
      87,   3, 100, 241,  85, 161, 100, 129,
-     17,   1,   0,   0, 122,   0,   0,   0,
+     49,   1,   0,   0, 122,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-      9,   1,   0,   0,   7,   0,   0,   0,
+     41,   1,   0,   0,   7,   0,   0,   0,
       8,   0,   0,   0,   0,   0,   0,   0,
      55,  35, 133, 246, 154, 163,   7, 228,
     151, 188,  16, 119, 172, 217,  23, 172,
-    253,   0,   0,   0, 146,   0,   0,   0,
+     29,   1,   0,   0, 146,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    249,   0,   0,   0,   7,   0,   0,   0,
+     25,   1,   0,   0,   7,   0,   0,   0,
       9,   0,   0,   0,   0,   0,   0,   0,
      51, 137, 100,  39, 170, 207,  69, 221,
     125,  50, 144, 231, 152, 188, 142, 192,
-    237,   0,   0,   0, 122,   0,   0,   0,
+     13,   1,   0,   0, 122,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    229,   0,   0,   0,   7,   0,   0,   0,
+      5,   1,   0,   0,   7,   0,   0,   0,
      10,   0,   0,   0,   0,   0,   0,   0,
     136, 190,  63, 231, 201, 140, 152, 173,
      28, 107,  55, 235, 137, 186, 255, 236,
-    217,   0,   0,   0, 130,   0,   0,   0,
+    249,   0,   0,   0, 130,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    209,   0,   0,   0,   7,   0,   0,   0,
+    241,   0,   0,   0,   7,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
      68, 176, 159, 214, 173,   0,  56, 184,
      54,  89, 237, 165, 161, 251,  94, 188,
-    197,   0,   0,   0, 178,   0,   0,   0,
+    229,   0,   0,   0, 178,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    193,   0,   0,   0,   7,   0,   0,   0,
+    225,   0,   0,   0,   7,   0,   0,   0,
       1,   0,   0,   0,   0,   0,   0,   0,
      55,  19, 177,  83, 163, 173, 119, 185,
     158, 127, 174, 199, 165, 213, 211, 242,
-    181,   0,   0,   0, 130,   0,   0,   0,
+    213,   0,   0,   0, 130,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    173,   0,   0,   0,   7,   0,   0,   0,
+    205,   0,   0,   0,   7,   0,   0,   0,
      11,   0,   0,   0,   0,   0,   0,   0,
     139, 207, 235, 135, 235, 135,  58, 144,
     203, 142, 218, 154, 215, 136,  61, 212,
-    161,   0,   0,   0, 106,   0,   0,   0,
+    193,   0,   0,   0, 106,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    153,   0,   0,   0,   7,   0,   0,   0,
+    185,   0,   0,   0,   7,   0,   0,   0,
+     12,   0,   0,   0,   0,   0,   0,   0,
+     22,  40, 113,  94, 216, 159, 232, 159,
+    123, 143, 220,  57, 136,  96, 179, 251,
+    173,   0,   0,   0, 146,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    169,   0,   0,   0,   7,   0,   0,   0,
     112, 108,  97, 110,  77, 101, 109,  99,
     112, 121,  72, 116, 111,  68,   0,   0,
       0,   0,   0,   0,   0,   0,   1,   0,
@@ -563,6 +571,10 @@ static const ::capnp::_::AlignedData<156> b_b5d15336d30e0dd1 = {
     108,  97, 117, 110,  99, 104,  75, 101,
     114, 110, 101, 108,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   1,   0,
+    108,  97, 117, 110,  99, 104,  75, 101,
+    114, 110, 101, 108,  66,  97, 116,  99,
+    104,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   1,   0,
       0,   0,   0,   0,   1,   0,   1,   0, }
 };
 ::capnp::word const* const bp_b5d15336d30e0dd1 = b_b5d15336d30e0dd1.words;
@@ -572,6 +584,7 @@ static const ::capnp::_::RawSchema* const d_b5d15336d30e0dd1[] = {
   &s_8164a155f1640357,
   &s_8cad8defaf95e7b0,
   &s_903a87eb87ebcf8b,
+  &s_9fe89fd85e712816,
   &s_a000d051b28a6d94,
   &s_a4ab519fa8915cb7,
   &s_ac17d9ac7710bc97,
@@ -592,11 +605,12 @@ static const ::capnp::_::RawSchema* const d_b5d15336d30e0dd1[] = {
   &s_ecffba89eb376b1c,
   &s_f2d3d5a5c7ae7f9e,
   &s_fa389ebe41e98f39,
+  &s_fbb3608839dc8f7b,
 };
-static const uint16_t m_b5d15336d30e0dd1[] = {7, 6, 2, 11, 4, 1, 0, 3, 9, 10, 8, 5};
+static const uint16_t m_b5d15336d30e0dd1[] = {7, 6, 2, 11, 12, 4, 1, 0, 3, 9, 10, 8, 5};
 const ::capnp::_::RawSchema s_b5d15336d30e0dd1 = {
-  0xb5d15336d30e0dd1, b_b5d15336d30e0dd1.words, 156, d_b5d15336d30e0dd1, m_b5d15336d30e0dd1,
-  24, 12, nullptr, nullptr, nullptr, { &s_b5d15336d30e0dd1, nullptr, nullptr, 0, 0, nullptr }, false
+  0xb5d15336d30e0dd1, b_b5d15336d30e0dd1.words, 168, d_b5d15336d30e0dd1, m_b5d15336d30e0dd1,
+  26, 13, nullptr, nullptr, nullptr, { &s_b5d15336d30e0dd1, nullptr, nullptr, 0, 0, nullptr }, false
 };
 #endif  // !CAPNP_LITE
 static const ::capnp::_::AlignedData<52> b_a000d051b28a6d94 = {
@@ -1976,6 +1990,108 @@ const ::capnp::_::RawSchema s_d43d88d79ada8ecb = {
   1, 1, i_d43d88d79ada8ecb, nullptr, nullptr, { &s_d43d88d79ada8ecb, nullptr, nullptr, 0, 0, nullptr }, false
 };
 #endif  // !CAPNP_LITE
+static const ::capnp::_::AlignedData<37> b_9fe89fd85e712816 = {
+  {   0,   0,   0,   0,   6,   0,   6,   0,
+     22,  40, 113,  94, 216, 159, 232, 159,
+     33,   0,   0,   0,   1,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      1,   0,   7,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     21,   0,   0,   0, 210,   1,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     41,   0,   0,   0,  63,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    104, 111, 111, 107,  45, 108,  97, 117,
+    110,  99, 104, 101, 114,  46,  99,  97,
+    112, 110, 112,  58,  72, 111, 111, 107,
+     76,  97, 117, 110,  99, 104, 101, 114,
+     46, 108,  97, 117, 110,  99, 104,  75,
+    101, 114, 110, 101, 108,  66,  97, 116,
+     99, 104,  36,  80,  97, 114,  97, 109,
+    115,   0,   0,   0,   0,   0,   0,   0,
+      4,   0,   0,   0,   3,   0,   4,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   1,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     13,   0,   0,   0,  66,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      8,   0,   0,   0,   3,   0,   1,   0,
+     20,   0,   0,   0,   2,   0,   1,   0,
+    114, 101, 113, 117, 101, 115, 116,   0,
+     16,   0,   0,   0,   0,   0,   0,   0,
+    148, 123, 222, 186,  36,  76, 207, 218,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     16,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0, }
+};
+::capnp::word const* const bp_9fe89fd85e712816 = b_9fe89fd85e712816.words;
+#if !CAPNP_LITE
+static const ::capnp::_::RawSchema* const d_9fe89fd85e712816[] = {
+  &s_dacf4c24bade7b94,
+};
+static const uint16_t m_9fe89fd85e712816[] = {0};
+static const uint16_t i_9fe89fd85e712816[] = {0};
+const ::capnp::_::RawSchema s_9fe89fd85e712816 = {
+  0x9fe89fd85e712816, b_9fe89fd85e712816.words, 37, d_9fe89fd85e712816, m_9fe89fd85e712816,
+  1, 1, i_9fe89fd85e712816, nullptr, nullptr, { &s_9fe89fd85e712816, nullptr, nullptr, 0, 0, nullptr }, false
+};
+#endif  // !CAPNP_LITE
+static const ::capnp::_::AlignedData<37> b_fbb3608839dc8f7b = {
+  {   0,   0,   0,   0,   6,   0,   6,   0,
+    123, 143, 220,  57, 136,  96, 179, 251,
+     33,   0,   0,   0,   1,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      1,   0,   7,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     21,   0,   0,   0, 218,   1,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     41,   0,   0,   0,  63,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+    104, 111, 111, 107,  45, 108,  97, 117,
+    110,  99, 104, 101, 114,  46,  99,  97,
+    112, 110, 112,  58,  72, 111, 111, 107,
+     76,  97, 117, 110,  99, 104, 101, 114,
+     46, 108,  97, 117, 110,  99, 104,  75,
+    101, 114, 110, 101, 108,  66,  97, 116,
+     99, 104,  36,  82, 101, 115, 117, 108,
+    116, 115,   0,   0,   0,   0,   0,   0,
+      4,   0,   0,   0,   3,   0,   4,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   1,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     13,   0,   0,   0,  34,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      8,   0,   0,   0,   3,   0,   1,   0,
+     20,   0,   0,   0,   2,   0,   1,   0,
+     97,  99, 107,   0,   0,   0,   0,   0,
+     16,   0,   0,   0,   0,   0,   0,   0,
+    136,  53,  26,  54,   3, 107, 110, 188,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     16,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0, }
+};
+::capnp::word const* const bp_fbb3608839dc8f7b = b_fbb3608839dc8f7b.words;
+#if !CAPNP_LITE
+static const ::capnp::_::RawSchema* const d_fbb3608839dc8f7b[] = {
+  &s_bc6e6b03361a3588,
+};
+static const uint16_t m_fbb3608839dc8f7b[] = {0};
+static const uint16_t i_fbb3608839dc8f7b[] = {0};
+const ::capnp::_::RawSchema s_fbb3608839dc8f7b = {
+  0xfbb3608839dc8f7b, b_fbb3608839dc8f7b.words, 37, d_fbb3608839dc8f7b, m_fbb3608839dc8f7b,
+  1, 1, i_fbb3608839dc8f7b, nullptr, nullptr, { &s_fbb3608839dc8f7b, nullptr, nullptr, 0, 0, nullptr }, false
+};
+#endif  // !CAPNP_LITE
 static const ::capnp::_::AlignedData<51> b_8e06bfe25704b493 = {
   {   0,   0,   0,   0,   6,   0,   6,   0,
     147, 180,   4,  87, 226, 191,   6, 142,
@@ -1983,7 +2099,7 @@ static const ::capnp::_::AlignedData<51> b_8e06bfe25704b493 = {
     113,  94, 165, 177, 235, 173, 187, 218,
       0,   0,   7,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-    203,  11,   0,   0,  70,  12,   0,   0,
+    120,  12,   0,   0, 243,  12,   0,   0,
      21,   0,   0,   0,  34,   1,   0,   0,
      37,   0,   0,   0,   7,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
@@ -2045,7 +2161,7 @@ static const ::capnp::_::AlignedData<51> b_9067a75daac545ad = {
     113,  94, 165, 177, 235, 173, 187, 218,
       0,   0,   7,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-     74,  12,   0,   0, 209,  12,   0,   0,
+    247,  12,   0,   0, 126,  13,   0,   0,
      21,   0,   0,   0, 250,   0,   0,   0,
      33,   0,   0,   0,   7,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
@@ -2107,7 +2223,7 @@ static const ::capnp::_::AlignedData<65> b_e512d381fed0aa2e = {
     113,  94, 165, 177, 235, 173, 187, 218,
       1,   0,   7,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
-      3,  13,   0,   0, 151,  13,   0,   0,
+    176,  13,   0,   0,  68,  14,   0,   0,
      21,   0,   0,   0, 234,   0,   0,   0,
      33,   0,   0,   0,   7,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,
@@ -2342,6 +2458,16 @@ HookLauncher::Client::launchKernelRequest(::kj::Maybe< ::capnp::MessageSize> siz
       "hook-launcher.capnp:HookLauncher", "launchKernel",
       0xb5d15336d30e0dd1ull, 11);
 }
+::capnp::Request< ::HookLauncher::LaunchKernelBatchParams,  ::HookLauncher::LaunchKernelBatchResults>
+HookLauncher::Client::launchKernelBatchRequest(::kj::Maybe< ::capnp::MessageSize> sizeHint) {
+  return newCall< ::HookLauncher::LaunchKernelBatchParams,  ::HookLauncher::LaunchKernelBatchResults>(
+      0xb5d15336d30e0dd1ull, 12, sizeHint, {true});
+}
+::kj::Promise<void> HookLauncher::Server::launchKernelBatch(LaunchKernelBatchContext) {
+  return ::capnp::Capability::Server::internalUnimplemented(
+      "hook-launcher.capnp:HookLauncher", "launchKernelBatch",
+      0xb5d15336d30e0dd1ull, 12);
+}
 ::capnp::Capability::Server::DispatchCallResult HookLauncher::Server::dispatchCall(
     uint64_t interfaceId, uint16_t methodId,
     ::capnp::CallContext< ::capnp::AnyPointer, ::capnp::AnyPointer> context) {
@@ -2440,6 +2566,13 @@ HookLauncher::Client::launchKernelRequest(::kj::Maybe< ::capnp::MessageSize> siz
         false,
         false
       };
+    case 12:
+      return {
+        launchKernelBatch(::capnp::Capability::Server::internalGetTypedContext<
+             ::HookLauncher::LaunchKernelBatchParams,  ::HookLauncher::LaunchKernelBatchResults>(context)),
+        false,
+        false
+      };
     default:
       (void)context;
       return ::capnp::Capability::Server::internalUnimplemented(
@@ -2745,6 +2878,30 @@ constexpr ::capnp::_::RawSchema const* HookLauncher::LaunchKernelResults::_capnp
 #endif  // !CAPNP_NEED_REDUNDANT_CONSTEXPR_DECL
 #endif  // !CAPNP_LITE
 
+// HookLauncher::LaunchKernelBatchParams
+#if CAPNP_NEED_REDUNDANT_CONSTEXPR_DECL
+constexpr uint16_t HookLauncher::LaunchKernelBatchParams::_capnpPrivate::dataWordSize;
+constexpr uint16_t HookLauncher::LaunchKernelBatchParams::_capnpPrivate::pointerCount;
+#endif  // !CAPNP_NEED_REDUNDANT_CONSTEXPR_DECL
+#if !CAPNP_LITE
+#if CAPNP_NEED_REDUNDANT_CONSTEXPR_DECL
+constexpr ::capnp::Kind HookLauncher::LaunchKernelBatchParams::_capnpPrivate::kind;
+constexpr ::capnp::_::RawSchema const* HookLauncher::LaunchKernelBatchParams::_capnpPrivate::schema;
+#endif  // !CAPNP_NEED_REDUNDANT_CONSTEXPR_DECL
+#endif  // !CAPNP_LITE
+
+// HookLauncher::LaunchKernelBatchResults
+#if CAPNP_NEED_REDUNDANT_CONSTEXPR_DECL
+constexpr uint16_t HookLauncher::LaunchKernelBatchResults::_capnpPrivate::dataWordSize;
+constexpr uint16_t HookLauncher::LaunchKernelBatchResults::_capnpPrivate::pointerCount;
+#endif  // !CAPNP_NEED_REDUNDANT_CONSTEXPR_DECL
+#if !CAPNP_LITE
+#if CAPNP_NEED_REDUNDANT_CONSTEXPR_DECL
+constexpr ::capnp::Kind HookLauncher::LaunchKernelBatchResults::_capnpPrivate::kind;
+constexpr ::capnp::_::RawSchema const* HookLauncher::LaunchKernelBatchResults::_capnpPrivate::schema;
+#endif  // !CAPNP_NEED_REDUNDANT_CONSTEXPR_DECL
+#endif  // !CAPNP_LITE
+
 // BandwidthResult
 #if CAPNP_NEED_REDUNDANT_CONSTEXPR_DECL
 constexpr uint16_t BandwidthResult::_capnpPrivate::dataWordSize;
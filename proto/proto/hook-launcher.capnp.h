@@ -16,6 +16,7 @@
 #endif
 
 #include "common.capnp.h"
+#include "cuda.capnp.h"
 #include "memcopy.capnp.h"
 
 CAPNP_BEGIN_HEADER
@@ -64,6 +65,8 @@ CAPNP_DECLARE_SCHEMA(b977ada353b11337);
 CAPNP_DECLARE_SCHEMA(f2d3d5a5c7ae7f9e);
 CAPNP_DECLARE_SCHEMA(903a87eb87ebcf8b);
 CAPNP_DECLARE_SCHEMA(d43d88d79ada8ecb);
+CAPNP_DECLARE_SCHEMA(9fe89fd85e712816);
+CAPNP_DECLARE_SCHEMA(fbb3608839dc8f7b);
 CAPNP_DECLARE_SCHEMA(8e06bfe25704b493);
 CAPNP_DECLARE_SCHEMA(9067a75daac545ad);
 CAPNP_DECLARE_SCHEMA(e512d381fed0aa2e);
@@ -153,6 +156,8 @@ struct HookLauncher {
   struct RequestFreePlanResults;
   struct LaunchKernelParams;
   struct LaunchKernelResults;
+  struct LaunchKernelBatchParams;
+  struct LaunchKernelBatchResults;
 
   #if !CAPNP_LITE
   struct _capnpPrivate {
@@ -522,6 +527,36 @@ struct HookLauncher::LaunchKernelResults {
   };
 };
 
+struct HookLauncher::LaunchKernelBatchParams {
+  LaunchKernelBatchParams() = delete;
+
+  class Reader;
+  class Builder;
+  class Pipeline;
+
+  struct _capnpPrivate {
+    CAPNP_DECLARE_STRUCT_HEADER(9fe89fd85e712816, 0, 1)
+    #if !CAPNP_LITE
+    static constexpr ::capnp::_::RawBrandedSchema const* brand() { return &schema->defaultBrand; }
+    #endif  // !CAPNP_LITE
+  };
+};
+
+struct HookLauncher::LaunchKernelBatchResults {
+  LaunchKernelBatchResults() = delete;
+
+  class Reader;
+  class Builder;
+  class Pipeline;
+
+  struct _capnpPrivate {
+    CAPNP_DECLARE_STRUCT_HEADER(fbb3608839dc8f7b, 0, 1)
+    #if !CAPNP_LITE
+    static constexpr ::capnp::_::RawBrandedSchema const* brand() { return &schema->defaultBrand; }
+    #endif  // !CAPNP_LITE
+  };
+};
+
 struct BandwidthResult {
   BandwidthResult() = delete;
 
@@ -905,6 +940,8 @@ public:
       ::kj::Maybe< ::capnp::MessageSize> sizeHint = nullptr);
   ::capnp::Request< ::HookLauncher::LaunchKernelParams,  ::HookLauncher::LaunchKernelResults> launchKernelRequest(
       ::kj::Maybe< ::capnp::MessageSize> sizeHint = nullptr);
+  ::capnp::Request< ::HookLauncher::LaunchKernelBatchParams,  ::HookLauncher::LaunchKernelBatchResults> launchKernelBatchRequest(
+      ::kj::Maybe< ::capnp::MessageSize> sizeHint = nullptr);
 
 protected:
   Client() = default;
@@ -969,6 +1006,10 @@ protected:
   typedef  ::HookLauncher::LaunchKernelResults LaunchKernelResults;
   typedef ::capnp::CallContext<LaunchKernelParams, LaunchKernelResults> LaunchKernelContext;
   virtual ::kj::Promise<void> launchKernel(LaunchKernelContext context);
+  typedef  ::HookLauncher::LaunchKernelBatchParams LaunchKernelBatchParams;
+  typedef  ::HookLauncher::LaunchKernelBatchResults LaunchKernelBatchResults;
+  typedef ::capnp::CallContext<LaunchKernelBatchParams, LaunchKernelBatchResults> LaunchKernelBatchContext;
+  virtual ::kj::Promise<void> launchKernelBatch(LaunchKernelBatchContext context);
 
   inline  ::HookLauncher::Client thisCap() {
     return ::capnp::Capability::Server::thisCap()
@@ -2986,6 +3027,170 @@ private:
 };
 #endif  // !CAPNP_LITE
 
+class HookLauncher::LaunchKernelBatchParams::Reader {
+public:
+  typedef LaunchKernelBatchParams Reads;
+
+  Reader() = default;
+  inline explicit Reader(::capnp::_::StructReader base): _reader(base) {}
+
+  inline ::capnp::MessageSize totalSize() const {
+    return _reader.totalSize().asPublic();
+  }
+
+#if !CAPNP_LITE
+  inline ::kj::StringTree toString() const {
+    return ::capnp::_::structString(_reader, *_capnpPrivate::brand());
+  }
+#endif  // !CAPNP_LITE
+
+  inline bool hasRequest() const;
+  inline  ::BatchKernelLaunch::Reader getRequest() const;
+
+private:
+  ::capnp::_::StructReader _reader;
+  template <typename, ::capnp::Kind>
+  friend struct ::capnp::ToDynamic_;
+  template <typename, ::capnp::Kind>
+  friend struct ::capnp::_::PointerHelpers;
+  template <typename, ::capnp::Kind>
+  friend struct ::capnp::List;
+  friend class ::capnp::MessageBuilder;
+  friend class ::capnp::Orphanage;
+};
+
+class HookLauncher::LaunchKernelBatchParams::Builder {
+public:
+  typedef LaunchKernelBatchParams Builds;
+
+  Builder() = delete;  // Deleted to discourage incorrect usage.
+                       // You can explicitly initialize to nullptr instead.
+  inline Builder(decltype(nullptr)) {}
+  inline explicit Builder(::capnp::_::StructBuilder base): _builder(base) {}
+  inline operator Reader() const { return Reader(_builder.asReader()); }
+  inline Reader asReader() const { return *this; }
+
+  inline ::capnp::MessageSize totalSize() const { return asReader().totalSize(); }
+#if !CAPNP_LITE
+  inline ::kj::StringTree toString() const { return asReader().toString(); }
+#endif  // !CAPNP_LITE
+
+  inline bool hasRequest();
+  inline  ::BatchKernelLaunch::Builder getRequest();
+  inline void setRequest( ::BatchKernelLaunch::Reader value);
+  inline  ::BatchKernelLaunch::Builder initRequest();
+  inline void adoptRequest(::capnp::Orphan< ::BatchKernelLaunch>&& value);
+  inline ::capnp::Orphan< ::BatchKernelLaunch> disownRequest();
+
+private:
+  ::capnp::_::StructBuilder _builder;
+  template <typename, ::capnp::Kind>
+  friend struct ::capnp::ToDynamic_;
+  friend class ::capnp::Orphanage;
+  template <typename, ::capnp::Kind>
+  friend struct ::capnp::_::PointerHelpers;
+};
+
+#if !CAPNP_LITE
+class HookLauncher::LaunchKernelBatchParams::Pipeline {
+public:
+  typedef LaunchKernelBatchParams Pipelines;
+
+  inline Pipeline(decltype(nullptr)): _typeless(nullptr) {}
+  inline explicit Pipeline(::capnp::AnyPointer::Pipeline&& typeless)
+      : _typeless(kj::mv(typeless)) {}
+
+  inline  ::BatchKernelLaunch::Pipeline getRequest();
+private:
+  ::capnp::AnyPointer::Pipeline _typeless;
+  friend class ::capnp::PipelineHook;
+  template <typename, ::capnp::Kind>
+  friend struct ::capnp::ToDynamic_;
+};
+#endif  // !CAPNP_LITE
+
+class HookLauncher::LaunchKernelBatchResults::Reader {
+public:
+  typedef LaunchKernelBatchResults Reads;
+
+  Reader() = default;
+  inline explicit Reader(::capnp::_::StructReader base): _reader(base) {}
+
+  inline ::capnp::MessageSize totalSize() const {
+    return _reader.totalSize().asPublic();
+  }
+
+#if !CAPNP_LITE
+  inline ::kj::StringTree toString() const {
+    return ::capnp::_::structString(_reader, *_capnpPrivate::brand());
+  }
+#endif  // !CAPNP_LITE
+
+  inline bool hasAck() const;
+  inline  ::Ack::Reader getAck() const;
+
+private:
+  ::capnp::_::StructReader _reader;
+  template <typename, ::capnp::Kind>
+  friend struct ::capnp::ToDynamic_;
+  template <typename, ::capnp::Kind>
+  friend struct ::capnp::_::PointerHelpers;
+  template <typename, ::capnp::Kind>
+  friend struct ::capnp::List;
+  friend class ::capnp::MessageBuilder;
+  friend class ::capnp::Orphanage;
+};
+
+class HookLauncher::LaunchKernelBatchResults::Builder {
+public:
+  typedef LaunchKernelBatchResults Builds;
+
+  Builder() = delete;  // Deleted to discourage incorrect usage.
+                       // You can explicitly initialize to nullptr instead.
+  inline Builder(decltype(nullptr)) {}
+  inline explicit Builder(::capnp::_::StructBuilder base): _builder(base) {}
+  inline operator Reader() const { return Reader(_builder.asReader()); }
+  inline Reader asReader() const { return *this; }
+
+  inline ::capnp::MessageSize totalSize() const { return asReader().totalSize(); }
+#if !CAPNP_LITE
+  inline ::kj::StringTree toString() const { return asReader().toString(); }
+#endif  // !CAPNP_LITE
+
+  inline bool hasAck();
+  inline  ::Ack::Builder getAck();
+  inline void setAck( ::Ack::Reader value);
+  inline  ::Ack::Builder initAck();
+  inline void adoptAck(::capnp::Orphan< ::Ack>&& value);
+  inline ::capnp::Orphan< ::Ack> disownAck();
+
+private:
+  ::capnp::_::StructBuilder _builder;
+  template <typename, ::capnp::Kind>
+  friend struct ::capnp::ToDynamic_;
+  friend class ::capnp::Orphanage;
+  template <typename, ::capnp::Kind>
+  friend struct ::capnp::_::PointerHelpers;
+};
+
+#if !CAPNP_LITE
+class HookLauncher::LaunchKernelBatchResults::Pipeline {
+public:
+  typedef LaunchKernelBatchResults Pipelines;
+
+  inline Pipeline(decltype(nullptr)): _typeless(nullptr) {}
+  inline explicit Pipeline(::capnp::AnyPointer::Pipeline&& typeless)
+      : _typeless(kj::mv(typeless)) {}
+
+  inline  ::Ack::Pipeline getAck();
+private:
+  ::capnp::AnyPointer::Pipeline _typeless;
+  friend class ::capnp::PipelineHook;
+  template <typename, ::capnp::Kind>
+  friend struct ::capnp::ToDynamic_;
+};
+#endif  // !CAPNP_LITE
+
 class BandwidthResult::Reader {
 public:
   typedef BandwidthResult Reads;
@@ -4505,6 +4710,84 @@ inline ::capnp::Orphan< ::Ack> HookLauncher::LaunchKernelResults::Builder::disow
       ::capnp::bounded<0>() * ::capnp::POINTERS));
 }
 
+inline bool HookLauncher::LaunchKernelBatchParams::Reader::hasRequest() const {
+  return !_reader.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS).isNull();
+}
+inline bool HookLauncher::LaunchKernelBatchParams::Builder::hasRequest() {
+  return !_builder.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS).isNull();
+}
+inline  ::BatchKernelLaunch::Reader HookLauncher::LaunchKernelBatchParams::Reader::getRequest() const {
+  return ::capnp::_::PointerHelpers< ::BatchKernelLaunch>::get(_reader.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS));
+}
+inline  ::BatchKernelLaunch::Builder HookLauncher::LaunchKernelBatchParams::Builder::getRequest() {
+  return ::capnp::_::PointerHelpers< ::BatchKernelLaunch>::get(_builder.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS));
+}
+#if !CAPNP_LITE
+inline  ::BatchKernelLaunch::Pipeline HookLauncher::LaunchKernelBatchParams::Pipeline::getRequest() {
+  return  ::BatchKernelLaunch::Pipeline(_typeless.getPointerField(0));
+}
+#endif  // !CAPNP_LITE
+inline void HookLauncher::LaunchKernelBatchParams::Builder::setRequest( ::BatchKernelLaunch::Reader value) {
+  ::capnp::_::PointerHelpers< ::BatchKernelLaunch>::set(_builder.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS), value);
+}
+inline  ::BatchKernelLaunch::Builder HookLauncher::LaunchKernelBatchParams::Builder::initRequest() {
+  return ::capnp::_::PointerHelpers< ::BatchKernelLaunch>::init(_builder.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS));
+}
+inline void HookLauncher::LaunchKernelBatchParams::Builder::adoptRequest(
+    ::capnp::Orphan< ::BatchKernelLaunch>&& value) {
+  ::capnp::_::PointerHelpers< ::BatchKernelLaunch>::adopt(_builder.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS), kj::mv(value));
+}
+inline ::capnp::Orphan< ::BatchKernelLaunch> HookLauncher::LaunchKernelBatchParams::Builder::disownRequest() {
+  return ::capnp::_::PointerHelpers< ::BatchKernelLaunch>::disown(_builder.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS));
+}
+
+inline bool HookLauncher::LaunchKernelBatchResults::Reader::hasAck() const {
+  return !_reader.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS).isNull();
+}
+inline bool HookLauncher::LaunchKernelBatchResults::Builder::hasAck() {
+  return !_builder.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS).isNull();
+}
+inline  ::Ack::Reader HookLauncher::LaunchKernelBatchResults::Reader::getAck() const {
+  return ::capnp::_::PointerHelpers< ::Ack>::get(_reader.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS));
+}
+inline  ::Ack::Builder HookLauncher::LaunchKernelBatchResults::Builder::getAck() {
+  return ::capnp::_::PointerHelpers< ::Ack>::get(_builder.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS));
+}
+#if !CAPNP_LITE
+inline  ::Ack::Pipeline HookLauncher::LaunchKernelBatchResults::Pipeline::getAck() {
+  return  ::Ack::Pipeline(_typeless.getPointerField(0));
+}
+#endif  // !CAPNP_LITE
+inline void HookLauncher::LaunchKernelBatchResults::Builder::setAck( ::Ack::Reader value) {
+  ::capnp::_::PointerHelpers< ::Ack>::set(_builder.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS), value);
+}
+inline  ::Ack::Builder HookLauncher::LaunchKernelBatchResults::Builder::initAck() {
+  return ::capnp::_::PointerHelpers< ::Ack>::init(_builder.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS));
+}
+inline void HookLauncher::LaunchKernelBatchResults::Builder::adoptAck(
+    ::capnp::Orphan< ::Ack>&& value) {
+  ::capnp::_::PointerHelpers< ::Ack>::adopt(_builder.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS), kj::mv(value));
+}
+inline ::capnp::Orphan< ::Ack> HookLauncher::LaunchKernelBatchResults::Builder::disownAck() {
+  return ::capnp::_::PointerHelpers< ::Ack>::disown(_builder.getPointerField(
+      ::capnp::bounded<0>() * ::capnp::POINTERS));
+}
+
 inline float BandwidthResult::Reader::getThroughput() const {
   return _reader.getDataField<float>(
       ::capnp::bounded<0>() * ::capnp::ELEMENTS);